@@ -0,0 +1,60 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// WebAssembly bulk interface; see bulk.hpp for buffer formats
+//
+// Typical use from JavaScript:
+//   const input = Module._bulkAllocate(inputSize);
+//   // write length-prefixed reports to Module.HEAPU8 at input
+//   const output = Module._bulkAllocate(stations * 64);
+//   const count = Module._currentWeatherBulk(input, inputSize, output, stations);
+//   // read records from Module.HEAPU8.buffer at output with DataView
+//   Module._bulkFree(output); Module._bulkFree(input);
+// Buffers may be kept and reused between batches
+
+#include "bulk.hpp"
+#include <cstdlib>
+#include <emscripten/emscripten.h>
+
+extern "C" void * EMSCRIPTEN_KEEPALIVE bulkAllocate(std::uint32_t size) {
+	return std::malloc(size);
+}
+
+extern "C" void EMSCRIPTEN_KEEPALIVE bulkFree(void * buffer) {
+	std::free(buffer);
+}
+
+extern "C" std::uint32_t EMSCRIPTEN_KEEPALIVE currentWeatherRecordSize() {
+	return sizeof(PackedCurrentWeather);
+}
+
+// If built with pthreads, the stations are processed by all available
+// threads, otherwise by the calling thread only
+extern "C" int EMSCRIPTEN_KEEPALIVE currentWeatherBulk(const std::uint8_t * input,
+	std::uint32_t inputSize,
+	PackedCurrentWeather * output,
+	std::uint32_t outputSize)
+{
+	return BulkProcessor::currentWeather(input, inputSize, output, outputSize, 0);
+}
+
+extern "C" int EMSCRIPTEN_KEEPALIVE explainBulk(const std::uint8_t * input,
+	std::uint32_t inputSize,
+	char * output,
+	std::uint32_t outputSize,
+	std::uint32_t * offsets,
+	std::uint32_t offsetsSize,
+	int isPlainText)
+{
+	return BulkProcessor::explain(input, inputSize, output, outputSize,
+		offsets, offsetsSize,
+		isPlainText ? ExplainDecoder::Format::TEXT : ExplainDecoder::Format::HTML);
+}
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+}
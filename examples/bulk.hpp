@@ -0,0 +1,212 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Bulk processing of many reports packed into a single buffer, so that
+// WebAssembly module is called once per batch rather than once per report
+//
+// Input buffer is a sequence of entries; each entry is a 32-bit little-endian
+// length followed by that many bytes of report text (not null-terminated)
+// For current weather, each station takes two consecutive entries: METAR and
+// TAF (either may have zero length)
+
+#ifndef BULK_HPP
+#define BULK_HPP
+
+#include "metaf.hpp"
+#include "explain.hpp"
+#include "workerpool.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <string>
+
+// Current weather record with fixed binary layout (little-endian), so that it
+// can be read directly from linear memory by JavaScript (e.g. via DataView)
+struct PackedCurrentWeather {
+	static const inline std::size_t maxWeather = 4;
+	enum Flags : std::uint8_t {
+		WIND_VARIABLE = 1,
+		STORM_CLOUDS = 2,
+		REPORT_TIME = 4
+	};
+
+	float windDirection;		// Offset 0, degrees
+	float windSpeed;			// Offset 4, knots
+	float gustSpeed;			// Offset 8, knots
+	float visibility;			// Offset 12, meters
+	float airTemperature;		// Offset 16, degrees Celsius
+	float perceivedTemperature;	// Offset 20, degrees Celsius
+	float airTemperatureHigh;	// Offset 24, degrees Celsius
+	float airTemperatureLow;	// Offset 28, degrees Celsius
+	float relativeHumidity;		// Offset 32, percent
+	float pressure;				// Offset 36, hectopascal
+	std::uint8_t source;		// Offset 40, CurrentWeather::Source
+	std::uint8_t cloud;			// Offset 41, CurrentWeather::Cloud
+	std::uint8_t flags;			// Offset 42, see Flags
+	std::uint8_t weatherSize;	// Offset 43
+	std::uint8_t reportDay;		// Offset 44, zero if day is not reported
+	std::uint8_t reportHour;	// Offset 45
+	std::uint8_t reportMinute;	// Offset 46
+	std::uint8_t reserved;		// Offset 47
+	std::uint32_t weather[maxWeather];	// Offset 48, ObservationColumns::weatherCode()
+
+	static inline PackedCurrentWeather fromCurrentWeather(
+		const metaf::CurrentWeather & cw);
+};
+
+static_assert(sizeof(PackedCurrentWeather) == 64,
+	"PackedCurrentWeather layout is used by JavaScript code");
+
+class BulkProcessor {
+public:
+	// Returns number of entries in the input buffer, or -1 if the buffer is
+	// malformed
+	static inline int countEntries(const std::uint8_t * input, std::size_t inputSize);
+	// Extracts current weather for each METAR/TAF pair of the input buffer
+	// into output array of at most outputSize records
+	// Returns number of records written, or -1 if the input buffer is malformed
+	// or contains an odd number of entries (METAR without TAF)
+	static inline int currentWeather(const std::uint8_t * input,
+		std::size_t inputSize,
+		PackedCurrentWeather * output,
+		std::size_t outputSize,
+		unsigned int threads = 1);
+	// Explains each report of the input buffer; the explanations are written
+	// one after another into the output buffer, each one null-terminated, and
+	// offsets[N] is position of N-th explanation in the output buffer
+	// Stops when the next explanation does not fit into the output buffer
+	// Returns number of explanations written, or -1 if the input buffer is
+	// malformed
+	static inline int explain(const std::uint8_t * input,
+		std::size_t inputSize,
+		char * output,
+		std::size_t outputSize,
+		std::uint32_t * offsets,
+		std::size_t offsetsSize,
+		ExplainDecoder::Format format);
+
+private:
+	// Splits input buffer into the reports; the strings retain their capacity
+	// between calls
+	static inline bool unpack(const std::uint8_t * input,
+		std::size_t inputSize,
+		std::vector<std::string> & reports);
+};
+
+PackedCurrentWeather PackedCurrentWeather::fromCurrentWeather(
+	const metaf::CurrentWeather & cw)
+{
+	PackedCurrentWeather result {};
+	result.windDirection = cw.windDirection;
+	result.windSpeed = cw.windSpeed;
+	result.gustSpeed = cw.gustSpeed;
+	result.visibility = cw.visibility;
+	result.airTemperature = cw.airTemperature;
+	result.perceivedTemperature = cw.perceivedTemperature;
+	result.airTemperatureHigh = cw.airTemperatureHigh;
+	result.airTemperatureLow = cw.airTemperatureLow;
+	result.relativeHumidity = cw.relativeHumidity;
+	result.pressure = cw.pressure;
+	result.source = static_cast<std::uint8_t>(cw.source);
+	result.cloud = static_cast<std::uint8_t>(cw.cloud);
+	if (cw.isWindVariable) result.flags |= WIND_VARIABLE;
+	if (cw.isStormClouds) result.flags |= STORM_CLOUDS;
+	if (cw.reportTime.has_value()) {
+		result.flags |= REPORT_TIME;
+		result.reportDay = cw.reportTime->day().value_or(0);
+		result.reportHour = cw.reportTime->hour();
+		result.reportMinute = cw.reportTime->minute();
+	}
+	result.weatherSize = std::min(static_cast<std::size_t>(cw.weatherSize), maxWeather);
+	for (auto i = 0u; i < result.weatherSize; i++) result.weather[i] = cw.weather[i];
+	return result;
+}
+
+int BulkProcessor::countEntries(const std::uint8_t * input, std::size_t inputSize) {
+	int count = 0;
+	std::size_t pos = 0;
+	while (pos < inputSize) {
+		std::uint32_t length;
+		if (inputSize - pos < sizeof(length)) return -1;
+		std::memcpy(&length, input + pos, sizeof(length));
+		pos += sizeof(length);
+		if (inputSize - pos < length) return -1;
+		pos += length;
+		count++;
+	}
+	return count;
+}
+
+bool BulkProcessor::unpack(const std::uint8_t * input,
+	std::size_t inputSize,
+	std::vector<std::string> & reports)
+{
+	const auto count = countEntries(input, inputSize);
+	if (count < 0) return false;
+	reports.resize(count);
+	std::size_t pos = 0;
+	for (auto & report : reports) {
+		std::uint32_t length;
+		std::memcpy(&length, input + pos, sizeof(length));
+		pos += sizeof(length);
+		report.assign(reinterpret_cast<const char *>(input + pos), length);
+		pos += length;
+	}
+	return true;
+}
+
+int BulkProcessor::currentWeather(const std::uint8_t * input,
+	std::size_t inputSize,
+	PackedCurrentWeather * output,
+	std::size_t outputSize,
+	unsigned int threads)
+{
+	// Thread-local variables are not captured by lambda, reference is used
+	// to access the reports from worker threads
+	thread_local std::vector<std::string> unpacked;
+	auto & reports = unpacked;
+	if (!unpack(input, inputSize, reports) || reports.size() % 2) return -1;
+	const auto size = std::min(reports.size() / 2, outputSize);
+	// Workers are kept alive between batches, so that the group cache of
+	// each worker thread is re-used
+	WorkerPool::shared().run(size, threads, [&](std::size_t begin, std::size_t end) {
+		auto & cache = metaf::GroupCache::threadCache();
+		metaf::ParseResult metar, taf;
+		for (auto i = begin; i < end; i++) {
+			metaf::Parser::parse(reports[2 * i], metar, cache);
+			metaf::Parser::parse(reports[2 * i + 1], taf, cache);
+			const auto cw = metaf::CurrentWeatherExtractor::extract(metar, taf);
+			output[i] = PackedCurrentWeather::fromCurrentWeather(cw);
+		}
+	});
+	return size;
+}
+
+int BulkProcessor::explain(const std::uint8_t * input,
+	std::size_t inputSize,
+	char * output,
+	std::size_t outputSize,
+	std::uint32_t * offsets,
+	std::size_t offsetsSize,
+	ExplainDecoder::Format format)
+{
+	thread_local std::vector<std::string> reports;
+	if (!unpack(input, inputSize, reports)) return -1;
+	const ExplainDecoder decoder(format);
+	const auto size = std::min(reports.size(), offsetsSize);
+	std::size_t pos = 0;
+	for (auto i = 0u; i < size; i++) {
+		if (pos >= outputSize) return i;
+		const auto length = decoder.decode(reports[i], output + pos, outputSize - pos);
+		if (pos + length >= outputSize) return i;
+		offsets[i] = pos;
+		pos += length + 1;
+	}
+	return size;
+}
+
+#endif //#ifndef BULK_HPP
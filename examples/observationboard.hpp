@@ -0,0 +1,399 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Board of the latest current weather per station, stored in POSIX shared
+// memory, so that the ingest process which parses the reports can publish
+// decoded observations and any number of other processes on the same host
+// can read them without parsing the reports again
+//
+// The board has one writer and any number of readers; readers map the
+// shared memory read-only and never block the writer
+// Each station has a fixed-size slot protected by a sequence lock: writer
+// makes sequence odd, updates the record and makes sequence even again;
+// reader copies the record and retries if the sequence was odd or changed
+// during copying; since the writer updates the station only when a new
+// report arrives, the retry is rare and a read normally takes a single copy
+// of the record
+// Slots are located by LocationGroup::key() in the open-addressing hash
+// table; the stations are never removed, so that the readers may search
+// the table without locking while the writer adds new stations
+//
+// Board is created (or replaced) by the writer; readers opened before the
+// board was replaced still see the old board and must re-open it
+
+#ifndef OBSERVATIONBOARD_HPP
+#define OBSERVATIONBOARD_HPP
+
+#include "metaf.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class ObservationBoard {
+public:
+	using Record = metaf::CurrentWeather;
+
+	ObservationBoard() = default;
+	ObservationBoard(const ObservationBoard &) = delete;
+	ObservationBoard & operator=(const ObservationBoard &) = delete;
+	ObservationBoard(ObservationBoard && other) { *this = std::move(other); }
+	inline ObservationBoard & operator=(ObservationBoard && other);
+	~ObservationBoard() { close(); }
+
+	// Creates shared memory object for at most maxStations stations and
+	// opens the board for writing; shared memory object with the same
+	// name, if exists, is replaced; name must begin with '/' (see shm_open)
+	// Returns false if failed, error() returns errno in this case
+	inline bool create(const std::string & name, std::size_t maxStations);
+	// Opens the board created by another process for reading
+	inline bool open(const std::string & name);
+	inline void close();
+	// Removes shared memory object; boards which are already open remain
+	// valid until closed
+	static bool remove(const std::string & name) {
+		return !shm_unlink(name.c_str());
+	}
+
+	bool isOpen() const { return (header != nullptr); }
+	bool isWriter() const { return writer; }
+	int error() const { return lastError; }
+	std::size_t capacity() const { return (header ? header->maxStations : 0); }
+	// Number of stations published so far
+	std::size_t size() const {
+		return (header ? header->stations.load(std::memory_order_acquire) : 0);
+	}
+	// Incremented every time the writer publishes a record, allows readers
+	// to check whether anything has changed since the last poll
+	std::uint64_t updates() const {
+		return (header ? header->updates.load(std::memory_order_acquire) : 0);
+	}
+
+	// Writer only; returns false if the board is not open for writing, the
+	// key is not valid or the board is full
+	inline bool publish(std::uint32_t key, const Record & record);
+	// Extracts current weather from METAR and TAF and publishes it for the
+	// station specified in the location group of METAR (or of TAF if METAR
+	// has no location)
+	inline bool publish(const metaf::ParseResult & metar,
+		const metaf::ParseResult & taf);
+
+	// Copies the latest record of the station; version is incremented every
+	// time the record of this station is published
+	// Returns false if the station was not published yet, or if the
+	// consistent copy could not be made because the writer terminated while
+	// updating this record
+	inline bool read(std::uint32_t key,
+		Record & record,
+		std::uint64_t * version = nullptr) const;
+	// Returns version of the latest record of the station without copying
+	// the record, or zero if the station was not published yet
+	inline std::uint64_t version(std::uint32_t key) const;
+	// Calls f(key, record, version) for every station on the board
+	template <typename F>
+	inline void forEach(F f) const;
+
+private:
+	static_assert(std::is_trivially_copyable_v<Record>);
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+	static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+	static const inline std::uint64_t magic = 0x4452414f42464d4dull;
+	// Incremented whenever layout of the shared memory changes
+	static const inline std::uint32_t layoutVersion = 1;
+	static const inline std::size_t cacheLineSize = 64;
+	static const inline std::size_t recordWords =
+		(sizeof(Record) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+	// Slots are at most half full to keep hash table probes short
+	static const inline std::size_t loadFactor = 2;
+	static const inline unsigned int maxReadAttempts = 1024;
+
+	struct Header {
+		// Written last by the writer, the board is not valid until the magic
+		// number is set
+		std::atomic<std::uint64_t> magic;
+		std::uint32_t layoutVersion;
+		std::uint32_t recordSize;
+		std::uint64_t maxStations;
+		std::uint64_t slotCount;	// Power of two
+		alignas(cacheLineSize) std::atomic<std::uint64_t> stations;
+		std::atomic<std::uint64_t> updates;
+	};
+	// Each slot is placed in its own cache lines, so that reading one
+	// station does not interfere with updating another
+	struct alignas(cacheLineSize) Slot {
+		// Zero if the slot is not used; set once before the first record
+		// is visible to readers
+		std::atomic<std::uint32_t> key;
+		// Odd while the writer updates the record
+		std::atomic<std::uint64_t> sequence;
+		// Record is stored as atomic words, so that the concurrent copying by
+		// writer and reader is not a data race
+		std::atomic<std::uint64_t> data[recordWords];
+	};
+
+	Header * header = nullptr;
+	Slot * slots = nullptr;
+	std::size_t mappingSize = 0;
+	bool writer = false;
+	int lastError = 0;
+
+	static std::size_t slotsOffset() {
+		return (sizeof(Header) + cacheLineSize - 1) / cacheLineSize * cacheLineSize;
+	}
+	static inline std::size_t slotCount(std::size_t maxStations);
+	inline bool map(int fd, std::size_t size, bool isWriter);
+	inline bool fail();
+	inline Slot * findSlot(std::uint32_t key) const;
+	inline Slot * addSlot(std::uint32_t key);
+	static inline bool readSlot(const Slot & slot,
+		Record & record,
+		std::uint64_t & version);
+};
+
+ObservationBoard & ObservationBoard::operator=(ObservationBoard && other) {
+	if (this == &other) return *this;
+	close();
+	header = std::exchange(other.header, nullptr);
+	slots = std::exchange(other.slots, nullptr);
+	mappingSize = std::exchange(other.mappingSize, 0);
+	writer = std::exchange(other.writer, false);
+	lastError = std::exchange(other.lastError, 0);
+	return *this;
+}
+
+bool ObservationBoard::create(const std::string & name, std::size_t maxStations) {
+	close();
+	if (!maxStations) { lastError = EINVAL; return false; }
+	const auto slotNumber = slotCount(maxStations);
+	const auto size = slotsOffset() + slotNumber * sizeof(Slot);
+	// Readers which still use the previous board keep their mapping; new
+	// object is created so that they never see partially initialised board
+	shm_unlink(name.c_str());
+	const auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) return fail();
+	if (ftruncate(fd, size)) {
+		const auto e = errno;
+		::close(fd);
+		shm_unlink(name.c_str());
+		lastError = e;
+		return false;
+	}
+	if (!map(fd, size, true)) {
+		shm_unlink(name.c_str());
+		return false;
+	}
+	// ftruncate fills the object with zeros, which is a valid initial state
+	// for the atomics, but they are still constructed formally
+	for (auto i = 0u; i < slotNumber; i++) new (&slots[i]) Slot();
+	auto h = new (header) Header();
+	h->layoutVersion = layoutVersion;
+	h->recordSize = sizeof(Record);
+	h->maxStations = maxStations;
+	h->slotCount = slotNumber;
+	h->stations.store(0, std::memory_order_relaxed);
+	h->updates.store(0, std::memory_order_relaxed);
+	h->magic.store(magic, std::memory_order_release);
+	return true;
+}
+
+bool ObservationBoard::open(const std::string & name) {
+	close();
+	const auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) return fail();
+	struct stat st;
+	if (fstat(fd, &st)) {
+		const auto e = errno;
+		::close(fd);
+		lastError = e;
+		return false;
+	}
+	const auto size = static_cast<std::size_t>(st.st_size);
+	if (size < slotsOffset()) {
+		::close(fd);
+		lastError = EPROTO;
+		return false;
+	}
+	if (!map(fd, size, false)) return false;
+	const auto isValid =
+		header->magic.load(std::memory_order_acquire) == magic &&
+		header->layoutVersion == layoutVersion &&
+		header->recordSize == sizeof(Record) &&
+		header->slotCount &&
+		size >= slotsOffset() + header->slotCount * sizeof(Slot);
+	if (!isValid) {
+		close();
+		lastError = EPROTO;
+		return false;
+	}
+	return true;
+}
+
+void ObservationBoard::close() {
+	if (header) munmap(header, mappingSize);
+	header = nullptr;
+	slots = nullptr;
+	mappingSize = 0;
+	writer = false;
+}
+
+bool ObservationBoard::publish(std::uint32_t key, const Record & record) {
+	if (!writer || !key) return false;
+	auto slot = findSlot(key);
+	const auto isNew = !slot;
+	if (isNew && !(slot = addSlot(key))) return false;
+	std::uint64_t words[recordWords] = {};
+	std::memcpy(words, &record, sizeof(Record));
+
+	const auto seq = slot->sequence.load(std::memory_order_relaxed);
+	slot->sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (auto i = 0u; i < recordWords; i++) {
+		slot->data[i].store(words[i], std::memory_order_relaxed);
+	}
+	slot->sequence.store(seq + 2, std::memory_order_release);
+
+	if (isNew) {
+		// Readers find the slot only after the first record is complete
+		slot->key.store(key, std::memory_order_release);
+		header->stations.fetch_add(1, std::memory_order_release);
+	}
+	header->updates.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+bool ObservationBoard::publish(const metaf::ParseResult & metar,
+	const metaf::ParseResult & taf)
+{
+	std::uint32_t key = 0;
+	for (const auto result : { &metar, &taf }) {
+		const auto i = result->sections.firstOf<metaf::LocationGroup>();
+		if (i == metaf::ReportSections::notFound) continue;
+		key = std::get<metaf::LocationGroup>(result->groups[i].group).key();
+		break;
+	}
+	if (!key) return false;
+	return publish(key, metaf::CurrentWeatherExtractor::extract(metar, taf));
+}
+
+bool ObservationBoard::read(std::uint32_t key,
+	Record & record,
+	std::uint64_t * version) const
+{
+	const auto slot = findSlot(key);
+	if (!slot) return false;
+	std::uint64_t v = 0;
+	if (!readSlot(*slot, record, v)) return false;
+	if (version) *version = v;
+	return true;
+}
+
+std::uint64_t ObservationBoard::version(std::uint32_t key) const {
+	const auto slot = findSlot(key);
+	if (!slot) return 0;
+	return (slot->sequence.load(std::memory_order_acquire) / 2);
+}
+
+template <typename F>
+void ObservationBoard::forEach(F f) const {
+	if (!header) return;
+	Record record;
+	for (auto i = 0u; i < header->slotCount; i++) {
+		const auto key = slots[i].key.load(std::memory_order_acquire);
+		std::uint64_t version = 0;
+		if (key && readSlot(slots[i], record, version)) {
+			f(key, static_cast<const Record &>(record), version);
+		}
+	}
+}
+
+std::size_t ObservationBoard::slotCount(std::size_t maxStations) {
+	std::size_t result = 2;
+	while (result < maxStations * loadFactor) result *= 2;
+	return result;
+}
+
+bool ObservationBoard::map(int fd, std::size_t size, bool isWriter) {
+	const auto protection = isWriter ? (PROT_READ | PROT_WRITE) : PROT_READ;
+	void * p = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+	const auto e = errno;
+	// Mapping remains valid after the descriptor is closed
+	::close(fd);
+	if (p == MAP_FAILED) {
+		lastError = e;
+		return false;
+	}
+	header = static_cast<Header *>(p);
+	slots = reinterpret_cast<Slot *>(static_cast<char *>(p) + slotsOffset());
+	mappingSize = size;
+	writer = isWriter;
+	lastError = 0;
+	return true;
+}
+
+bool ObservationBoard::fail() {
+	lastError = errno;
+	return false;
+}
+
+ObservationBoard::Slot * ObservationBoard::findSlot(std::uint32_t key) const {
+	if (!header || !key) return nullptr;
+	const auto mask = header->slotCount - 1;
+	// Fibonacci hashing, ICAO keys of nearby stations differ in low bytes
+	auto i = (key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+	for (auto probes = 0u; probes <= mask; probes++, i = (i + 1) & mask) {
+		const auto k = slots[i].key.load(std::memory_order_acquire);
+		if (k == key) return &slots[i];
+		if (!k) return nullptr;
+	}
+	return nullptr;
+}
+
+ObservationBoard::Slot * ObservationBoard::addSlot(std::uint32_t key) {
+	if (header->stations.load(std::memory_order_relaxed) >= header->maxStations) {
+		return nullptr;
+	}
+	const auto mask = header->slotCount - 1;
+	auto i = (key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+	while (slots[i].key.load(std::memory_order_relaxed)) i = (i + 1) & mask;
+	return &slots[i];
+}
+
+bool ObservationBoard::readSlot(const Slot & slot,
+	Record & record,
+	std::uint64_t & version)
+{
+	std::uint64_t words[recordWords];
+	for (auto attempt = 0u; attempt < maxReadAttempts; attempt++) {
+		const auto seq = slot.sequence.load(std::memory_order_acquire);
+		if (seq & 1) {
+			// Writer was preempted in the middle of update
+			if (attempt > maxReadAttempts / 2) std::this_thread::yield();
+			continue;
+		}
+		for (auto i = 0u; i < recordWords; i++) {
+			words[i] = slot.data[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != seq) continue;
+		if (!seq) return false;
+		std::memcpy(&record, words, sizeof(Record));
+		version = seq / 2;
+		return true;
+	}
+	return false;
+}
+
+#endif //#ifndef OBSERVATIONBOARD_HPP
@@ -0,0 +1,341 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Multi-threaded ingest pipeline: read and split text into reports, parse
+// the reports, and pass the results to the sink, each stage running in its
+// own thread(s)
+//
+// Stages are connected by bounded lock-free single-producer single-consumer
+// queues: source thread dispatches reports to the parser threads in
+// round-robin order and sink thread collects the results in the same order,
+// so that the sink receives the reports in the order they were read
+// Reports and parse results are stored in the pre-allocated items which are
+// returned by sink to the source via free list; when all items are in use,
+// the source waits for the sink (backpressure)
+
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "metaf.hpp"
+#include <atomic>
+#include <cctype>
+#include <thread>
+#include <vector>
+#include <string>
+#include <memory>
+
+// Bounded lock-free queue for one producer thread and one consumer thread
+template <typename T>
+class SpscQueue {
+public:
+	// Capacity is rounded up to the power of two
+	explicit SpscQueue(std::size_t capacity) :
+		buffer(roundCapacity(capacity)), mask(buffer.size() - 1) {}
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue & operator=(const SpscQueue &) = delete;
+
+	// Called by producer thread only; returns false if the queue is full
+	bool push(T value) {
+		const auto t = tail.load(std::memory_order_relaxed);
+		if (t - headCache > mask) {
+			headCache = head.load(std::memory_order_acquire);
+			if (t - headCache > mask) return false;
+		}
+		buffer[t & mask] = std::move(value);
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+	// Called by consumer thread only; returns false if the queue is empty
+	bool pop(T & value) {
+		const auto h = head.load(std::memory_order_relaxed);
+		if (h == tailCache) {
+			tailCache = tail.load(std::memory_order_acquire);
+			if (h == tailCache) return false;
+		}
+		value = std::move(buffer[h & mask]);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+	// Approximate number of the items in the queue, may be called from any
+	// thread
+	std::size_t size() const {
+		const auto h = head.load(std::memory_order_relaxed);
+		const auto t = tail.load(std::memory_order_relaxed);
+		return (t > h ? t - h : 0);
+	}
+	std::size_t capacity() const { return buffer.size(); }
+
+private:
+	static const inline std::size_t cacheLineSize = 64;
+	std::vector<T> buffer;
+	const std::size_t mask;
+	// Producer's and consumer's data are placed in different cache lines
+	alignas(cacheLineSize) std::atomic<std::size_t> tail {0};
+	std::size_t headCache = 0;
+	alignas(cacheLineSize) std::atomic<std::size_t> head {0};
+	std::size_t tailCache = 0;
+
+	static std::size_t roundCapacity(std::size_t capacity) {
+		std::size_t result = 1;
+		while (result < capacity) result *= 2;
+		return result;
+	}
+};
+
+class IngestPipeline {
+public:
+	enum class Delimiter {
+		LINE,		// Each line is a separate report
+		EMPTY_LINE	// Reports may span multiple lines, separated by empty line
+	};
+	struct Options {
+		// Number of parser threads, or zero to use all hardware threads which
+		// are not used by the source and the sink
+		unsigned int parsers = 0;
+		// Capacity of queue between the source and each parser thread, and
+		// between each parser thread and the sink
+		std::size_t queueSize = 256;
+		// Besides delimiter, report end character (=) always ends the report
+		Delimiter delimiter = Delimiter::EMPTY_LINE;
+		std::size_t readBufferSize = 64 * 1024;
+	};
+	// Counters are updated while the pipeline is running and may be read
+	// from any thread
+	struct Stats {
+		std::uint64_t bytesRead = 0;
+		std::uint64_t reportsRead = 0;
+		std::uint64_t reportsParsed = 0;
+		std::uint64_t reportsWritten = 0;
+		// Number of times the source waited for free item or for space in
+		// the parser queue (i.e. parsers or sink are the bottleneck)
+		std::uint64_t sourceStalls = 0;
+		// Number of times the sink waited for the next parsed report (i.e.
+		// source or parsers are the bottleneck)
+		std::uint64_t sinkStalls = 0;
+		// Current number of reports waiting to be parsed, and parsed reports
+		// waiting for the sink, all parsers combined
+		std::size_t parseQueueDepth = 0;
+		std::size_t sinkQueueDepth = 0;
+	};
+
+	inline IngestPipeline();
+	explicit inline IngestPipeline(const Options & o);
+
+	// Source is a function object with signature
+	//   std::size_t(char * buffer, std::size_t size)
+	// which reads at most size bytes into buffer and returns the number of
+	// bytes read, or zero when there is no more data
+	// Sink is a function object with signature
+	//   void(const std::string & report, const metaf::ParseResult & result)
+	// Source is called from a separate thread, sink is called from the
+	// thread which called run(); neither of them may throw
+	// Returns after all reports were passed to the sink; must not be called
+	// from more than one thread at the same time
+	template <typename Source, typename Sink>
+	inline void run(Source source, Sink sink);
+
+	inline Stats stats() const;
+	unsigned int parsers() const { return parserStages.size(); }
+
+private:
+	struct Item {
+		std::string report;
+		metaf::ParseResult parseResult;
+	};
+	// Counter updated by a single thread and read by any thread
+	class Counter {
+	public:
+		void increment() {
+			value.store(value.load(std::memory_order_relaxed) + 1,
+				std::memory_order_relaxed);
+		}
+		void add(std::uint64_t n) {
+			value.store(value.load(std::memory_order_relaxed) + n,
+				std::memory_order_relaxed);
+		}
+		std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+		void reset() { value.store(0, std::memory_order_relaxed); }
+	private:
+		std::atomic<std::uint64_t> value {0};
+	};
+	struct ParserStage {
+		ParserStage(std::size_t queueSize) : input(queueSize), output(queueSize) {}
+		SpscQueue<Item *> input;
+		SpscQueue<Item *> output;
+		Counter parsed;
+	};
+
+	Options options;
+	std::vector<std::unique_ptr<ParserStage>> parserStages;
+	std::vector<Item> items;
+	std::unique_ptr<SpscQueue<Item *>> freeItems;
+	Counter bytesRead, reportsRead, reportsWritten, sourceStalls, sinkStalls;
+
+	static inline unsigned int parserCount(unsigned int parsers);
+	template <typename Source>
+	inline void runSource(Source & source);
+	inline void runParser(ParserStage & parser);
+	template <typename T>
+	static inline void push(SpscQueue<T> & queue, T value, Counter * stalls);
+	template <typename T>
+	static inline T pop(SpscQueue<T> & queue, Counter * stalls);
+	static inline void wait(unsigned int & attempt);
+};
+
+IngestPipeline::IngestPipeline() : IngestPipeline(Options()) {}
+
+IngestPipeline::IngestPipeline(const Options & o) : options(o) {
+	const auto parserThreads = parserCount(options.parsers);
+	const auto queueSize = std::max(options.queueSize, std::size_t(1));
+	for (auto i = 0u; i < parserThreads; i++) {
+		parserStages.push_back(std::make_unique<ParserStage>(queueSize));
+	}
+	// Each queue between source and parser may be full, as well as each
+	// queue between parser and sink, plus the item being filled by source
+	// All items are returned to the free list when run() finishes
+	items.resize(2 * parserStages.front()->input.capacity() * parserThreads + 1);
+	freeItems = std::make_unique<SpscQueue<Item *>>(items.size());
+	for (auto & item : items) freeItems->push(&item);
+}
+
+template <typename Source, typename Sink>
+void IngestPipeline::run(Source source, Sink sink) {
+	for (auto c : { &bytesRead, &reportsRead, &reportsWritten, &sourceStalls, &sinkStalls }) {
+		c->reset();
+	}
+	for (auto & p : parserStages) p->parsed.reset();
+
+	std::vector<std::thread> threads;
+	for (auto & p : parserStages) threads.emplace_back([this, &p](){ runParser(*p); });
+	threads.emplace_back([this, &source](){ runSource(source); });
+
+	// Results are collected in the same round-robin order as dispatched by
+	// source; null item marks the end of data
+	for (std::size_t i = 0; ; i = (i + 1) % parserStages.size()) {
+		Item * item = pop(parserStages[i]->output, &sinkStalls);
+		if (!item) break;
+		sink(static_cast<const std::string &>(item->report),
+			static_cast<const metaf::ParseResult &>(item->parseResult));
+		reportsWritten.increment();
+		push(*freeItems, item, nullptr);
+	}
+	for (auto & t : threads) t.join();
+	// Remove end-of-data marks of the other parsers, so that the queues are
+	// empty for the next run
+	Item * item;
+	for (auto & p : parserStages) p->output.pop(item);
+}
+
+template <typename Source>
+void IngestPipeline::runSource(Source & source) {
+	std::vector<char> buffer(std::max(options.readBufferSize, std::size_t(1)));
+	std::size_t nextParser = 0;
+	Item * item = nullptr;
+	bool isLineEmpty = true;
+	auto finishReport = [&]() {
+		if (!item) return;
+		while (!item->report.empty() &&
+			std::isspace(static_cast<unsigned char>(item->report.back())))
+		{
+			item->report.pop_back();
+		}
+		push(parserStages[nextParser]->input, item, &sourceStalls);
+		nextParser = (nextParser + 1) % parserStages.size();
+		reportsRead.increment();
+		item = nullptr;
+	};
+	while (const auto size = source(buffer.data(), buffer.size())) {
+		bytesRead.add(size);
+		for (auto i = 0u; i < size; i++) {
+			const auto c = buffer[i];
+			if (c == '\n') {
+				if (options.delimiter == Delimiter::LINE || isLineEmpty) {
+					finishReport();
+				}
+				isLineEmpty = true;
+				if (item) item->report.push_back(c);
+				continue;
+			}
+			if (std::isspace(static_cast<unsigned char>(c))) {
+				if (item) item->report.push_back(c);
+				continue;
+			}
+			isLineEmpty = false;
+			if (!item) {
+				item = pop(*freeItems, &sourceStalls);
+				item->report.clear();
+			}
+			item->report.push_back(c);
+			if (c == '=') finishReport();
+		}
+	}
+	finishReport();
+	for (auto & p : parserStages) push(p->input, static_cast<Item *>(nullptr), nullptr);
+}
+
+void IngestPipeline::runParser(ParserStage & parser) {
+	auto & cache = metaf::GroupCache::threadCache();
+	while (true) {
+		Item * item = pop(parser.input, nullptr);
+		if (item) {
+			metaf::Parser::parse(item->report, item->parseResult, cache);
+			parser.parsed.increment();
+		}
+		push(parser.output, item, nullptr);
+		if (!item) return;
+	}
+}
+
+unsigned int IngestPipeline::parserCount(unsigned int parsers) {
+	if (parsers) return parsers;
+	static const unsigned int otherThreads = 2; // Source and sink
+	const auto threads = std::thread::hardware_concurrency();
+	return (threads > otherThreads + 1 ? threads - otherThreads : 1);
+}
+
+IngestPipeline::Stats IngestPipeline::stats() const {
+	Stats result;
+	result.bytesRead = bytesRead.get();
+	result.reportsRead = reportsRead.get();
+	result.reportsWritten = reportsWritten.get();
+	result.sourceStalls = sourceStalls.get();
+	result.sinkStalls = sinkStalls.get();
+	for (const auto & p : parserStages) {
+		result.reportsParsed += p->parsed.get();
+		result.parseQueueDepth += p->input.size();
+		result.sinkQueueDepth += p->output.size();
+	}
+	return result;
+}
+
+template <typename T>
+void IngestPipeline::push(SpscQueue<T> & queue, T value, Counter * stalls) {
+	if (queue.push(value)) return;
+	if (stalls) stalls->increment();
+	unsigned int attempt = 0;
+	while (!queue.push(value)) wait(attempt);
+}
+
+template <typename T>
+T IngestPipeline::pop(SpscQueue<T> & queue, Counter * stalls) {
+	T result;
+	if (queue.pop(result)) return result;
+	if (stalls) stalls->increment();
+	unsigned int attempt = 0;
+	while (!queue.pop(result)) wait(attempt);
+	return result;
+}
+
+void IngestPipeline::wait(unsigned int & attempt) {
+	// Spin briefly before yielding, since the other stage is normally
+	// only a few microseconds away
+	static const unsigned int spinAttempts = 64;
+	if (attempt++ < spinAttempts) return;
+	std::this_thread::yield();
+}
+
+#endif //#ifndef PIPELINE_HPP
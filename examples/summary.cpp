@@ -130,8 +130,6 @@ struct CurrentWeather {
 	int updateMinute = valueNotSpecified;
 };
 
-using GroupVector = std::vector<metaf::GroupInfo>;
-
 metaf::Temperature::Unit temperatureUnit(bool isImperialUnit) {
 	return (isImperialUnit ? metaf::Temperature::Unit::F : metaf::Temperature::Unit::C);
 }
@@ -454,22 +452,26 @@ std::vector<int> weatherFromWeatherPhenomena(
 	return result;
 }
 
-GroupVector parseReport(const std::string & report, metaf::ReportType type) {
+metaf::ParseResult parseReport(const std::string & report, metaf::ReportType type) {
 	auto parsed = metaf::Parser::parse(report);
 	if (parsed.reportMetadata.type != type || 
-		parsed.reportMetadata.error != metaf::ReportError::NONE) return GroupVector();
-	return std::move(parsed.groups);
+		parsed.reportMetadata.error != metaf::ReportError::NONE) return metaf::ParseResult();
+	return parsed;
 }
 
-CurrentWeather currentWeatherFromMetar(const GroupVector & metarGroups, bool isImperialUnit) {
+CurrentWeather currentWeatherFromMetar(const metaf::ParseResult & metar, bool isImperialUnit) {
 	CurrentWeather result;
 	const auto visUnit = visibilityUnit(isImperialUnit);
 	const auto presUnit = pressureUnit(isImperialUnit);
 	const auto tempUnit = temperatureUnit(isImperialUnit);
 	const auto spdUnit = speedUnit(isImperialUnit);
 	metaf::Speed windSpeed;
-	for (const auto & metarGroupInfo : metarGroups) {
-		const auto & metarGroup = metarGroupInfo.group;
+	// This version ignores trends; remarks (e.g. precise temperature in T-group)
+	// are used only if the report has no trends
+	const auto end = std::min(metar.sections.firstOf<metaf::TrendGroup>(),
+		metar.groups.size());
+	for (auto i = metar.sections.body.begin; i < end; i++) {
+		const auto & metarGroup = metar.groups[i].group;
 		if (const auto gr = std::get_if<metaf::FixedGroup>(&metarGroup); gr) {
 			if (gr->type() == metaf::FixedGroup::Type::CAVOK) {
 				const auto v = metaf::Distance::cavokVisibility().toUnit(visUnit); 
@@ -477,10 +479,6 @@ CurrentWeather currentWeatherFromMetar(const GroupVector & metarGroups, bool isI
 				result.cloud = Cloud::MOSTLY_CLEAR;
 			}
 		}
-		
-		if (const auto gr = std::get_if<metaf::TrendGroup>(&metarGroup); gr) {
-			break; //this version ignores trends
-		}
 
 		if (const auto gr = std::get_if<metaf::WindGroup>(&metarGroup); gr) {
 			if (gr->type() == metaf::WindGroup::Type::SURFACE_WIND ||
@@ -572,14 +570,15 @@ CurrentWeather currentWeatherFromMetar(const GroupVector & metarGroups, bool isI
 	return result;
 }
 
-CurrentWeather currentWeatherFromTaf(const GroupVector & tafGroups, bool isImperialUnit) {
+CurrentWeather currentWeatherFromTaf(const metaf::ParseResult & taf, bool isImperialUnit) {
 	CurrentWeather result;
 	const auto visUnit = visibilityUnit(isImperialUnit);
 	const auto spdUnit = speedUnit(isImperialUnit);
 	metaf::Speed windSpeed;
-	int trendCounter = 0;
-	for (const auto & tafGroupInfo : tafGroups) {
-		const auto & tafGroup = tafGroupInfo.group;
+	// Consider only prevailing conditions (i.e. before the first trend)
+	const auto & body = taf.sections.body;
+	for (auto i = body.begin; i < body.end; i++) {
+		const auto & tafGroup = taf.groups[i].group;
 		if (const auto gr = std::get_if<metaf::FixedGroup>(&tafGroup); gr) {
 			if (gr->type() == metaf::FixedGroup::Type::CAVOK) {
 				const auto v = metaf::Distance::cavokVisibility().toUnit(visUnit); 
@@ -587,10 +586,6 @@ CurrentWeather currentWeatherFromTaf(const GroupVector & tafGroups, bool isImper
 				result.cloud = Cloud::MOSTLY_CLEAR;
 			}
 		}
-		if (const auto gr = std::get_if<metaf::TrendGroup>(&tafGroup); gr) {
-			trendCounter++;
-			if (trendCounter > 1) break; //consider only prevailing trend (i.e. first trend)
-		}
 		if (const auto gr = std::get_if<metaf::WindGroup>(&tafGroup); gr) {
 			if (const auto dir = gr->direction().degrees(); dir.has_value()) {
 				result.windDirection = dir.value();
@@ -636,12 +631,12 @@ CurrentWeather currentWeatherFromTaf(const GroupVector & tafGroups, bool isImper
 
 void temperatureForecastFromTaf(
 	CurrentWeather & currentWeather,
-	const GroupVector & tafGroups, 
+	const metaf::ParseResult & taf, 
 	bool isImperialUnit)
 {
 	const auto tempUnit = temperatureUnit(isImperialUnit);
 	metaf::Temperature minTemp, maxTemp;
-	for (const auto & tafGroupInfo : tafGroups) {
+	for (const auto & tafGroupInfo : taf.groups) {
 		const auto & tafGroup = tafGroupInfo.group;
 		if (const auto gr = std::get_if<metaf::TemperatureForecastGroup>(&tafGroup); gr) {
 			switch(gr->point()) {
@@ -667,24 +662,27 @@ void temperatureForecastFromTaf(
 }
 
 void reportReleaseTime(CurrentWeather & currentWeather, 
-	const GroupVector & groups,
+	const metaf::ParseResult & report,
 	int year, 
 	int month, 
 	int day)
 {
-	for (const auto & groupInfo : groups) {
-		const auto & group = groupInfo.group;
-		if (const auto gr = std::get_if<metaf::ReportTimeGroup>(&group); gr) {
-			const auto currDate = metaf::MetafTime::Date(year, month, day);
-			const auto reportTime = gr->time();
-			const auto reportDate = reportTime.dateBeforeRef(currDate);
-			currentWeather.updateYear = reportDate.year;
-			currentWeather.updateMonth = reportDate.month;
-			currentWeather.updateDay = reportDate.day;
-			currentWeather.updateHour = reportTime.hour();
-			currentWeather.updateMinute = reportTime.minute();	
-		}
+	const auto first = report.sections.firstOf<metaf::ReportTimeGroup>();
+	if (first == metaf::ReportSections::notFound) return;
+	// If report time is specified more than once, the last one is used
+	auto index = first;
+	for (auto i = first + 1; i < report.groups.size(); i++) {
+		if (std::holds_alternative<metaf::ReportTimeGroup>(report.groups[i].group)) index = i;
 	}
+	const auto & gr = std::get<metaf::ReportTimeGroup>(report.groups[index].group);
+	const auto currDate = metaf::MetafTime::Date(year, month, day);
+	const auto reportTime = gr.time();
+	const auto reportDate = reportTime.dateBeforeRef(currDate);
+	currentWeather.updateYear = reportDate.year;
+	currentWeather.updateMonth = reportDate.month;
+	currentWeather.updateDay = reportDate.day;
+	currentWeather.updateHour = reportTime.hour();
+	currentWeather.updateMinute = reportTime.minute();	
 }
 
 CurrentWeather getCurrentWeather(
@@ -696,16 +694,16 @@ CurrentWeather getCurrentWeather(
 	bool isImperialUnit)
 {
 	CurrentWeather result;
-	const auto metarGroups = parseReport(metar, metaf::ReportType::METAR);
-	const auto tafGroups = parseReport(taf, metaf::ReportType::TAF);
-	if (!metarGroups.empty()) {
-		result = currentWeatherFromMetar(metarGroups, isImperialUnit);
-		reportReleaseTime(result, metarGroups, currYear, currMonth, currDay);
+	const auto metarResult = parseReport(metar, metaf::ReportType::METAR);
+	const auto tafResult = parseReport(taf, metaf::ReportType::TAF);
+	if (!metarResult.groups.empty()) {
+		result = currentWeatherFromMetar(metarResult, isImperialUnit);
+		reportReleaseTime(result, metarResult, currYear, currMonth, currDay);
 	} else {
-		result = currentWeatherFromTaf(tafGroups, isImperialUnit);
-		reportReleaseTime(result, tafGroups, currYear, currMonth, currDay);
+		result = currentWeatherFromTaf(tafResult, isImperialUnit);
+		reportReleaseTime(result, tafResult, currYear, currMonth, currDay);
 	}
-	temperatureForecastFromTaf(result, tafGroups, isImperialUnit);
+	temperatureForecastFromTaf(result, tafResult, isImperialUnit);
 
 	return result;
 }
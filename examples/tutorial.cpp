@@ -71,6 +71,15 @@ std::string errorMessage(ReportError error) {
 
 		case ReportError::REPORT_TOO_LARGE:
 		return "Report has too many groups and may be corrupted";
+
+		case ReportError::GROUP_TOO_LONG:
+		return "Group is too long";
+
+		case ReportError::REPORT_TOO_LONG:
+		return "Report is too long";
+
+		case ReportError::WORK_LIMIT_EXCEEDED:
+		return "Report requires too much processing";
 	}
 }
 
@@ -0,0 +1,178 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Pool of worker threads used by the examples to process batches of reports
+// in parallel
+//
+// The threads are started on first use and kept alive between batches, so
+// that thread creation is not paid for every batch and the thread-local data
+// of the workers (e.g. metaf::GroupCache::threadCache()) is re-used by the
+// next batches
+//
+// If threads are not available (WebAssembly built without pthreads), the
+// batch is processed by the calling thread
+
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <exception>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+	#define WORKERPOOL_THREADS
+	#include <thread>
+	#include <mutex>
+	#include <condition_variable>
+#endif
+
+class WorkerPool {
+public:
+	WorkerPool() = default;
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool & operator=(const WorkerPool &) = delete;
+	inline ~WorkerPool();
+
+	// Pool shared by all batch functions of the examples
+	static inline WorkerPool & shared();
+
+	// Splits range [0, size) into at most the specified number of contiguous
+	// ranges and calls f(begin, end) for each of them; one range is processed
+	// by the calling thread and the others by the workers
+	// Returns when all ranges are processed; if f throws, the first exception
+	// is re-thrown after all ranges are processed
+	// If threads is zero, the number of hardware threads is used
+	// Batches passed from different threads are processed one after another;
+	// f must not call run() of the same pool
+	template <typename F>
+	inline void run(std::size_t size, unsigned int threads, F && f);
+
+	// Number of worker threads started so far
+	inline std::size_t workers() const;
+
+private:
+#ifdef WORKERPOOL_THREADS
+	std::mutex batchMutex;			// Held by the caller for the entire batch
+	mutable std::mutex mutex;		// Protects the batch state below
+	std::condition_variable wake;	// Notifies the workers of a new batch
+	std::condition_variable done;	// Notifies the caller that batch is done
+	std::vector<std::thread> threadList;
+	bool stopping = false;
+	unsigned int generation = 0;	// Incremented for every batch
+
+	std::function<void(std::size_t, std::size_t)> task;
+	std::size_t taskSize = 0;
+	std::size_t rangeSize = 0;
+	std::size_t ranges = 0;
+	std::size_t nextRange = 0;
+	std::size_t pending = 0;		// Ranges which are not finished yet
+	std::exception_ptr error;
+
+	inline void work();
+	inline void processRanges(std::unique_lock<std::mutex> & lock);
+#endif
+};
+
+WorkerPool::~WorkerPool() {
+#ifdef WORKERPOOL_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto & t : threadList) t.join();
+#endif
+}
+
+WorkerPool & WorkerPool::shared() {
+	static WorkerPool pool;
+	return pool;
+}
+
+template <typename F>
+void WorkerPool::run(std::size_t size, unsigned int threads, F && f) {
+#ifdef WORKERPOOL_THREADS
+	if (!threads) threads = std::max(std::thread::hardware_concurrency(), 1u);
+	threads = static_cast<unsigned int>(
+		std::min(static_cast<std::size_t>(threads), size));
+	if (threads <= 1) {
+		f(0, size);
+		return;
+	}
+	std::lock_guard<std::mutex> batchLock(batchMutex);
+	std::unique_lock<std::mutex> lock(mutex);
+	while (threadList.size() < threads - 1) {
+		threadList.emplace_back([this](){ work(); });
+	}
+	task = [&f](std::size_t begin, std::size_t end) { f(begin, end); };
+	taskSize = size;
+	rangeSize = (size + threads - 1) / threads;
+	ranges = (size + rangeSize - 1) / rangeSize;
+	nextRange = 0;
+	pending = ranges;
+	error = nullptr;
+	generation++;
+	wake.notify_all();
+	processRanges(lock);
+	done.wait(lock, [this](){ return !pending; });
+	task = nullptr;
+	const auto e = error;
+	error = nullptr;
+	lock.unlock();
+	if (e) std::rethrow_exception(e);
+#else
+	(void)threads;
+	f(0, size);
+#endif
+}
+
+std::size_t WorkerPool::workers() const {
+#ifdef WORKERPOOL_THREADS
+	std::lock_guard<std::mutex> lock(mutex);
+	return threadList.size();
+#else
+	return 0;
+#endif
+}
+
+#ifdef WORKERPOOL_THREADS
+
+void WorkerPool::work() {
+	unsigned int processed = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [&](){ return stopping || generation != processed; });
+		if (stopping) return;
+		processed = generation;
+		processRanges(lock);
+	}
+}
+
+void WorkerPool::processRanges(std::unique_lock<std::mutex> & lock) {
+	// Ranges are taken one by one, so that the workers which woke up late
+	// (or not at all) do not delay the batch
+	while (nextRange < ranges) {
+		const auto begin = nextRange++ * rangeSize;
+		const auto end = std::min(begin + rangeSize, taskSize);
+		lock.unlock();
+		std::exception_ptr e;
+		try {
+			task(begin, end);
+		} catch (...) {
+			e = std::current_exception();
+		}
+		lock.lock();
+		if (e && !error) error = e;
+		if (!--pending) done.notify_all();
+	}
+}
+
+#endif
+
+#endif //#ifndef WORKERPOOL_HPP
@@ -16,14 +16,47 @@
 	#pragma GCC diagnostic ignored "-Wunused-but-set-parameter"
 	// GCC gives numerous false positives in switch/return methods
 	#pragma GCC diagnostic ignored "-Wreturn-type"
+	// GCC gives false positives in the optionals returned by the parse methods
+	// of GroupParser alternatives when the parse dispatch table is inlined
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
 #endif
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 #include <optional>
-#include <regex>
 #include <cmath>
+#include <cstring>
+#include <cctype>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <list>
+#include <unordered_map>
+
+#if defined(METAF_PARSE_STATS) || defined(METAF_PARSE_TRACE)
+	#include <atomic>
+	#include <chrono>
+#endif
+
+// Separate compilation: if METAF_SEPARATE_COMPILATION is defined for all
+// translation units, the non-template functions which are not defined in
+// the class declarations are only compiled in the translation unit which
+// also defines METAF_IMPLEMENTATION (see src/metaf.cpp); the templates and
+// the functions defined in the class declarations remain inline
+#ifdef METAF_SEPARATE_COMPILATION
+	#define METAF_INLINE
+	#ifdef METAF_IMPLEMENTATION
+		#define METAF_DEFINITIONS
+	#endif
+#else
+	#define METAF_INLINE inline
+	#define METAF_DEFINITIONS
+#endif
 
 namespace metaf {
 
@@ -95,6 +128,158 @@ using Group = std::variant<
 
 ///////////////////////////////////////////////////////////////////////////
 
+// Groups of the string matched by Regex; group 0 is the entire match, and
+// groups 1 and above are the capture groups in the order of their opening
+// parenthesis in the pattern; no heap allocation is performed
+// Similar to std::smatch, the matched string must outlive RegexMatch
+class RegexMatch {
+public:
+	static const inline std::size_t maxGroups = 10;
+	// Positions are stored as 16-bit values; longer strings never match
+	static const inline std::size_t maxLength = 
+		std::numeric_limits<std::uint16_t>::max() - 1;
+	std::size_t size() const { return groups; }
+	bool matched(std::size_t n) const {
+		return (n < groups && pos[2 * n] != none && pos[2 * n + 1] != none);
+	}
+	std::size_t position(std::size_t n) const {
+		return (matched(n) ? pos[2 * n] : 0);
+	}
+	std::size_t length(std::size_t n) const {
+		return (matched(n) ? pos[2 * n + 1] - pos[2 * n] : 0);
+	}
+	std::string str(std::size_t n) const {
+		if (!matched(n) || !source) return std::string();
+		return source->substr(position(n), length(n));
+	}
+
+private:
+	template <std::size_t N, std::size_t Size> friend class Regex;
+	using Position = std::uint16_t;
+	static const inline Position none = std::numeric_limits<Position>::max();
+	const std::string * source = nullptr;
+	std::size_t groups = 0;
+	std::array<Position, 2 * maxGroups> pos;
+};
+
+// Regular expression compiled at compile time into a program of a
+// non-deterministic automaton, which is matched without heap allocations
+// and in time linear to the length of the string (no backtracking); search
+// tries all start positions in the same single pass over the string
+// Strings longer than RegexMatch::maxLength never match
+// Supported syntax is a subset of ECMAScript regex: literal chars, ., classes
+// such as [A-Z0-9] and [^/], escapes \d \D \w \W \s \S and escaped special
+// chars, groups (...) and (?:...), alternation |, greedy and lazy (suffix ?)
+// quantifiers ?, *, +, {n}, {n,} and {n,m}; anchors are not supported
+// Captures are same as in ECMAScript except the captures inside repeated
+// group, which keep the value from the last iteration where they matched
+// Malformed pattern results in compile error if Regex is constexpr
+template <std::size_t N, std::size_t Size = 4 * N + 8>
+class Regex {
+public:
+	constexpr Regex(const char (&pattern)[N]);
+	// Entire string must match the pattern (similar to std::regex_match)
+	inline bool match(const std::string & s) const;
+	inline bool match(const std::string & s, RegexMatch & result) const;
+	bool match(const std::string && s, RegexMatch & result) const = delete;
+	// Finds leftmost match beginning at or after index 'from' (similar to
+	// std::regex_search)
+	inline bool search(const std::string & s,
+		std::size_t from,
+		RegexMatch & result) const;
+	bool search(const std::string && s,
+		std::size_t from,
+		RegexMatch & result) const = delete;
+	constexpr std::size_t groups() const { return captureGroups; }
+	constexpr bool isValid() const { return valid; }
+	constexpr const char * pattern() const { return source.data(); }
+
+private:
+	enum class Op : std::uint8_t {
+		CHAR,	// Char equal to x
+		CLASS,	// Char within class with index x
+		ANY,	// Any char
+		SPLIT,	// Continue at x, or at y with lower priority
+		JMP,	// Continue at x
+		SAVE,	// Save position to capture slot x
+		MATCH	// Pattern matched
+	};
+	struct Instruction {
+		Op op = Op::MATCH;
+		std::uint16_t x = 0;
+		std::uint16_t y = 0;
+	};
+	struct CharClass {
+		std::uint16_t firstRange = 0;
+		std::uint16_t ranges = 0;
+		bool negated = false;
+	};
+	struct Range {
+		unsigned char from = 0;
+		unsigned char to = 0;
+	};
+	static const inline std::size_t length = N - 1;
+	static const inline std::size_t infinite = std::numeric_limits<std::size_t>::max();
+	static const inline std::size_t maxSlots = 2 * RegexMatch::maxGroups;
+
+	std::array<char, N> source {};
+	std::array<Instruction, Size> program {};
+	std::array<CharClass, N> classes {};
+	std::array<Range, 4 * N> ranges {};
+	std::size_t programSize = 0;
+	std::size_t classesSize = 0;
+	std::size_t rangesSize = 0;
+	std::size_t captureGroups = 1;
+	bool valid = true;
+
+	constexpr void error();
+	constexpr std::size_t emit(Op op, std::size_t x = 0, std::size_t y = 0);
+	constexpr void insert(std::size_t position, Op op);
+	constexpr void copy(std::size_t from, std::size_t to);
+	constexpr void setSplit(std::size_t index,
+		std::size_t preferred,
+		std::size_t other,
+		bool lazy);
+	constexpr void addRange(unsigned char from, unsigned char to);
+	constexpr bool addEscapeRanges(char c);
+	constexpr void alternation(const char (&pattern)[N], std::size_t & i);
+	constexpr void concatenation(const char (&pattern)[N], std::size_t & i);
+	constexpr void repetition(const char (&pattern)[N], std::size_t & i);
+	constexpr void atom(const char (&pattern)[N], std::size_t & i);
+	constexpr void charClass(const char (&pattern)[N], std::size_t & i);
+	constexpr void quantify(std::size_t start,
+		std::size_t min,
+		std::size_t max,
+		bool lazy);
+
+	using Slots = std::array<RegexMatch::Position, maxSlots>;
+	struct Thread {
+		std::uint16_t pc;
+		Slots slots;
+	};
+	struct ThreadList {
+		std::array<Thread, Size> threads;
+		std::size_t size = 0;
+	};
+	inline bool matchesChar(const Instruction & instruction, unsigned char c) const;
+	inline void addThread(ThreadList & list,
+		std::array<std::size_t, Size> & visited,
+		std::size_t pc,
+		Slots & slots,
+		std::size_t slotCount,
+		std::size_t pos) const;
+	inline bool run(const std::string & s,
+		std::size_t start,
+		bool entire,
+		RegexMatch * result) const;
+};
+
+// Called when Regex pattern is malformed; not constexpr so that malformed
+// pattern in a constexpr Regex causes compile error
+inline void regexPatternError() {}
+
+///////////////////////////////////////////////////////////////////////////
+
 class Runway {
 public:
 	enum class Designator {
@@ -118,7 +303,7 @@ public:
 	}
 
 	Runway() = default;
-	static inline std::optional<Runway> fromString(const std::string & s, bool enableRwy = false);
+	static METAF_INLINE std::optional<Runway> fromString(const std::string & s, bool enableRwy = false);
 	static Runway makeAllRunways() {
 		Runway rw;
 		rw.rNumber = allRunwaysNumber;
@@ -126,7 +311,7 @@ public:
 	}
 
 private:
-	static inline std::optional<Designator> designatorFromChar(char c);
+	static METAF_INLINE std::optional<Designator> designatorFromChar(char c);
 
 	unsigned int rNumber = 0;
 	Designator rDesignator = Designator::NONE;
@@ -147,16 +332,16 @@ public:
 	std::optional<unsigned int> day() const { return dayValue; }
 	unsigned int hour() const { return hourValue; }
 	unsigned int minute() const { return minuteValue; }
-	inline bool isValid() const;
-	inline bool is3hourlyReportTime() const;
-	inline bool is6hourlyReportTime() const;
-	inline Date dateBeforeRef(const Date & refDate) const;
+	METAF_INLINE bool isValid() const;
+	METAF_INLINE bool is3hourlyReportTime() const;
+	METAF_INLINE bool is6hourlyReportTime() const;
+	METAF_INLINE Date dateBeforeRef(const Date & refDate) const;
 
 	MetafTime() = default;
 	MetafTime(unsigned int hour, unsigned int minute) :
 		hourValue(hour), minuteValue(minute) {}
-	static inline std::optional<MetafTime> fromStringDDHHMM(const std::string & s);
-	static inline std::optional<MetafTime> fromStringDDHH(const std::string & s);
+	static METAF_INLINE std::optional<MetafTime> fromStringDDHHMM(const std::string & s);
+	static METAF_INLINE std::optional<MetafTime> fromStringDDHH(const std::string & s);
 
 private:
 	std::optional<unsigned int> dayValue;
@@ -184,25 +369,25 @@ public:
 			tempValue.value());
 	}
 	Unit unit() const { return tempUnit; }
-	std::optional<float> inline toUnit(Unit unit) const;
+	std::optional<float> METAF_INLINE toUnit(Unit unit) const;
 	bool isFreezing() const { return freezing; }
 	bool isPrecise() const { return precise; }
 	bool isReported() const { return tempValue.has_value(); }
-	inline static std::optional<float> relativeHumidity(
+	METAF_INLINE static std::optional<float> relativeHumidity(
 		const Temperature & airTemperature,
 		const Temperature & dewPoint);
-	inline static Temperature heatIndex(const Temperature & airTemperature,
+	METAF_INLINE static Temperature heatIndex(const Temperature & airTemperature,
 		float relativeHumidity);
-	inline static Temperature heatIndex(const Temperature & airTemperature,
+	METAF_INLINE static Temperature heatIndex(const Temperature & airTemperature,
 		const Temperature & dewPoint);
-	inline static Temperature windChill(const Temperature & airTemperature,
+	METAF_INLINE static Temperature windChill(const Temperature & airTemperature,
 		const Speed & windSpeed);
 
 	Temperature () = default;
-	static inline std::optional<Temperature> fromString(const std::string & s);
-	static inline std::optional<Temperature> fromRemarkString(const std::string & s);
+	static METAF_INLINE std::optional<Temperature> fromString(const std::string & s);
+	static METAF_INLINE std::optional<Temperature> fromRemarkString(const std::string & s);
 private:
-	inline Temperature (float value);
+	METAF_INLINE Temperature (float value);
 
 	std::optional<int> tempValue;
 	bool freezing = false;
@@ -221,21 +406,23 @@ public:
 	};
 	std::optional<unsigned int> speed() const { return speedValue; }
 	Unit unit() const { return speedUnit; }
-	std::optional<float> inline toUnit(Unit unit) const;
+	std::optional<float> METAF_INLINE toUnit(Unit unit) const;
 	bool isReported() const { return speedValue.has_value(); }
 
 	Speed() = default;
-	static inline std::optional<Speed> fromString(const std::string & s, Unit unit);
-	static inline std::optional<Unit> unitFromString(const std::string & s);
+	static METAF_INLINE std::optional<Speed> fromString(const std::string & s, Unit unit);
+	static METAF_INLINE std::optional<Unit> unitFromString(const std::string & s);
 
 private:
+	friend class BatchConverter;
+
 	std::optional<unsigned int> speedValue;
 	Unit speedUnit = Unit::KNOTS;
 
-	static inline std::optional<float> knotsToUnit(float valueKnots, Unit otherUnit);
-	static inline std::optional<float> mpsToUnit(float valueMps, Unit otherUnit);
-	static inline std::optional<float> kmhToUnit(float valueKmh, Unit otherUnit);
-	static inline std::optional<float> mphToUnit(float valueMph, Unit otherUnit);
+	static METAF_INLINE std::optional<float> knotsToUnit(float valueKnots, Unit otherUnit);
+	static METAF_INLINE std::optional<float> mpsToUnit(float valueMps, Unit otherUnit);
+	static METAF_INLINE std::optional<float> kmhToUnit(float valueKmh, Unit otherUnit);
+	static METAF_INLINE std::optional<float> mphToUnit(float valueMph, Unit otherUnit);
 };
 
 class Distance {
@@ -278,7 +465,7 @@ public:
 	bool hasFraction() const { 
 		return (numerator().has_value() && denominator().has_value()); 
 	}
-	inline std::optional<float> toUnit(Unit unit) const;
+	METAF_INLINE std::optional<float> toUnit(Unit unit) const;
 	bool isValid() const {
 		if (distValueDen.has_value() && !distValueDen.value()) return false;
 		if (distValueNum.has_value() && !distValueNum.value()) return false;
@@ -291,18 +478,18 @@ public:
 		distValueNum(numerator), distValueDen(denominator), 
 		distUnit(Unit::STATUTE_MILES) {} 
 	Distance(Unit u) : distUnit(u) {} // Init non-reported distance
-	static inline std::optional<Distance> fromIntegerAndFraction(const Distance & integer,
+	static METAF_INLINE std::optional<Distance> fromIntegerAndFraction(const Distance & integer,
 		const Distance & fraction);
-	static inline std::optional<Distance> fromMeterString(const std::string & s);
-	static inline std::optional<Distance> fromMileString(const std::string & s);
-	static inline std::optional<Distance> fromHeightString(const std::string & s);
-	static inline std::optional<Distance> fromRvrString(const std::string & s, bool unitFeet);
-	static inline std::optional< std::pair<Distance,Distance> > fromLayerString(
+	static METAF_INLINE std::optional<Distance> fromMeterString(const std::string & s);
+	static METAF_INLINE std::optional<Distance> fromMileString(const std::string & s);
+	static METAF_INLINE std::optional<Distance> fromHeightString(const std::string & s);
+	static METAF_INLINE std::optional<Distance> fromRvrString(const std::string & s, bool unitFeet);
+	static METAF_INLINE std::optional< std::pair<Distance,Distance> > fromLayerString(
 		const std::string & s);
-	static inline Distance cavokVisibility(bool unitMiles = false);
-	static inline std::optional<Distance> fromKmString(const std::string & s);
-	static inline Distance makeDistant();
-	static inline Distance makeVicinity();
+	static METAF_INLINE Distance cavokVisibility(bool unitMiles = false);
+	static METAF_INLINE std::optional<Distance> fromKmString(const std::string & s);
+	static METAF_INLINE Distance makeDistant();
+	static METAF_INLINE Distance makeVicinity();
 private:
 	Modifier distModifier = Modifier::NONE;
 	std::optional<unsigned int> distValueInt;
@@ -318,10 +505,10 @@ private:
 	// Icing or turbulence layer depth is given in 1000s of feet
 	static const unsigned int layerDepthFactor = 1000;
 
-	static inline std::optional<Modifier> modifierFromChar(char c);
-	static inline std::optional<float> metersToUnit(float value, Unit unit);
-	static inline std::optional<float> milesToUnit(float value, Unit unit);
-	static inline std::optional<float> feetToUnit(float value, Unit unit);
+	static METAF_INLINE std::optional<Modifier> modifierFromChar(char c);
+	static METAF_INLINE std::optional<float> metersToUnit(float value, Unit unit);
+	static METAF_INLINE std::optional<float> milesToUnit(float value, Unit unit);
+	static METAF_INLINE std::optional<float> feetToUnit(float value, Unit unit);
 };
 
 class Direction {
@@ -357,7 +544,7 @@ public:
 		UNKNOWN 		// Direction is reported as unknown explicitly
 	};
 	Status status() const { return dirStatus; }
-	inline Cardinal cardinal(bool trueDirections = false) const;
+	METAF_INLINE Cardinal cardinal(bool trueDirections = false) const;
 	std::optional<unsigned int> degrees() const {
 		if (!isValue())	return std::optional<unsigned int>();
 		return dirDegrees;
@@ -366,21 +553,23 @@ public:
 		return (dirStatus == Status::VALUE_DEGREES || 
 			dirStatus == Status::VALUE_CARDINAL);
 	}
-	static inline std::vector<Cardinal> sectorCardinalDirToVector(
+	template <typename Allocator = std::allocator<Cardinal>>
+	static inline std::vector<Cardinal, Allocator> sectorCardinalDirToVector(
 		const Direction & dir1from, 
-		const Direction & dir1to);
+		const Direction & dir1to,
+		const Allocator & alloc = Allocator());
 	bool isValid() const {
 		if (isValue() && dirDegrees > maxDegrees) return false;
 		return true;
 	}
-	static inline Cardinal rotateOctantClockwise(Cardinal cardinal);
+	static METAF_INLINE Cardinal rotateOctantClockwise(Cardinal cardinal);
 
 	Direction() = default;
-	static inline std::optional<Direction> fromCardinalString(const std::string & s,
+	static METAF_INLINE std::optional<Direction> fromCardinalString(const std::string & s,
 		bool enableOhdAlqds = false,
 		bool enableUnknown = false);
-	static inline std::optional<Direction> fromDegreesString(const std::string & s);
-	static inline std::optional<std::pair<Direction, Direction>> fromSectorString(
+	static METAF_INLINE std::optional<Direction> fromDegreesString(const std::string & s);
+	static METAF_INLINE std::optional<std::pair<Direction, Direction>> fromSectorString(
 		const std::string & s);
 
 private:
@@ -408,17 +597,19 @@ public:
 	};
 	std::optional<float> pressure() const { return pressureValue; }
 	Unit unit() const { return pressureUnit; }
-	inline std::optional<float> toUnit(Unit unit) const;
+	METAF_INLINE std::optional<float> toUnit(Unit unit) const;
 	bool isReported() const { return pressureValue.has_value(); }
 
 	Pressure() = default;
-	static inline std::optional<Pressure> fromString(const std::string & s);
-	static inline std::optional<Pressure> fromForecastString(const std::string & s);
-	static inline std::optional<Pressure> fromSlpString(const std::string & s);
-	static inline std::optional<Pressure> fromQfeString(const std::string & s);
-	static inline std::optional<Pressure> fromTendencyString(const std::string & s);
+	static METAF_INLINE std::optional<Pressure> fromString(const std::string & s);
+	static METAF_INLINE std::optional<Pressure> fromForecastString(const std::string & s);
+	static METAF_INLINE std::optional<Pressure> fromSlpString(const std::string & s);
+	static METAF_INLINE std::optional<Pressure> fromQfeString(const std::string & s);
+	static METAF_INLINE std::optional<Pressure> fromTendencyString(const std::string & s);
 
 private:
+	friend class BatchConverter;
+
 	std::optional<float> pressureValue;
 	Unit pressureUnit = Unit::HECTOPASCAL;
 
@@ -434,17 +625,17 @@ public:
 	};
 	std::optional<float> precipitation() const { return precipValue; }
 	Unit unit() const { return precipUnit; }
-	inline std::optional<float> toUnit(Unit unit) const;
+	METAF_INLINE std::optional<float> toUnit(Unit unit) const;
 	bool isReported() const { return precipValue.has_value(); }
 
 	Precipitation() = default;
-	static inline std::optional<Precipitation> fromRainfallString(const std::string & s);
-	static inline std::optional<Precipitation> fromRunwayDeposits(const std::string & s);
-	static inline std::optional<Precipitation> fromRemarkString(const std::string & s,
+	static METAF_INLINE std::optional<Precipitation> fromRainfallString(const std::string & s);
+	static METAF_INLINE std::optional<Precipitation> fromRunwayDeposits(const std::string & s);
+	static METAF_INLINE std::optional<Precipitation> fromRemarkString(const std::string & s,
 		float factor = 1,
 		Unit unit = Unit::INCHES, 
 		bool allowNotReported = false);
-	static inline std::optional<std::pair<Precipitation, Precipitation> >
+	static METAF_INLINE std::optional<std::pair<Precipitation, Precipitation> >
 		fromSnincrString(const std::string & s);
 
 private:
@@ -487,12 +678,12 @@ public:
 			sfStatus == Status::UNRELIABLE) return std::optional<float>();
 		return (sfCoefficient * coefficientDecimalPointShift);
 	}
-	inline BrakingAction brakingAction() const;
+	METAF_INLINE BrakingAction brakingAction() const;
 	bool isReported() const { return (status() != Status::NOT_REPORTED); }
 	bool isUnreliable() const { return (status() == Status::UNRELIABLE); }
 
 	SurfaceFriction() = default;
-	static inline std::optional<SurfaceFriction> fromString(const std::string & s);
+	static METAF_INLINE std::optional<SurfaceFriction> fromString(const std::string & s);
 
 private:
 	Status sfStatus = Status::NOT_REPORTED;
@@ -543,17 +734,17 @@ public:
 		PHENOMENAL,
 	};
 	Type type() const { return whType; }
-	inline StateOfSurface stateOfSurface() const;
+	METAF_INLINE StateOfSurface stateOfSurface() const;
 	Unit unit() const { return whUnit; }
 	std::optional<float> waveHeight() const {
 		if (!whValue.has_value()) return std::optional<float>();
 		return (whValue.value() * waveHeightDecimalPointShift);
 	}
 	bool isReported() const { return whValue.has_value(); }
-	inline std::optional<float> toUnit(Unit unit) const;
+	METAF_INLINE std::optional<float> toUnit(Unit unit) const;
 
 	WaveHeight() = default;
-	static inline std::optional<WaveHeight> fromString(const std::string & s);
+	static METAF_INLINE std::optional<WaveHeight> fromString(const std::string & s);
 
 private:
 	Type whType = Type::STATE_OF_SURFACE;
@@ -561,7 +752,7 @@ private:
 	static const inline auto waveHeightDecimalPointShift = 0.1;
 	static const Unit whUnit = Unit::METERS;
 private:
-	static inline std::optional<unsigned int> waveHeightFromStateOfSurfaceChar(char c);
+	static METAF_INLINE std::optional<unsigned int> waveHeightFromStateOfSurfaceChar(char c);
 private:
 	//Values below are in decimeters, muliply by 0.1 to get value in meters
 	static const inline auto maxWaveHeightCalmGlassy = 0;
@@ -632,7 +823,9 @@ public:
 
 	Qualifier qualifier() const { return q; }
 	Descriptor descriptor() const { return d; }
-	inline std::vector<Weather> weather() const;
+	template <typename Allocator = std::allocator<Weather>>
+	inline std::vector<Weather, Allocator> weather(
+		const Allocator & alloc = Allocator()) const;
 	Event event() const { return ev; }
 	std::optional<MetafTime> time() const { return tm; }
 	bool isOmmitted() const { 
@@ -642,12 +835,12 @@ public:
 			event() == Event::NONE &&
 			!tm.has_value());
 	}
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	WeatherPhenomena() = default;
-	static inline std::optional <WeatherPhenomena> fromString(const std::string & s,
+	static METAF_INLINE std::optional <WeatherPhenomena> fromString(const std::string & s,
 		bool enableQualifiers = false);
-	static inline std::optional <WeatherPhenomena> fromWeatherBeginEndString(
+	static METAF_INLINE std::optional <WeatherPhenomena> fromWeatherBeginEndString(
 		const std::string & s,
 		const MetafTime & reportTime,
 		const WeatherPhenomena & previous);
@@ -682,9 +875,9 @@ private:
 		w[0] = wthr; w[1] = Weather::OMMITTED;
 	}
 
-	static inline bool isDescriptorShAllowed (Weather w);
+	static METAF_INLINE bool isDescriptorShAllowed (Weather w);
 	static inline bool isDescriptorTsAllowed (Weather w);
-	static inline bool isDescriptorFzAllowed (Weather w);
+	static METAF_INLINE bool isDescriptorFzAllowed (Weather w);
 };
 
 ///////////////////////////////////////////////////////////////////////////
@@ -717,7 +910,10 @@ enum class ReportError {
 	AMD_ALLOWED_IN_TAF_ONLY,
 	CNL_ALLOWED_IN_TAF_ONLY,
 	MAINTENANCE_INDICATOR_ALLOWED_IN_METAR_ONLY,
-	REPORT_TOO_LARGE
+	REPORT_TOO_LARGE,
+	GROUP_TOO_LONG,
+	REPORT_TOO_LONG,
+	WORK_LIMIT_EXCEEDED
 };
 
 struct ReportMetadata {
@@ -758,12 +954,14 @@ enum class AppendResult {
 ///////////////////////////////////////////////////////////////////////////
 
 // Default delimiter between groups
-// Note: only used to append raw strings, see also groupDelimiterRegex
+// Note: only used to append raw strings, see also isGroupDelimiter()
 static const inline char groupDelimiterChar = ' ';
 
-// This is the regex is used by parser to split report into separate
-// group strings
-static const inline std::regex groupDelimiterRegex("\\s+");
+// Parser splits report into separate group strings at any sequence of
+// whitespace characters
+inline bool isGroupDelimiter(char c) {
+	return std::isspace(static_cast<unsigned char>(c));
+}
 
 // Everything after this char is ignored by parser
 static const inline char reportEndChar = '=';
@@ -820,10 +1018,10 @@ public:
 	bool isValid() const { return (incompleteText == IncompleteText::NONE); }
 
 	FixedGroup() = default;
-	static inline std::optional<FixedGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<FixedGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -854,20 +1052,27 @@ private:
 
 class LocationGroup {
 public:
-	std::string toString() const {return std::string(location);}
+	std::string toString() const { return keyToString(icaoKey); }
+	// ICAO location packed into 32-bit integer, first character in the most 
+	// significant byte; comparing keys gives the same order as comparing
+	// strings; zero key is not a valid location
+	std::uint32_t key() const { return icaoKey; }
 	inline bool isValid() const { return true; }
 
+	static METAF_INLINE std::optional<std::uint32_t> stringToKey(std::string_view location);
+	static METAF_INLINE std::string keyToString(std::uint32_t key);
+
 	LocationGroup() = default;
-	static inline std::optional<LocationGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<LocationGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
 private:
 	static const inline auto locationLength = 4;
-	char location [locationLength + 1] = "\0";
+	std::uint32_t icaoKey = 0;
 };
 
 class ReportTimeGroup {
@@ -876,11 +1081,11 @@ public:
 	bool isValid() const { return (t.isValid() && t.day().has_value()); }
 
 	ReportTimeGroup() = default;
-	static inline std::optional<ReportTimeGroup> parse(
+	static METAF_INLINE std::optional<ReportTimeGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -915,14 +1120,14 @@ public:
 		if (tAt.has_value() && !tAt->isValid()) return false;
 		return (type() != Type::NONE); // Incomplete groups are considered invalid
 	}
-	inline bool isTimeSpanGroup() const;
+	METAF_INLINE bool isTimeSpanGroup() const;
 
 	TrendGroup() = default;
-	static inline std::optional<TrendGroup> parse(
+	static METAF_INLINE std::optional<TrendGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -930,21 +1135,21 @@ private:
 	TrendGroup(Type type) : t(type) {}
 	TrendGroup(Probability p) : t(Type::NONE), prob(p) {}
 
-	static inline std::optional<TrendGroup> fromTimeSpan(const std::string & s);
-	static inline std::optional<TrendGroup> fromFm(const std::string & s);
-	static inline std::optional<TrendGroup> fromTrendTime(const std::string & s);
+	static METAF_INLINE std::optional<TrendGroup> fromTimeSpan(const std::string & s);
+	static METAF_INLINE std::optional<TrendGroup> fromFm(const std::string & s);
+	static METAF_INLINE std::optional<TrendGroup> fromTrendTime(const std::string & s);
 
-	inline bool combineProbAndTrendTypeGroups(const TrendGroup & nextTrendGroup);
-	inline bool combineTrendTypeAndTimeGroup(const TrendGroup & nextTrendGroup);
-	inline bool combineProbAndTimeSpanGroups(const TrendGroup & nextTrendGroup);
-	inline bool combineIncompleteGroups(const TrendGroup & nextTrendGroup);
+	METAF_INLINE bool combineProbAndTrendTypeGroups(const TrendGroup & nextTrendGroup);
+	METAF_INLINE bool combineTrendTypeAndTimeGroup(const TrendGroup & nextTrendGroup);
+	METAF_INLINE bool combineProbAndTimeSpanGroups(const TrendGroup & nextTrendGroup);
+	METAF_INLINE bool combineIncompleteGroups(const TrendGroup & nextTrendGroup);
 
-	static inline bool canCombineTime(const TrendGroup & g1, const TrendGroup & g2);
-	inline void combineTime(const TrendGroup & nextTrendGroup);
+	static METAF_INLINE bool canCombineTime(const TrendGroup & g1, const TrendGroup & g2);
+	METAF_INLINE void combineTime(const TrendGroup & nextTrendGroup);
 
-	inline bool isProbabilityGroup() const;
-	inline bool isTrendTypeGroup() const;
-	inline bool isTrendTimeGroup() const;
+	METAF_INLINE bool isProbabilityGroup() const;
+	METAF_INLINE bool isTrendTypeGroup() const;
+	METAF_INLINE bool isTrendTimeGroup() const;
 
 	Type t = Type::NONE;
 	Probability prob = Probability::NONE;
@@ -973,14 +1178,14 @@ public:
 	Direction varSectorBegin() const { return vsecBegin; }
 	Direction varSectorEnd() const { return vsecEnd; }
 	std::optional<MetafTime> eventTime() const { return evTime; }
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	WindGroup() = default;
-	static inline std::optional<WindGroup> parse(
+	static METAF_INLINE std::optional<WindGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -989,7 +1194,7 @@ private:
 		PK,
 		PK_WND
 	};
-	inline AppendResult parsePeakWind(const std::string & group,
+	METAF_INLINE AppendResult parsePeakWind(const std::string & group,
 		const ReportMetadata & reportMetadata);
 
 	Type windType;
@@ -1042,14 +1247,14 @@ public:
 	bool isDirectional() const {
 		return (type() == Type::DIRECTIONAL || type() == Type::DIRECTIONAL_VARIABLE);
 	}
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	VisibilityGroup() = default;
-	inline static std::optional<VisibilityGroup> parse(
+	METAF_INLINE static std::optional<VisibilityGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -1065,18 +1270,18 @@ private:
 		RMK_SFC_OR_TWR_VIS_INTEGER
 	};
 
-	inline static VisibilityGroup rmkVisIncomplete();
-	inline static VisibilityGroup rmkSfcVisIncomplete();
-	inline static VisibilityGroup rmkTwrVisIncomplete();
+	METAF_INLINE static VisibilityGroup rmkVisIncomplete();
+	METAF_INLINE static VisibilityGroup rmkSfcVisIncomplete();
+	METAF_INLINE static VisibilityGroup rmkTwrVisIncomplete();
 
-	static inline std::optional<VisibilityGroup> fromIncompleteInteger(const std::string & group);
-	static inline std::optional<VisibilityGroup> fromMeters(const std::string & group);
+	static METAF_INLINE std::optional<VisibilityGroup> fromIncompleteInteger(const std::string & group);
+	static METAF_INLINE std::optional<VisibilityGroup> fromMeters(const std::string & group);
 
-	inline bool appendDirection(const std::string & group);
-	inline bool appendInteger(const std::string & group);
-	inline bool appendFraction(const std::string & group);
-	inline bool appendVariable(const std::string & group);
-	inline bool appendVariableMeters(const std::string & group);
+	METAF_INLINE bool appendDirection(const std::string & group);
+	METAF_INLINE bool appendInteger(const std::string & group);
+	METAF_INLINE bool appendFraction(const std::string & group);
+	METAF_INLINE bool appendVariable(const std::string & group);
+	METAF_INLINE bool appendVariableMeters(const std::string & group);
 
 	Type visType = Type::PREVAILING;
 	Distance vis;
@@ -1110,7 +1315,7 @@ public:
 	};
 	Amount amount() const { return amnt; }
 	Type type() const { return tp; }
-	inline Distance height() const;
+	METAF_INLINE Distance height() const;
 	Distance verticalVisibility() const {
 		if (amount() != Amount::OBSCURED) return heightNotReported;
 		return heightOrVertVis;
@@ -1123,16 +1328,16 @@ public:
 				amount() == Amount::NCD || 
 				amount() == Amount::NSC);
 	}
-	inline bool isCloudLayer() const;
+	METAF_INLINE bool isCloudLayer() const;
 	inline bool isObscuration() const { return !w.isOmmitted(); }
 	bool isValid() const { return heightOrVertVis.isValid(); }
 
 	CloudGroup () = default;
-	static inline std::optional<CloudGroup> parse(
+	static METAF_INLINE std::optional<CloudGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -1150,12 +1355,12 @@ private:
 	IncompleteType incompleteType = IncompleteType::NONE;
 
 	CloudGroup(Amount a) : amnt(a) {}
-	static inline std::optional<CloudGroup> parseCloudLayer(const std::string & s);
-	static inline std::optional<CloudGroup> parseVariableCloudLayer(const std::string & s);
-	static inline std::optional<Amount> amountFromString(const std::string & s);
-	static inline std::optional<Type> typeFromString(const std::string & s);
+	static METAF_INLINE std::optional<CloudGroup> parseCloudLayer(const std::string & s);
+	static METAF_INLINE std::optional<CloudGroup> parseVariableCloudLayer(const std::string & s);
+	static METAF_INLINE std::optional<Amount> amountFromString(const std::string & s);
+	static METAF_INLINE std::optional<Type> typeFromString(const std::string & s);
 
-	static inline std::optional<Amount> variableAmount(Amount first, Amount second);
+	static METAF_INLINE std::optional<Amount> variableAmount(Amount first, Amount second);
 };
 
 class WeatherGroup {
@@ -1166,7 +1371,9 @@ public:
 		EVENT,
 	};
 	Type type() const { return t; }
-	inline std::vector<WeatherPhenomena> weatherPhenomena() const;
+	template <typename Allocator = std::allocator<WeatherPhenomena>>
+	inline std::vector<WeatherPhenomena, Allocator> weatherPhenomena(
+		const Allocator & alloc = Allocator()) const;
 	bool isValid() const { 
 		for (auto i=0u; i < wSize; i++) 
 			if (!w[i].isOmmitted() && !w[i].isValid()) return false;
@@ -1174,16 +1381,16 @@ public:
 	}
 
 	WeatherGroup() = default;
-	static inline std::optional<WeatherGroup> parse(
+	static METAF_INLINE std::optional<WeatherGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
 private:
-	inline bool addWeatherPhenomena(const WeatherPhenomena & wp);
+	METAF_INLINE bool addWeatherPhenomena(const WeatherPhenomena & wp);
 
 	Type t = Type::CURRENT;
 	static const inline size_t wSize = 10;
@@ -1192,10 +1399,10 @@ private:
 	static inline WeatherGroup notReported();
 	static inline WeatherGroup notReportedRecent();
 
-	static inline std::optional<WeatherPhenomena> parseWeatherWithoutEvent(
+	static METAF_INLINE std::optional<WeatherPhenomena> parseWeatherWithoutEvent(
 		const std::string & group, 
 		ReportPart reportPart);
-	static inline std::optional<WeatherGroup> parseWeatherEvent(
+	static METAF_INLINE std::optional<WeatherGroup> parseWeatherEvent(
 		const std::string & group, 
 		const MetafTime & reportTime);
 };
@@ -1207,14 +1414,14 @@ public:
 	std::optional<float> relativeHumidity() const {
 		return Temperature::relativeHumidity(airTemperature(), dewPoint());
 	}
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	TemperatureGroup() = default;
-	static inline std::optional<TemperatureGroup> parse(
+	static METAF_INLINE std::optional<TemperatureGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1236,11 +1443,11 @@ public:
 	bool isValid() const { return tm.isValid(); }
 
 	TemperatureForecastGroup() = default;
-	static inline std::optional<TemperatureForecastGroup> parse(
+	static METAF_INLINE std::optional<TemperatureForecastGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1269,11 +1476,11 @@ public:
 	bool isValid() const { return true; }
 
 	PressureGroup() = default;
-	static inline std::optional<PressureGroup> parse(
+	static METAF_INLINE std::optional<PressureGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1308,11 +1515,11 @@ public:
 	}
 
 	RunwayVisualRangeGroup() = default;
-	static inline std::optional<RunwayVisualRangeGroup> parse(
+	static METAF_INLINE std::optional<RunwayVisualRangeGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1322,7 +1529,7 @@ private:
 	Distance varVisRange;
 	Trend trnd;
 private:
-	static inline std::optional<Trend> trendFromString(const std::string & s);
+	static METAF_INLINE std::optional<Trend> trendFromString(const std::string & s);
 };
 
 class RunwayStateGroup {
@@ -1376,11 +1583,11 @@ public:
 	}
 
 	RunwayStateGroup() = default;
-	static inline std::optional<RunwayStateGroup> parse(
+	static METAF_INLINE std::optional<RunwayStateGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1392,12 +1599,12 @@ private:
 	Precipitation dDepth;
 	SurfaceFriction sf;
 
-	static inline RunwayStateGroup runwaySnoclo(Runway runway);
-	static inline RunwayStateGroup runwayClrd(Runway runway,
+	static METAF_INLINE RunwayStateGroup runwaySnoclo(Runway runway);
+	static METAF_INLINE RunwayStateGroup runwayClrd(Runway runway,
 		SurfaceFriction surfaceFriction);
 
-	static inline std::optional<Deposits> depositsFromString(const std::string & s);
-	static inline std::optional<Extent> extentFromString(const std::string & s);
+	static METAF_INLINE std::optional<Deposits> depositsFromString(const std::string & s);
+	static METAF_INLINE std::optional<Extent> extentFromString(const std::string & s);
 };
 
 class SecondaryLocationGroup {
@@ -1420,14 +1627,14 @@ public:
 	Distance visibility() const { return vis; }
 	Distance minVisibility() const { return minVis; }
 	Distance maxVisibility() const { return maxVis; }
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	SecondaryLocationGroup() = default;
-	static inline std::optional<SecondaryLocationGroup> parse(
+	static METAF_INLINE std::optional<SecondaryLocationGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -1456,7 +1663,7 @@ private:
 	Distance minVis;
 	Distance maxVis;
 
-	inline bool appendVisibility(const std::string & group);
+	METAF_INLINE bool appendVisibility(const std::string & group);
 };
 
 class RainfallGroup {
@@ -1467,11 +1674,11 @@ public:
 	bool isValid() const { return true; }
 
 	RainfallGroup() = default;
-	static inline std::optional<RainfallGroup> parse(
+	static METAF_INLINE std::optional<RainfallGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1488,11 +1695,11 @@ public:
 	bool isValid() const { return true; }
 
 	SeaSurfaceGroup() = default;
-	static inline std::optional<SeaSurfaceGroup> parse(
+	static METAF_INLINE std::optional<SeaSurfaceGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1517,11 +1724,11 @@ public:
 	bool isValid() const { return true; }
 
 	ColourCodeGroup() = default;
-	static inline std::optional<ColourCodeGroup> parse(
+	static METAF_INLINE std::optional<ColourCodeGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -1541,11 +1748,11 @@ public:
 	bool isValid() const { return true; }
 
 	MinMaxTemperatureGroup() = default;
-	static inline std::optional<MinMaxTemperatureGroup> parse(
+	static METAF_INLINE std::optional<MinMaxTemperatureGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -1577,10 +1784,10 @@ public:
 	bool isValid() const { return true; }
 
 	PrecipitationGroup() = default;
-	static inline std::optional<PrecipitationGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<PrecipitationGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 private:
@@ -1588,11 +1795,11 @@ private:
 	Precipitation precAmount;
 	Precipitation precChange;
 
-	static inline std::optional<Type> typeFromString(const std::string & s,
+	static METAF_INLINE std::optional<Type> typeFromString(const std::string & s,
 		bool is3hourly,
 		bool is6hourly);
-	static inline float factorFromType(Type type);
-	static inline Precipitation::Unit unitFromType(Type type);
+	static METAF_INLINE float factorFromType(Type type);
+	static METAF_INLINE Precipitation::Unit unitFromType(Type type);
 };
 
 class LayerForecastGroup {
@@ -1626,10 +1833,10 @@ public:
 	bool isValid() const { return true; }
 
 	LayerForecastGroup() = default;
-	static inline std::optional<LayerForecastGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<LayerForecastGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1638,7 +1845,7 @@ private:
 	Distance layerBaseHeight;
 	Distance layerTopHeight;
 
-	static inline std::optional<Type> typeFromStr(const std::string & s);
+	static METAF_INLINE std::optional<Type> typeFromStr(const std::string & s);
 };
 
 class PressureTendencyGroup {
@@ -1667,15 +1874,15 @@ public:
 	};
 	Type type() const { return tendencyType; }
 	Pressure difference() const { return pressureDifference; }
-	static inline Trend trend(Type type);
+	static METAF_INLINE Trend trend(Type type);
 	bool isValid() const { return true; }
 
 	PressureTendencyGroup() = default;
-	static inline std::optional<PressureTendencyGroup> parse(
+	static METAF_INLINE std::optional<PressureTendencyGroup> parse(
 		const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1683,7 +1890,7 @@ private:
 	Type tendencyType;
 	Pressure pressureDifference;
 
-	static inline std::optional<Type> typeFromChar(char type);
+	static METAF_INLINE std::optional<Type> typeFromChar(char type);
 };
 
 class CloudTypesGroup {
@@ -1720,15 +1927,17 @@ public:
 		MIST,
 		HAZE
 	};
-	inline std::vector<std::pair<Type, unsigned int>> toVector() const;
+	template <typename Allocator = std::allocator<std::pair<Type, unsigned int>>>
+	inline std::vector<std::pair<Type, unsigned int>, Allocator> toVector(
+		const Allocator & alloc = Allocator()) const;
 	Distance baseHeight() const { return bh; }
 	bool isValid() const { return true; }
 
 	CloudTypesGroup() = default;
-	static inline std::optional<CloudTypesGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<CloudTypesGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1738,8 +1947,8 @@ private:
 	std::pair<Type, unsigned int> cloudTypes[cloudTypesMaxSize];
 	Distance bh;
 
-	static inline std::optional<Type> cloudTypeFromString(std::string s);
-	static inline std::optional<Type> typeFromString(std::string s);
+	static METAF_INLINE std::optional<Type> cloudTypeFromString(std::string s);
+	static METAF_INLINE std::optional<Type> typeFromString(std::string s);
 };
 
 class CloudLayersGroup {
@@ -1786,13 +1995,13 @@ public:
 	LowLayer lowLayer() const { return cloudLowLayer; }
 	MidLayer midLayer() const { return cloudMidLayer; }
 	HighLayer highLayer() const { return cloudHighLayer; }
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	CloudLayersGroup() = default;
-	static inline std::optional<CloudLayersGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<CloudLayersGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1801,9 +2010,9 @@ private:
 	MidLayer cloudMidLayer = MidLayer::NONE;
 	HighLayer cloudHighLayer = HighLayer::NONE;
 
-	static inline std::optional<LowLayer> lowLayerFromChar(char c);
-	static inline std::optional<MidLayer> midLayerFromChar(char c);
-	static inline std::optional<HighLayer> highLayerFromChar(char c);
+	static METAF_INLINE std::optional<LowLayer> lowLayerFromChar(char c);
+	static METAF_INLINE std::optional<MidLayer> midLayerFromChar(char c);
+	static METAF_INLINE std::optional<HighLayer> highLayerFromChar(char c);
 };
 
 class LightningGroup {
@@ -1821,14 +2030,16 @@ public:
 	bool isCloudCloud() const { return typeCloudCloud; }
 	bool isCloudAir() const { return typeCloudAir; }
 	bool isUnknownType() const { return typeUnknown; }
-	inline std::vector<Direction::Cardinal> directions() const;
+	template <typename Allocator = std::allocator<Direction::Cardinal>>
+	inline std::vector<Direction::Cardinal, Allocator> directions(
+		const Allocator & alloc = Allocator()) const;
 	inline bool isValid() const { return !typeUnknown; }
 
 	LightningGroup() = default;
-	static inline std::optional<LightningGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<LightningGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	inline AppendResult append(const std::string & group,
+	METAF_INLINE AppendResult append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1850,7 +2061,7 @@ private:
 		freq = frequency;
 		incomplete = true;
 	}
-	static inline std::optional<LightningGroup> fromLtgGroup(
+	static METAF_INLINE std::optional<LightningGroup> fromLtgGroup(
 		const std::string & group);
 	bool isOmmittedDir1() const {
 		return (dir1from.status() == Direction::Status::OMMITTED && 
@@ -1888,16 +2099,18 @@ public:
 	};
 	Type type() const { return t; }
 	Distance distance() const { return dist; }
-	inline std::vector<Direction::Cardinal> directions() const;
+	template <typename Allocator = std::allocator<Direction::Cardinal>>
+	inline std::vector<Direction::Cardinal, Allocator> directions(
+		const Allocator & alloc = Allocator()) const;
 	inline Direction::Cardinal movingDirection() const { return movDir; }
 	inline bool isValid() const {
 		return (incompleteType == IncompleteType::NONE);
 	}
 
-	static inline std::optional<VicinityGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<VicinityGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	inline AppendResult append(const std::string & group,
+	METAF_INLINE AppendResult append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1938,9 +2151,9 @@ private:
 		if (type() == Type::ROTOR_CLOUD) expectNext(IncompleteType::EXPECT_CLD);
 	}
 
-	inline bool appendDir1(const std::string & str);
-	inline bool appendDir2(const std::string & str);
-	inline bool appendDistance(const std::string & str);
+	METAF_INLINE bool appendDir1(const std::string & str);
+	METAF_INLINE bool appendDir2(const std::string & str);
+	METAF_INLINE bool appendDistance(const std::string & str);
 };
 
 class MiscGroup {
@@ -1953,13 +2166,13 @@ public:
 	};
 	Type type() const { return groupType; }
 	std::optional<float> value() const { return groupValue; }
-	inline bool isValid() const;
+	METAF_INLINE bool isValid() const;
 
 	MiscGroup() = default;
-	static inline std::optional<MiscGroup> parse(const std::string & group,
+	static METAF_INLINE std::optional<MiscGroup> parse(const std::string & group,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata = missingMetadata);
-	AppendResult inline append(const std::string & group,
+	AppendResult METAF_INLINE append(const std::string & group,
 		ReportPart reportPart = ReportPart::UNKNOWN,
 		const ReportMetadata & reportMetadata = missingMetadata);
 
@@ -1976,8 +2189,8 @@ private:
 	std::optional<float> groupValue;
 	IncompleteType incompleteType = IncompleteType::NONE;
 
-	inline bool appendHailstoneFraction (const std::string & group);
-	inline bool appendDensityAltitude (const std::string & group);
+	METAF_INLINE bool appendHailstoneFraction (const std::string & group);
+	METAF_INLINE bool appendDensityAltitude (const std::string & group);
 };
 
 class UnknownGroup {
@@ -2002,14 +2215,39 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-struct GroupInfo {
-	GroupInfo(Group g, ReportPart rp, std::string rawstr) :
-		group(std::move(g)), reportPart(rp), rawString(std::move(rawstr)) {}
+// Raw string is allocated using the specified allocator; when GroupInfo is
+// stored in allocator-aware container (e.g. std::pmr::vector), the raw string
+// uses the container's allocator
+template <typename Allocator = std::allocator<char>>
+struct BasicGroupInfo {
+	using allocator_type = Allocator;
+	using String = std::basic_string<char,
+		std::char_traits<char>,
+		typename std::allocator_traits<Allocator>::template rebind_alloc<char>>;
+
+	BasicGroupInfo(Group g,
+		ReportPart rp,
+		String rawstr,
+		const Allocator & alloc = Allocator()) :
+			group(std::move(g)), reportPart(rp), rawString(std::move(rawstr), alloc) {}
+	BasicGroupInfo(const BasicGroupInfo & other) = default;
+	BasicGroupInfo(BasicGroupInfo && other) = default;
+	BasicGroupInfo(const BasicGroupInfo & other, const Allocator & alloc) :
+		group(other.group), reportPart(other.reportPart), rawString(other.rawString, alloc) {}
+	BasicGroupInfo(BasicGroupInfo && other, const Allocator & alloc) :
+		group(std::move(other.group)),
+		reportPart(other.reportPart),
+		rawString(std::move(other.rawString), alloc) {}
+	BasicGroupInfo & operator=(const BasicGroupInfo & other) = default;
+	BasicGroupInfo & operator=(BasicGroupInfo && other) = default;
+
 	Group group;
 	ReportPart reportPart;
-	std::string rawString;
+	String rawString;
 };
 
+using GroupInfo = BasicGroupInfo<>;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // Syntax Group is a delimiter of structural part of METAR/TAF report
@@ -2030,7 +2268,218 @@ enum class SyntaxGroup {
 };
 
 // Determines groups important for report syntax
-inline SyntaxGroup getSyntaxGroup(const Group & group);
+METAF_INLINE SyntaxGroup getSyntaxGroup(const Group & group);
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Parse instrumentation: counters of parse and append attempts for each
+// alternative of Group variant (indexed as Group::index())
+// Counters are collected only if METAF_PARSE_STATS is defined before
+// including metaf.hpp, and parse time is only measured if
+// METAF_PARSE_STATS_TIMING is defined as well; otherwise the instrumentation
+// is compiled out and all counters remain zero
+struct ParseStats {
+	struct Alternative {
+		std::uint64_t parseAttempts = 0;
+		std::uint64_t parsed = 0;
+		std::uint64_t parseNanoseconds = 0;
+		std::uint64_t appendAttempts = 0;
+		std::uint64_t appended = 0;
+		std::uint64_t notAppended = 0;
+		std::uint64_t invalidated = 0;
+		std::uint64_t rejected() const { return parseAttempts - parsed; }
+	};
+	std::array<Alternative, std::variant_size_v<Group>> alternatives;
+	std::uint64_t reports = 0;
+	// Group strings parsed again because report part has changed
+	std::uint64_t reparses = 0;
+
+#ifdef METAF_PARSE_STATS
+	static const inline bool enabled = true;
+#else
+	static const inline bool enabled = false;
+#endif
+	// Counters are shared by all threads
+	static METAF_INLINE ParseStats snapshot();
+	static METAF_INLINE void reset();
+};
+
+// Updates the counters reported by ParseStats
+class ParseStatsRecorder {
+public:
+	static METAF_INLINE std::uint64_t now();
+	static METAF_INLINE void parse(std::size_t index, bool parsed, std::uint64_t startTime);
+	static METAF_INLINE void append(std::size_t index, AppendResult result);
+	static METAF_INLINE void reparse();
+	static METAF_INLINE void report();
+private:
+#ifdef METAF_PARSE_STATS
+	friend struct ParseStats;
+	// Static storage, zero-initialised
+	struct Counters {
+		std::atomic<std::uint64_t> parseAttempts;
+		std::atomic<std::uint64_t> parsed;
+		std::atomic<std::uint64_t> parseNanoseconds;
+		std::atomic<std::uint64_t> appendAttempts;
+		std::atomic<std::uint64_t> appended;
+		std::atomic<std::uint64_t> notAppended;
+		std::atomic<std::uint64_t> invalidated;
+	};
+	static inline std::array<Counters, std::variant_size_v<Group>> counters;
+	static inline std::atomic<std::uint64_t> reports;
+	static inline std::atomic<std::uint64_t> reparses;
+	static void increment(std::atomic<std::uint64_t> & counter,
+		std::uint64_t value = 1)
+	{
+		counter.fetch_add(value, std::memory_order_relaxed);
+	}
+#endif
+};
+
+// Parse tracing: begin and end time of each stage of parsing of each report,
+// recorded into the ring buffer of the calling thread; allows to find out
+// where the time was spent when a particular report was parsed slowly
+// The trace is recorded only if METAF_PARSE_TRACE is defined before
+// including metaf.hpp; otherwise the tracing is compiled out and the trace
+// is always empty
+struct ParseTrace {
+	enum class Stage : std::uint8_t {
+		REPORT,		// Entire report (or remarks decoded by LazyParseResult)
+		TOKENIZE,	// Finding the next group string
+		APPEND,		// Appending group string to the previous group
+		DECODE,		// Decoding group string (GroupParser or GroupCache)
+		REPARSE,	// Decoding group string again after report part changed
+		TRANSITION,	// Syntax check
+		METADATA,	// Updating report metadata
+		FINISH		// Finishing the last group and indexing report sections
+	};
+	struct Event {
+		std::uint64_t begin = 0;	// Nanoseconds, std::chrono::steady_clock
+		std::uint64_t end = 0;
+		std::uint32_t thread = 0;	// Number of the thread which parsed the report
+		std::uint32_t report = 0;	// Number of the report parsed by the thread
+		std::uint32_t group = 0;	// Number of the group string in the report
+		Stage stage = Stage::REPORT;
+	};
+	// Maximum number of events stored per thread; older events are
+	// overwritten
+	static const inline std::size_t capacity = 65536;
+
+#ifdef METAF_PARSE_TRACE
+	static const inline bool enabled = true;
+#else
+	static const inline bool enabled = false;
+#endif
+	// Events recorded by the calling thread, oldest first
+	static METAF_INLINE std::vector<Event> events();
+	static METAF_INLINE void clear();
+	// Events in Chrome trace event format (JSON), which can be opened in
+	// the timeline viewer (chrome://tracing or Perfetto UI); only the
+	// reports which took at least minReportNanoseconds are included
+	// Events recorded by several threads may be combined into one vector
+	static METAF_INLINE std::string toChromeTrace(const std::vector<Event> & events,
+		std::uint64_t minReportNanoseconds = 0);
+	static METAF_INLINE std::string_view stageName(Stage stage);
+};
+
+// Records the events reported by ParseTrace
+class ParseTraceRecorder {
+public:
+	static METAF_INLINE std::uint64_t now();
+	static METAF_INLINE void beginReport();
+	static METAF_INLINE void record(ParseTrace::Stage stage,
+		std::uint64_t begin,
+		std::size_t group = 0);
+private:
+#ifdef METAF_PARSE_TRACE
+	friend struct ParseTrace;
+	struct Buffer {
+		std::vector<ParseTrace::Event> events;	// Allocated on first use
+		std::size_t next = 0;
+		std::size_t size = 0;
+		std::uint32_t thread = 0;
+		std::uint32_t report = 0;
+	};
+	static inline std::atomic<std::uint32_t> threads;
+	static inline Buffer & buffer() {
+		static thread_local Buffer buffer;
+		if (buffer.events.empty()) {
+			buffer.events.resize(ParseTrace::capacity);
+			buffer.thread = threads.fetch_add(1, std::memory_order_relaxed);
+		}
+		return buffer;
+	}
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename Allocator = std::allocator<char>>
+struct BasicParseResult;
+struct ParseResult;
+
+template <typename Allocator>
+struct BasicReportSections;
+
+namespace pmr {
+	using GroupInfo = BasicGroupInfo<std::pmr::polymorphic_allocator<char>>;
+	using ReportSections = BasicReportSections<std::pmr::polymorphic_allocator<char>>;
+	using ParseResult = BasicParseResult<std::pmr::polymorphic_allocator<char>>;
+} // namespace pmr
+
+// Number of groups of each Group alternative found in parsed reports, counted
+// separately for each report part; used to build GroupParseOrder
+class GroupFrequency {
+public:
+	template <typename Allocator>
+	inline void add(const BasicParseResult<Allocator> & parseResult);
+	std::uint64_t count(ReportPart reportPart, std::size_t index) const {
+		return counts[static_cast<std::size_t>(reportPart)][index];
+	}
+private:
+	static const inline std::size_t reportParts =
+		static_cast<std::size_t>(ReportPart::RMK) + 1;
+	std::array<std::array<std::uint64_t, std::variant_size_v<Group>>, reportParts>
+		counts = {};
+};
+
+// Order in which GroupParser attempts to parse a group string with the
+// alternatives of Group variant, specified separately for each report part
+// Fallback group is not included since it is always the last alternative
+// The default order is the order of alternatives in Group; the order built
+// from observed group frequency attempts the most common groups first but
+// still respects priorities() of the alternatives
+class GroupParseOrder {
+public:
+	static const inline std::size_t size = std::variant_size_v<Group> - 1;
+	using Order = std::array<std::uint8_t, size>;
+	// Pairs of alternative indices: the first alternative must be attempted
+	// before the second one, since both may parse the same group string
+	static METAF_INLINE const std::vector<std::pair<std::size_t, std::size_t>> &
+		priorities();
+
+	METAF_INLINE GroupParseOrder();
+	const Order & order(ReportPart reportPart) const {
+		return orders[static_cast<std::size_t>(reportPart)];
+	}
+	// Returns false and keeps the current order if the order is not valid:
+	// it is not a permutation of alternative indices or violates priorities
+	METAF_INLINE bool setOrder(ReportPart reportPart, const Order & order);
+	static METAF_INLINE bool isValid(const Order & order);
+
+	static METAF_INLINE GroupParseOrder fromFrequency(const GroupFrequency & frequency);
+
+	// Order as a text, e.g. to store the order built at one time and load it
+	// at startup; the report parts are separated by semicolon, and the
+	// indices of alternatives within each report part are separated by space
+	METAF_INLINE std::string toString() const;
+	static METAF_INLINE std::optional<GroupParseOrder> fromString(const std::string & s);
+
+private:
+	static const inline std::size_t reportParts =
+		static_cast<std::size_t>(ReportPart::RMK) + 1;
+	std::array<Order, reportParts> orders;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -2042,7 +2491,48 @@ public:
 	{
 		return parseAlternative<0>(group, reportPart, reportMetadata);
 	}
+	// Alternatives are attempted in the specified order
+	static Group parse(const std::string & group,
+		ReportPart reportPart,
+		const ReportMetadata & reportMetadata,
+		const GroupParseOrder & order)
+	{
+		for (const auto i : order.order(reportPart)) {
+			auto parsed = alternativeParsers[i](group, reportPart, reportMetadata);
+			if (parsed.has_value()) return std::move(*parsed);
+		}
+		ParseStatsRecorder::parse(GroupParseOrder::size, true,
+			ParseStatsRecorder::now());
+		return FallbackGroup();
+	}
 private:
+	using AlternativeParser = std::optional<Group>(*)(const std::string &,
+		ReportPart,
+		const ReportMetadata &);
+
+	template <size_t I>
+	static std::optional<Group> parseOnly(const std::string & group,
+		ReportPart reportPart,
+		const ReportMetadata & reportMetadata)
+	{
+		using Alternative = std::variant_alternative_t<I, Group>;
+		const auto startTime = ParseStatsRecorder::now();
+		auto parsed = Alternative::parse(group, reportPart, reportMetadata);
+		ParseStatsRecorder::parse(I, parsed.has_value(), startTime);
+		if (!parsed.has_value()) return std::optional<Group>();
+		return Group(std::move(*parsed));
+	}
+
+	template <size_t... I>
+	static constexpr std::array<AlternativeParser, sizeof...(I)> parsers(
+		std::index_sequence<I...>)
+	{
+		return {{ &parseOnly<I>... }};
+	}
+
+	static const inline auto alternativeParsers =
+		parsers(std::make_index_sequence<GroupParseOrder::size>());
+
 	template <size_t I>
 	static Group parseAlternative(const std::string & group,
 		ReportPart reportPart,
@@ -2050,35 +2540,366 @@ private:
 	{
 		using Alternative = std::variant_alternative_t<I, Group>;
 		if constexpr (!std::is_same<Alternative, FallbackGroup>::value) {
+			const auto startTime = ParseStatsRecorder::now();
 			const auto parsed = Alternative::parse(group, reportPart, reportMetadata);
+			ParseStatsRecorder::parse(I, parsed.has_value(), startTime);
 			if (parsed.has_value()) return parsed.value();
 		}
 		if constexpr (I < std::variant_size_v<Group> - 1) {
 			return parseAlternative<I+1>(group, reportPart, reportMetadata);
 		}
+		// Fallback group is counted as parsed when all other alternatives fail
+		ParseStatsRecorder::parse(I, true, ParseStatsRecorder::now());
 		return FallbackGroup();
 	}
 };
 
-struct ParseResult {
+// Bounded cache of parsed groups, used to avoid parsing again the group
+// strings which are repeated often (e.g. NOSIG, CAVOK, 9999, NSC, AO2)
+// Cached group is found by group string, report part, and the bits of report
+// metadata which may affect the parse result; the groups which depend on
+// report time value (weather events in remarks) are never cached
+// Least recently used group is evicted when the cache is full
+// The cache is not thread-safe and must not be shared between threads; use
+// a separate instance per thread, e.g. the one returned by threadCache()
+class GroupCache {
+public:
+	struct Stats {
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		// Parsed groups which were not cached because they depend on report time
+		std::uint64_t bypassed = 0;
+		std::uint64_t evictions = 0;
+		std::size_t size = 0;
+		double hitRate() const {
+			const auto total = hits + misses;
+			if (!total) return 0.0;
+			return (static_cast<double>(hits) / total);
+		}
+	};
+
+	explicit GroupCache(std::size_t capacity = defaultCapacity) :
+		cacheCapacity(capacity) {}
+	METAF_INLINE Group parse(const std::string & group,
+		ReportPart reportPart,
+		const ReportMetadata & reportMetadata,
+		const GroupParseOrder * order = nullptr);
+	std::size_t capacity() const { return cacheCapacity; }
+	Stats stats() const { auto s = cacheStats; s.size = index.size(); return s; }
+	METAF_INLINE void clear();
+
+	static GroupCache & threadCache() {
+		static thread_local GroupCache cache;
+		return cache;
+	}
+
+private:
+	static const inline std::size_t defaultCapacity = 1024;
+	struct Entry {
+		std::string key;
+		Group group;
+	};
+	std::size_t cacheCapacity;
+	// Most recently used entries are at the beginning of the list
+	std::list<Entry> entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> index;
+	Stats cacheStats;
+
+	static METAF_INLINE std::string key(const std::string & group,
+		ReportPart reportPart,
+		const ReportMetadata & reportMetadata);
+	static METAF_INLINE bool isCacheable(const Group & group, ReportPart reportPart);
+};
+
+// Positions of report sections in ParseResult::groups, so that the groups of
+// a certain section can be accessed without scanning all groups
+// Sections follow each other in the order header, body, trends, remarks, 
+// each section is a range [begin, end) of group indices
+template <typename Allocator = std::allocator<char>>
+struct BasicReportSections {
+	static const inline std::size_t notFound = std::numeric_limits<std::size_t>::max();
+	struct Range {
+		std::size_t begin = 0;
+		std::size_t end = 0;
+		std::size_t size() const { return end - begin; }
+		bool empty() const { return begin == end; }
+	};
+	// Trend period begins with TrendGroup and lasts until next TrendGroup,
+	// until remarks, or until the end of report
+	struct Trend {
+		std::size_t trendGroup = 0;	// Index of TrendGroup
+		Range range;
+	};
+
+	using Trends = std::vector<Trend,
+		typename std::allocator_traits<Allocator>::template rebind_alloc<Trend>>;
+
+	Range header;	// Report type, location, report time, TAF validity time
+	Range body;		// METAR observation or TAF prevailing conditions
+	Trends trends;
+	Range remarks;	// Begins with RMK group
+	// Index of first occurrence of each Group alternative, or notFound
+	std::array<std::size_t, std::variant_size_v<Group>> first;
+
+	BasicReportSections() { first.fill(notFound); }
+	explicit BasicReportSections(const Allocator & alloc) : trends(alloc) {
+		first.fill(notFound);
+	}
+	template <typename T>
+	std::size_t firstOf() const { return first[groupIndex<T>()]; }
+
+	// Index of Group alternative
+	template <typename T, std::size_t I = 0>
+	static constexpr std::size_t groupIndex() {
+		static_assert(I < std::variant_size_v<Group>, "Type is not a Group alternative");
+		if constexpr (std::is_same_v<T, std::variant_alternative_t<I, Group>>) {
+			return I;
+		} else {
+			return groupIndex<T, I + 1>();
+		}
+	}
+	// Groups is a vector of BasicGroupInfo
+	template <typename Groups>
+	inline void index(const Groups & groups);
+};
+
+using ReportSections = BasicReportSections<>;
+
+// All memory used by parse result is allocated using the specified allocator
+template <typename Allocator>
+struct BasicParseResult {
+	using allocator_type = Allocator;
+	using GroupInfo = BasicGroupInfo<Allocator>;
+	using Groups = std::vector<GroupInfo,
+		typename std::allocator_traits<Allocator>::template rebind_alloc<GroupInfo>>;
+
+	BasicParseResult() = default;
+	explicit BasicParseResult(const Allocator & alloc) :
+		groups(alloc), sections(alloc) {}
+	BasicParseResult(const BasicParseResult & other) = default;
+	BasicParseResult(BasicParseResult && other) = default;
+	// Allocator-extended constructors used by allocator-aware containers
+	BasicParseResult(const BasicParseResult & other, const Allocator & alloc) :
+		BasicParseResult(alloc) { *this = other; }
+	BasicParseResult(BasicParseResult && other, const Allocator & alloc) :
+		BasicParseResult(alloc) { *this = std::move(other); }
+	BasicParseResult & operator=(const BasicParseResult & other) = default;
+	BasicParseResult & operator=(BasicParseResult && other) = default;
+
+	ReportMetadata reportMetadata;
+	Groups groups;
+	// Updated by Parser
+	BasicReportSections<Allocator> sections;
+};
+
+// Parse result using default allocator; a distinct type rather than alias so
+// that it can still be forward-declared as struct ParseResult
+struct ParseResult : BasicParseResult<> {
+	using BasicParseResult::BasicParseResult;
+	ParseResult() = default;
+	ParseResult(const BasicParseResult & other) : BasicParseResult(other) {}
+	ParseResult(BasicParseResult && other) : BasicParseResult(std::move(other)) {}
+};
+
+// Group info which refers to the raw string stored in CompactParseResult
+struct CompactGroupInfo {
+	Group group;
+	ReportPart reportPart;
+	// Raw string position in CompactParseResult::text
+	std::uint32_t begin;
+	std::uint32_t end;
+};
+
+// Parse result where raw strings of all groups are stored in a single
+// normalized copy of the report (groups separated by single delimiter char)
+// rather than in a separate string for each group; this saves memory and an
+// allocation per group, since the text buffer is re-used when the result is
+// used to parse many reports
+struct CompactParseResult {
 	ReportMetadata reportMetadata;
-	std::vector<GroupInfo> groups;
+	std::vector<CompactGroupInfo> groups;
+	// Updated by Parser
+	ReportSections sections;
+	std::string text;
+
+	std::string_view rawString(const CompactGroupInfo & groupInfo) const {
+		return std::string_view(text).substr(groupInfo.begin,
+			groupInfo.end - groupInfo.begin);
+	}
+	std::string_view rawString(std::size_t index) const {
+		return rawString(groups.at(index));
+	}
+	GroupInfo groupInfo(std::size_t index) const {
+		const auto & gi = groups.at(index);
+		return GroupInfo(gi.group, gi.reportPart, std::string(rawString(gi)));
+	}
+	METAF_INLINE ParseResult toParseResult() const;
+};
+
+// Limits of the parser's work on a single report, which bound the time
+// needed to parse the report from untrusted source; parsing stops before
+// the group string which exceeds any of the limits and the error is set
+// in report metadata
+// Conversion from the number keeps the group limit argument of the
+// parser's functions compatible
+struct ParseLimits {
+	ParseLimits(std::size_t groupLimit = 100) : groups(groupLimit) {}
+	// Number of groups, REPORT_TOO_LARGE if exceeded
+	std::size_t groups;
+	// Length of a single group string, GROUP_TOO_LONG if exceeded
+	std::size_t groupLength = 256;
+	// Number of characters before the end of the report including
+	// delimiters, REPORT_TOO_LONG if exceeded; trailing delimiters are not
+	// counted
+	std::size_t reportLength = 16384;
+	// Number of characters passed to the group decoders and append()
+	// including repeated attempts, WORK_LIMIT_EXCEEDED if exceeded; with
+	// the default limits above the work limit cannot be reached
+	std::size_t work = 65536;
 };
 
+class LazyParseResult;
+
 class Parser {
 public:
-	static inline ParseResult parse (const std::string & report, size_t groupLimit = 100); 
+	static METAF_INLINE ParseResult parse (const std::string & report,
+		const ParseLimits & limits = ParseLimits());
+	// Group strings are parsed using cache
+	static METAF_INLINE ParseResult parse (const std::string & report,
+		GroupCache & cache,
+		const ParseLimits & limits = ParseLimits());
+	// Group alternatives are attempted in the specified order
+	static METAF_INLINE ParseResult parse (const std::string & report,
+		const GroupParseOrder & order,
+		const ParseLimits & limits = ParseLimits());
+	static METAF_INLINE ParseResult parse (const std::string & report,
+		GroupCache & cache,
+		const GroupParseOrder & order,
+		const ParseLimits & limits = ParseLimits());
+	// Previous content of the result is replaced; the memory allocated for
+	// result's groups is re-used; groups and their raw strings are allocated
+	// using the result's allocator (e.g. pmr::ParseResult)
+	template <typename Allocator>
+	static inline void parse (const std::string & report,
+		BasicParseResult<Allocator> & result,
+		GroupCache & cache,
+		const ParseLimits & limits = ParseLimits());
+	// METAR remarks are not decoded until LazyParseResult::parseResult() is
+	// called; previous content of the result is replaced
+	static METAF_INLINE void parse (const std::string & report,
+		LazyParseResult & result,
+		const ParseLimits & limits = ParseLimits());
+	static METAF_INLINE void parse (const std::string & report,
+		LazyParseResult & result,
+		GroupCache & cache,
+		const ParseLimits & limits = ParseLimits());
+	// Raw strings are stored as positions in the text of the result; the
+	// memory allocated for the result's groups and text is re-used
+	static METAF_INLINE void parse (const std::string & report,
+		CompactParseResult & result,
+		GroupCache & cache,
+		const ParseLimits & limits = ParseLimits());
+	// Parses the report re-using the groups decoded in the previous result,
+	// e.g. when the report is a correction or amendment of the previous
+	// one; only the groups which were changed, moved to a different report
+	// part or depend on the changed report time are decoded again
+	// Result is the same as if the report was parsed in full; previous
+	// result must not be the same object as result
+	static METAF_INLINE ParseResult reparse(const std::string & report,
+		const ParseResult & previous,
+		const ParseLimits & limits = ParseLimits());
+	static METAF_INLINE void reparse(const std::string & report,
+		const ParseResult & previous,
+		ParseResult & result,
+		GroupCache & cache,
+		const ParseLimits & limits = ParseLimits());
 
 private:
-	static inline bool appendToLastResultGroup(ParseResult & result,
+	friend class LazyParseResult;
+	// Group of the previous result which may be re-used for the group
+	// string at the same position in the report being parsed
+	struct ReusableGroup {
+		const GroupInfo * groupInfo = nullptr;
+		// Report time used when the group was decoded
+		std::optional<MetafTime> reportTime;
+	};
+	using ReusableGroups = std::vector<ReusableGroup>;
+	// Result is BasicParseResult or CompactParseResult
+	template <typename Result>
+	static inline void parseReport(const std::string & report,
+		const ParseLimits & limits,
+		GroupCache * cache,
+		const GroupParseOrder * order,
+		Result & result,
+		const ReusableGroups * reusable = nullptr);
+	static METAF_INLINE Group parseGroup(const std::string & group,
+		ReportPart reportPart,
+		const ReportMetadata & reportMetadata,
+		GroupCache * cache,
+		const GroupParseOrder * order);
+	static METAF_INLINE Group parseGroup(const std::string & group,
+		ReportPart reportPart,
+		const ReportMetadata & reportMetadata,
+		GroupCache * cache,
+		const GroupParseOrder * order,
+		const ReusableGroup * reusable);
+	// Finds the groups of the previous result which are decoded from the
+	// same group strings as the groups of the report
+	static METAF_INLINE void findReusableGroups(const std::string & report,
+		std::size_t reportLength,
+		const ParseResult & previous,
+		ReusableGroups & reusable);
+	// Matches two sequences of group strings with minimum number of
+	// insertions and deletions (Myers' diff algorithm); for each string in
+	// b stores the index of matching string in a or std::string::npos
+	static METAF_INLINE void matchGroupStrings(const std::vector<std::string_view> & a,
+		const std::vector<std::string_view> & b,
+		std::vector<std::size_t> & match);
+	static METAF_INLINE bool isSameTime(const std::optional<MetafTime> & t1,
+		const std::optional<MetafTime> & t2);
+	template <typename Result>
+	static inline bool appendToLastResultGroup(Result & result,
 		const std::string & groupStr,
 		ReportPart reportPart,
 		const ReportMetadata & reportMetadata);
-	static inline void addGroupToResult(ParseResult & result,
+	template <typename Result>
+	static inline void addGroupToResult(Result & result,
 		Group group,
 		ReportPart reportPart,
 		std::string groupString);
-	static inline void updateMetadata(const Group & group,
+	// Raw string storage of the results
+	template <typename Allocator>
+	static inline void clearResult(BasicParseResult<Allocator> & result,
+		const std::string & report);
+	static METAF_INLINE void clearResult(CompactParseResult & result,
+		const std::string & report);
+	template <typename Allocator>
+	static inline void addRawGroup(BasicParseResult<Allocator> & result,
+		Group group,
+		ReportPart reportPart,
+		std::string rawString);
+	static METAF_INLINE void addRawGroup(CompactParseResult & result,
+		Group group,
+		ReportPart reportPart,
+		const std::string & rawString);
+	// Appends delimiter and string to raw string of the last group
+	template <typename Allocator>
+	static inline void appendRawString(BasicParseResult<Allocator> & result,
+		const std::string & str);
+	static METAF_INLINE void appendRawString(CompactParseResult & result,
+		const std::string & str);
+	// Removes last group and returns its raw string
+	template <typename Allocator>
+	static inline std::string removeLastGroup(BasicParseResult<Allocator> & result);
+	static METAF_INLINE std::string removeLastGroup(CompactParseResult & result);
+	template <typename Allocator>
+	static std::size_t rawStringLength(const BasicGroupInfo<Allocator> & groupInfo) {
+		return groupInfo.rawString.length();
+	}
+	static std::size_t rawStringLength(const CompactGroupInfo & groupInfo) {
+		return groupInfo.end - groupInfo.begin;
+	}
+	static METAF_INLINE void updateMetadata(const Group & group,
 		ReportMetadata & reportMetadata);
 
 	class Status {
@@ -2090,9 +2911,9 @@ private:
 		ReportType getReportType() { return reportType; }
 		ReportError getError() { return reportError; }
 		bool isError() { return (reportError != ReportError::NONE); }
-		inline ReportPart getReportPart();
-		inline void transition(SyntaxGroup group);
-		inline void finalTransition();
+		METAF_INLINE ReportPart getReportPart();
+		METAF_INLINE void transition(SyntaxGroup group);
+		METAF_INLINE void finalTransition();
 		bool isReparseRequired() {
 			return (state == State::REPORT_BODY_BEGIN_METAR_REPEAT_PARSE);
 		}
@@ -2120,18 +2941,85 @@ private:
 		void setState(State s) { state = s; }
 		void setReportType(ReportType rt) { reportType = rt; }
 
-		inline void transitionFromReportTypeOrLocation(SyntaxGroup group);
-		inline void transitionFromCorrecton(SyntaxGroup group);
-		inline void transitionFromReportTime(SyntaxGroup group);
-		inline void transitionFromTimeSpan(SyntaxGroup group);
-		inline void transitionFromReportBodyBeginMetar(SyntaxGroup group);
-		inline void transitionFromReportBodyMetar(SyntaxGroup group);
-		inline void transitionFromReportBodyBeginTaf(SyntaxGroup group);
-		inline void transitionFromReportBodyTaf(SyntaxGroup group);
+		METAF_INLINE void transitionFromReportTypeOrLocation(SyntaxGroup group);
+		METAF_INLINE void transitionFromCorrecton(SyntaxGroup group);
+		METAF_INLINE void transitionFromReportTime(SyntaxGroup group);
+		METAF_INLINE void transitionFromTimeSpan(SyntaxGroup group);
+		METAF_INLINE void transitionFromReportBodyBeginMetar(SyntaxGroup group);
+		METAF_INLINE void transitionFromReportBodyMetar(SyntaxGroup group);
+		METAF_INLINE void transitionFromReportBodyBeginTaf(SyntaxGroup group);
+		METAF_INLINE void transitionFromReportBodyTaf(SyntaxGroup group);
 		State state;
 		ReportType reportType;
 		ReportError reportError;
 	};
+
+	// Parser state carried from one group of the report to the next, which
+	// allows to stop parsing before the remarks and resume later
+	struct Progress {
+		Status status;
+		ReportMetadata reportMetadata;
+		size_t groupCount = 0;
+		size_t work = 0;
+	};
+	// If stopBeforeRemarks is true, stops before the first group of METAR
+	// remarks and returns its position in the report; otherwise parses all
+	// groups and returns std::string::npos
+	template <typename Result>
+	static inline std::size_t parseGroups(const std::string & report,
+		const ParseLimits & limits,
+		GroupCache * cache,
+		const GroupParseOrder * order,
+		Progress & progress,
+		Result & result,
+		bool stopBeforeRemarks = false,
+		const ReusableGroups * reusable = nullptr);
+	template <typename Result>
+	static inline void finishReport(Progress & progress, Result & result);
+	static METAF_INLINE void parseLazy(const std::string & report,
+		const ParseLimits & limits,
+		GroupCache * cache,
+		LazyParseResult & result);
+	static METAF_INLINE void decodeRemarks(LazyParseResult & result, GroupCache * cache);
+	// Decodes the remarks when accessed, traced as a separate report
+	static METAF_INLINE void decodeDeferredRemarks(LazyParseResult & result, GroupCache * cache);
+};
+
+// Parse result where METAR remarks are decoded only when accessed
+// Header, body and trends are always decoded, since the syntax check and
+// group boundaries depend on the decoded groups, but remarks do not affect
+// the rest of the report; this saves time and memory when only the
+// observed or forecast conditions are needed
+class LazyParseResult {
+public:
+	// Report metadata is final and does not depend on whether the remarks
+	// are decoded
+	const ReportMetadata & reportMetadata() const { return result.reportMetadata; }
+	bool isDecoded() const { return !deferred; }
+	// Raw text of the remarks which are not decoded yet, or empty string
+	std::string_view remarks() const {
+		return (deferred ? std::string_view(remarksText) : std::string_view());
+	}
+	// Groups decoded so far; until the remarks are decoded, the last group is
+	// RMK and sections.remarks contains only this group
+	const ParseResult & partialResult() const { return result; }
+	// Decodes the remarks on the first call
+	const ParseResult & parseResult() {
+		if (deferred) Parser::decodeDeferredRemarks(*this, nullptr);
+		return result;
+	}
+	const ParseResult & parseResult(GroupCache & cache) {
+		if (deferred) Parser::decodeDeferredRemarks(*this, &cache);
+		return result;
+	}
+
+private:
+	friend class Parser;
+	ParseResult result;
+	bool deferred = false;
+	std::string remarksText;
+	Parser::Progress progress;
+	ParseLimits limits;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2145,6 +3033,13 @@ public:
 	inline T visit(const GroupInfo & groupInfo) {
 		return visit(groupInfo.group, groupInfo.reportPart, groupInfo.rawString);
 	}
+	// Raw string is copied to std::string for the visit functions
+	template <typename Allocator>
+	inline T visit(const BasicGroupInfo<Allocator> & groupInfo) {
+		return visit(groupInfo.group,
+			groupInfo.reportPart,
+			std::string(groupInfo.rawString.data(), groupInfo.rawString.length()));
+	}
 protected:
 	virtual T visitFixedGroup(
 		const FixedGroup & group,
@@ -2441,80 +3336,1216 @@ inline void Visitor<void>::visit(const GroupInfo & groupInfo) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-inline std::optional<unsigned int> strToUint(const std::string & str,
-	std::size_t startPos,
-	std::size_t digits);
+// Observed conditions from multiple reports stored as one array per field 
+// (structure of arrays); element N of each array belongs to the N-th report
+struct ObservationColumns {
+	// Value is not reported or not present in the report
+	static const inline float notReported = std::numeric_limits<float>::quiet_NaN();
+	// Ceiling is not limited by cloud layers or vertical visibility
+	static const inline float unlimited = std::numeric_limits<float>::infinity();
+	static bool isReported(float value) { return !std::isnan(value); }
+
+	std::vector<float> windDirection;	// Degrees, not reported for calm or variable wind
+	std::vector<float> windSpeed;		// Knots
+	std::vector<float> gustSpeed;		// Knots
+	std::vector<float> visibility;		// Prevailing visibility, meters
+	std::vector<float> ceiling;			// Lowest BKN/OVC layer or vertical visibility, feet
+	std::vector<float> airTemperature;	// Degrees Celsius
+	std::vector<float> dewPoint;		// Degrees Celsius
+	std::vector<float> pressure;		// Observed QNH, hectopascal
+	// Weather codes of N-th report are stored in weather array from index 
+	// weatherOffset[N] to weatherOffset[N+1] (exclusive), see weatherCode()
+	std::vector<std::uint32_t> weather;
+	std::vector<std::size_t> weatherOffset = std::vector<std::size_t>(1);
+
+	std::size_t size() const { return windDirection.size(); }
+	METAF_INLINE void reserve(std::size_t reports);
+	METAF_INLINE void clear();
+
+	// Weather code packs weather phenomena into 32-bit value: bits 0-7, 8-15 
+	// and 16-23 are WeatherPhenomena::Weather, bits 24-27 are descriptor,
+	// and bits 28-31 are qualifier
+	METAF_INLINE static std::uint32_t weatherCode(const WeatherPhenomena & wp);
+	static WeatherPhenomena::Qualifier weatherCodeQualifier(std::uint32_t code) {
+		return static_cast<WeatherPhenomena::Qualifier>(code >> 28);
+	}
+	static WeatherPhenomena::Descriptor weatherCodeDescriptor(std::uint32_t code) {
+		return static_cast<WeatherPhenomena::Descriptor>((code >> 24) & 0xF);
+	}
+	static WeatherPhenomena::Weather weatherCodeWeather(std::uint32_t code, 
+		std::size_t index)
+	{
+		return static_cast<WeatherPhenomena::Weather>((code >> (index * 8)) & 0xFF);
+	}
+};
 
-inline std::optional<std::pair<unsigned int, unsigned int> > fractionStrToUint(
-	const std::string & str,
-	std::size_t startPos,
-	std::size_t length);
+// Fills ObservationColumns from METAR or TAF reports; only report body before
+// the first trend is considered, the trends and remarks are ignored
+class ObservationExtractor {
+public:
+	static METAF_INLINE void extract(const ParseResult & parseResult,
+		ObservationColumns & columns);
+	static METAF_INLINE void extract(const std::vector<ParseResult> & parseResults,
+		ObservationColumns & columns);
+
+	// Lowers ceiling in feet if cloud group reports BKN, OVC or vertical 
+	// visibility below it; other cloud amounts set not reported ceiling to 
+	// ObservationColumns::unlimited
+	static METAF_INLINE void updateCeiling(const CloudGroup & group,
+		float & ceilingFeet);
+private:
+	static METAF_INLINE void extractGroup(const Group & group, 
+		ObservationColumns & columns);
+};
 
-} //namespace metaf
+// Batch versions of unit conversions and derived values calculation which 
+// process contiguous arrays of values; the loops are branch-free to allow 
+// auto-vectorisation by compiler
+// Element N of input arrays is only used if valid[N] is non-zero; result is 
+// ObservationColumns::notReported for the elements which are not valid
+class BatchConverter {
+public:
+	static METAF_INLINE void validityMask(std::size_t size,
+		const float * values,
+		std::uint8_t * valid);
+
+	static METAF_INLINE void speedToUnit(std::size_t size,
+		const float * speed,
+		const std::uint8_t * valid,
+		Speed::Unit unit,
+		Speed::Unit resultUnit,
+		float * result);
+	static METAF_INLINE void distanceToUnit(std::size_t size,
+		const float * distance,
+		const std::uint8_t * valid,
+		Distance::Unit unit,
+		Distance::Unit resultUnit,
+		float * result);
+	static METAF_INLINE void pressureToUnit(std::size_t size,
+		const float * pressure,
+		const std::uint8_t * valid,
+		Pressure::Unit unit,
+		Pressure::Unit resultUnit,
+		float * result);
+	static METAF_INLINE void temperatureToUnit(std::size_t size,
+		const float * temperature,
+		const std::uint8_t * valid,
+		Temperature::Unit unit,
+		Temperature::Unit resultUnit,
+		float * result);
+
+	static METAF_INLINE void relativeHumidity(std::size_t size,
+		const float * airTemperatureC,
+		const float * dewPointC,
+		const std::uint8_t * valid,
+		float * result);
+	static METAF_INLINE void heatIndex(std::size_t size,
+		const float * airTemperatureC,
+		const float * relativeHumidity,
+		const std::uint8_t * valid,
+		float * result,
+		std::uint8_t * resultValid);
+	static METAF_INLINE void windChill(std::size_t size,
+		const float * airTemperatureC,
+		const float * windSpeedKmh,
+		const std::uint8_t * valid,
+		float * result,
+		std::uint8_t * resultValid);
 
-///////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////
+private:
+	static METAF_INLINE void linear(std::size_t size,
+		const float * values,
+		const std::uint8_t * valid,
+		float factor,
+		float offset,
+		float * result);
+	static METAF_INLINE float select(bool condition, float valueTrue, float valueFalse);
+	static METAF_INLINE float exp(float x);
+	static METAF_INLINE float log(float x);
+};
 
-namespace metaf {
+// Forecast conditions specified in the TAF report or in a TAF trend
+// Optional values which are not set and empty vectors mean that the
+// conditions are not specified (i.e. not changed by the trend)
+struct TafConditions {
+	std::optional<WindGroup> wind;
+	std::optional<VisibilityGroup> visibility;
+	std::vector<CloudGroup> clouds;
+	std::vector<WeatherGroup> weather;
+	bool cavok = false;
+	bool nsw = false;
+};
 
-std::optional<unsigned int> strToUint(const std::string & str,
-	std::size_t startPos,
-	std::size_t digits)
-{
-	std::optional<unsigned int> error;
-	if (str.empty() || !digits || startPos + digits > str.length()) return error;
-	unsigned int value = 0;
-	for (auto [i,c] = std::pair(0u, str.c_str() + startPos); i < digits; i++, c++) {
-		if (*c < '0' || *c > '9') return error;
-		static const auto decimalRadix = 10u;
-		value = value * decimalRadix + (*c - '0');
-	}
-	return value;
-}
+// TAF report compiled into the sorted intervals of prevailing and temporary
+// conditions; allows to quickly find which conditions apply at certain time
+// or during certain time span
+// Prevailing periods do not overlap and cover the entire validity time of
+// the TAF; BECMG trends are resolved, so that each prevailing period contains
+// complete forecast conditions rather than only changes
+// Temporary periods (TEMPO, INTER and PROB trends) may overlap, and contain
+// only the conditions which temporarily differ from prevailing conditions
+// All time spans include beginning time and exclude end time; the trends
+// which are out of chronological order are ignored
+class TafTimeline {
+public:
+	struct Period {
+		MetafTime from;
+		MetafTime till;
+		// Trend which begins this period, or TAF validity time span for the
+		// first prevailing period
+		TrendGroup trend;
+		// Conditions gradually change from those of previous period during
+		// BECMG transition period
+		bool isTransition = false;
+		TafConditions conditions;
+	};
+	using Indices = std::pair<std::size_t, std::size_t>;
+
+	MetafTime validFrom() const { return prevailingPeriods.front().from; }
+	MetafTime validTill() const { return prevailingPeriods.back().till; }
+	const std::vector<Period> & prevailing() const { return prevailingPeriods; }
+	const std::vector<Period> & temporary() const { return temporaryPeriods; }
+
+	// Index of prevailing period at certain time
+	METAF_INLINE std::optional<std::size_t> prevailingAt(const MetafTime & time) const;
+	// Temporary periods at certain time; the indices of temporary periods are
+	// stored in activeTemporary() from first (inclusive) to last (exclusive)
+	METAF_INLINE Indices temporaryAt(const MetafTime & time) const;
+	const std::vector<std::size_t> & activeTemporary() const {
+		return segmentTemporary;
+	}
+	// Indices of prevailing periods during certain time span, first to last
+	// (exclusive) elements of the vector returned by prevailing()
+	METAF_INLINE Indices prevailingBetween(const MetafTime & from,
+		const MetafTime & till) const;
+	// Indices of temporary periods during certain time span (sorted)
+	METAF_INLINE std::vector<std::size_t> temporaryBetween(const MetafTime & from,
+		const MetafTime & till) const;
+
+	static METAF_INLINE std::optional<TafTimeline> fromParseResult(
+		const ParseResult & parseResult);
 
-std::optional<std::pair<unsigned int, unsigned int> >
-	fractionStrToUint(const std::string & str,
-		std::size_t startPos,
-		std::size_t length)
-{
-	//Equivalent regex "(\\d\\d?)/(\\d\\d?)"
-	std::optional<std::pair<unsigned int, unsigned int> > error;
-	if (length + startPos > str.length()) length = str.length() - startPos;
-	const int endPos = startPos + length;
+private:
+	TafTimeline() = default;
+
+	// Time converted to minutes since beginning of the month of TAF
+	// validity; days of the next month follow the last possible day of the
+	// month so that the sequence remains monotonic
+	METAF_INLINE int timeKey(const MetafTime & time) const;
+	METAF_INLINE std::size_t segment(int key) const;
+	METAF_INLINE void addPeriod(const TrendGroup & trend,
+		const TafConditions & conditions);
+	METAF_INLINE void buildSegments();
+
+	static METAF_INLINE void addGroup(const Group & group, TafConditions & conditions);
+	static METAF_INLINE void applyChanges(const TafConditions & changes,
+		TafConditions & conditions);
+
+	std::vector<Period> prevailingPeriods;
+	std::vector<Period> temporaryPeriods;
+	std::vector<int> prevailingBegin;
+	std::vector<int> temporaryBegin;
+	std::vector<int> temporaryEnd;
+	// Elementary time segments between all period boundaries; segment N
+	// begins at segmentBegin[N] and ends at segmentBegin[N+1]; temporary
+	// periods active during segment N are listed in segmentTemporary from
+	// index segmentOffset[N] (inclusive) to segmentOffset[N+1] (exclusive)
+	std::vector<int> segmentBegin;
+	std::vector<std::size_t> segmentOffset;
+	std::vector<std::size_t> segmentTemporary;
+	unsigned int referenceDay = 0;
+	int referenceKey = 0;
+	int endKey = 0;
+};
 
-	const auto slashPos = str.find('/', startPos);
-	if (slashPos == std::string::npos) return error;
+// Flight category, ordered from least to most restrictive
+enum class FlightCategory {
+	UNKNOWN,
+	VFR,
+	MVFR,
+	IFR,
+	LIFR
+};
 
-	static const int minDigits = 1, maxDigits = 2;
+// Determines flight category from ceiling (lowest BKN, OVC or vertical
+// visibility) and prevailing visibility; the most restrictive of the
+// categories determined by ceiling and by visibility is used
+// Batch versions store the results in the array provided by caller and do
+// not allocate memory
+class FlightCategoryClassifier {
+public:
+	enum class Mode {
+		// All groups of the report body are checked
+		FULL,
+		// Checking stops once no further group can change the category: when
+		// LIFR is reached, after CAVOK, or at the first ceiling layer once
+		// visibility is known (cloud layers are reported in ascending order)
+		EARLY_EXIT
+	};
 
-	const int numeratorPos = startPos;
-	const int numeratorLength = slashPos - startPos;
-	if (numeratorLength < minDigits || numeratorLength > maxDigits) return error;
-	const int denominatorPos = slashPos + 1;
-	const int denominatorLength = endPos - denominatorPos;
-	if (denominatorLength < minDigits || denominatorLength > maxDigits) return error;
+	static METAF_INLINE FlightCategory fromCeilingVisibility(float ceilingFeet,
+		float visibilityMiles);
+
+	// Only report body before the first trend is used
+	static METAF_INLINE FlightCategory classify(const ParseResult & parseResult,
+		Mode mode = Mode::FULL);
+	static METAF_INLINE void classify(const std::vector<ParseResult> & parseResults,
+		FlightCategory * result,
+		Mode mode = Mode::FULL);
+
+	static METAF_INLINE FlightCategory classify(const TafConditions & conditions);
+	// Result arrays must be at least the size of timeline.prevailing() and
+	// timeline.temporary() respectively
+	static METAF_INLINE void classify(const TafTimeline & timeline,
+		FlightCategory * prevailing,
+		FlightCategory * temporary);
+	// Most restrictive of prevailing and temporary conditions at certain time
+	static METAF_INLINE FlightCategory classifyAt(const TafTimeline & timeline,
+		const MetafTime & time);
 
-	const auto numerator = strToUint(str, numeratorPos, numeratorLength);
-	const auto denominator = strToUint(str, denominatorPos, denominatorLength);
-	if (!numerator.has_value() || !denominator.has_value()) return error;
-	return std::pair(numerator.value(), denominator.value());
-}
+private:
+	// Ceiling height in feet and visibility in statute miles
+	static const inline float lifrCeiling = 500;
+	static const inline float ifrCeiling = 1000;
+	static const inline float mvfrCeiling = 3000;
+	static const inline float lifrVisibility = 1;
+	static const inline float ifrVisibility = 3;
+	static const inline float mvfrVisibility = 5;
+
+	// Returns true if no further group can change ceiling
+	static METAF_INLINE bool checkGroup(const Group & group,
+		float & ceilingFeet,
+		float & visibilityMiles);
+};
 
-std::optional<Runway> Runway::fromString(const std::string & s, bool enableRwy) {
-	//static const std::regex rgx("R(?:WY)?(\\d\\d)([RLC])?");
-	static const std::optional<Runway> error;
-	if (s.length() < 3) return error;
-	if (s[0] != 'R') return error;
-	auto numPos = 1u;
-	if (enableRwy && s[1] == 'W' && s[2] == 'Y') numPos += 2;
-	const auto rwyNum = strToUint(s, numPos, 2);
-	if (!rwyNum.has_value()) return error;
-	const auto dsgPos = numPos + 2;
-	if (s.length() > dsgPos + 1) return error;
-	Runway runway;
-	runway.rNumber = rwyNum.value();
-	if ( s.length() > dsgPos) {
-		const auto designator = designatorFromChar(s[dsgPos]);
+// Summary of current weather at a station based on the latest METAR and TAF
+// (from METAR if available, otherwise from the prevailing conditions of TAF)
+// Fixed-size record, does not allocate memory
+struct CurrentWeather {
+	enum class Source : std::uint8_t {
+		NONE,	// Neither METAR nor TAF could be parsed
+		METAR,
+		TAF
+	};
+	enum class Cloud : std::uint8_t {
+		NOT_REPORTED,
+		CLEAR,
+		MOSTLY_CLEAR,
+		MOSTLY_CLOUDY,
+		OVERCAST
+	};
+	static const inline float notReported = std::numeric_limits<float>::quiet_NaN();
+	static bool isReported(float value) { return !std::isnan(value); }
+	static const inline std::size_t maxWeather = 8;
+
+	Source source = Source::NONE;
+	Cloud cloud = Cloud::NOT_REPORTED;
+	bool isWindVariable = false;
+	bool isStormClouds = false;			// Cumulonimbus or towering cumulus
+	float windDirection = notReported;	// Degrees
+	float windSpeed = notReported;		// Knots
+	float gustSpeed = notReported;		// Knots
+	float visibility = notReported;		// Prevailing visibility, meters
+	float airTemperature = notReported;	// Degrees Celsius
+	// Wind chill or heat index if applicable, otherwise air temperature
+	float perceivedTemperature = notReported;	// Degrees Celsius
+	float airTemperatureHigh = notReported;	// Forecast by TAF, degrees Celsius
+	float airTemperatureLow = notReported;	// Forecast by TAF, degrees Celsius
+	float relativeHumidity = notReported;	// Percent
+	float pressure = notReported;		// Observed QNH, hectopascal
+	std::optional<MetafTime> reportTime;
+	// Weather phenomena packed by ObservationColumns::weatherCode(); only the
+	// first maxWeather phenomena are stored
+	std::array<std::uint32_t, maxWeather> weather {};
+	std::uint8_t weatherSize = 0;
+};
+
+// Extracts current weather from pairs of METAR and TAF reports
+// Extractor does not have a state; batch versions parse the reports using 
+// the group cache provided by caller (or the cache of the current thread) and
+// store the results in the array provided by caller, so that batches may be 
+// processed in parallel by calling extract() for different ranges of reports
+// from different threads
+class CurrentWeatherExtractor {
+public:
+	using Reports = std::pair<std::string, std::string>; // METAR and TAF
+
+	static METAF_INLINE CurrentWeather extract(const ParseResult & metar,
+		const ParseResult & taf);
+	static METAF_INLINE CurrentWeather extract(const Reports & reports,
+		GroupCache & cache = GroupCache::threadCache());
+	// Reports are parsed into the results provided by caller, so that the
+	// memory allocated for their groups is re-used for the next reports
+	static METAF_INLINE CurrentWeather extract(const Reports & reports,
+		ParseResult & metar,
+		ParseResult & taf,
+		GroupCache & cache = GroupCache::threadCache());
+	static METAF_INLINE void extract(const Reports * reports,
+		std::size_t size,
+		CurrentWeather * result,
+		GroupCache & cache = GroupCache::threadCache());
+	// Result vector is resized to the size of reports vector
+	static METAF_INLINE void extract(const std::vector<Reports> & reports,
+		std::vector<CurrentWeather> & result,
+		GroupCache & cache = GroupCache::threadCache());
+
+private:
+	static METAF_INLINE bool isValid(const ParseResult & parseResult, ReportType type);
+	static METAF_INLINE void extractMetar(const ParseResult & metar, CurrentWeather & result);
+	static METAF_INLINE void extractTaf(const ParseResult & taf, CurrentWeather & result);
+	static METAF_INLINE void extractTemperatureForecast(const ParseResult & taf,
+		CurrentWeather & result);
+	// Common for METAR and TAF
+	static METAF_INLINE void extractGroup(const Group & group,
+		CurrentWeather & result,
+		Speed & windSpeed);
+	static METAF_INLINE CurrentWeather::Cloud cloud(CurrentWeather::Cloud previous,
+		CloudGroup::Amount amount);
+};
+
+// Assigns dense integer IDs (0, 1, 2...) to the stations identified by
+// LocationGroup::key(), so that per-station data can be stored in arrays
+// indexed by station ID rather than in maps keyed by strings
+class StationRegistry {
+public:
+	using Id = std::uint32_t;
+	static const inline Id notFound = std::numeric_limits<Id>::max();
+
+	StationRegistry() = default;
+	// Loads station list; each line of the text begins with ICAO location, 
+	// the rest of the line is ignored; empty lines, lines beginning with #
+	// and lines beginning with invalid location are skipped
+	// Returns number of stations added
+	METAF_INLINE std::size_t load(std::string_view text);
+
+	// Returns ID of the station, the station is added if not registered yet
+	METAF_INLINE Id add(std::uint32_t key);
+	inline Id add(const LocationGroup & location) { return add(location.key()); }
+	METAF_INLINE Id find(std::uint32_t key) const;
+	inline Id find(const LocationGroup & location) const { return find(location.key()); }
+	// Returns ID of the station from report's location group or notFound
+	METAF_INLINE Id find(const ParseResult & parseResult) const;
+
+	std::uint32_t key(Id id) const { return keys.at(id); }
+	std::size_t size() const { return keys.size(); }
+	void reserve(std::size_t size) { keys.reserve(size); ids.reserve(size); }
+	void clear() { keys.clear(); ids.clear(); }
+
+private:
+	std::vector<std::uint32_t> keys;
+	std::unordered_map<std::uint32_t, Id> ids;
+};
+
+// Geographic index of the stations registered in StationRegistry, answers
+// radius and nearest-N queries; stations are stored in the grid of cells of 
+// 1 by 1 degree so that adding, moving or removing a station only updates 
+// the cell where the station is located, without rebuilding the index
+// The queries accept an optional filter which allows to join the index with
+// per-station data (e.g. the latest reports stored in array indexed by 
+// station ID): only the stations for which filter returns true are included
+class StationIndex {
+public:
+	using Id = StationRegistry::Id;
+	struct Result {
+		Id id;
+		float distance;	// Nautical miles
+	};
+
+	StationIndex() = default;
+	// Loads station list; each line of the text begins with ICAO location, 
+	// followed by latitude and longitude in decimal degrees (positive for 
+	// North and East), the rest of the line is ignored; the stations are
+	// added to the registry and the locations of stations already present in 
+	// the index are updated; empty lines, lines beginning with # and lines 
+	// without valid location or coordinates are skipped
+	// Returns number of stations added or updated
+	METAF_INLINE std::size_t load(std::string_view text, StationRegistry & registry);
+
+	// Sets location of the station, adding the station if not present in 
+	// the index; returns false if the coordinates are out of range
+	METAF_INLINE bool set(Id id, float latitude, float longitude);
+	METAF_INLINE void remove(Id id);
+	METAF_INLINE bool contains(Id id) const;
+	std::size_t size() const { return stationCount; }
+	METAF_INLINE void clear();
+
+	// Returns stations within specified distance (in nautical miles), 
+	// unordered
+	METAF_INLINE void radius(float latitude,
+		float longitude,
+		float distance,
+		std::vector<Result> & result) const;
+	template <typename F>
+	inline void radius(float latitude,
+		float longitude,
+		float distance,
+		std::vector<Result> & result,
+		F filter) const;
+	// Returns at most n stations nearest to the specified point, ordered by
+	// distance
+	METAF_INLINE void nearest(float latitude,
+		float longitude,
+		std::size_t n,
+		std::vector<Result> & result) const;
+	template <typename F>
+	inline void nearest(float latitude,
+		float longitude,
+		std::size_t n,
+		std::vector<Result> & result,
+		F filter) const;
+
+	// Great circle distance in nautical miles
+	static METAF_INLINE float distance(float latitude1,
+		float longitude1,
+		float latitude2,
+		float longitude2);
+
+private:
+	static const inline int latCells = 180;
+	static const inline int lonCells = 360;
+	static const inline std::uint32_t noCell = std::numeric_limits<std::uint32_t>::max();
+	static const inline double earthRadius = 3440.065;	// Nautical miles
+	static const inline double pi = 3.14159265358979323846;
+
+	struct Location {
+		float latitude = 0;
+		float longitude = 0;
+		std::uint32_t cell = noCell;
+	};
+	std::vector<Location> locations;				// Indexed by station ID
+	std::vector<std::vector<Id>> cells;	// Station IDs in each cell
+	std::size_t stationCount = 0;
+
+	static METAF_INLINE std::optional<float> coordinate(std::string_view field, float maxValue);
+	static METAF_INLINE int latCell(double latitude);
+	static METAF_INLINE int lonCell(double longitude);
+	static double toRadians(double degrees) { return degrees * pi / 180; }
+	static double toDegrees(double radians) { return radians * 180 / pi; }
+};
+
+// Detects significant changes of weather between consecutive METAR reports
+// from the same station, similar to the criteria for issuing SPECI: ceiling
+// or visibility crossing one of the thresholds, wind shift, and beginning
+// or ending of thunderstorm or freezing precipitation
+// Detector stores only the conditions from the latest report of each
+// station as a fixed-size state in the array indexed by station ID (see 
+// StationRegistry), so that each new report is compared with the state
+// rather than with the previous report; updating the state does not
+// allocate memory if reserve() was called for all stations
+// Only report body before the first trend is used; the value is compared
+// only if it is reported in both consecutive reports
+class SignificantChangeDetector {
+public:
+	using Id = StationRegistry::Id;
+	struct Event {
+		enum class Type : std::uint8_t {
+			CEILING,		// Ceiling crossed threshold, previous/current in feet
+			VISIBILITY,		// Visibility crossed threshold, previous/current in meters
+			WIND_SHIFT,		// Previous/current are wind directions in degrees
+			THUNDERSTORM_BEGIN,
+			THUNDERSTORM_END,
+			FREEZING_PRECIPITATION_BEGIN,
+			FREEZING_PRECIPITATION_END
+		};
+		Id station;
+		Type type;
+		// Unlimited ceiling is ObservationColumns::unlimited
+		float previous = ObservationColumns::notReported;
+		float current = ObservationColumns::notReported;
+	};
+	struct Options {
+		// Ascending thresholds; the event is detected when the value drops
+		// below the threshold or rises to or above it
+		std::vector<float> ceilingFeet = { 100, 200, 500, 1000, 1500, 3000 };
+		std::vector<float> visibilityMeters = { 800, 1500, 3000, 5000 };
+		// Wind shift is detected when wind direction changes by at least
+		// windShiftDegrees and wind speed in both reports is at least
+		// windShiftSpeed
+		float windShiftDegrees = 45;
+		float windShiftSpeed = 10;	// Knots
+	};
+	// Conditions from the latest report of the station
+	struct State {
+		float ceiling = ObservationColumns::notReported;		// Feet
+		float visibility = ObservationColumns::notReported;	// Meters
+		float windDirection = ObservationColumns::notReported;	// Degrees
+		float windSpeed = ObservationColumns::notReported;	// Knots
+		bool isThunderstorm = false;
+		bool isFreezingPrecipitation = false;
+		bool isReported = false;	// False if no report received yet
+	};
+
+	SignificantChangeDetector() = default;
+	explicit SignificantChangeDetector(const Options & o) : options(o) {}
+	// Station states are allocated from the specified memory resource
+	explicit SignificantChangeDetector(std::pmr::memory_resource * resource)
+		: states(resource) {}
+	SignificantChangeDetector(const Options & o,
+		std::pmr::memory_resource * resource) : options(o), states(resource) {}
+
+	// Compares the report with the state of the station, calls f(event) for
+	// each change detected, and updates the state; reports which are not
+	// valid METAR reports and missing (NIL) reports are ignored; returns
+	// number of events
+	// Reports of each station must be passed in the order of issue
+	template <typename F>
+	inline std::size_t update(Id station, const ParseResult & metar, F f);
+	METAF_INLINE std::size_t update(Id station,
+		const ParseResult & metar,
+		std::vector<Event> & events);
+	// Station is identified by the location group of the report and is
+	// added to the registry if not registered yet
+	template <typename F>
+	inline std::size_t update(StationRegistry & registry,
+		const ParseResult & metar,
+		F f);
+
+	METAF_INLINE const State & state(Id station) const;
+	void reset(Id station) { if (station < states.size()) states[station] = State(); }
+	void reserve(std::size_t stations) { states.reserve(stations); }
+	void clear() { states.clear(); }
+	const Options & settings() const { return options; }
+
+	static METAF_INLINE State fromParseResult(const ParseResult & metar);
+
+private:
+	Options options;
+	std::pmr::vector<State> states;
+
+	static METAF_INLINE void checkGroup(const Group & group, State & state);
+	static METAF_INLINE void checkWeather(const WeatherGroup & group, State & state);
+	static METAF_INLINE std::size_t band(float value, const std::vector<float> & thresholds);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t N, std::size_t Size>
+constexpr Regex<N, Size>::Regex(const char (&pattern)[N]) {
+	for (std::size_t i = 0; i < N; i++) source[i] = pattern[i];
+	const auto saveEntireMatch = 0, saveEntireMatchEnd = 1;
+	emit(Op::SAVE, saveEntireMatch);
+	std::size_t i = 0;
+	alternation(pattern, i);
+	if (i != length) error();
+	emit(Op::SAVE, saveEntireMatchEnd);
+	emit(Op::MATCH);
+}
+
+template <std::size_t N, std::size_t Size>
+bool Regex<N, Size>::match(const std::string & s) const {
+	return run(s, 0, true, nullptr);
+}
+
+template <std::size_t N, std::size_t Size>
+bool Regex<N, Size>::match(const std::string & s, RegexMatch & result) const {
+	return run(s, 0, true, &result);
+}
+
+template <std::size_t N, std::size_t Size>
+bool Regex<N, Size>::search(const std::string & s,
+	std::size_t from,
+	RegexMatch & result) const
+{
+	if (from > s.length()) return false;
+	return run(s, from, false, &result);
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::error() {
+	valid = false;
+	regexPatternError();
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr std::size_t Regex<N, Size>::emit(Op op, std::size_t x, std::size_t y) {
+	if (programSize >= Size) { error(); return programSize; }
+	program[programSize].op = op;
+	program[programSize].x = x;
+	program[programSize].y = y;
+	return programSize++;
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::insert(std::size_t position, Op op) {
+	// Instructions after position are moved and their jumps are relocated;
+	// jumps from the instructions before position remain unchanged
+	if (programSize >= Size) { error(); return; }
+	for (auto i = programSize; i > position; i--) {
+		auto instruction = program[i - 1];
+		if (instruction.op == Op::SPLIT || instruction.op == Op::JMP) {
+			if (instruction.x >= position) instruction.x++;
+			if (instruction.op == Op::SPLIT && instruction.y >= position) {
+				instruction.y++;
+			}
+		}
+		program[i] = instruction;
+	}
+	program[position] = Instruction();
+	program[position].op = op;
+	programSize++;
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::copy(std::size_t from, std::size_t to) {
+	const auto offset = programSize - from;
+	for (auto i = from; i < to; i++) {
+		auto instruction = program[i];
+		if (instruction.op == Op::SPLIT || instruction.op == Op::JMP) {
+			instruction.x += offset;
+			if (instruction.op == Op::SPLIT) instruction.y += offset;
+		}
+		emit(instruction.op, instruction.x, instruction.y);
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::setSplit(std::size_t index,
+	std::size_t preferred,
+	std::size_t other,
+	bool lazy)
+{
+	program[index].op = Op::SPLIT;
+	program[index].x = lazy ? other : preferred;
+	program[index].y = lazy ? preferred : other;
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::addRange(unsigned char from, unsigned char to) {
+	if (rangesSize >= ranges.size() || from > to) { error(); return; }
+	ranges[rangesSize].from = from;
+	ranges[rangesSize].to = to;
+	rangesSize++;
+	classes[classesSize - 1].ranges++;
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr bool Regex<N, Size>::addEscapeRanges(char c) {
+	switch (c) {
+		case 'd':
+		addRange('0', '9');
+		return true;
+
+		case 'w':
+		addRange('0', '9');
+		addRange('A', 'Z');
+		addRange('_', '_');
+		addRange('a', 'z');
+		return true;
+
+		case 's':
+		addRange('\t', '\r');
+		addRange(' ', ' ');
+		return true;
+
+		default:
+		return false;
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::alternation(const char (&pattern)[N],
+	std::size_t & i)
+{
+	const auto start = programSize;
+	concatenation(pattern, i);
+	if (i >= length || pattern[i] != '|') return;
+	i++;
+	insert(start, Op::SPLIT);
+	const auto jump = emit(Op::JMP);
+	const auto second = programSize;
+	alternation(pattern, i);
+	setSplit(start, start + 1, second, false);
+	program[jump].x = programSize;
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::concatenation(const char (&pattern)[N],
+	std::size_t & i)
+{
+	while (i < length && pattern[i] != '|' && pattern[i] != ')' && valid) {
+		repetition(pattern, i);
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::repetition(const char (&pattern)[N],
+	std::size_t & i)
+{
+	const auto start = programSize;
+	atom(pattern, i);
+	if (i >= length) return;
+	std::size_t min = 0, max = 0;
+	switch (pattern[i]) {
+		case '?':
+		min = 0; max = 1;
+		break;
+
+		case '*':
+		min = 0; max = infinite;
+		break;
+
+		case '+':
+		min = 1; max = infinite;
+		break;
+
+		case '{':
+		{
+			auto number = [&](std::size_t & value) {
+				const auto begin = i;
+				while (i < length && pattern[i] >= '0' && pattern[i] <= '9') {
+					value = value * 10 + (pattern[i++] - '0');
+				}
+				return (i != begin);
+			};
+			i++;
+			if (!number(min)) { error(); return; }
+			max = min;
+			if (i < length && pattern[i] == ',') {
+				i++;
+				max = 0;
+				if (!number(max)) max = infinite;
+			}
+			if (i >= length || pattern[i] != '}' || min > max) { error(); return; }
+		}
+		break;
+
+		default:
+		return;
+	}
+	i++;
+	auto lazy = false;
+	if (i < length && pattern[i] == '?') { lazy = true; i++; }
+	quantify(start, min, max, lazy);
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::quantify(std::size_t start,
+	std::size_t min,
+	std::size_t max,
+	bool lazy)
+{
+	const auto blockEnd = programSize;
+	const auto blockSize = blockEnd - start;
+	if (!max) { programSize = start; return; }
+
+	// Mandatory repetitions
+	auto lastStart = start;
+	for (auto n = 1u; n < min; n++) {
+		lastStart = programSize;
+		copy(start, blockEnd);
+	}
+
+	if (max == infinite) {
+		if (!min) {
+			insert(start, Op::SPLIT);
+			emit(Op::JMP, start);
+			setSplit(start, start + 1, programSize, lazy);
+			return;
+		}
+		const auto split = emit(Op::SPLIT);
+		setSplit(split, lastStart, programSize, lazy);
+		return;
+	}
+
+	// Optional repetitions, each one is only attempted if previous matched
+	auto optional = max - min;
+	auto copyFrom = start, copyTo = blockEnd;
+	const auto end = (min ? programSize : start) + optional * (blockSize + 1);
+	if (!min) {
+		insert(start, Op::SPLIT);
+		setSplit(start, start + 1, end, lazy);
+		copyFrom++;
+		copyTo++;
+		optional--;
+	}
+	for (auto n = 0u; n < optional; n++) {
+		const auto split = emit(Op::SPLIT);
+		setSplit(split, split + 1, end, lazy);
+		copy(copyFrom, copyTo);
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::atom(const char (&pattern)[N], std::size_t & i) {
+	const auto c = pattern[i++];
+	switch (c) {
+		case '(':
+		if (i + 1 < length && pattern[i] == '?' && pattern[i + 1] == ':') {
+			i += 2;
+			alternation(pattern, i);
+		} else {
+			if (captureGroups >= RegexMatch::maxGroups) { error(); return; }
+			const auto group = captureGroups++;
+			emit(Op::SAVE, 2 * group);
+			alternation(pattern, i);
+			emit(Op::SAVE, 2 * group + 1);
+		}
+		if (i >= length || pattern[i] != ')') { error(); return; }
+		i++;
+		return;
+
+		case '[':
+		charClass(pattern, i);
+		return;
+
+		case '.':
+		emit(Op::ANY);
+		return;
+
+		case '\\':
+		{
+			if (i >= length) { error(); return; }
+			const auto e = pattern[i++];
+			if (e == 'd' || e == 'w' || e == 's' || e == 'D' || e == 'W' || e == 'S') {
+				const auto lower = static_cast<char>(e | 0x20);
+				classes[classesSize].firstRange = rangesSize;
+				classes[classesSize].negated = (e != lower);
+				emit(Op::CLASS, classesSize++);
+				addEscapeRanges(lower);
+				return;
+			}
+			if ((e >= '0' && e <= '9') || (e >= 'A' && e <= 'Z') || 
+				(e >= 'a' && e <= 'z')) { error(); return; }
+			emit(Op::CHAR, static_cast<unsigned char>(e));
+		}
+		return;
+
+		case '?':
+		case '*':
+		case '+':
+		case '{':
+		case '^':
+		case '$':
+		error();
+		return;
+
+		default:
+		emit(Op::CHAR, static_cast<unsigned char>(c));
+		return;
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+constexpr void Regex<N, Size>::charClass(const char (&pattern)[N], std::size_t & i) {
+	classes[classesSize].firstRange = rangesSize;
+	if (i < length && pattern[i] == '^') {
+		classes[classesSize].negated = true;
+		i++;
+	}
+	emit(Op::CLASS, classesSize++);
+	while (i < length && pattern[i] != ']' && valid) {
+		auto from = static_cast<unsigned char>(pattern[i++]);
+		if (from == '\\') {
+			if (i >= length) { error(); return; }
+			const auto e = pattern[i++];
+			if (addEscapeRanges(e)) continue;
+			if ((e >= '0' && e <= '9') || (e >= 'A' && e <= 'Z') || 
+				(e >= 'a' && e <= 'z')) { error(); return; }
+			from = static_cast<unsigned char>(e);
+		}
+		auto to = from;
+		if (i + 1 < length && pattern[i] == '-' && pattern[i + 1] != ']') {
+			to = static_cast<unsigned char>(pattern[i + 1]);
+			if (to == '\\') { error(); return; }
+			i += 2;
+		}
+		addRange(from, to);
+	}
+	if (i >= length) { error(); return; }
+	i++;
+}
+
+template <std::size_t N, std::size_t Size>
+bool Regex<N, Size>::matchesChar(const Instruction & instruction,
+	unsigned char c) const
+{
+	switch (instruction.op) {
+		case Op::CHAR:
+		return (c == instruction.x);
+
+		case Op::ANY:
+		return (c != '\n');
+
+		case Op::CLASS:
+		{
+			const auto & cc = classes[instruction.x];
+			auto found = false;
+			for (auto r = cc.firstRange; r < cc.firstRange + cc.ranges; r++) {
+				if (c >= ranges[r].from && c <= ranges[r].to) { found = true; break; }
+			}
+			return (found != cc.negated);
+		}
+
+		default:
+		return false;
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+void Regex<N, Size>::addThread(ThreadList & list,
+	std::array<std::size_t, Size> & visited,
+	std::size_t pc,
+	Slots & slots,
+	std::size_t slotCount,
+	std::size_t pos) const
+{
+	// Threads are added in the order of priority; a thread which reaches an
+	// instruction already reached by a higher-priority thread is discarded
+	if (visited[pc] == pos + 1) return;
+	visited[pc] = pos + 1;
+	const auto & instruction = program[pc];
+	switch (instruction.op) {
+		case Op::JMP:
+		addThread(list, visited, instruction.x, slots, slotCount, pos);
+		return;
+
+		case Op::SPLIT:
+		addThread(list, visited, instruction.x, slots, slotCount, pos);
+		addThread(list, visited, instruction.y, slots, slotCount, pos);
+		return;
+
+		case Op::SAVE:
+		if (instruction.x < slotCount) {
+			const auto saved = slots[instruction.x];
+			slots[instruction.x] = pos;
+			addThread(list, visited, pc + 1, slots, slotCount, pos);
+			slots[instruction.x] = saved;
+			return;
+		}
+		addThread(list, visited, pc + 1, slots, slotCount, pos);
+		return;
+
+		default:
+		{
+			auto & thread = list.threads[list.size++];
+			thread.pc = pc;
+			for (auto i = 0u; i < slotCount; i++) thread.slots[i] = slots[i];
+		}
+		return;
+	}
+}
+
+template <std::size_t N, std::size_t Size>
+bool Regex<N, Size>::run(const std::string & s,
+	std::size_t start,
+	bool entire,
+	RegexMatch * result) const
+{
+	if (s.length() > RegexMatch::maxLength) return false;
+	const std::size_t slotCount = result ? 2 * captureGroups : 0;
+	ThreadList lists[2];
+	auto * current = &lists[0];
+	auto * next = &lists[1];
+	std::array<std::size_t, Size> visited;
+	for (auto i = 0u; i < programSize; i++) visited[i] = 0;
+	Slots slots;
+	for (auto i = 0u; i < slotCount; i++) slots[i] = RegexMatch::none;
+	addThread(*current, visited, 0, slots, slotCount, start);
+
+	auto matched = false;
+	for (auto pos = start; current->size; pos++) {
+		next->size = 0;
+		for (auto t = 0u; t < current->size; t++) {
+			auto & thread = current->threads[t];
+			const auto & instruction = program[thread.pc];
+			if (instruction.op == Op::MATCH) {
+				if (entire && pos != s.length()) continue;
+				// Lower-priority threads are discarded
+				matched = true;
+				if (result) {
+					for (auto i = 0u; i < slotCount; i++) {
+						result->pos[i] = thread.slots[i];
+					}
+				}
+				break;
+			}
+			if (pos < s.length() &&
+				matchesChar(instruction, static_cast<unsigned char>(s[pos])))
+			{
+				addThread(*next, visited, thread.pc + 1, thread.slots, slotCount, pos + 1);
+			}
+		}
+		if (pos >= s.length()) break;
+		// When searching, the match may begin at the next position; this
+		// thread has the lowest priority so that the leftmost match wins
+		if (!entire && !matched) {
+			addThread(*next, visited, 0, slots, slotCount, pos + 1);
+		}
+		if (!next->size) break;
+		std::swap(current, next);
+	}
+	if (matched && result) {
+		result->source = &s;
+		result->groups = captureGroups;
+		for (auto i = slotCount; i < maxSlots; i++) result->pos[i] = RegexMatch::none;
+	}
+	return matched;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Patterns of the groups and of the values within groups; each pattern is 
+// either matched by Regex directly, or documents the syntax accepted by the
+// hand-coded matcher (tests check that both agree)
+namespace patterns {
+
+// Values within groups, matched by hand-coded functions which also convert 
+// the value; some of these functions additionally reject the values which
+// are syntactically correct but reserved
+
+inline constexpr Regex runway("R(?:WY)?(\\d\\d)([RLC])?");
+inline constexpr Regex timeDayHourMinute("(\\d\\d)?(\\d\\d)(\\d\\d)");
+inline constexpr Regex timeDayHour("(\\d\\d)(\\d\\d)");
+inline constexpr Regex temperature("(?:(M)?(\\d\\d))|//");
+inline constexpr Regex temperatureRemark("([01])(\\d\\d\\d)");
+inline constexpr Regex speed("([1-9]?\\d\\d)|//|");
+inline constexpr Regex distanceMeters("(\\d\\d\\d\\d)|////");
+inline constexpr Regex distanceMiles("([PM])?(\\d?\\d)(?:/(\\d?\\d))?SM|////SM");
+inline constexpr Regex distanceHeight("(\\d\\d\\d)|///");
+inline constexpr Regex distanceRvr("([PM])?(\\d\\d\\d\\d)|////");
+inline constexpr Regex distanceLayer("(\\d\\d\\d)(\\d)");
+inline constexpr Regex distanceKm("(\\d\\d?)KM");
+inline constexpr Regex directionDegrees("(\\d\\d0)|///|VRB|");
+inline constexpr Regex pressure("([QA])(?:(\\d\\d\\d\\d)|////)");
+inline constexpr Regex pressureForecast("QNH(\\d\\d\\d\\d)INS");
+inline constexpr Regex pressureSlp("SLP(\\d\\d\\d)");
+inline constexpr Regex pressureQfe("QFE(\\d\\d\\d)(/\\d\\d\\d\\d)?");
+inline constexpr Regex pressureTendency("(\\d\\d\\d)|///");
+inline constexpr Regex precipitationRainfall("(\\d?\\d\\d\\.\\d)|///\\./|//\\./|");
+inline constexpr Regex precipitationRunwayDeposits("(\\d\\d)|//");
+inline constexpr Regex precipitationRemark("(\\d\\d\\d\\d?)|////?");
+inline constexpr Regex fraction("(\\d\\d?)/(\\d\\d?)");
+inline constexpr Regex surfaceFriction("(\\d\\d)|//");
+inline constexpr Regex waveHeight("S(\\d|/)|H(\\d?\\d?\\d|///)");
+inline constexpr Regex cloudType("CB|TCU|CU|CF|SC|NS|ST|SF|AS|AC|ACC|CI|CS|CC");
+inline constexpr Regex cloudTypesType("CB|TCU|CU|CF|SC|NS|ST|SF|AS|AC|ACC|CI|CS|CC|"
+	"BLSN|BLDU|BLSA|IC|RA|DZ|SN|PL|FU|FG|BR|HZ");
+
+// Groups and parts of groups, matched by Regex
+
+inline constexpr Regex directionSector(
+	"([NSWE][WE]?)(?:-[NSWE]|-[NS][WE])*-([NSWE][WE]?)");
+inline constexpr Regex weatherBeginEnd("((?:[A-Z][A-Z]){0,4})([BE])(\\d\\d)?(\\d\\d)");
+inline constexpr Regex location("[A-Z][A-Z0-9]{3}");
+inline constexpr Regex reportTime("\\d\\d\\d\\d\\d\\dZ");
+inline constexpr Regex trendTimeSpan("(\\d\\d\\d\\d)/(\\d\\d\\d\\d)");
+inline constexpr Regex trendFrom("FM\\d\\d\\d\\d\\d\\d");
+inline constexpr Regex trendTime("([FTA][MLT])(\\d\\d\\d\\d)");
+inline constexpr Regex wind("(?:WS(\\d\\d\\d)/)?"
+	"(\\d\\d0|VRB|///)([1-9]?\\d\\d|//)(?:G([1-9]?\\d\\d))?([KM][TMP][HS]?)");
+inline constexpr Regex windVariableSector("(\\d\\d0)V(\\d\\d0)");
+inline constexpr Regex peakWind("(\\d\\d0)([1-9]?\\d\\d)/(\\d\\d)?(\\d\\d)");
+inline constexpr Regex visibilityMeters("(\\d\\d\\d\\d|////)([NSWE][WED]?[V]?)?");
+inline constexpr Regex visibilityVariable(
+	"(?:(\\d?\\d/\\d?\\d)|(\\d?\\d))V(?:(\\d?\\d/\\d?\\d)|(\\d?\\d))");
+inline constexpr Regex visibilityVariableMeters("(\\d\\d\\d\\d)V(\\d\\d\\d\\d)");
+inline constexpr Regex cloudLayer(
+	"([A-Z][A-Z][A-Z]?|///)(\\d\\d\\d|///)([CT][BC][U]?|///)?");
+inline constexpr Regex cloudLayerVariable("([A-Z][A-Z][A-Z])(\\d\\d\\d)?");
+inline constexpr Regex temperatureGroup("(M?\\d\\d|//)/(M?\\d\\d|//)?");
+inline constexpr Regex temperatureGroupRemark("T([01]\\d\\d\\d)([01]\\d\\d\\d)?");
+inline constexpr Regex temperatureForecast("(T[XN]?)(M?\\d\\d)/(\\d\\d\\d\\d)Z");
+inline constexpr Regex runwayVisualRange("(R\\d\\d[RCL]?)/(////|[PM]?\\d\\d\\d\\d)"
+	"(?:V([PM]?\\d\\d\\d\\d))?(FT/?)?([UND/])?");
+inline constexpr Regex runwayState("(R\\d\\d[RCL]?)/"
+	"(?:(SNOCLO)|(?:([0-9/])([0-9/])(\\d\\d|//)|(CLRD))(\\d\\d|//))");
+inline constexpr Regex variableCeiling("(\\d\\d\\d)V(\\d\\d\\d)");
+inline constexpr Regex rainfall(
+	"RF(\\d\\d\\.\\d|//\\./)/(\\d\\d\\d\\.\\d|///\\./)(?:/(\\d\\d\\d\\.\\d))?");
+inline constexpr Regex seaSurface("W(\\d\\d|//)/([HS](?:\\d\\d?\\d?|///|/))");
+inline constexpr Regex minMaxTemperature6hourly("([12])([01]\\d\\d\\d|////)");
+inline constexpr Regex minMaxTemperature24hourly("4([01]\\d\\d\\d)([01]\\d\\d\\d)");
+inline constexpr Regex precipitationGroup(
+	"([P67])(\\d\\d\\d\\d|////)|(4/|93[13]|I[136]|PP)(\\d\\d\\d|///)");
+inline constexpr Regex layerForecast("([65][\\dX])(\\d\\d\\d\\d)");
+inline constexpr Regex pressureTendencyGroup("5([\\d/])(\\d\\d\\d|///)");
+inline constexpr Regex cloudTypes("(?:(?:[A-Z]{2,4})[1-8])+");
+inline constexpr Regex cloudTypesSearch("([A-Z]{2,4})([1-8])");
+inline constexpr Regex cloudTypesAltFormat("([1-8])([A-Z][A-Z][A-Z]?)(\\d\\d\\d)");
+inline constexpr Regex cloudLayers("8/([\\d/])([\\d/])([\\d/])");
+inline constexpr Regex sunshineDuration("98(\\d\\d\\d)");
+inline constexpr Regex correctionObservation("CC([A-Z])");
+
+} //namespace patterns
+
+///////////////////////////////////////////////////////////////////////////////
+
+METAF_INLINE std::optional<unsigned int> strToUint(const std::string & str,
+	std::size_t startPos,
+	std::size_t digits);
+
+METAF_INLINE std::optional<std::pair<unsigned int, unsigned int> > fractionStrToUint(
+	const std::string & str,
+	std::size_t startPos,
+	std::size_t length);
+
+} //namespace metaf
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+namespace metaf {
+
+#ifdef METAF_DEFINITIONS
+
+std::optional<unsigned int> strToUint(const std::string & str,
+	std::size_t startPos,
+	std::size_t digits)
+{
+	std::optional<unsigned int> error;
+	if (str.empty() || !digits || startPos + digits > str.length()) return error;
+	unsigned int value = 0;
+	for (auto [i,c] = std::pair(0u, str.c_str() + startPos); i < digits; i++, c++) {
+		if (*c < '0' || *c > '9') return error;
+		static const auto decimalRadix = 10u;
+		value = value * decimalRadix + (*c - '0');
+	}
+	return value;
+}
+
+std::optional<std::pair<unsigned int, unsigned int> >
+	fractionStrToUint(const std::string & str,
+		std::size_t startPos,
+		std::size_t length)
+{
+	//Hand-coded matcher of patterns::fraction
+	std::optional<std::pair<unsigned int, unsigned int> > error;
+	if (length + startPos > str.length()) length = str.length() - startPos;
+	const int endPos = startPos + length;
+
+	const auto slashPos = str.find('/', startPos);
+	if (slashPos == std::string::npos) return error;
+
+	static const int minDigits = 1, maxDigits = 2;
+
+	const int numeratorPos = startPos;
+	const int numeratorLength = slashPos - startPos;
+	if (numeratorLength < minDigits || numeratorLength > maxDigits) return error;
+	const int denominatorPos = slashPos + 1;
+	const int denominatorLength = endPos - denominatorPos;
+	if (denominatorLength < minDigits || denominatorLength > maxDigits) return error;
+
+	const auto numerator = strToUint(str, numeratorPos, numeratorLength);
+	const auto denominator = strToUint(str, denominatorPos, denominatorLength);
+	if (!numerator.has_value() || !denominator.has_value()) return error;
+	return std::pair(numerator.value(), denominator.value());
+}
+
+std::optional<Runway> Runway::fromString(const std::string & s, bool enableRwy) {
+	//Hand-coded matcher of patterns::runway
+	static const std::optional<Runway> error;
+	if (s.length() < 3) return error;
+	if (s[0] != 'R') return error;
+	auto numPos = 1u;
+	if (enableRwy && s[1] == 'W' && s[2] == 'Y') numPos += 2;
+	const auto rwyNum = strToUint(s, numPos, 2);
+	if (!rwyNum.has_value()) return error;
+	const auto dsgPos = numPos + 2;
+	if (s.length() > dsgPos + 1) return error;
+	Runway runway;
+	runway.rNumber = rwyNum.value();
+	if ( s.length() > dsgPos) {
+		const auto designator = designatorFromChar(s[dsgPos]);
 		if (!designator.has_value()) return error;
 		runway.rDesignator = designator.value();
 	}
@@ -2564,7 +4595,7 @@ MetafTime::Date MetafTime::dateBeforeRef(const Date & refDate) const {
 }
 
 std::optional<MetafTime> MetafTime::fromStringDDHHMM(const std::string & s) {
-	//static const std::regex rgx ("(\\d\\d)?(\\d\\d)(\\d\\d)");
+	//Hand-coded matcher of patterns::timeDayHourMinute
 	static const std::optional<MetafTime> error;
 	if (s.length() == 4) {
 		const auto hour = strToUint(s, 0, 2);
@@ -2590,7 +4621,7 @@ std::optional<MetafTime> MetafTime::fromStringDDHHMM(const std::string & s) {
 }
 
 std::optional<MetafTime> MetafTime::fromStringDDHH(const std::string & s) {
-	//static const std::regex rgx ("(\\d\\d)(\\d\\d)");
+	//Hand-coded matcher of patterns::timeDayHour
 	static const std::optional<MetafTime> error;
 	if (s.length() != 4) return error;
 	const auto day = strToUint(s, 0, 2);
@@ -2638,10 +4669,11 @@ Temperature Temperature::heatIndex(
 	// Using formula from https://en.wikipedia.org/wiki/Heat_index
 	// (see formula for degrees Celsius)
 	// The formula is valid for temperature > 27 C and RH > 40%
+	static const Temperature error;
 	const auto temperatureC = airTemperature.toUnit(Temperature::Unit::C);
-	if (!temperatureC.has_value() || temperatureC <27.0) return Temperature();
+	if (!temperatureC.has_value() || temperatureC <27.0) return error;
 
-	if (relativeHumidity > 100.0 || relativeHumidity < 40.0) return Temperature();
+	if (relativeHumidity > 100.0 || relativeHumidity < 40.0) return error;
 
 	const auto c1 = -8.78469475556;
 	const auto c2 = 1.61139411;
@@ -2666,8 +4698,9 @@ Temperature Temperature::heatIndex(
 	const Temperature & airTemperature,
 	const Temperature & dewPoint)
 {
+	static const Temperature error;
 	const auto rh = relativeHumidity(airTemperature, dewPoint);
-	if (!rh.has_value()) return Temperature();
+	if (!rh.has_value()) return error;
 	return heatIndex(airTemperature, rh.value());
 }
 
@@ -2675,11 +4708,12 @@ Temperature Temperature::windChill(
 	const Temperature & airTemperature,
 	const Speed & windSpeed)
 {
+	static const Temperature error;
 	const auto temperatureC = airTemperature.toUnit(Temperature::Unit::C);
-	if (!temperatureC.has_value() || temperatureC.value() > 10.0) return Temperature();
+	if (!temperatureC.has_value() || temperatureC.value() > 10.0) return error;
 
 	const auto windKmh = windSpeed.toUnit(Speed::Unit::KILOMETERS_PER_HOUR);
-	if (!windKmh.has_value() || windKmh.value() < 4.8) return Temperature();
+	if (!windKmh.has_value() || windKmh.value() < 4.8) return error;
 
 	const auto windChillC =
 		13.12 +
@@ -2691,7 +4725,7 @@ Temperature Temperature::windChill(
 }
 
 std::optional<Temperature> Temperature::fromString(const std::string & s) {
-	//static const std::regex rgx ("(?:(M)?(\\d\\d))|//");
+	//Hand-coded matcher of patterns::temperature
 	std::optional<Temperature> error;
 	if (s == "//") return Temperature();
 	if (s.length() == 3) {
@@ -2714,7 +4748,7 @@ std::optional<Temperature> Temperature::fromString(const std::string & s) {
 }
 
 std::optional<Temperature> Temperature::fromRemarkString(const std::string & s) {
-	//static const std::regex ("([01])(\\d\\d\\d)");
+	//Hand-coded matcher of patterns::temperatureRemark
 	std::optional<Temperature> error;
 	if (s.length() != 4) return error;
 	if (s[0] != '0' && s[0] != '1') return error;
@@ -2737,7 +4771,7 @@ std::optional<float> Temperature::toUnit(Unit unit) const {
 ///////////////////////////////////////////////////////////////////////////////
 
 std::optional<Speed> Speed::fromString(const std::string & s, Unit unit) {
-	//static const std::regex rgx ("([1-9]?\\d\\d)|//");
+	//Hand-coded matcher of patterns::speed
 	static const std::optional<Speed> error;
 	if (s.empty() || s == "//") return Speed();
 	if (s.length() != 2 && s.length() != 3) return error;
@@ -2811,7 +4845,7 @@ std::optional<float> Speed::mphToUnit(float valueMph, Unit otherUnit) {
 ////////////////////////////////////////////////////////////////////////////////
 
 std::optional<Distance> Distance::fromMeterString(const std::string & s) {
-	//static const std::regex rgx ("(\\d\\d\\d\\d)|////");
+	//Hand-coded matcher of patterns::distanceMeters
 	static const std::optional<Distance> error;
 	if (s.length() != 4) return error;
 	Distance distance;
@@ -2831,7 +4865,7 @@ std::optional<Distance> Distance::fromMeterString(const std::string & s) {
 }
 
 std::optional<Distance> Distance::fromMileString(const std::string & s) {
-	//static const std::regex rgx ("([PM])?(\\d?\\d)(?:/(\\d?\\d))?SM|////SM");
+	//Hand-coded matcher of patterns::distanceMiles
 	static const std::optional<Distance> error;
 	static const auto unitStr = std::string ("SM");
 	static const auto unitLength = unitStr.length();
@@ -2876,7 +4910,7 @@ std::optional<Distance> Distance::fromMileString(const std::string & s) {
 }
 
 std::optional<Distance> Distance::fromHeightString(const std::string & s) {
-	//static const std::regex rgx ("(\\d\\d\\d)|///");
+	//Hand-coded matcher of patterns::distanceHeight
 	static const std::optional<Distance> error;
 	if (s.length() != 3) return error;
 	Distance distance;
@@ -2889,7 +4923,7 @@ std::optional<Distance> Distance::fromHeightString(const std::string & s) {
 }
 
 std::optional<Distance> Distance::fromRvrString(const std::string & s, bool unitFeet) {
-	//static const std::regex rgx ("([PM])?(\\d\\d\\d\\d)|////");
+	//Hand-coded matcher of patterns::distanceRvr
 	static const std::optional<Distance> error;
 	Distance distance;
 	distance.distUnit = unitFeet ? Unit::FEET : Unit::METERS;
@@ -2915,7 +4949,7 @@ std::optional<Distance> Distance::fromRvrString(const std::string & s, bool unit
 std::optional<std::pair<Distance, Distance>> Distance::fromLayerString(
 	const std::string & s)
 {
-	//static const std::regex rgx ("(\\d\\d\\d)(\\d)");
+	//Hand-coded matcher of patterns::distanceLayer
 	static const std::optional<std::pair<Distance, Distance>> error;
 	if (s.length() != 4) return error;
 	const auto h = strToUint(s, 0, 3);
@@ -2932,7 +4966,7 @@ std::optional<std::pair<Distance, Distance>> Distance::fromLayerString(
 }
 
 std::optional<Distance> Distance::fromKmString(const std::string & s) {
-	//static const std::regex rgx ("(\\d\\d?)KM");
+	//Hand-coded matcher of patterns::distanceKm
 	static const std::optional<Distance> error;
 	static const auto metersPerKm = 1000u;
 
@@ -3104,7 +5138,7 @@ std::optional<Direction> Direction::fromDegreesString(const std::string & s) {
 		direction.dirStatus = Status::VARIABLE;
 		return direction;
 	}
-	//static const std::regex rgx("\\d\\d0");
+	//Hand-coded matcher of patterns::directionDegrees
 	if (s[2] != '0') return error;
 	const auto dir = strToUint(s, 0, 3);
 	if (!dir.has_value()) return error;
@@ -3153,11 +5187,9 @@ std::optional<std::pair<Direction, Direction>> Direction::fromSectorString(
 	const std::string & s)
 {
 	static const std::optional<std::pair<Direction, Direction>> notRecognised;
-	static const std::regex rgx 
-		("([NSWE][WE]?)(?:-[NSWE]|-[NS][WE])*-([NSWE][WE]?)");
 	static const auto matchBegin = 1, matchEnd = 2;
-	std::smatch match;
-	if (!regex_match(s, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::directionSector.match(s, match)) return notRecognised;
 	const auto dirBegin = fromCardinalString(match.str(matchBegin));
 	if (!dirBegin.has_value()) return(notRecognised);
 	const auto dirEnd = fromCardinalString(match.str(matchEnd));
@@ -3165,11 +5197,15 @@ std::optional<std::pair<Direction, Direction>> Direction::fromSectorString(
 	return std::pair(dirBegin.value(), dirEnd.value());
 }
 
-std::vector<Direction::Cardinal> Direction::sectorCardinalDirToVector(
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+std::vector<Direction::Cardinal, Allocator> Direction::sectorCardinalDirToVector(
 	const Direction & dirFrom, 
-	const Direction & dirTo)
+	const Direction & dirTo,
+	const Allocator & alloc)
 {
-	std::vector<Cardinal> result;
+	std::vector<Cardinal, Allocator> result(alloc);
 	const auto cardinalFrom = dirFrom.cardinal();
 	const auto cardinalTo = dirTo.cardinal();
 	if (cardinalFrom == Cardinal::NONE || 
@@ -3198,6 +5234,8 @@ std::vector<Direction::Cardinal> Direction::sectorCardinalDirToVector(
 	return result;
 }
 
+#ifdef METAF_DEFINITIONS
+
 Direction::Cardinal Direction::rotateOctantClockwise(Cardinal cardinal) {
 	switch(cardinal) {
 		case Cardinal::TRUE_N:
@@ -3227,7 +5265,7 @@ Direction::Cardinal Direction::rotateOctantClockwise(Cardinal cardinal) {
 ///////////////////////////////////////////////////////////////////////////////
 
 std::optional<Pressure> Pressure::fromString(const std::string & s) {
-	//static const std::regex rgx("([QA])(?:(\\d\\d\\d\\d)|////)");
+	//Hand-coded matcher of patterns::pressure
 	static const std::optional<Pressure> error;
 	if (s.length() != 5) return error;
 	Pressure pressure;
@@ -3256,7 +5294,7 @@ std::optional<Pressure> Pressure::fromString(const std::string & s) {
 }
 
 std::optional<Pressure> Pressure::fromForecastString(const std::string & s) {
-	//static const std::regex rgx("QNH(\\d\\d\\d\\d)INS");
+	//Hand-coded matcher of patterns::pressureForecast
 	static const std::optional<Pressure> error;
 	if (s.length() != 10) return error;
 	if (s[0] != 'Q' || s[1] != 'N' || s[2] != 'H') return error;
@@ -3271,7 +5309,7 @@ std::optional<Pressure> Pressure::fromForecastString(const std::string & s) {
 
 std::optional<Pressure> Pressure::fromSlpString(const std::string & s) {
 	//SLP982 = 998.2 hPa, SLP015 = 1001.5 hPa, SLP221 = 1022.1 hPa
-	//static const std::regex rgx("SLP(\\d\\d\\d)");
+	//Hand-coded matcher of patterns::pressureSlp
 	static const std::optional<Pressure> error;
 	if (s.length() != 6) return error;
 	if (s[0] != 'S' || s[1] != 'L' || s[2] != 'P') return error;
@@ -3286,7 +5324,7 @@ std::optional<Pressure> Pressure::fromSlpString(const std::string & s) {
 }
 
 std::optional<Pressure> Pressure::fromQfeString(const std::string & s) {
-	//static const std::regex rgx("QFE(\\d\\d\\d)(/\\d\\d\\d\\d)?");
+	//Hand-coded matcher of patterns::pressureQfe
 	static const std::optional<Pressure> error;
 	if (s.length() != 6 && s.length() != 11) return error;
 	if (s[0] != 'Q' || s[1] != 'F' || s[2] != 'E') return error;
@@ -3304,7 +5342,7 @@ std::optional<Pressure> Pressure::fromQfeString(const std::string & s) {
 }
 
 std::optional<Pressure> Pressure::fromTendencyString(const std::string & s) {
-	//static const std::regex rgx("(\\d\\d\\d)|///");
+	//Hand-coded matcher of patterns::pressureTendency
 	static const std::optional<Pressure> error;
 	if (s.length() != 3) return error;
 	if (s == "///") return Pressure();
@@ -3347,7 +5385,7 @@ std::optional<float> Pressure::toUnit(Unit unit) const {
 ///////////////////////////////////////////////////////////////////////////////
 
 std::optional<Precipitation> Precipitation::fromRainfallString(const std::string & s) {
-	//static const std::regex rgx("\\d?\\d\\d\\.\\d");
+	//Hand-coded matcher of patterns::precipitationRainfall
 	static const std::optional<Precipitation> error;
 	if (s.empty() || s == "///./" || s == "//./") return Precipitation();
 	if (s.length() != 4 && s.length() != 5) return error;
@@ -3362,7 +5400,7 @@ std::optional<Precipitation> Precipitation::fromRainfallString(const std::string
 }
 
 std::optional<Precipitation> Precipitation::fromRunwayDeposits(const std::string & s) {
-	//static const std::regex rgx("\\d\\d");
+	//Hand-coded matcher of patterns::precipitationRunwayDeposits
 	std::optional<Precipitation> error;
 	if (s.length() != 2) return error;
 	if (s == "//") return Precipitation();
@@ -3397,7 +5435,7 @@ std::optional<Precipitation> Precipitation::fromRemarkString(const std::string &
 		Precipitation::Unit unit,
 		bool allowNotReported)
 {
-	//static const std::regex rgx("\\d\\d\\d\\d?");
+	//Hand-coded matcher of patterns::precipitationRemark
 	std::optional<Precipitation> error;
 	Precipitation precipitation;
 	precipitation.precipUnit = unit;
@@ -3415,7 +5453,7 @@ std::optional<Precipitation> Precipitation::fromRemarkString(const std::string &
 std::optional<std::pair<Precipitation, Precipitation>>
 	Precipitation::fromSnincrString(const std::string & s)
 {
-	//static const std::regex rgx("\\d?\\d)/(\\d?\\d");
+	//Hand-coded matcher of patterns::fraction
 	static const std::optional<std::pair<Precipitation, Precipitation>> error;
 	const auto fraction = fractionStrToUint(s, 0, s.length());
 	if (!fraction.has_value()) return error;
@@ -3448,7 +5486,7 @@ std::optional<float> Precipitation::toUnit(Unit unit) const {
 ///////////////////////////////////////////////////////////////////////////////
 
 std::optional<SurfaceFriction> SurfaceFriction::fromString(const std::string & s) {
-	//static const std::regex rgx("\\d\\d");
+	//Hand-coded matcher of patterns::surfaceFriction
 	static const std::optional<SurfaceFriction> error;
 	if (s.length() != 2) return error;
 	if (s == "//") return SurfaceFriction();
@@ -3513,7 +5551,7 @@ SurfaceFriction::BrakingAction SurfaceFriction::brakingAction() const {
 ///////////////////////////////////////////////////////////////////////////////
 
 std::optional<WaveHeight> WaveHeight::fromString(const std::string & s) {
-	//static const std::regex rgx("S(\\d)|H(\\d?\\d?\\d)");
+	//Hand-coded matcher of patterns::waveHeight
 	static const std::optional<WaveHeight> error;
 	if (s.length() < 2 || s.length() > 4) return error;
 	WaveHeight wh;
@@ -3588,11 +5626,15 @@ std::optional<unsigned int> WaveHeight::waveHeightFromStateOfSurfaceChar(char c)
 	}
 }
 
+#endif //#ifdef METAF_DEFINITIONS
+
 ///////////////////////////////////////////////////////////////////////////////
 
-std::vector<WeatherPhenomena::Weather> WeatherPhenomena::weather() const 
+template <typename Allocator>
+std::vector<WeatherPhenomena::Weather, Allocator> WeatherPhenomena::weather(
+	const Allocator & alloc) const 
 {
-	std::vector<Weather> result;
+	std::vector<Weather, Allocator> result(alloc);
 	for (auto i=0u; i < wSize; i++) {
 		if (w[i] == Weather::OMMITTED) break;
 		result.push_back(w[i]);
@@ -3601,6 +5643,8 @@ std::vector<WeatherPhenomena::Weather> WeatherPhenomena::weather() const
 }
 
 
+#ifdef METAF_DEFINITIONS
+
 std::optional <WeatherPhenomena> WeatherPhenomena::fromString(const std::string & s,
 		bool enableQualifiers)
 {
@@ -3753,7 +5797,7 @@ std::optional <WeatherPhenomena> WeatherPhenomena::fromString(const std::string
 	return result;
 }
 
-inline bool WeatherPhenomena::isDescriptorShAllowed (Weather w) {
+bool WeatherPhenomena::isDescriptorShAllowed (Weather w) {
 	switch (w) {
 		case Weather::RAIN:
 		case Weather::SNOW:
@@ -3768,7 +5812,7 @@ inline bool WeatherPhenomena::isDescriptorShAllowed (Weather w) {
 	}
 }
 
-inline bool WeatherPhenomena::isDescriptorFzAllowed (Weather w) {
+bool WeatherPhenomena::isDescriptorFzAllowed (Weather w) {
 	switch (w) {
 		case Weather::DRIZZLE:
 		case Weather::RAIN:
@@ -3786,12 +5830,11 @@ std::optional <WeatherPhenomena> WeatherPhenomena::fromWeatherBeginEndString(
 	const WeatherPhenomena & previous)
 {
 	std::optional <WeatherPhenomena> error;
-	static const std::regex rgx("((?:[A-Z][A-Z]){0,4})([BE])(\\d\\d)?(\\d\\d)");
 	static const auto matchPhenomena = 1, matchEvent = 2;
 	static const auto matchHour = 3, matchMinute = 4;
 
-	std::smatch match;
-	if (!regex_match(s, match, rgx)) return error;
+	RegexMatch match;
+	if (!patterns::weatherBeginEnd.match(s, match)) return error;
 
 	WeatherPhenomena result;
 
@@ -3956,11 +5999,9 @@ std::optional<LocationGroup> LocationGroup::parse(const std::string & group,
 	(void)reportMetadata;
 	static const std::optional<LocationGroup> notRecognised;
 	if (reportPart != ReportPart::HEADER) return notRecognised;
-	static const std::regex rgx = std::regex("[A-Z][A-Z0-9]{3}");
-	if (!regex_match(group, rgx)) return notRecognised;
+	if (!patterns::location.match(group)) return notRecognised;
 	LocationGroup result;
-	strncpy(result.location, group.c_str(), locationLength);
-	result.location[locationLength] = '\0';
+	result.icaoKey = *stringToKey(group);
 	return result;
 }
 
@@ -3972,6 +6013,27 @@ AppendResult LocationGroup::append(const std::string & group,
 	return AppendResult::NOT_APPENDED;
 }
 
+std::optional<std::uint32_t> LocationGroup::stringToKey(std::string_view location) {
+	if (location.length() != locationLength) return std::optional<std::uint32_t>();
+	if (location[0] < 'A' || location[0] > 'Z') return std::optional<std::uint32_t>();
+	std::uint32_t result = 0;
+	for (const auto c : location) {
+		if ((c < 'A' || c > 'Z') && (c < '0' || c > '9')) return std::optional<std::uint32_t>();
+		result = (result << 8) | static_cast<std::uint8_t>(c);
+	}
+	return result;
+}
+
+std::string LocationGroup::keyToString(std::uint32_t key) {
+	if (!key) return std::string();
+	std::string result(locationLength, '\0');
+	for (auto i = locationLength - 1; i >= 0; i--) {
+		result[i] = static_cast<char>(key & 0xFF);
+		key >>= 8;
+	}
+	return result;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 std::optional<ReportTimeGroup> ReportTimeGroup::parse(const std::string & group,
@@ -3980,10 +6042,9 @@ std::optional<ReportTimeGroup> ReportTimeGroup::parse(const std::string & group,
 {
 	(void)reportMetadata;
 	static const std::optional<ReportTimeGroup> notRecognised;
-	static const std::regex rgx ("\\d\\d\\d\\d\\d\\dZ");
 	static const auto posTime = 0, lenTime = 6;
 	if (reportPart != ReportPart::HEADER) return notRecognised;
-	if (!regex_match(group, rgx)) return notRecognised;
+	if (!patterns::reportTime.match(group)) return notRecognised;
 	const auto tm = MetafTime::fromStringDDHHMM(group.substr(posTime, lenTime));
 	if (!tm.has_value()) return notRecognised;
 	if (!tm->day().has_value()) return notRecognised;
@@ -4055,10 +6116,9 @@ AppendResult TrendGroup::append(const std::string & group,
 
 std::optional<TrendGroup> TrendGroup::fromTimeSpan(const std::string & s) {
 	static const std::optional<TrendGroup> notRecognised;
-	static const std::regex rgx("(\\d\\d\\d\\d)/(\\d\\d\\d\\d)");
 	static const auto matchFrom = 1, matchTill = 2;
-	std::smatch match;
-	if (!regex_match(s, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::trendTimeSpan.match(s, match)) return notRecognised;
 	const auto from = MetafTime::fromStringDDHH(match.str(matchFrom));
 	const auto till = MetafTime::fromStringDDHH(match.str(matchTill));
 	if (!from.has_value() || !till.has_value()) return notRecognised;
@@ -4072,9 +6132,8 @@ std::optional<TrendGroup> TrendGroup::fromTimeSpan(const std::string & s) {
 
 std::optional<TrendGroup> TrendGroup::fromFm(const std::string & s) {
 	static const std::optional<TrendGroup> notRecognised;
-	static const std::regex rgx("FM\\d\\d\\d\\d\\d\\d");
 	static const auto posTime = 2, lenTime = 6;
-	if (!regex_match(s, rgx)) return notRecognised;
+	if (!patterns::trendFrom.match(s)) return notRecognised;
 	const auto time = MetafTime::fromStringDDHHMM(s.substr(posTime, lenTime));
 	if (!time.has_value()) return notRecognised;
 
@@ -4086,10 +6145,9 @@ std::optional<TrendGroup> TrendGroup::fromFm(const std::string & s) {
 
 std::optional<TrendGroup> TrendGroup::fromTrendTime(const std::string & s) {
 	static const std::optional<TrendGroup> notRecognised;
-	static const std::regex rgx("([FTA][MLT])(\\d\\d\\d\\d)");
 	static const auto matchType = 1, matchTime = 2;
-	std::smatch match;
-	if (!regex_match(s, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::trendTime.match(s, match)) return notRecognised;
 	const auto time = MetafTime::fromStringDDHHMM(match.str(matchTime));
 	if (!time.has_value()) return notRecognised;
 	TrendGroup result;
@@ -4218,12 +6276,9 @@ std::optional<WindGroup> WindGroup::parse(const std::string & group,
 	(void)reportMetadata;
 	static const std::optional<WindGroup> notRecognised;
 
-	static const std::regex windRgx("(?:WS(\\d\\d\\d)/)?"
-		"(\\d\\d0|VRB|///)([1-9]?\\d\\d|//)(?:G([1-9]?\\d\\d))?([KM][TMP][HS]?)");
 	static const auto matchWindShearHeight = 1, matchWindDir = 2;
 	static const auto matchWindSpeed = 3, matchWindGust = 4, matchWindUnit = 5;
 
-	static const std::regex varWindRgx("(\\d\\d0)V(\\d\\d0)");
 	static const auto matchVarWindBegin = 1, matchVarWindEnd = 2;
 
 	if (reportPart == ReportPart::RMK) {
@@ -4246,7 +6301,7 @@ std::optional<WindGroup> WindGroup::parse(const std::string & group,
 		reportPart != ReportPart::TAF) return notRecognised;
 
 	// Surface wind or wind shear, e.g. dd0ssKT or dd0ssGggMPS or WShhhdd0ssGggKT
-	if (std::smatch match; std::regex_match(group, match, windRgx)) {
+	if (RegexMatch match; patterns::wind.match(group, match)) {
 		const auto speedUnit = Speed::unitFromString(match.str(matchWindUnit));
 		if (!speedUnit.has_value()) return notRecognised;
 		const auto speed = Speed::fromString(match.str(matchWindSpeed), speedUnit.value());
@@ -4281,7 +6336,7 @@ std::optional<WindGroup> WindGroup::parse(const std::string & group,
 	}
 
 	// Variable wind sector, e.g. xx0Vyy0
-	if (std::smatch match; std::regex_match(group, match, varWindRgx)) {
+	if (RegexMatch match; patterns::windVariableSector.match(group, match)) {
 		WindGroup result;
 		const auto begin = Direction::fromDegreesString(match.str(matchVarWindBegin));
 		if (!begin.has_value()) return notRecognised;
@@ -4369,12 +6424,11 @@ AppendResult WindGroup::append(const std::string & group,
 AppendResult WindGroup::parsePeakWind(const std::string & group,
 	const ReportMetadata & reportMetadata)
 {
-	static const std::regex pkWndRgx("(\\d\\d0)([1-9]?\\d\\d)/(\\d\\d)?(\\d\\d)");
 	static const auto matchDir = 1, matchSpeed = 2;
 	static const auto matchHour = 3, matchMinute = 4;
 
-	std::smatch match;
-	if (!std::regex_match(group, match, pkWndRgx)) return AppendResult::GROUP_INVALIDATED;
+	RegexMatch match;
+	if (!patterns::peakWind.match(group, match)) return AppendResult::GROUP_INVALIDATED;
 
 	windType = Type::PEAK_WIND;
 	const auto dir = Direction::fromDegreesString(match.str(matchDir));
@@ -4535,10 +6589,9 @@ std::optional<VisibilityGroup> VisibilityGroup::fromMeters(
 	const std::string & group)
 {
 	static const std::optional<VisibilityGroup> notRecognised;
-	static const std::regex rgx("(\\d\\d\\d\\d|////)([NSWE][WED]?[V]?)?");
 	static const auto matchVis = 1, matchDir = 2;
-	std::smatch match;
-	if (std::regex_match(group, match, rgx)) {
+	RegexMatch match;
+	if (patterns::visibilityMeters.match(group, match)) {
 		const auto v = Distance::fromMeterString(match.str(matchVis));
 		if (!v.has_value()) return notRecognised;
 		const auto d = Direction::fromCardinalString(match.str(matchDir));
@@ -4638,12 +6691,10 @@ bool VisibilityGroup::appendFraction(const std::string & group) {
 bool VisibilityGroup::appendVariable(const std::string & group) {
 	if (vis.hasFraction() || visMax.isReported()) return false;
 
-	static const std::regex rgx(
-		"(?:(\\d?\\d/\\d?\\d)|(\\d?\\d))V(?:(\\d?\\d/\\d?\\d)|(\\d?\\d))");
 	static const auto matchFractionMin = 1, matchIntegerMin = 2;
 	static const auto matchFractionMax = 3, matchIntegerMax = 4;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return false;
+	RegexMatch match;
+	if (!patterns::visibilityVariable.match(group, match)) return false;
 
 	Distance minDistance = vis, maxDistance = visMax;
 
@@ -4688,10 +6739,9 @@ bool VisibilityGroup::appendVariable(const std::string & group) {
 }
 
 bool VisibilityGroup::appendVariableMeters(const std::string & group) {
-	static const std::regex rgx("(\\d\\d\\d\\d)V(\\d\\d\\d\\d)");
 	static const auto matchMin = 1, matchMax = 2;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return false;
+	RegexMatch match;
+	if (!patterns::visibilityVariableMeters.match(group, match)) return false;
 	const auto min = Distance::fromMeterString(match.str(matchMin));
 	if (!min.has_value()) return false;
 	const auto max = Distance::fromMeterString(match.str(matchMax));
@@ -4778,11 +6828,9 @@ std::optional<CloudGroup> CloudGroup::parseCloudLayer(const std::string & s) {
 	if (s == "CLR") return CloudGroup(Amount::NONE_CLR);
 	if (s == "SKC") return CloudGroup(Amount::NONE_SKC);
 	//Attempt to parse cloud layer or vertical visibility
-	std::smatch match;
-	static const std::regex rgx(
-		"([A-Z][A-Z][A-Z]?|///)(\\d\\d\\d|///)([CT][BC][U]?|///)?");
+	RegexMatch match;
 	static const auto matchAmount = 1, matchHeight = 2, matchType = 3;
-	if (!std::regex_match(s, match, rgx)) return notRecognised;
+	if (!patterns::cloudLayer.match(s, match)) return notRecognised;
 
 	const auto amount = amountFromString(match.str(matchAmount));
 	if (!amount.has_value()) return notRecognised;
@@ -4804,11 +6852,9 @@ std::optional<CloudGroup> CloudGroup::parseCloudLayer(const std::string & s) {
 std::optional<CloudGroup> CloudGroup::parseVariableCloudLayer(const std::string & s) {
 	static const std::optional<CloudGroup> notRecognised;
 
-	std::smatch match;
-	static const std::regex rgx(
-		"([A-Z][A-Z][A-Z])(\\d\\d\\d)?");
+	RegexMatch match;
 	static const auto matchAmount = 1, matchHeight = 2;
-	if (!std::regex_match(s, match, rgx)) return notRecognised;
+	if (!patterns::cloudLayerVariable.match(s, match)) return notRecognised;
 
 	CloudGroup result;
 	result.incompleteType = IncompleteType::EXPECT_V;
@@ -4922,14 +6968,21 @@ AppendResult WeatherGroup::append(const std::string & group,
 	return AppendResult::NOT_APPENDED;
 }
 
-inline std::vector<WeatherPhenomena> WeatherGroup::weatherPhenomena() const {
-	std::vector<WeatherPhenomena> result;
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+std::vector<WeatherPhenomena, Allocator> WeatherGroup::weatherPhenomena(
+	const Allocator & alloc) const
+{
+	std::vector<WeatherPhenomena, Allocator> result(alloc);
 	for (auto i=0u; i < wSize; i++) {
 		if (!w[i].isOmmitted()) result.push_back(w[i]);
 	}
 	return result;
 }
 
+#ifdef METAF_DEFINITIONS
+
 std::optional<WeatherPhenomena> WeatherGroup::parseWeatherWithoutEvent(
 	const std::string & group, 
 	ReportPart reportPart)
@@ -5014,12 +7067,10 @@ std::optional<TemperatureGroup> TemperatureGroup::parse(const std::string & grou
 {
 	(void)reportMetadata;
 	static const std::optional<TemperatureGroup> notRecognised;
-	static const std::regex rgx("(M?\\d\\d|//)/(M?\\d\\d|//)?");
 	static const auto matchTemperature = 1, matchDewPoint = 2;
-	static const std::regex rmkRgx("T([01]\\d\\d\\d)([01]\\d\\d\\d)?");
 	static const auto rmkMatchTemperature = 1, rmkMatchDewPoint = 2;
-	std::smatch match;
-	if (reportPart == ReportPart::METAR && regex_match(group, match, rgx)) {
+	RegexMatch match;
+	if (reportPart == ReportPart::METAR && patterns::temperatureGroup.match(group, match)) {
 		const auto t = Temperature::fromString(match.str(matchTemperature));
 		if (!t.has_value()) return notRecognised;
 		TemperatureGroup result;
@@ -5031,7 +7082,7 @@ std::optional<TemperatureGroup> TemperatureGroup::parse(const std::string & grou
 		}
 		return result;
 	}
-	if (reportPart == ReportPart::RMK && regex_match(group, match, rmkRgx)) {
+	if (reportPart == ReportPart::RMK && patterns::temperatureGroupRemark.match(group, match)) {
 		const auto t = Temperature::fromRemarkString(match.str(rmkMatchTemperature));
 		if (!t.has_value()) return notRecognised;
 		TemperatureGroup result;
@@ -5064,10 +7115,9 @@ std::optional<TemperatureForecastGroup> TemperatureForecastGroup::parse(
 	(void)reportMetadata;
 	static const std::optional<TemperatureForecastGroup> notRecognised;
 	if (reportPart != ReportPart::TAF) return notRecognised;
-	static const std::regex rgx ("(T[XN]?)(M?\\d\\d)/(\\d\\d\\d\\d)Z");
 	static const auto matchPoint = 1, matchTemperature = 2, matchTime = 3;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::temperatureForecast.match(group, match)) return notRecognised;
 	auto point = pointFromString(match.str(matchPoint));
 	if (!point.has_value()) return notRecognised;
 	auto temp = Temperature::fromString(match.str(matchTemperature));
@@ -5151,12 +7201,10 @@ std::optional<RunwayVisualRangeGroup> RunwayVisualRangeGroup::parse(
 	(void)reportMetadata;
 	static const std::optional<RunwayVisualRangeGroup> notRecognised;
 	if (reportPart != ReportPart::METAR) return notRecognised;
-	static const std::regex rgx("(R\\d\\d[RCL]?)/(////|[PM]?\\d\\d\\d\\d)"
-		"(?:V([PM]?\\d\\d\\d\\d))?(FT/?)?([UND/])?");
 	static const auto matchRunway = 1, matchRvr = 2, matchVarRvr = 3, matchUnit = 4;
 	static const auto matchTrend = 5;
-	std::smatch match;
-	if (!regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::runwayVisualRange.match(group, match)) return notRecognised;
 	const auto tr = trendFromString(match.str(matchTrend));
 	if (!tr.has_value()) return notRecognised;
 	const bool unitFeet = match.length(matchUnit);
@@ -5204,13 +7252,11 @@ std::optional<RunwayStateGroup> RunwayStateGroup::parse(const std::string & grou
 	(void)reportMetadata;
 	static const std::optional<RunwayStateGroup> notRecognised;
 	if (reportPart != ReportPart::METAR) return notRecognised;
-	static const std::regex rgx("(R\\d\\d[RCL]?)/"
-		"(?:(SNOCLO)|(?:([0-9/])([0-9/])(\\d\\d|//)|(CLRD))(\\d\\d|//))");
 	static const auto matchRunway = 1, matchSnoclo = 2, matchDeposits = 3;
 	static const auto matchExtent = 4, matchDepth = 5, matchClrd = 6, matchFriction = 7;
 	static const std::string depthRunwayNotOperational = "99";
-	std::smatch match;
-	if (!regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::runwayState.match(group, match)) return notRecognised;
 	const auto runway = Runway::fromString(match.str(matchRunway));
 	if (!runway.has_value()) return notRecognised;
 	if (match.length(matchSnoclo)) return runwaySnoclo(runway.value());
@@ -5385,10 +7431,9 @@ AppendResult SecondaryLocationGroup::append(const std::string & group,
 			return AppendResult::APPENDED;
 		}
 		{
-			static const std::regex rgx ("(\\d\\d\\d)V(\\d\\d\\d)");
 			static const auto matchMinHeight = 1, matchMaxHeight = 2;
-			std::smatch match;
-			if (!std::regex_match(group, match, rgx)) return AppendResult::GROUP_INVALIDATED;
+			RegexMatch match;
+			if (!patterns::variableCeiling.match(group, match)) return AppendResult::GROUP_INVALIDATED;
 			const auto minHt = Distance::fromHeightString(match.str(matchMinHeight));
 			if (!minHt.has_value()) return AppendResult::GROUP_INVALIDATED;
 			const auto maxHt = Distance::fromHeightString(match.str(matchMaxHeight));
@@ -5554,11 +7599,9 @@ std::optional<RainfallGroup> RainfallGroup::parse(const std::string & group,
 	(void)reportMetadata;
 	static const std::optional<RainfallGroup> notRecognised;
 	if (reportPart != ReportPart::METAR) return notRecognised;
-	static const std::regex rgx (
-		"RF(\\d\\d\\.\\d|//\\./)/(\\d\\d\\d\\.\\d|///\\./)(?:/(\\d\\d\\d\\.\\d))?");
 	static const auto matchLast10Minutes = 1, matchSince9AM = 2, matchLast60Minutes = 3;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::rainfall.match(group, match)) return notRecognised;
 	const auto last10min = Precipitation::fromRainfallString(match.str(matchLast10Minutes));
 	if (!last10min.has_value()) return notRecognised;
 	const auto since9AM = Precipitation::fromRainfallString(match.str(matchSince9AM));
@@ -5589,10 +7632,9 @@ std::optional<SeaSurfaceGroup> SeaSurfaceGroup::parse(const std::string & group,
 	(void)reportMetadata;
 	static const std::optional<SeaSurfaceGroup> notRecognised;
 	if (reportPart != ReportPart::METAR) return notRecognised;
-	static const std::regex rgx ("W(\\d\\d|//)/([HS](?:\\d\\d?\\d?|///|/))");
 	static const auto matchTemp = 1, matchWaveHeight = 2;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::seaSurface.match(group, match)) return notRecognised;
 	const auto temp = Temperature::fromString(match.str(matchTemp));
 	if (!temp.has_value()) return notRecognised;
 	const auto waveHeight = WaveHeight::fromString(match.str(matchWaveHeight));
@@ -5653,13 +7695,11 @@ std::optional<MinMaxTemperatureGroup> MinMaxTemperatureGroup::parse(
 {
 	(void)reportMetadata;
 	std::optional<MinMaxTemperatureGroup> notRecognised;
-	static const std::regex rgx6hourly("([12])([01]\\d\\d\\d|////)");
 	static const auto matchType6hourly = 1, matchValue6hourly = 2;
-	static const std::regex rgx24hourly("4([01]\\d\\d\\d)([01]\\d\\d\\d)");
 	static const auto matchMaxTemp24hourly = 1, matchMinTemp24hourly = 2;
 	if (reportPart != ReportPart::RMK) return notRecognised;
-	std::smatch match;
-	if (std::regex_match(group, match, rgx24hourly)) {
+	RegexMatch match;
+	if (patterns::minMaxTemperature24hourly.match(group, match)) {
 		const auto max =
 			Temperature::fromRemarkString(match.str(matchMaxTemp24hourly));
 		if (!max.has_value()) return notRecognised;
@@ -5672,7 +7712,7 @@ std::optional<MinMaxTemperatureGroup> MinMaxTemperatureGroup::parse(
 		result.maxTemp = max.value();
 		return result;
 	}
-	if (std::regex_match(group, match, rgx6hourly)) {
+	if (patterns::minMaxTemperature6hourly.match(group, match)) {
 		if (match.str(matchValue6hourly) == "////") {
 			MinMaxTemperatureGroup result;
 			result.obsPeriod = ObservationPeriod::HOURS6;
@@ -5724,8 +7764,6 @@ std::optional<PrecipitationGroup> PrecipitationGroup::parse(const std::string &
 	const ReportMetadata & reportMetadata)
 {
 	std::optional<PrecipitationGroup> notRecognised;
-	static const std::regex rgx(
-		"([P67])(\\d\\d\\d\\d|////)|(4/|93[13]|I[136]|PP)(\\d\\d\\d|///)");
 	static const auto matchType1 = 1, matchType2 = 3;
 	static const auto matchValue1 = 2, matchValue2 = 4;
 
@@ -5736,8 +7774,8 @@ std::optional<PrecipitationGroup> PrecipitationGroup::parse(const std::string &
 		return result;
 	}
 
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::precipitationGroup.match(group, match)) return notRecognised;
 
 	// assuming only one pair matchType and matchValue will be non-empty
 	std::string typeStr = match.str(matchType1) + match.str(matchType2);
@@ -5878,12 +7916,11 @@ std::optional<LayerForecastGroup> LayerForecastGroup::parse(
 {
 	(void)reportMetadata;
 	std::optional<LayerForecastGroup> notRecognised;
-	static const std::regex rgx("([65][\\dX])(\\d\\d\\d\\d)");
 	static const auto matchType = 1, matchHeight = 2;
 
 	if (reportPart != ReportPart::TAF) return notRecognised;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::layerForecast.match(group, match)) return notRecognised;
 	const auto type = typeFromStr(match.str(matchType));
 	if (!type.has_value()) return notRecognised;
 	const auto heights = Distance::fromLayerString(match.str(matchHeight));
@@ -5973,11 +8010,10 @@ std::optional<PressureTendencyGroup> PressureTendencyGroup::parse(
 		return result;
 	}
 
-	static const std::regex rgx("5([\\d/])(\\d\\d\\d|///)");
 	static const auto matchType = 1, matchPressure = 2;
 
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::pressureTendencyGroup.match(group, match)) return notRecognised;
 	const auto type = typeFromChar(match.str(matchType)[0]);
 	if (!type.has_value()) return notRecognised;
 	const auto pressure = Pressure::fromTendencyString(match.str(matchPressure));
@@ -5997,34 +8033,35 @@ AppendResult PressureTendencyGroup::append(const std::string & group,
 	return AppendResult::NOT_APPENDED;
 }
 
+#endif //#ifdef METAF_DEFINITIONS
+
 ///////////////////////////////////////////////////////////////////////////////
 
-std::vector<std::pair<CloudTypesGroup::Type, unsigned int>>
-CloudTypesGroup::toVector() const
+template <typename Allocator>
+std::vector<std::pair<CloudTypesGroup::Type, unsigned int>, Allocator>
+CloudTypesGroup::toVector(const Allocator & alloc) const
 {
-	std::vector<std::pair<CloudTypesGroup::Type, unsigned int>> result;
+	std::vector<std::pair<CloudTypesGroup::Type, unsigned int>, Allocator> result(alloc);
 	for (auto i=0u; i < cloudTypesSize; i++) {
 		result.push_back(cloudTypes[i]);
 	}
 	return result;
 }
 
+#ifdef METAF_DEFINITIONS
+
 std::optional<CloudTypesGroup> CloudTypesGroup::parse(const std::string & group,
 	ReportPart reportPart,
 	const ReportMetadata & reportMetadata)
 {
 	(void)reportMetadata;
 	std::optional<CloudTypesGroup> notRecognised;
-	//"(CB|TCU|CU|CF|SC|NS|ST|SF|AS|AC|ACC|CI|CS|CC|BLSN|BLDU|BLSA|IC|)(\\d)"
-	static const std::regex matchRgx("(?:(?:[A-Z]{2,4})[1-8])+");
-	static const std::regex searchRgx("([A-Z]{2,4})([1-8])");
 	static const auto matchType = 1, matchOkta = 2;
-	static const std::regex altFormatRgx("([1-8])([A-Z][A-Z][A-Z]?)(\\d\\d\\d)");
 	static const auto altMatchOkta = 1, altMatchType = 2, altMatchHeight = 3;
 
 	if (reportPart != ReportPart::RMK) return notRecognised;
-	std::smatch match;
-	if (std::regex_match(group, match, altFormatRgx)) {
+	RegexMatch match;
+	if (patterns::cloudTypesAltFormat.match(group, match)) {
 		//Assuming okta is a number in range 1..8, guaranteed by regex
 		const auto okta = static_cast<unsigned int>(stoi(match.str(altMatchOkta)));
 		const auto type = cloudTypeFromString(match.str(altMatchType));
@@ -6037,11 +8074,10 @@ std::optional<CloudTypesGroup> CloudTypesGroup::parse(const std::string & group,
 		result.cloudTypes[0] = std::pair(type.value(), okta);
 		return result;
 	}
-	if (std::regex_match(group, match, matchRgx)) {
+	if (patterns::cloudTypes.match(group, match)) {
 		CloudTypesGroup result;
-		auto iter = std::sregex_iterator(group.begin(), group.end(), searchRgx);
-		while (iter != std::sregex_iterator()) {
-			match = *iter++;
+		for (std::size_t pos = 0; patterns::cloudTypesSearch.search(group, pos, match);) {
+			pos = match.position(0) + match.length(0);
 			const auto type = typeFromString(match.str(matchType));
 			if (!type.has_value()) return notRecognised;
 			const auto okta = static_cast<unsigned int>(stoi(match.str(matchOkta)));
@@ -6064,6 +8100,7 @@ AppendResult CloudTypesGroup::append(const std::string & group,
 }
 
 std::optional<CloudTypesGroup::Type> CloudTypesGroup::cloudTypeFromString(std::string s) {
+	//Hand-coded matcher of patterns::cloudType
 	if (s == "CB")    return Type::CUMULONIMBUS;
 	if (s == "TCU")   return Type::TOWERING_CUMULUS;
 	if (s == "CU")    return Type::CUMULUS;
@@ -6082,6 +8119,7 @@ std::optional<CloudTypesGroup::Type> CloudTypesGroup::cloudTypeFromString(std::s
 }
 
 std::optional<CloudTypesGroup::Type> CloudTypesGroup::typeFromString(std::string s) {
+	//Hand-coded matcher of patterns::cloudTypesType
 	if (const auto t = cloudTypeFromString(s); t.has_value()) return t;
 	if (s == "BLSN")  return Type::BLOWING_SNOW;
 	if (s == "BLDU")  return Type::BLOWING_DUST;
@@ -6115,12 +8153,11 @@ std::optional<CloudLayersGroup> CloudLayersGroup::parse(const std::string & grou
 {
 	(void)reportMetadata;
 	std::optional<CloudLayersGroup> notRecognised;
-	static const std::regex rgx("8/([\\d/])([\\d/])([\\d/])");
 	static const auto matchLowLayer = 1, matchMidLayer = 2, matchHighLayer = 3;
 
 	if (reportPart != ReportPart::RMK) return notRecognised;
-	std::smatch match;
-	if (!std::regex_match(group, match, rgx)) return notRecognised;
+	RegexMatch match;
+	if (!patterns::cloudLayers.match(group, match)) return notRecognised;
 
 	const auto lowLayer = lowLayerFromChar(match.str(matchLowLayer)[0]);
 	const auto midLayer = midLayerFromChar(match.str(matchMidLayer)[0]);
@@ -6292,12 +8329,17 @@ std::optional<LightningGroup> LightningGroup::fromLtgGroup(const std::string & g
 	return result;
 }
 
-std::vector<Direction::Cardinal> LightningGroup::directions() const {
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+std::vector<Direction::Cardinal, Allocator> LightningGroup::directions(
+	const Allocator & alloc) const
+{
 	// The result vector is max 10 elements possible, typically up to 
 	// 5 elements which does not justify using std::set and std::find
-	std::vector<Direction::Cardinal> result = 
-		Direction::sectorCardinalDirToVector(dir1from, dir1to);
-	const auto result2 = Direction::sectorCardinalDirToVector(dir2from, dir2to);
+	auto result = Direction::sectorCardinalDirToVector(dir1from, dir1to, alloc);
+	const auto result2 =
+		Direction::sectorCardinalDirToVector(dir2from, dir2to, alloc);
 	for (const auto r2 : result2) {
 		// Check if r2 is already present in result
 		bool r2_alreadyPresent = false;
@@ -6311,6 +8353,8 @@ std::vector<Direction::Cardinal> LightningGroup::directions() const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef METAF_DEFINITIONS
+
 std::optional<VicinityGroup> VicinityGroup::parse(
 	const std::string & group,
 	ReportPart reportPart,
@@ -6428,11 +8472,16 @@ bool VicinityGroup::appendDistance(const std::string & str) {
 	return true;
 }
 
-std::vector<Direction::Cardinal> VicinityGroup::directions() const {
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+std::vector<Direction::Cardinal, Allocator> VicinityGroup::directions(
+	const Allocator & alloc) const
+{
 	// Copy of LightningGroup::directions
-	std::vector<Direction::Cardinal> result = 
-		Direction::sectorCardinalDirToVector(dir1from, dir1to);
-	const auto result2 = Direction::sectorCardinalDirToVector(dir2from, dir2to);
+	auto result = Direction::sectorCardinalDirToVector(dir1from, dir1to, alloc);
+	const auto result2 =
+		Direction::sectorCardinalDirToVector(dir2from, dir2to, alloc);
 	for (const auto r2 : result2) {
 		// Check if r2 is already present in result
 		bool r2_alreadyPresent = false;
@@ -6446,20 +8495,20 @@ std::vector<Direction::Cardinal> VicinityGroup::directions() const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef METAF_DEFINITIONS
+
 std::optional<MiscGroup> MiscGroup::parse(const std::string & group,
 	ReportPart reportPart,
 	const ReportMetadata & reportMetadata)
 {
 	(void)reportMetadata;
-	static const std::regex rgxSunshineDuration("98(\\d\\d\\d)");
-	static const std::regex rgxCorrectionObservation("CC([A-Z])");
 	static const auto matchValue = 1;
 
-	std::smatch match;
+	RegexMatch match;
 	MiscGroup result;
 
 	if (reportPart == ReportPart::METAR) {
-		if (std::regex_match(group, match, rgxCorrectionObservation)) {
+		if (patterns::correctionObservation.match(group, match)) {
 			result.groupType = Type::CORRECTED_WEATHER_OBSERVATION;
 			result.groupValue = match.str(matchValue)[0] - 'A' + 1;
 			return result;
@@ -6477,7 +8526,7 @@ std::optional<MiscGroup> MiscGroup::parse(const std::string & group,
 			result.incompleteType = IncompleteType::DENSITY;
 			return result;
 		}
-		if (std::regex_match(group, match, rgxSunshineDuration)) {
+		if (patterns::sunshineDuration.match(group, match)) {
 			result.groupType = Type::SUNSHINE_DURATION_MINUTES;
 			result.groupValue = std::stoi(match.str(matchValue));
 			return result;
@@ -6588,19 +8637,632 @@ SyntaxGroup getSyntaxGroup(const Group & group) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-ParseResult Parser::parse(const std::string & report, size_t groupLimit) {
-	std::sregex_token_iterator iter(report.begin(), report.end(),
-		groupDelimiterRegex,
-		-1);
-	bool reportEnd = false;
-	Status status;
-	ReportMetadata reportMetadata;
+ParseStats ParseStats::snapshot() {
+	ParseStats result;
+#ifdef METAF_PARSE_STATS
+	using Recorder = ParseStatsRecorder;
+	for (auto i = 0u; i < result.alternatives.size(); i++) {
+		const auto & c = Recorder::counters[i];
+		auto & a = result.alternatives[i];
+		a.parseAttempts = c.parseAttempts.load(std::memory_order_relaxed);
+		a.parsed = c.parsed.load(std::memory_order_relaxed);
+		a.parseNanoseconds = c.parseNanoseconds.load(std::memory_order_relaxed);
+		a.appendAttempts = c.appendAttempts.load(std::memory_order_relaxed);
+		a.appended = c.appended.load(std::memory_order_relaxed);
+		a.notAppended = c.notAppended.load(std::memory_order_relaxed);
+		a.invalidated = c.invalidated.load(std::memory_order_relaxed);
+	}
+	result.reports = Recorder::reports.load(std::memory_order_relaxed);
+	result.reparses = Recorder::reparses.load(std::memory_order_relaxed);
+#endif
+	return result;
+}
+
+void ParseStats::reset() {
+#ifdef METAF_PARSE_STATS
+	using Recorder = ParseStatsRecorder;
+	for (auto & c : Recorder::counters) {
+		c.parseAttempts = 0;
+		c.parsed = 0;
+		c.parseNanoseconds = 0;
+		c.appendAttempts = 0;
+		c.appended = 0;
+		c.notAppended = 0;
+		c.invalidated = 0;
+	}
+	Recorder::reports = 0;
+	Recorder::reparses = 0;
+#endif
+}
+
+std::uint64_t ParseStatsRecorder::now() {
+#if defined(METAF_PARSE_STATS) && defined(METAF_PARSE_STATS_TIMING)
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(
+		steady_clock::now().time_since_epoch()).count();
+#else
+	return 0;
+#endif
+}
+
+void ParseStatsRecorder::parse(std::size_t index,
+	bool parsed,
+	std::uint64_t startTime)
+{
+#ifdef METAF_PARSE_STATS
+	auto & c = counters[index];
+	increment(c.parseAttempts);
+	if (parsed) increment(c.parsed);
+	#ifdef METAF_PARSE_STATS_TIMING
+		increment(c.parseNanoseconds, now() - startTime);
+	#else
+		(void)startTime;
+	#endif
+#else
+	(void)index; (void)parsed; (void)startTime;
+#endif
+}
+
+void ParseStatsRecorder::append(std::size_t index, AppendResult result) {
+#ifdef METAF_PARSE_STATS
+	auto & c = counters[index];
+	increment(c.appendAttempts);
+	switch (result) {
+		case AppendResult::APPENDED:
+		increment(c.appended);
+		break;
+
+		case AppendResult::NOT_APPENDED:
+		increment(c.notAppended);
+		break;
+
+		case AppendResult::GROUP_INVALIDATED:
+		increment(c.invalidated);
+		break;
+	}
+#else
+	(void)index; (void)result;
+#endif
+}
+
+void ParseStatsRecorder::reparse() {
+#ifdef METAF_PARSE_STATS
+	increment(reparses);
+#endif
+}
+
+void ParseStatsRecorder::report() {
+#ifdef METAF_PARSE_STATS
+	increment(reports);
+#endif
+}
+
+std::vector<ParseTrace::Event> ParseTrace::events() {
+	std::vector<Event> result;
+#ifdef METAF_PARSE_TRACE
+	const auto & b = ParseTraceRecorder::buffer();
+	result.reserve(b.size);
+	const auto first = (b.next + capacity - b.size) % capacity;
+	for (auto i = 0u; i < b.size; i++) {
+		result.push_back(b.events[(first + i) % capacity]);
+	}
+#endif
+	return result;
+}
+
+void ParseTrace::clear() {
+#ifdef METAF_PARSE_TRACE
+	auto & b = ParseTraceRecorder::buffer();
+	b.next = 0;
+	b.size = 0;
+#endif
+}
+
+std::string ParseTrace::toChromeTrace(const std::vector<Event> & events,
+	std::uint64_t minReportNanoseconds)
+{
+	// Reports which are slow enough, identified by thread and report number
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> reports;
+	for (const auto & e : events) {
+		if (e.stage == Stage::REPORT && e.end - e.begin >= minReportNanoseconds) {
+			reports.push_back(std::pair(e.thread, e.report));
+		}
+	}
+	std::sort(reports.begin(), reports.end());
+
+	// Chrome trace event format uses microseconds
+	const auto microseconds = [](std::uint64_t ns) {
+		static const auto nsPerUs = 1000u;
+		std::string result = std::to_string(ns / nsPerUs);
+		const auto fraction = std::to_string(ns % nsPerUs + nsPerUs);
+		result += '.';
+		result += fraction.substr(1);
+		return result;
+	};
+	std::string result = "{\"traceEvents\":[";
+	bool isFirst = true;
+	for (const auto & e : events) {
+		if (!std::binary_search(reports.begin(), reports.end(),
+			std::pair(e.thread, e.report))) continue;
+		if (!isFirst) result += ',';
+		isFirst = false;
+		result += "\n{\"name\":\"";
+		result += stageName(e.stage);
+		result += "\",\"cat\":\"metaf\",\"ph\":\"X\",\"pid\":0,\"tid\":";
+		result += std::to_string(e.thread);
+		result += ",\"ts\":";
+		result += microseconds(e.begin);
+		result += ",\"dur\":";
+		result += microseconds(e.end - e.begin);
+		result += ",\"args\":{\"report\":";
+		result += std::to_string(e.report);
+		if (e.stage != Stage::REPORT) {
+			result += ",\"group\":";
+			result += std::to_string(e.group);
+		}
+		result += "}}";
+	}
+	result += "\n]}\n";
+	return result;
+}
+
+std::string_view ParseTrace::stageName(Stage stage) {
+	switch (stage) {
+		case Stage::REPORT:		return "report";
+		case Stage::TOKENIZE:	return "tokenize";
+		case Stage::APPEND:		return "append";
+		case Stage::DECODE:		return "decode";
+		case Stage::REPARSE:	return "reparse";
+		case Stage::TRANSITION:	return "transition";
+		case Stage::METADATA:	return "metadata";
+		case Stage::FINISH:		return "finish";
+	}
+}
+
+std::uint64_t ParseTraceRecorder::now() {
+#ifdef METAF_PARSE_TRACE
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(
+		steady_clock::now().time_since_epoch()).count();
+#else
+	return 0;
+#endif
+}
+
+void ParseTraceRecorder::beginReport() {
+#ifdef METAF_PARSE_TRACE
+	buffer().report++;
+#endif
+}
+
+void ParseTraceRecorder::record(ParseTrace::Stage stage,
+	std::uint64_t begin,
+	std::size_t group)
+{
+#ifdef METAF_PARSE_TRACE
+	auto & b = buffer();
+	auto & e = b.events[b.next];
+	e.begin = begin;
+	e.end = now();
+	e.thread = b.thread;
+	e.report = b.report;
+	e.group = static_cast<std::uint32_t>(group);
+	e.stage = stage;
+	b.next = (b.next + 1) % ParseTrace::capacity;
+	if (b.size < ParseTrace::capacity) b.size++;
+#else
+	(void)stage; (void)begin; (void)group;
+#endif
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename Allocator>
+void GroupFrequency::add(const BasicParseResult<Allocator> & parseResult) {
+	for (const auto & groupInfo : parseResult.groups) {
+		counts[static_cast<std::size_t>(groupInfo.reportPart)]
+			[groupInfo.group.index()]++;
+	}
+}
+
+#ifdef METAF_DEFINITIONS
+
+const std::vector<std::pair<std::size_t, std::size_t>> &
+	GroupParseOrder::priorities()
+{
+	// VIS in remarks is both a beginning of visibility group (e.g. VIS 3/4V1)
+	// and of secondary location group (e.g. VIS 2 1/2 RWY11)
+	static const std::vector<std::pair<std::size_t, std::size_t>> p = {
+		{ Group(VisibilityGroup()).index(), Group(SecondaryLocationGroup()).index() }
+	};
+	return p;
+}
+
+GroupParseOrder::GroupParseOrder() {
+	for (auto & o : orders) {
+		for (auto i = 0u; i < o.size(); i++) o[i] = i;
+	}
+}
+
+bool GroupParseOrder::setOrder(ReportPart reportPart, const Order & order) {
+	if (!isValid(order)) return false;
+	orders[static_cast<std::size_t>(reportPart)] = order;
+	return true;
+}
+
+bool GroupParseOrder::isValid(const Order & order) {
+	std::array<std::size_t, size> position;
+	std::array<bool, size> found = {};
+	for (auto i = 0u; i < order.size(); i++) {
+		if (order[i] >= size || found[order[i]]) return false;
+		found[order[i]] = true;
+		position[order[i]] = i;
+	}
+	for (const auto & p : priorities()) {
+		if (position[p.first] > position[p.second]) return false;
+	}
+	return true;
+}
+
+GroupParseOrder GroupParseOrder::fromFrequency(const GroupFrequency & frequency) {
+	GroupParseOrder result;
+	for (auto rp = 0u; rp < reportParts; rp++) {
+		const auto reportPart = static_cast<ReportPart>(rp);
+		// Most frequent alternative is chosen among the alternatives which
+		// have no preceding alternatives left according to priorities()
+		std::array<bool, size> used = {};
+		for (auto n = 0u; n < size; n++) {
+			std::optional<std::size_t> best;
+			for (auto i = 0u; i < size; i++) {
+				if (used[i]) continue;
+				bool available = true;
+				for (const auto & p : priorities()) {
+					if (p.second == i && !used[p.first]) available = false;
+				}
+				if (!available) continue;
+				if (!best.has_value() ||
+					frequency.count(reportPart, i) > frequency.count(reportPart, *best))
+						best = i;
+			}
+			used[*best] = true;
+			result.orders[rp][n] = *best;
+		}
+	}
+	return result;
+}
+
+std::string GroupParseOrder::toString() const {
+	std::string result;
+	for (auto rp = 0u; rp < reportParts; rp++) {
+		if (rp) result += ';';
+		for (auto i = 0u; i < size; i++) {
+			if (i) result += ' ';
+			result += std::to_string(orders[rp][i]);
+		}
+	}
+	return result;
+}
+
+std::optional<GroupParseOrder> GroupParseOrder::fromString(const std::string & s) {
+	static const std::optional<GroupParseOrder> error;
+	GroupParseOrder result;
+	std::size_t rp = 0, i = 0;
+	unsigned int value = 0;
+	bool hasDigits = false;
+	auto store = [&]() {
+		if (!hasDigits) return true;
+		if (rp >= reportParts || i >= size || value >= size) return false;
+		result.orders[rp][i++] = value;
+		value = 0;
+		hasDigits = false;
+		return true;
+	};
+	for (const auto c : s) {
+		if (c >= '0' && c <= '9') {
+			static const auto maxValue = 255u;
+			value = value * 10 + (c - '0');
+			hasDigits = true;
+			if (value > maxValue) return error;
+			continue;
+		}
+		if (!store()) return error;
+		if (c == ' ') continue;
+		if (c != ';' || i != size) return error;
+		rp++;
+		i = 0;
+	}
+	if (!store() || rp != reportParts - 1 || i != size) return error;
+	for (const auto & o : result.orders) {
+		if (!isValid(o)) return error;
+	}
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Group GroupCache::parse(const std::string & group,
+	ReportPart reportPart,
+	const ReportMetadata & reportMetadata,
+	const GroupParseOrder * order)
+{
+	auto parse = [&]() {
+		if (order) return GroupParser::parse(group, reportPart, reportMetadata, *order);
+		return GroupParser::parse(group, reportPart, reportMetadata);
+	};
+	if (!cacheCapacity) {
+		cacheStats.misses++;
+		return parse();
+	}
+	auto k = key(group, reportPart, reportMetadata);
+	if (const auto it = index.find(k); it != index.end()) {
+		cacheStats.hits++;
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->group;
+	}
+	cacheStats.misses++;
+	auto result = parse();
+	if (!isCacheable(result, reportPart)) {
+		cacheStats.bypassed++;
+		return result;
+	}
+	if (index.size() >= cacheCapacity) {
+		index.erase(entries.back().key);
+		entries.pop_back();
+		cacheStats.evictions++;
+	}
+	entries.push_front(Entry{std::move(k), result});
+	index.emplace(entries.front().key, entries.begin());
+	return result;
+}
+
+void GroupCache::clear() {
+	entries.clear();
+	index.clear();
+	cacheStats = Stats();
+}
+
+std::string GroupCache::key(const std::string & group,
+	ReportPart reportPart,
+	const ReportMetadata & reportMetadata)
+{
+	// Report time is only used when parsing remarks: precipitation groups
+	// depend on whether the report is 3-hourly or 6-hourly, and weather
+	// groups are not recognised if report time is missing
+	char flags = 0;
+	if (reportPart == ReportPart::RMK && reportMetadata.reportTime.has_value()) {
+		flags |= 1;
+		if (reportMetadata.reportTime->is3hourlyReportTime()) flags |= 2;
+		if (reportMetadata.reportTime->is6hourlyReportTime()) flags |= 4;
+	}
+	std::string result;
+	result.reserve(group.length() + 2);
+	result.push_back(static_cast<char>(reportPart));
+	result.push_back(flags);
+	result += group;
+	return result;
+}
+
+bool GroupCache::isCacheable(const Group & group, ReportPart reportPart) {
+	// Weather event times in remarks are based on report time
+	if (reportPart == ReportPart::RMK &&
+		std::holds_alternative<WeatherGroup>(group)) return false;
+	return true;
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename Allocator>
+template <typename Groups>
+void BasicReportSections<Allocator>::index(const Groups & groups) {
+	const auto size = groups.size();
+	first.fill(notFound);
+	trends.clear();
+	header = body = remarks = Range{size, size};
+	std::size_t headerEnd = 0;
+	while (headerEnd < size && groups[headerEnd].reportPart == ReportPart::HEADER) {
+		headerEnd++;
+	}
+	auto remarksBegin = size;
+	for (auto i = size; i > 0; i--) {
+		const auto & group = groups[i - 1].group;
+		first[group.index()] = i - 1;
+		const auto fixedGroup = std::get_if<FixedGroup>(&group);
+		if (groups[i - 1].reportPart == ReportPart::RMK ||
+			(fixedGroup && fixedGroup->type() == FixedGroup::Type::RMK))
+		{
+			remarksBegin = i - 1;
+		}
+	}
+	remarksBegin = std::max(remarksBegin, headerEnd);
+	for (auto i = headerEnd; i < remarksBegin; i++) {
+		if (!std::holds_alternative<TrendGroup>(groups[i].group)) continue;
+		if (!trends.empty()) trends.back().range.end = i;
+		trends.push_back(Trend{i, Range{i, remarksBegin}});
+	}
+	header = Range{0, headerEnd};
+	body = Range{headerEnd, trends.empty() ? remarksBegin : trends.front().trendGroup};
+	remarks = Range{remarksBegin, size};
+}
+
+#ifdef METAF_DEFINITIONS
+
+ParseResult CompactParseResult::toParseResult() const {
+	ParseResult result;
+	result.reportMetadata = reportMetadata;
+	result.groups.reserve(groups.size());
+	for (const auto & gi : groups) {
+		result.groups.emplace_back(gi.group, gi.reportPart, std::string(rawString(gi)));
+	}
+	result.sections = sections;
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ParseResult Parser::parse(const std::string & report, const ParseLimits & limits) {
+	ParseResult result;
+	parseReport(report, limits, nullptr, nullptr, result);
+	return result;
+}
+
+ParseResult Parser::parse(const std::string & report,
+	GroupCache & cache,
+	const ParseLimits & limits)
+{
+	ParseResult result;
+	parseReport(report, limits, &cache, nullptr, result);
+	return result;
+}
+
+ParseResult Parser::parse(const std::string & report,
+	const GroupParseOrder & order,
+	const ParseLimits & limits)
+{
+	ParseResult result;
+	parseReport(report, limits, nullptr, &order, result);
+	return result;
+}
+
+ParseResult Parser::parse(const std::string & report,
+	GroupCache & cache,
+	const GroupParseOrder & order,
+	const ParseLimits & limits)
+{
+	ParseResult result;
+	parseReport(report, limits, &cache, &order, result);
+	return result;
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+void Parser::parse(const std::string & report,
+	BasicParseResult<Allocator> & result,
+	GroupCache & cache,
+	const ParseLimits & limits)
+{
+	parseReport(report, limits, &cache, nullptr, result);
+}
+
+#ifdef METAF_DEFINITIONS
+
+void Parser::parse(const std::string & report,
+	LazyParseResult & result,
+	const ParseLimits & limits)
+{
+	parseLazy(report, limits, nullptr, result);
+}
+
+void Parser::parse(const std::string & report,
+	LazyParseResult & result,
+	GroupCache & cache,
+	const ParseLimits & limits)
+{
+	parseLazy(report, limits, &cache, result);
+}
+
+void Parser::parse(const std::string & report,
+	CompactParseResult & result,
+	GroupCache & cache,
+	const ParseLimits & limits)
+{
+	parseReport(report, limits, &cache, nullptr, result);
+}
+
+ParseResult Parser::reparse(const std::string & report,
+	const ParseResult & previous,
+	const ParseLimits & limits)
+{
 	ParseResult result;
-	size_t groupCount = 0;
+	ReusableGroups reusable;
+	findReusableGroups(report, limits.reportLength, previous, reusable);
+	parseReport(report, limits, nullptr, nullptr, result, &reusable);
+	return result;
+}
+
+void Parser::reparse(const std::string & report,
+	const ParseResult & previous,
+	ParseResult & result,
+	GroupCache & cache,
+	const ParseLimits & limits)
+{
+	ReusableGroups reusable;
+	findReusableGroups(report, limits.reportLength, previous, reusable);
+	parseReport(report, limits, &cache, nullptr, result, &reusable);
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Result>
+void Parser::parseReport(const std::string & report,
+	const ParseLimits & limits,
+	GroupCache * cache,
+	const GroupParseOrder * order,
+	Result & result,
+	const ReusableGroups * reusable)
+{
+	ParseTraceRecorder::beginReport();
+	const auto traceTime = ParseTraceRecorder::now();
+	Progress progress;
+	clearResult(result, report);
+	parseGroups(report, limits, cache, order, progress, result, false, reusable);
+	finishReport(progress, result);
+	ParseStatsRecorder::report();
+	ParseTraceRecorder::record(ParseTrace::Stage::REPORT, traceTime);
+}
+
+template <typename Result>
+std::size_t Parser::parseGroups(const std::string & report,
+	const ParseLimits & limits,
+	GroupCache * cache,
+	const GroupParseOrder * order,
+	Progress & progress,
+	Result & result,
+	bool stopBeforeRemarks,
+	const ReusableGroups * reusable)
+{
+	const auto reportLength = std::min(report.length(), limits.reportLength);
+	std::size_t pos = 0;
+	bool reportEnd = false;
+	std::size_t groupStrIndex = 0;
+	auto & status = progress.status;
+	auto & reportMetadata = progress.reportMetadata;
+	auto & groupCount = progress.groupCount;
+	auto & work = progress.work;
 
 	//Iterate through report groups separated by delimiters
-	while (iter != std::sregex_token_iterator() && !reportEnd && !status.isError()) {
-		std::string groupStr = *iter;
+	while (!reportEnd && !status.isError()) {
+		auto traceTime = ParseTraceRecorder::now();
+		while (pos < reportLength && isGroupDelimiter(report[pos])) pos++;
+		const auto groupBegin = pos;
+		while (pos < reportLength && !isGroupDelimiter(report[pos])) pos++;
+		if (pos == reportLength && reportLength < report.length()) {
+			// Text continues after the limit, which is allowed only if the
+			// last group string within the limit is complete and either ends
+			// the report or is followed by nothing but delimiters
+			const auto isReportEnd =
+				pos != groupBegin && report[pos - 1] == reportEndChar;
+			if (!isGroupDelimiter(report[pos]) ||
+				(!isReportEnd && !std::all_of(report.begin() + pos,
+					report.end(),
+					isGroupDelimiter)))
+			{
+				status.setError(ReportError::REPORT_TOO_LONG);
+				break;
+			}
+		}
+		if (pos == groupBegin) break;
+		if (stopBeforeRemarks &&
+			status.getReportPart() == ReportPart::RMK &&
+			status.getReportType() == ReportType::METAR)
+		{
+			return groupBegin;
+		}
+		std::string groupStr(report, groupBegin, pos - groupBegin);
 
 		// Check for report end character (=), it is normally appended to the end
 		// of last group, eg "NOSIG=" 
@@ -6608,12 +9270,35 @@ ParseResult Parser::parse(const std::string & report, size_t groupLimit) {
 			reportEnd = true;
 			groupStr.pop_back();
 		}
+		if (groupStr.length() > limits.groupLength) {
+			status.setError(ReportError::GROUP_TOO_LONG);
+			break;
+		}
+		ParseTraceRecorder::record(ParseTrace::Stage::TOKENIZE, traceTime, groupStrIndex);
 
 		if (groupStr.length()) {
 			Group group;
 			ReportPart reportPart = status.getReportPart();
+			const ReusableGroup * reusableGroup = nullptr;
+			const auto groupIndex = groupStrIndex;
+			if (reusable && groupStrIndex < reusable->size()) {
+				reusableGroup = &(*reusable)[groupStrIndex];
+			}
+			groupStrIndex++;
+			// Each attempt to append or to decode the string counts as work
+			// even if the decoded group is re-used or found in cache, so that
+			// the result does not depend on them
+			const auto attemptWork = groupStr.length() + 1;
+			if ((work += attemptWork) > limits.work) {
+				status.setError(ReportError::WORK_LIMIT_EXCEEDED);
+				break;
+			}
 			// Try to append the raw string to the last group first
-			if (!appendToLastResultGroup(result, groupStr, reportPart, reportMetadata)) {
+			traceTime = ParseTraceRecorder::now();
+			const auto isAppended =
+				appendToLastResultGroup(result, groupStr, reportPart, reportMetadata);
+			ParseTraceRecorder::record(ParseTrace::Stage::APPEND, traceTime, groupIndex);
+			if (!isAppended) {
 				// Raw string cannot be appended to the previous group or this is the first group
 				do {
 					// Try to parse group in a loop until no more re-parsing is required
@@ -6630,15 +9315,36 @@ ParseResult Parser::parse(const std::string & report, size_t groupLimit) {
 
 					// updating report part here is mandatory since the group may 
 					// be re-parsed with different report part
+					if ((work += attemptWork) > limits.work) {
+						status.setError(ReportError::WORK_LIMIT_EXCEEDED);
+						break;
+					}
+					const auto stage = status.isReparseRequired() ?
+						ParseTrace::Stage::REPARSE : ParseTrace::Stage::DECODE;
 					reportPart = status.getReportPart(); 
-					group = GroupParser::parse(groupStr, reportPart, reportMetadata);
+					traceTime = ParseTraceRecorder::now();
+					group = parseGroup(groupStr,
+						reportPart,
+						reportMetadata,
+						cache,
+						order,
+						reusableGroup);
+					ParseTraceRecorder::record(stage, traceTime, groupIndex);
+					traceTime = ParseTraceRecorder::now();
 					status.transition(getSyntaxGroup(group));
+					ParseTraceRecorder::record(ParseTrace::Stage::TRANSITION,
+						traceTime,
+						groupIndex);
+					if (status.isReparseRequired()) ParseStatsRecorder::reparse();
 					groupCount++;
-					if (groupCount >= groupLimit) status.setError(ReportError::REPORT_TOO_LARGE);
+					if (groupCount >= limits.groups) status.setError(ReportError::REPORT_TOO_LARGE);
 				} while(status.isReparseRequired()  && !status.isError());
+				if (status.getError() == ReportError::WORK_LIMIT_EXCEEDED) break;
 				// Update report metadata, e.g. set global report release time which can 
 				// be used by other groups (for example by PK WND group if hour is not specified)
+				traceTime = ParseTraceRecorder::now();
 				updateMetadata(group, reportMetadata);
+				ParseTraceRecorder::record(ParseTrace::Stage::METADATA, traceTime, groupIndex);
 				// Add group to result along with its report part and raw string
 				addGroupToResult(result,
 					std::move(group),
@@ -6647,68 +9353,340 @@ ParseResult Parser::parse(const std::string & report, size_t groupLimit) {
 			} else {
 				// Raw string was appended to the group, just increase group count
 				groupCount++;
-				if (groupCount >= groupLimit) status.setError(ReportError::REPORT_TOO_LARGE);
+				if (groupCount >= limits.groups) status.setError(ReportError::REPORT_TOO_LARGE);
 			}
 		}
-		
-		iter++;
 	}
+	return std::string::npos;
+}
+
+template <typename Result>
+void Parser::finishReport(Progress & progress, Result & result) {
+	const auto traceTime = ParseTraceRecorder::now();
+	auto & status = progress.status;
 	if (!result.groups.empty()) {
 		// if last group is incomplete, invalidate it by adding an empty string
-		appendToLastResultGroup(result, "", status.getReportPart(), reportMetadata);
+		appendToLastResultGroup(result, "", status.getReportPart(), progress.reportMetadata);
 		// but do not save this empty string if the group just rejects it
-		if (result.groups.back().rawString.empty()) result.groups.pop_back();
+		if (!rawStringLength(result.groups.back())) result.groups.pop_back();
 	}
 	status.finalTransition();
-	reportMetadata.type = status.getReportType();
-	reportMetadata.error = status.getError();
-	result.reportMetadata = std::move(reportMetadata);
-	return result;
+	result.reportMetadata = std::move(progress.reportMetadata);
+	result.reportMetadata.type = status.getReportType();
+	result.reportMetadata.error = status.getError();
+	result.sections.index(result.groups);
+	ParseTraceRecorder::record(ParseTrace::Stage::FINISH, traceTime);
 }
 
-bool Parser::appendToLastResultGroup(ParseResult & result,
-	const std::string & groupStr,
-	ReportPart reportPart,
-	const ReportMetadata & reportMetadata)
-{
-	// Unable to append if this is the first group
-	if (result.groups.empty()) return false;
-
-	// Do not append last group in result is fallback (unknown) group
-	// Fallback group is for case 'when everything else fails' and must be
-	// used only if all parse attempts by other groups failed
-	if (std::holds_alternative<FallbackGroup>(result.groups.back().group)) return false;
+#ifdef METAF_DEFINITIONS
 
-	GroupInfo & lastGroupInfo = result.groups.back();
-	Group lastGroup = lastGroupInfo.group;
+void Parser::parseLazy(const std::string & report,
+	const ParseLimits & limits,
+	GroupCache * cache,
+	LazyParseResult & result)
+{
+	ParseTraceRecorder::beginReport();
+	const auto traceTime = ParseTraceRecorder::now();
+	result.progress = Progress();
+	result.limits = limits;
+	result.deferred = false;
+	result.remarksText.clear();
+	result.result.groups.clear();
+	const auto remarksPos = parseGroups(report,
+		limits,
+		cache,
+		nullptr,
+		result.progress,
+		result.result,
+		true);
+	if (remarksPos != std::string::npos) {
+		// Find where the report ends and count the remarks; if the remarks
+		// may exceed any of the limits, decode them now so that the metadata
+		// reports the error
+		const auto reportLength = std::min(report.length(), limits.reportLength);
+		auto remarksEnd = remarksPos;
+		size_t groupCount = result.progress.groupCount;
+		// Appending and decoding of each remark group string is attempted
+		// at most once
+		size_t work = result.progress.work;
+		bool reportEnd = false;
+		bool isGroupTooLong = false;
+		while (remarksEnd < reportLength && !reportEnd) {
+			while (remarksEnd < reportLength &&
+				isGroupDelimiter(report[remarksEnd])) remarksEnd++;
+			const auto groupBegin = remarksEnd;
+			while (remarksEnd < reportLength &&
+				!isGroupDelimiter(report[remarksEnd])) remarksEnd++;
+			auto groupEnd = remarksEnd;
+			if (groupEnd > groupBegin && report[groupEnd - 1] == reportEndChar) {
+				reportEnd = true;
+				groupEnd--;
+			}
+			if (groupEnd > groupBegin) {
+				groupCount++;
+				work += 2 * (groupEnd - groupBegin + 1);
+				if (groupEnd - groupBegin > limits.groupLength) isGroupTooLong = true;
+			}
+		}
+		if (remarksEnd == reportLength && reportLength < report.length()) {
+			// Report length limit depends on the position of the remarks in
+			// the report, parse the entire report again
+			result.progress = Progress();
+			result.result.groups.clear();
+			parseGroups(report, limits, cache, nullptr, result.progress, result.result);
+			finishReport(result.progress, result.result);
+			ParseStatsRecorder::report();
+			ParseTraceRecorder::record(ParseTrace::Stage::REPORT, traceTime);
+			return;
+		}
+		result.remarksText = report.substr(remarksPos, remarksEnd - remarksPos);
+		result.deferred = true;
+		if (groupCount >= limits.groups || work > limits.work || isGroupTooLong) {
+			decodeRemarks(result, cache);
+			ParseStatsRecorder::report();
+			ParseTraceRecorder::record(ParseTrace::Stage::REPORT, traceTime);
+			return;
+		}
+		// Metadata and sections for the groups decoded so far; remarks
+		// do not change report type or error
+		auto & parseResult = result.result;
+		parseResult.reportMetadata = result.progress.reportMetadata;
+		parseResult.reportMetadata.type = result.progress.status.getReportType();
+		parseResult.reportMetadata.error = result.progress.status.getError();
+		parseResult.sections.index(parseResult.groups);
+		ParseStatsRecorder::report();
+		ParseTraceRecorder::record(ParseTrace::Stage::REPORT, traceTime);
+		return;
+	}
+	finishReport(result.progress, result.result);
+	ParseStatsRecorder::report();
+	ParseTraceRecorder::record(ParseTrace::Stage::REPORT, traceTime);
+}
 
-	const auto appendResult = std::visit(
-		[&](auto && gr) -> AppendResult {
-			return gr.append(groupStr, reportPart, reportMetadata);
-		}, lastGroup);
+void Parser::decodeRemarks(LazyParseResult & result, GroupCache * cache) {
+	parseGroups(result.remarksText,
+		result.limits,
+		cache,
+		nullptr,
+		result.progress,
+		result.result);
+	finishReport(result.progress, result.result);
+	result.deferred = false;
+	result.remarksText.clear();
+}
 
-	switch (appendResult) {
-		case AppendResult::APPENDED:
-		lastGroupInfo.group = std::move(lastGroup);
-		lastGroupInfo.rawString += groupDelimiterChar;
-		lastGroupInfo.rawString += groupStr;
-		return true;
+void Parser::decodeDeferredRemarks(LazyParseResult & result, GroupCache * cache) {
+	ParseTraceRecorder::beginReport();
+	const auto traceTime = ParseTraceRecorder::now();
+	decodeRemarks(result, cache);
+	ParseTraceRecorder::record(ParseTrace::Stage::REPORT, traceTime);
+}
 
-		case AppendResult::NOT_APPENDED:
-		return false;
 
-		case AppendResult::GROUP_INVALIDATED:
-		{
-			std::string prevStr = std::move(result.groups.back().rawString);
-			const auto prevRp = result.groups.back().reportPart; 
-			result.groups.pop_back();
-			addGroupToResult(result, FallbackGroup(), prevRp, std::move(prevStr));
-			return false;
-		}
-	}
+Group Parser::parseGroup(const std::string & group,
+	ReportPart reportPart,
+	const ReportMetadata & reportMetadata,
+	GroupCache * cache,
+	const GroupParseOrder * order)
+{
+	if (cache) return cache->parse(group, reportPart, reportMetadata, order);
+	if (order) return GroupParser::parse(group, reportPart, reportMetadata, *order);
+	return GroupParser::parse(group, reportPart, reportMetadata);
 }
 
-void Parser::addGroupToResult(ParseResult & result,
+Group Parser::parseGroup(const std::string & group,
+	ReportPart reportPart,
+	const ReportMetadata & reportMetadata,
+	GroupCache * cache,
+	const GroupParseOrder * order,
+	const ReusableGroup * reusable)
+{
+	// Decoding the group string depends only on the string, report part 
+	// and report time, so the group decoded from the same string with the
+	// same report part and report time is the same
+	if (reusable &&
+		reusable->groupInfo &&
+		reusable->groupInfo->reportPart == reportPart &&
+		reusable->groupInfo->rawString == group &&
+		isSameTime(reusable->reportTime, reportMetadata.reportTime))
+	{
+		return reusable->groupInfo->group;
+	}
+	return parseGroup(group, reportPart, reportMetadata, cache, order);
+}
+
+void Parser::findReusableGroups(const std::string & report,
+	std::size_t reportLength,
+	const ParseResult & previous,
+	ReusableGroups & reusable)
+{
+	// Split the report into group strings in the same way as parseGroups();
+	// the text after the report length limit is never parsed
+	std::vector<std::string_view> groupStrings;
+	const std::string_view r(report.data(), std::min(report.length(), reportLength));
+	for (std::size_t pos = 0; pos < r.length(); ) {
+		while (pos < r.length() && isGroupDelimiter(r[pos])) pos++;
+		const auto begin = pos;
+		while (pos < r.length() && !isGroupDelimiter(r[pos])) pos++;
+		auto groupStr = r.substr(begin, pos - begin);
+		const bool reportEnd = (!groupStr.empty() && groupStr.back() == reportEndChar);
+		if (reportEnd) groupStr.remove_suffix(1);
+		if (!groupStr.empty()) groupStrings.push_back(groupStr);
+		if (reportEnd) break;
+	}
+
+	// Previous group strings are restored from raw strings; only the groups
+	// which consist of a single group string were not modified by append()
+	// and may be re-used; fallback group may be the result of invalidation
+	std::vector<std::string_view> previousStrings;
+	ReusableGroups previousGroups;
+	ReportMetadata reportMetadata;
+	for (const auto & gi : previous.groups) {
+		const std::string_view raw(gi.rawString);
+		const auto isSingle = (raw.find(groupDelimiterChar) == std::string_view::npos);
+		const auto isReusable = isSingle && !raw.empty() &&
+			!std::holds_alternative<FallbackGroup>(gi.group);
+		for (std::size_t pos = 0; pos <= raw.length(); ) {
+			auto end = raw.find(groupDelimiterChar, pos);
+			if (end == std::string_view::npos) end = raw.length();
+			previousStrings.push_back(raw.substr(pos, end - pos));
+			previousGroups.push_back(ReusableGroup());
+			if (isReusable) {
+				previousGroups.back().groupInfo = &gi;
+				previousGroups.back().reportTime = reportMetadata.reportTime;
+			}
+			pos = end + 1;
+		}
+		updateMetadata(gi.group, reportMetadata);
+	}
+
+	std::vector<std::size_t> match;
+	matchGroupStrings(previousStrings, groupStrings, match);
+	reusable.clear();
+	reusable.resize(groupStrings.size());
+	for (auto i = 0u; i < match.size(); i++) {
+		if (match[i] != std::string::npos) reusable[i] = previousGroups[match[i]];
+	}
+}
+
+void Parser::matchGroupStrings(const std::vector<std::string_view> & a,
+	const std::vector<std::string_view> & b,
+	std::vector<std::size_t> & match)
+{
+	match.assign(b.size(), std::string::npos);
+	// Amended or corrected report usually differs from the original report
+	// in a few groups, so common beginning and end are matched first
+	std::size_t prefix = 0;
+	while (prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix]) {
+		match[prefix] = prefix;
+		prefix++;
+	}
+	std::size_t suffix = 0;
+	while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+		a[a.size() - suffix - 1] == b[b.size() - suffix - 1])
+	{
+		match[b.size() - suffix - 1] = a.size() - suffix - 1;
+		suffix++;
+	}
+	const int n = a.size() - prefix - suffix;
+	const int m = b.size() - prefix - suffix;
+	if (!n || !m) return;
+
+	// Search for the shortest edit script is limited to maxEdits, so that
+	// unrelated reports do not take quadratic time; if the limit is
+	// exceeded, only the common beginning and end are matched
+	static const int maxEdits = 32;
+	const auto maxD = std::min(n + m, maxEdits);
+	const auto offset = maxD + 1;
+	const auto width = 2 * maxD + 3;
+	std::vector<int> v(width), trace;
+	auto aStr = [&](int x) { return a[prefix + x]; };
+	auto bStr = [&](int y) { return b[prefix + y]; };
+	for (auto d = 0; d <= maxD; d++) {
+		trace.insert(trace.end(), v.begin(), v.end());
+		for (auto k = -d; k <= d; k += 2) {
+			auto x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ?
+				v[offset + k + 1] : v[offset + k - 1] + 1;
+			auto y = x - k;
+			while (x < n && y < m && aStr(x) == bStr(y)) { x++; y++; }
+			v[offset + k] = x;
+			if (x < n || y < m) continue;
+			// Shortest edit script found, trace back the matching strings
+			for (auto td = d; td >= 0; td--) {
+				const auto * tv = &trace[td * width];
+				const auto tk = x - y;
+				const auto prevK = 
+					(tk == -td || (tk != td && tv[offset + tk - 1] < tv[offset + tk + 1])) ?
+						tk + 1 : tk - 1;
+				const auto prevX = tv[offset + prevK];
+				const auto prevY = prevX - prevK;
+				while (x > prevX && y > prevY) {
+					x--; y--;
+					match[prefix + y] = prefix + x;
+				}
+				x = prevX;
+				y = prevY;
+			}
+			return;
+		}
+	}
+}
+
+bool Parser::isSameTime(const std::optional<MetafTime> & t1,
+	const std::optional<MetafTime> & t2)
+{
+	if (!t1.has_value() || !t2.has_value()) return (t1.has_value() == t2.has_value());
+	return (t1->day() == t2->day() &&
+		t1->hour() == t2->hour() &&
+		t1->minute() == t2->minute());
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Result>
+bool Parser::appendToLastResultGroup(Result & result,
+	const std::string & groupStr,
+	ReportPart reportPart,
+	const ReportMetadata & reportMetadata)
+{
+	// Unable to append if this is the first group
+	if (result.groups.empty()) return false;
+
+	// Do not append last group in result is fallback (unknown) group
+	// Fallback group is for case 'when everything else fails' and must be
+	// used only if all parse attempts by other groups failed
+	if (std::holds_alternative<FallbackGroup>(result.groups.back().group)) return false;
+
+	auto & lastGroupInfo = result.groups.back();
+	Group lastGroup = lastGroupInfo.group;
+
+	const auto appendResult = std::visit(
+		[&](auto && gr) -> AppendResult {
+			return gr.append(groupStr, reportPart, reportMetadata);
+		}, lastGroup);
+	ParseStatsRecorder::append(lastGroup.index(), appendResult);
+
+	switch (appendResult) {
+		case AppendResult::APPENDED:
+		lastGroupInfo.group = std::move(lastGroup);
+		appendRawString(result, groupStr);
+		return true;
+
+		case AppendResult::NOT_APPENDED:
+		return false;
+
+		case AppendResult::GROUP_INVALIDATED:
+		{
+			const auto prevRp = result.groups.back().reportPart; 
+			auto prevStr = removeLastGroup(result);
+			addGroupToResult(result, FallbackGroup(), prevRp, std::move(prevStr));
+			return false;
+		}
+	}
+}
+
+template <typename Result>
+void Parser::addGroupToResult(Result & result,
 	Group group,
 	ReportPart reportPart,
 	std::string groupString)
@@ -6716,7 +9694,7 @@ void Parser::addGroupToResult(ParseResult & result,
 	if (!result.groups.empty() && std::holds_alternative<FallbackGroup>(group)) {
 		// Check if both last group in result and curent group are
 		// fallback group (unknown), if yes try to append current group
-		GroupInfo & lastGroupInfo = result.groups.back();
+		auto & lastGroupInfo = result.groups.back();
 		auto lastFallbackGroup = std::get_if<FallbackGroup>(&lastGroupInfo.group);
 		if (lastFallbackGroup)
 		{
@@ -6724,20 +9702,118 @@ void Parser::addGroupToResult(ParseResult & result,
 			// should be appended if possible
 			const auto appendResult =
 				lastFallbackGroup->append(groupString, reportPart, missingMetadata);
+			ParseStatsRecorder::append(lastGroupInfo.group.index(), appendResult);
 
 			if (appendResult == AppendResult::APPENDED) {
 				// Appended successfully, just append raw group string as well
 				// Append may fail if max length of text that may be stored in
 				// the fallback (unknown) group is exceeded
-				lastGroupInfo.rawString += groupDelimiterChar;
-				lastGroupInfo.rawString += groupString;
+				appendRawString(result, groupString);
 				return;
 			}
 			// Unable to append to previous fallback group, add new group normally
 		}
 	}
-	GroupInfo groupInfo(std::move(group), reportPart, groupString);
-	result.groups.push_back(std::move(groupInfo));
+	addRawGroup(result, std::move(group), reportPart, std::move(groupString));
+}
+
+template <typename Allocator>
+void Parser::clearResult(BasicParseResult<Allocator> & result,
+	const std::string & report)
+{
+	(void)report;
+	result.groups.clear();
+}
+
+#ifdef METAF_DEFINITIONS
+
+void Parser::clearResult(CompactParseResult & result, const std::string & report) {
+	result.groups.clear();
+	result.text.clear();
+	result.text.reserve(report.length());
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+void Parser::addRawGroup(BasicParseResult<Allocator> & result,
+	Group group,
+	ReportPart reportPart,
+	std::string rawString)
+{
+	using String = typename BasicGroupInfo<Allocator>::String;
+	if constexpr (std::is_same_v<String, std::string>) {
+		result.groups.emplace_back(std::move(group), reportPart, std::move(rawString));
+	} else {
+		// Raw string and group info use the allocator of groups vector
+		result.groups.emplace_back(std::move(group),
+			reportPart,
+			String(rawString.data(), rawString.length(), result.groups.get_allocator()));
+	}
+}
+
+#ifdef METAF_DEFINITIONS
+
+void Parser::addRawGroup(CompactParseResult & result,
+	Group group,
+	ReportPart reportPart,
+	const std::string & rawString)
+{
+	// Groups are separated by delimiter in the text, same as the strings
+	// appended to a group
+	if (!result.groups.empty()) result.text += groupDelimiterChar;
+	const auto begin = static_cast<std::uint32_t>(result.text.length());
+	result.text += rawString;
+	result.groups.push_back(CompactGroupInfo{std::move(group),
+		reportPart,
+		begin,
+		static_cast<std::uint32_t>(result.text.length())});
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+void Parser::appendRawString(BasicParseResult<Allocator> & result,
+	const std::string & str)
+{
+	auto & rawString = result.groups.back().rawString;
+	rawString += groupDelimiterChar;
+	rawString += str;
+}
+
+#ifdef METAF_DEFINITIONS
+
+void Parser::appendRawString(CompactParseResult & result, const std::string & str) {
+	// Raw string of the last group is always at the end of the text
+	result.text += groupDelimiterChar;
+	result.text += str;
+	result.groups.back().end = static_cast<std::uint32_t>(result.text.length());
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename Allocator>
+std::string Parser::removeLastGroup(BasicParseResult<Allocator> & result) {
+	auto & rawString = result.groups.back().rawString;
+	std::string str;
+	if constexpr (std::is_same_v<std::decay_t<decltype(rawString)>, std::string>) {
+		str = std::move(rawString);
+	} else {
+		str.assign(rawString.data(), rawString.length());
+	}
+	result.groups.pop_back();
+	return str;
+}
+
+#ifdef METAF_DEFINITIONS
+
+std::string Parser::removeLastGroup(CompactParseResult & result) {
+	const auto & last = result.groups.back();
+	std::string str(result.text, last.begin, last.end - last.begin);
+	// Remove the raw string and the delimiter preceding it
+	result.text.resize(last.begin ? last.begin - 1 : 0);
+	result.groups.pop_back();
+	return str;
 }
 
 ReportPart Parser::Status::getReportPart() {
@@ -7040,6 +10116,1448 @@ void Parser::updateMetadata(const Group & group, ReportMetadata & reportMetadata
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void ObservationColumns::reserve(std::size_t reports) {
+	windDirection.reserve(reports);
+	windSpeed.reserve(reports);
+	gustSpeed.reserve(reports);
+	visibility.reserve(reports);
+	ceiling.reserve(reports);
+	airTemperature.reserve(reports);
+	dewPoint.reserve(reports);
+	pressure.reserve(reports);
+	weatherOffset.reserve(reports + 1);
+}
+
+void ObservationColumns::clear() {
+	windDirection.clear();
+	windSpeed.clear();
+	gustSpeed.clear();
+	visibility.clear();
+	ceiling.clear();
+	airTemperature.clear();
+	dewPoint.clear();
+	pressure.clear();
+	weather.clear();
+	weatherOffset.resize(1);
+	weatherOffset[0] = 0;
+}
+
+std::uint32_t ObservationColumns::weatherCode(const WeatherPhenomena & wp) {
+	std::uint32_t result = 
+		(static_cast<std::uint32_t>(wp.qualifier()) << 28) |
+		(static_cast<std::uint32_t>(wp.descriptor()) << 24);
+	const auto weather = wp.weather();
+	static const auto maxWeather = 3u;
+	for (auto i = 0u; i < weather.size() && i < maxWeather; i++) {
+		result |= static_cast<std::uint32_t>(weather[i]) << (i * 8);
+	}
+	return result;
+}
+
+void ObservationExtractor::extract(const ParseResult & parseResult,
+	ObservationColumns & columns)
+{
+	columns.windDirection.push_back(ObservationColumns::notReported);
+	columns.windSpeed.push_back(ObservationColumns::notReported);
+	columns.gustSpeed.push_back(ObservationColumns::notReported);
+	columns.visibility.push_back(ObservationColumns::notReported);
+	columns.ceiling.push_back(ObservationColumns::notReported);
+	columns.airTemperature.push_back(ObservationColumns::notReported);
+	columns.dewPoint.push_back(ObservationColumns::notReported);
+	columns.pressure.push_back(ObservationColumns::notReported);
+	const auto & body = parseResult.sections.body;
+	for (auto i = body.begin; i < body.end; i++) {
+		extractGroup(parseResult.groups[i].group, columns);
+	}
+	columns.weatherOffset.push_back(columns.weather.size());
+}
+
+void ObservationExtractor::extract(const std::vector<ParseResult> & parseResults,
+	ObservationColumns & columns)
+{
+	columns.reserve(columns.size() + parseResults.size());
+	for (const auto & parseResult : parseResults) extract(parseResult, columns);
+}
+
+void ObservationExtractor::extractGroup(const Group & group, 
+	ObservationColumns & columns)
+{
+	if (const auto gr = std::get_if<FixedGroup>(&group); gr) {
+		if (gr->type() == FixedGroup::Type::CAVOK) {
+			auto & ceiling = columns.ceiling.back();
+			columns.visibility.back() = 
+				Distance::cavokVisibility().toUnit(Distance::Unit::METERS).value();
+			if (!ObservationColumns::isReported(ceiling)) {
+				ceiling = ObservationColumns::unlimited;
+			}
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<WindGroup>(&group); gr) {
+		if (gr->type() != WindGroup::Type::SURFACE_WIND &&
+			gr->type() != WindGroup::Type::SURFACE_WIND_CALM &&
+			gr->type() != WindGroup::Type::SURFACE_WIND_WITH_VARIABLE_SECTOR) return;
+		if (const auto d = gr->direction().degrees(); d.has_value()) {
+			columns.windDirection.back() = *d;
+		}
+		if (const auto s = gr->windSpeed().toUnit(Speed::Unit::KNOTS); s.has_value()) {
+			columns.windSpeed.back() = *s;
+		}
+		if (const auto s = gr->gustSpeed().toUnit(Speed::Unit::KNOTS); s.has_value()) {
+			columns.gustSpeed.back() = *s;
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<VisibilityGroup>(&group); gr) {
+		if (gr->type() != VisibilityGroup::Type::PREVAILING &&
+			gr->type() != VisibilityGroup::Type::PREVAILING_NDV) return;
+		const auto v = gr->visibility().toUnit(Distance::Unit::METERS);
+		if (v.has_value()) columns.visibility.back() = *v;
+		return;
+	}
+	if (const auto gr = std::get_if<CloudGroup>(&group); gr) {
+		updateCeiling(*gr, columns.ceiling.back());
+		return;
+	}
+	if (const auto gr = std::get_if<WeatherGroup>(&group); gr) {
+		if (gr->type() != WeatherGroup::Type::CURRENT) return;
+		for (const auto & wp : gr->weatherPhenomena()) {
+			columns.weather.push_back(ObservationColumns::weatherCode(wp));
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<TemperatureGroup>(&group); gr) {
+		const auto t = gr->airTemperature().toUnit(Temperature::Unit::C);
+		if (t.has_value()) columns.airTemperature.back() = *t;
+		const auto dp = gr->dewPoint().toUnit(Temperature::Unit::C);
+		if (dp.has_value()) columns.dewPoint.back() = *dp;
+		return;
+	}
+	if (const auto gr = std::get_if<PressureGroup>(&group); gr) {
+		if (gr->type() != PressureGroup::Type::OBSERVED_QNH) return;
+		const auto p = gr->atmosphericPressure().toUnit(Pressure::Unit::HECTOPASCAL);
+		if (p.has_value()) columns.pressure.back() = *p;
+		return;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BatchConverter::validityMask(std::size_t size,
+	const float * values,
+	std::uint8_t * valid)
+{
+	for (std::size_t i = 0; i < size; i++) valid[i] = (values[i] == values[i]);
+}
+
+void BatchConverter::speedToUnit(std::size_t size,
+	const float * speed,
+	const std::uint8_t * valid,
+	Speed::Unit unit,
+	Speed::Unit resultUnit,
+	float * result)
+{
+	Speed s;
+	s.speedValue = 1;
+	s.speedUnit = unit;
+	const auto factor = s.toUnit(resultUnit).value_or(ObservationColumns::notReported);
+	linear(size, speed, valid, factor, 0.0, result);
+}
+
+void BatchConverter::distanceToUnit(std::size_t size,
+	const float * distance,
+	const std::uint8_t * valid,
+	Distance::Unit unit,
+	Distance::Unit resultUnit,
+	float * result)
+{
+	const auto factor = 
+		Distance(1, unit).toUnit(resultUnit).value_or(ObservationColumns::notReported);
+	linear(size, distance, valid, factor, 0.0, result);
+}
+
+void BatchConverter::pressureToUnit(std::size_t size,
+	const float * pressure,
+	const std::uint8_t * valid,
+	Pressure::Unit unit,
+	Pressure::Unit resultUnit,
+	float * result)
+{
+	Pressure p;
+	p.pressureValue = 1.0;
+	p.pressureUnit = unit;
+	const auto factor = p.toUnit(resultUnit).value_or(ObservationColumns::notReported);
+	linear(size, pressure, valid, factor, 0.0, result);
+}
+
+void BatchConverter::temperatureToUnit(std::size_t size,
+	const float * temperature,
+	const std::uint8_t * valid,
+	Temperature::Unit unit,
+	Temperature::Unit resultUnit,
+	float * result)
+{
+	// Same conversions as in Temperature::toUnit(); the result is not 
+	// reported for the unit pairs which are not supported by scalar version
+	static const auto factorCtoF = 1.8;
+	static const auto offsetCtoF = 32.0;
+	if (unit == resultUnit) {
+		linear(size, temperature, valid, 1.0, 0.0, result);
+		return;
+	}
+	if (unit == Temperature::Unit::C && resultUnit == Temperature::Unit::F) {
+		linear(size, temperature, valid, factorCtoF, offsetCtoF, result);
+		return;
+	}
+	linear(size, temperature, valid, 0.0, ObservationColumns::notReported, result);
+}
+
+void BatchConverter::relativeHumidity(std::size_t size,
+	const float * airTemperatureC,
+	const float * dewPointC,
+	const std::uint8_t * valid,
+	float * result)
+{
+	// Same formula as in Temperature::relativeHumidity(), ratio of actual and
+	// saturation vapour pressures is calculated as a single exponent
+	static const float ln10 = 2.30258509;
+	for (std::size_t i = 0; i < size; i++) {
+		const bool isValid = valid[i];
+		const float t = select(isValid, airTemperatureC[i], 0.0f);
+		const float dp = select(isValid, dewPointC[i], 0.0f);
+		const float x = 7.5f * dp / (237.7f + dp) - 7.5f * t / (237.7f + t);
+		const float rh = select(t < dp, 100.0f, 100.0f * exp(ln10 * x));
+		result[i] = select(isValid, rh, ObservationColumns::notReported);
+	}
+}
+
+void BatchConverter::heatIndex(std::size_t size,
+	const float * airTemperatureC,
+	const float * relativeHumidity,
+	const std::uint8_t * valid,
+	float * result,
+	std::uint8_t * resultValid)
+{
+	// Same formula and constraints as in Temperature::heatIndex()
+	static const float c1 = -8.78469475556;
+	static const float c2 = 1.61139411;
+	static const float c3 = 2.33854883889;
+	static const float c4 = -0.14611605;
+	static const float c5 = -0.012308094;
+	static const float c6 = -0.0164248277778;
+	static const float c7 = 0.002211732;
+	static const float c8 = 0.00072546;
+	static const float c9 = -0.000003582;
+	for (std::size_t i = 0; i < size; i++) {
+		const float t = airTemperatureC[i], r = relativeHumidity[i];
+		const bool isValid = (valid[i] != 0) & 
+			(t >= 27.0f) & (r >= 40.0f) & (r <= 100.0f);
+		const float hi = 
+			c1 + c2 * t + c3 * r + c4 * t * r +
+			c5 * t * t + c6 * r * r +
+			c7 * t * t * r + c8 * t * r * r + c9 * t * t * r * r;
+		result[i] = select(isValid, hi, ObservationColumns::notReported);
+		resultValid[i] = isValid;
+	}
+}
+
+void BatchConverter::windChill(std::size_t size,
+	const float * airTemperatureC,
+	const float * windSpeedKmh,
+	const std::uint8_t * valid,
+	float * result,
+	std::uint8_t * resultValid)
+{
+	// Same formula and constraints as in Temperature::windChill()
+	for (std::size_t i = 0; i < size; i++) {
+		const float t = airTemperatureC[i], w = windSpeedKmh[i];
+		const bool isValid = (valid[i] != 0) & (t <= 10.0f) & (w >= 4.8f);
+		const float v = select(isValid, w, 1.0f);
+		const float vPow = exp(0.16f * log(v));
+		const float wc = 13.12f + 0.6215f * t - 11.37f * vPow + 0.3965f * t * vPow;
+		result[i] = select(isValid, wc, ObservationColumns::notReported);
+		resultValid[i] = isValid;
+	}
+}
+
+void BatchConverter::linear(std::size_t size,
+	const float * values,
+	const std::uint8_t * valid,
+	float factor,
+	float offset,
+	float * result)
+{
+	for (std::size_t i = 0; i < size; i++) {
+		const float v = values[i] * factor + offset;
+		result[i] = select(valid[i], v, ObservationColumns::notReported);
+	}
+}
+
+float BatchConverter::select(bool condition, float valueTrue, float valueFalse) {
+	// Equivalent of (condition ? valueTrue : valueFalse) which is implemented
+	// with bitwise operations, since compiler does not auto-vectorise 
+	// conditional operator with float values unless trapping math is disabled
+	std::uint32_t bitsTrue, bitsFalse;
+	std::memcpy(&bitsTrue, &valueTrue, sizeof(bitsTrue));
+	std::memcpy(&bitsFalse, &valueFalse, sizeof(bitsFalse));
+	const std::uint32_t mask = 0u - static_cast<std::uint32_t>(condition);
+	const std::uint32_t bits = (bitsTrue & mask) | (bitsFalse & ~mask);
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+float BatchConverter::exp(float x) {
+	// Range reduction exp(x) = 2^n * exp(r) where |r| <= ln(2)/2, and exp(r)
+	// is approximated by Taylor series; relative error is below 3e-7
+	static const float log2e = 1.44269504;
+	static const float ln2hi = 0.693145751953125;
+	static const float ln2lo = 1.42860682e-6;
+	static const float roundingConstant = 12582912.0; // 1.5 * 2^23
+	static const float minArg = -87.0, maxArg = 88.0;
+	x = select(x < minArg, minArg, x);
+	x = select(x > maxArg, maxArg, x);
+	const float n = (x * log2e + roundingConstant) - roundingConstant;
+	const float r = (x - n * ln2hi) - n * ln2lo;
+	const float p = 1.0f + r * (1.0f + r * (1.0f / 2 + r * (1.0f / 6 + 
+		r * (1.0f / 24 + r * (1.0f / 120 + r * (1.0f / 720))))));
+	static const std::int32_t exponentBias = 127, mantissaBits = 23;
+	const std::int32_t scaleBits = 
+		(static_cast<std::int32_t>(n) + exponentBias) << mantissaBits;
+	float scale;
+	std::memcpy(&scale, &scaleBits, sizeof(scale));
+	return p * scale;
+}
+
+float BatchConverter::log(float x) {
+	// Range reduction log(x) = e * ln(2) + log(m) where sqrt(0.5) <= m < sqrt(2)
+	// and log(m) is approximated by series for 2 * atanh((m - 1) / (m + 1));
+	// argument must be positive normal number, relative error is below 3e-7
+	static const float ln2 = 0.693147181;
+	static const float sqrt2 = 1.41421356;
+	static const std::int32_t exponentBias = 127, mantissaBits = 23;
+	static const std::int32_t mantissaMask = 0x007FFFFF;
+	static const std::int32_t exponentOfOne = 0x3F800000;
+	std::int32_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	const float e = static_cast<float>((bits >> mantissaBits) - exponentBias);
+	bits = (bits & mantissaMask) | exponentOfOne;
+	float m;
+	std::memcpy(&m, &bits, sizeof(m));
+	const bool isLarge = m > sqrt2;
+	m = select(isLarge, m * 0.5f, m);
+	const float ef = select(isLarge, e + 1.0f, e);
+	const float s = (m - 1.0f) / (m + 1.0f);
+	const float s2 = s * s;
+	const float logm = 2.0f * s * (1.0f + s2 * (1.0f / 3 + s2 * (1.0f / 5 + 
+		s2 * (1.0f / 7 + s2 * (1.0f / 9)))));
+	return ef * ln2 + logm;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::optional<TafTimeline> TafTimeline::fromParseResult(
+	const ParseResult & parseResult)
+{
+	static const std::optional<TafTimeline> notCompiled;
+	if (parseResult.reportMetadata.type != ReportType::TAF) return notCompiled;
+
+	std::optional<TrendGroup> validity;
+	const auto & header = parseResult.sections.header;
+	for (auto i = header.begin; i < header.end; i++) {
+		const auto trend = std::get_if<TrendGroup>(&parseResult.groups[i].group);
+		if (trend && trend->isTimeSpanGroup()) { validity = *trend; break; }
+	}
+	if (!validity.has_value()) return notCompiled;
+
+	TafTimeline result;
+	result.referenceDay = validity->timeFrom()->day().value_or(0);
+	result.referenceKey = 0;
+	result.referenceKey = result.timeKey(*validity->timeFrom());
+	result.endKey = result.timeKey(*validity->timeTill());
+	if (result.endKey <= result.referenceKey) return notCompiled;
+
+	Period initial;
+	initial.from = *validity->timeFrom();
+	initial.till = *validity->timeTill();
+	initial.trend = *validity;
+	result.prevailingPeriods.push_back(initial);
+	result.prevailingBegin.push_back(result.referenceKey);
+
+	const auto & groups = parseResult.groups;
+	auto conditions = [&groups](ReportSections::Range range) {
+		TafConditions result;
+		for (auto i = range.begin; i < range.end; i++) addGroup(groups[i].group, result);
+		return result;
+	};
+	result.prevailingPeriods.front().conditions = conditions(parseResult.sections.body);
+	for (const auto & trend : parseResult.sections.trends) {
+		const auto & trendGroup = std::get<TrendGroup>(groups[trend.trendGroup].group);
+		result.addPeriod(trendGroup,
+			conditions(ReportSections::Range{trend.range.begin + 1, trend.range.end}));
+	}
+	result.buildSegments();
+	return result;
+}
+
+std::optional<std::size_t> TafTimeline::prevailingAt(
+	const MetafTime & time) const
+{
+	const auto key = timeKey(time);
+	if (key < referenceKey || key >= endKey) return std::optional<std::size_t>();
+	const auto it =
+		std::upper_bound(prevailingBegin.begin(), prevailingBegin.end(), key);
+	return (it - prevailingBegin.begin() - 1);
+}
+
+TafTimeline::Indices TafTimeline::temporaryAt(const MetafTime & time) const {
+	const auto key = timeKey(time);
+	if (key < referenceKey || key >= endKey) return Indices(0, 0);
+	const auto s = segment(key);
+	return Indices(segmentOffset[s], segmentOffset[s + 1]);
+}
+
+TafTimeline::Indices TafTimeline::prevailingBetween(const MetafTime & from,
+	const MetafTime & till) const
+{
+	const auto keyFrom = std::max(timeKey(from), referenceKey);
+	const auto keyTill = std::min(timeKey(till), endKey);
+	if (keyFrom >= keyTill) return Indices(0, 0);
+	const auto first =
+		std::upper_bound(prevailingBegin.begin(), prevailingBegin.end(), keyFrom);
+	const auto last =
+		std::lower_bound(prevailingBegin.begin(), prevailingBegin.end(), keyTill);
+	return Indices(first - prevailingBegin.begin() - 1,
+		last - prevailingBegin.begin());
+}
+
+std::vector<std::size_t> TafTimeline::temporaryBetween(const MetafTime & from,
+	const MetafTime & till) const
+{
+	std::vector<std::size_t> result;
+	const auto keyFrom = std::max(timeKey(from), referenceKey);
+	const auto keyTill = std::min(timeKey(till), endKey);
+	if (keyFrom >= keyTill) return result;
+	const auto first = segment(keyFrom), last = segment(keyTill - 1);
+	result.insert(result.end(),
+		segmentTemporary.begin() + segmentOffset[first],
+		segmentTemporary.begin() + segmentOffset[last + 1]);
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+int TafTimeline::timeKey(const MetafTime & time) const {
+	static const int minutesPerHour = 60;
+	static const int minutesPerDay = 24 * minutesPerHour;
+	static const unsigned int maxDay = 31;
+	const auto day = time.day().value_or(referenceDay);
+	auto key = static_cast<int>(day * minutesPerDay +
+		time.hour() * minutesPerHour + time.minute());
+	if (day < referenceDay) key += maxDay * minutesPerDay;
+	if (!time.day().has_value() && key < referenceKey) key += minutesPerDay;
+	return key;
+}
+
+std::size_t TafTimeline::segment(int key) const {
+	const auto it = std::upper_bound(segmentBegin.begin(), segmentBegin.end(), key);
+	return (it - segmentBegin.begin() - 1);
+}
+
+void TafTimeline::addPeriod(const TrendGroup & trend,
+	const TafConditions & conditions)
+{
+	switch (trend.type()) {
+		case TrendGroup::Type::FROM:
+		case TrendGroup::Type::BECMG:
+		break;
+
+		case TrendGroup::Type::TIME_SPAN:
+		if (trend.probability() == TrendGroup::Probability::NONE) return;
+		[[fallthrough]];
+		case TrendGroup::Type::TEMPO:
+		case TrendGroup::Type::INTER:
+		{
+			const auto begin = trend.timeFrom().has_value() ?
+				std::max(timeKey(*trend.timeFrom()), referenceKey) : referenceKey;
+			const auto end = trend.timeTill().has_value() ?
+				std::min(timeKey(*trend.timeTill()), endKey) : endKey;
+			if (begin >= end) return;
+			Period period;
+			period.from = (begin == referenceKey) ? validFrom() : *trend.timeFrom();
+			period.till = (end == endKey) ? validTill() : *trend.timeTill();
+			period.trend = trend;
+			period.conditions = conditions;
+			temporaryPeriods.push_back(std::move(period));
+			temporaryBegin.push_back(begin);
+			temporaryEnd.push_back(end);
+		}
+		return;
+
+		default:
+		return;
+	}
+
+	// Trend changes prevailing conditions; for BECMG trend time 'from' or
+	// time 'at' is the beginning of the transition period, and time 'till'
+	// is the end of the transition period
+	auto beginTime = trend.timeFrom();
+	if (!beginTime.has_value()) beginTime = trend.timeAt();
+	if (!beginTime.has_value()) return;
+	const auto begin = timeKey(*beginTime);
+	if (begin <= prevailingBegin.back() || begin >= endKey) return;
+
+	Period period;
+	period.from = *beginTime;
+	period.till = validTill();
+	period.trend = trend;
+	if (trend.type() == TrendGroup::Type::FROM) {
+		period.conditions = conditions;
+	} else {
+		period.conditions = prevailingPeriods.back().conditions;
+		applyChanges(conditions, period.conditions);
+	}
+	prevailingPeriods.back().till = *beginTime;
+	prevailingPeriods.push_back(period);
+	prevailingBegin.push_back(begin);
+
+	if (trend.type() != TrendGroup::Type::BECMG || !trend.timeTill().has_value()) {
+		return;
+	}
+	const auto end = timeKey(*trend.timeTill());
+	if (end <= begin) return;
+	prevailingPeriods.back().isTransition = true;
+	if (end >= endKey) return;
+	prevailingPeriods.back().till = *trend.timeTill();
+	period.from = *trend.timeTill();
+	prevailingPeriods.push_back(std::move(period));
+	prevailingBegin.push_back(end);
+}
+
+void TafTimeline::buildSegments() {
+	// Temporary periods are sorted by beginning time
+	std::vector<std::size_t> order(temporaryPeriods.size());
+	for (auto i = 0u; i < order.size(); i++) order[i] = i;
+	std::stable_sort(order.begin(), order.end(),
+		[this](std::size_t a, std::size_t b) {
+			return (temporaryBegin[a] < temporaryBegin[b]);
+		});
+	std::vector<Period> periods;
+	std::vector<int> begin, end;
+	for (const auto i : order) {
+		periods.push_back(std::move(temporaryPeriods[i]));
+		begin.push_back(temporaryBegin[i]);
+		end.push_back(temporaryEnd[i]);
+	}
+	temporaryPeriods = std::move(periods);
+	temporaryBegin = std::move(begin);
+	temporaryEnd = std::move(end);
+
+	segmentBegin = prevailingBegin;
+	segmentBegin.push_back(endKey);
+	segmentBegin.insert(segmentBegin.end(), temporaryBegin.begin(), temporaryBegin.end());
+	segmentBegin.insert(segmentBegin.end(), temporaryEnd.begin(), temporaryEnd.end());
+	std::sort(segmentBegin.begin(), segmentBegin.end());
+	segmentBegin.erase(std::unique(segmentBegin.begin(), segmentBegin.end()),
+		segmentBegin.end());
+
+	segmentOffset.push_back(0);
+	for (auto s = 0u; s < segmentBegin.size() - 1; s++) {
+		for (auto i = 0u; i < temporaryPeriods.size(); i++) {
+			if (temporaryBegin[i] > segmentBegin[s]) break;
+			if (temporaryEnd[i] > segmentBegin[s]) segmentTemporary.push_back(i);
+		}
+		segmentOffset.push_back(segmentTemporary.size());
+	}
+}
+
+void TafTimeline::addGroup(const Group & group, TafConditions & conditions) {
+	if (const auto gr = std::get_if<FixedGroup>(&group); gr) {
+		if (gr->type() == FixedGroup::Type::CAVOK) conditions.cavok = true;
+		if (gr->type() == FixedGroup::Type::NSW) conditions.nsw = true;
+		return;
+	}
+	if (const auto gr = std::get_if<WindGroup>(&group); gr) {
+		if (gr->type() == WindGroup::Type::SURFACE_WIND ||
+			gr->type() == WindGroup::Type::SURFACE_WIND_CALM ||
+			gr->type() == WindGroup::Type::SURFACE_WIND_WITH_VARIABLE_SECTOR)
+				conditions.wind = *gr;
+		return;
+	}
+	if (const auto gr = std::get_if<VisibilityGroup>(&group); gr) {
+		if (gr->type() == VisibilityGroup::Type::PREVAILING ||
+			gr->type() == VisibilityGroup::Type::PREVAILING_NDV)
+				conditions.visibility = *gr;
+		return;
+	}
+	if (const auto gr = std::get_if<CloudGroup>(&group); gr) {
+		conditions.clouds.push_back(*gr);
+		return;
+	}
+	if (const auto gr = std::get_if<WeatherGroup>(&group); gr) {
+		if (gr->type() == WeatherGroup::Type::CURRENT) conditions.weather.push_back(*gr);
+		return;
+	}
+}
+
+void TafTimeline::applyChanges(const TafConditions & changes,
+	TafConditions & conditions)
+{
+	if (changes.cavok) {
+		conditions.visibility.reset();
+		conditions.clouds.clear();
+		conditions.weather.clear();
+		conditions.cavok = true;
+		conditions.nsw = false;
+	}
+	if (changes.wind.has_value()) conditions.wind = changes.wind;
+	if (changes.visibility.has_value()) {
+		conditions.visibility = changes.visibility;
+		conditions.cavok = false;
+	}
+	if (!changes.clouds.empty()) {
+		conditions.clouds = changes.clouds;
+		conditions.cavok = false;
+	}
+	if (changes.nsw) {
+		conditions.weather.clear();
+		conditions.nsw = true;
+	}
+	if (!changes.weather.empty()) {
+		conditions.weather = changes.weather;
+		conditions.cavok = false;
+		conditions.nsw = false;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FlightCategory FlightCategoryClassifier::fromCeilingVisibility(
+	float ceilingFeet,
+	float visibilityMiles)
+{
+	auto result = FlightCategory::UNKNOWN;
+	if (!std::isnan(ceilingFeet)) {
+		auto c = FlightCategory::VFR;
+		if (ceilingFeet <= mvfrCeiling) c = FlightCategory::MVFR;
+		if (ceilingFeet < ifrCeiling) c = FlightCategory::IFR;
+		if (ceilingFeet < lifrCeiling) c = FlightCategory::LIFR;
+		result = std::max(result, c);
+	}
+	if (!std::isnan(visibilityMiles)) {
+		auto c = FlightCategory::VFR;
+		if (visibilityMiles <= mvfrVisibility) c = FlightCategory::MVFR;
+		if (visibilityMiles < ifrVisibility) c = FlightCategory::IFR;
+		if (visibilityMiles < lifrVisibility) c = FlightCategory::LIFR;
+		result = std::max(result, c);
+	}
+	return result;
+}
+
+FlightCategory FlightCategoryClassifier::classify(
+	const ParseResult & parseResult,
+	Mode mode)
+{
+	auto ceiling = ObservationColumns::notReported;
+	auto visibility = ObservationColumns::notReported;
+	const auto & body = parseResult.sections.body;
+	for (auto i = body.begin; i < body.end; i++) {
+		const auto ceilingFinal = 
+			checkGroup(parseResult.groups[i].group, ceiling, visibility);
+		if (mode != Mode::EARLY_EXIT) continue;
+		if (ceilingFinal && ObservationColumns::isReported(visibility)) break;
+		if (fromCeilingVisibility(ceiling, visibility) == FlightCategory::LIFR) break;
+	}
+	return fromCeilingVisibility(ceiling, visibility);
+}
+
+void FlightCategoryClassifier::classify(
+	const std::vector<ParseResult> & parseResults,
+	FlightCategory * result,
+	Mode mode)
+{
+	for (auto i = 0u; i < parseResults.size(); i++) {
+		result[i] = classify(parseResults[i], mode);
+	}
+}
+
+FlightCategory FlightCategoryClassifier::classify(
+	const TafConditions & conditions)
+{
+	auto ceiling = ObservationColumns::notReported;
+	auto visibility = ObservationColumns::notReported;
+	if (conditions.cavok) {
+		ceiling = ObservationColumns::unlimited;
+		visibility = Distance::cavokVisibility(true).toUnit(
+			Distance::Unit::STATUTE_MILES).value();
+	}
+	for (const auto & cloud : conditions.clouds) {
+		ObservationExtractor::updateCeiling(cloud, ceiling);
+	}
+	if (conditions.visibility.has_value()) {
+		const auto v = conditions.visibility->visibility().toUnit(
+			Distance::Unit::STATUTE_MILES);
+		if (v.has_value()) visibility = *v;
+	}
+	return fromCeilingVisibility(ceiling, visibility);
+}
+
+void FlightCategoryClassifier::classify(const TafTimeline & timeline,
+	FlightCategory * prevailing,
+	FlightCategory * temporary)
+{
+	for (auto i = 0u; i < timeline.prevailing().size(); i++) {
+		prevailing[i] = classify(timeline.prevailing()[i].conditions);
+	}
+	for (auto i = 0u; i < timeline.temporary().size(); i++) {
+		temporary[i] = classify(timeline.temporary()[i].conditions);
+	}
+}
+
+FlightCategory FlightCategoryClassifier::classifyAt(
+	const TafTimeline & timeline,
+	const MetafTime & time)
+{
+	const auto p = timeline.prevailingAt(time);
+	if (!p.has_value()) return FlightCategory::UNKNOWN;
+	auto result = classify(timeline.prevailing()[*p].conditions);
+	const auto t = timeline.temporaryAt(time);
+	for (auto i = t.first; i < t.second; i++) {
+		const auto index = timeline.activeTemporary()[i];
+		result = std::max(result, classify(timeline.temporary()[index].conditions));
+	}
+	return result;
+}
+
+bool FlightCategoryClassifier::checkGroup(const Group & group,
+	float & ceilingFeet,
+	float & visibilityMiles)
+{
+	if (const auto gr = std::get_if<FixedGroup>(&group); gr) {
+		if (gr->type() != FixedGroup::Type::CAVOK) return false;
+		ceilingFeet = ObservationColumns::unlimited;
+		visibilityMiles = Distance::cavokVisibility(true).toUnit(
+			Distance::Unit::STATUTE_MILES).value();
+		return true;
+	}
+	if (const auto gr = std::get_if<VisibilityGroup>(&group); gr) {
+		if (gr->type() != VisibilityGroup::Type::PREVAILING &&
+			gr->type() != VisibilityGroup::Type::PREVAILING_NDV) return false;
+		const auto v = gr->visibility().toUnit(Distance::Unit::STATUTE_MILES);
+		if (v.has_value()) visibilityMiles = *v;
+		return false;
+	}
+	if (const auto gr = std::get_if<CloudGroup>(&group); gr) {
+		ObservationExtractor::updateCeiling(*gr, ceilingFeet);
+		return (std::isfinite(ceilingFeet));
+	}
+	return false;
+}
+
+void ObservationExtractor::updateCeiling(const CloudGroup & group,
+	float & ceilingFeet)
+{
+	auto lowerCeiling = [&ceilingFeet](const Distance & height) {
+		const auto h = height.toUnit(Distance::Unit::FEET);
+		if (!h.has_value()) return;
+		if (!ObservationColumns::isReported(ceilingFeet) || *h < ceilingFeet) {
+			ceilingFeet = *h;
+		}
+	};
+	switch (group.amount()) {
+		case CloudGroup::Amount::BROKEN:
+		case CloudGroup::Amount::OVERCAST:
+		case CloudGroup::Amount::VARIABLE_BROKEN_OVERCAST:
+		lowerCeiling(group.height());
+		break;
+
+		case CloudGroup::Amount::OBSCURED:
+		lowerCeiling(group.verticalVisibility());
+		break;
+
+		case CloudGroup::Amount::NOT_REPORTED:
+		break;
+
+		default:
+		if (!ObservationColumns::isReported(ceilingFeet)) {
+			ceilingFeet = ObservationColumns::unlimited;
+		}
+		break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CurrentWeather CurrentWeatherExtractor::extract(const ParseResult & metar,
+	const ParseResult & taf)
+{
+	CurrentWeather result;
+	const auto metarValid = isValid(metar, ReportType::METAR);
+	const auto tafValid = isValid(taf, ReportType::TAF);
+	if (metarValid) {
+		result.source = CurrentWeather::Source::METAR;
+		extractMetar(metar, result);
+	} else if (tafValid) {
+		result.source = CurrentWeather::Source::TAF;
+		extractTaf(taf, result);
+	}
+	if (metarValid || tafValid) {
+		// Report time is in the report header rather than in the body
+		const auto & source = metarValid ? metar : taf;
+		const auto i = source.sections.firstOf<ReportTimeGroup>();
+		if (i < source.sections.header.end) {
+			result.reportTime = std::get<ReportTimeGroup>(source.groups[i].group).time();
+		}
+	}
+	if (tafValid) extractTemperatureForecast(taf, result);
+	return result;
+}
+
+CurrentWeather CurrentWeatherExtractor::extract(const Reports & reports,
+	GroupCache & cache)
+{
+	ParseResult metar, taf;
+	return extract(reports, metar, taf, cache);
+}
+
+CurrentWeather CurrentWeatherExtractor::extract(const Reports & reports,
+	ParseResult & metar,
+	ParseResult & taf,
+	GroupCache & cache)
+{
+	Parser::parse(reports.first, metar, cache);
+	Parser::parse(reports.second, taf, cache);
+	return extract(metar, taf);
+}
+
+void CurrentWeatherExtractor::extract(const Reports * reports,
+	std::size_t size,
+	CurrentWeather * result,
+	GroupCache & cache)
+{
+	// Parse results are shared by all reports of the batch
+	ParseResult metar, taf;
+	for (std::size_t i = 0; i < size; i++) {
+		result[i] = extract(reports[i], metar, taf, cache);
+	}
+}
+
+void CurrentWeatherExtractor::extract(const std::vector<Reports> & reports,
+	std::vector<CurrentWeather> & result,
+	GroupCache & cache)
+{
+	result.resize(reports.size());
+	extract(reports.data(), reports.size(), result.data(), cache);
+}
+
+bool CurrentWeatherExtractor::isValid(const ParseResult & parseResult,
+	ReportType type)
+{
+	return (parseResult.reportMetadata.type == type &&
+		parseResult.reportMetadata.error == ReportError::NONE);
+}
+
+void CurrentWeatherExtractor::extractMetar(const ParseResult & metar,
+	CurrentWeather & result)
+{
+	Speed windSpeed;
+	const auto & body = metar.sections.body;
+	for (auto i = body.begin; i < body.end; i++) {
+		const auto & group = metar.groups[i].group;
+		extractGroup(group, result, windSpeed);
+		if (const auto gr = std::get_if<TemperatureGroup>(&group); gr) {
+			const auto t = gr->airTemperature().toUnit(Temperature::Unit::C);
+			if (t.has_value()) {
+				result.airTemperature = *t;
+				result.perceivedTemperature = *t;
+			}
+			// Wind group is reported before temperature group
+			const auto windChill = 
+				Temperature::windChill(gr->airTemperature(), windSpeed);
+			if (const auto wc = windChill.toUnit(Temperature::Unit::C); wc.has_value()) {
+				result.perceivedTemperature = *wc;
+			}
+			// Relative humidity is calculated once and used for heat index
+			const auto rh = gr->relativeHumidity();
+			if (!rh.has_value()) continue;
+			result.relativeHumidity = *rh;
+			const auto heatIndex = 
+				Temperature::heatIndex(gr->airTemperature(), *rh);
+			if (const auto hi = heatIndex.toUnit(Temperature::Unit::C); hi.has_value()) {
+				result.perceivedTemperature = *hi;
+			}
+			continue;
+		}
+		if (const auto gr = std::get_if<PressureGroup>(&group); gr) {
+			if (gr->type() != PressureGroup::Type::OBSERVED_QNH) continue;
+			const auto p = 
+				gr->atmosphericPressure().toUnit(Pressure::Unit::HECTOPASCAL);
+			if (p.has_value()) result.pressure = *p;
+			continue;
+		}
+	}
+}
+
+void CurrentWeatherExtractor::extractTaf(const ParseResult & taf,
+	CurrentWeather & result)
+{
+	Speed windSpeed;
+	const auto & body = taf.sections.body;
+	for (auto i = body.begin; i < body.end; i++) {
+		extractGroup(taf.groups[i].group, result, windSpeed);
+	}
+}
+
+void CurrentWeatherExtractor::extractTemperatureForecast(const ParseResult & taf,
+	CurrentWeather & result)
+{
+	const auto first = taf.sections.firstOf<TemperatureForecastGroup>();
+	for (auto i = first; i < taf.groups.size(); i++) {
+		const auto gr = std::get_if<TemperatureForecastGroup>(&taf.groups[i].group);
+		if (!gr) continue;
+		const auto t = gr->airTemperature().toUnit(Temperature::Unit::C);
+		if (!t.has_value()) continue;
+		switch (gr->point()) {
+			case TemperatureForecastGroup::Point::MINIMUM:
+			result.airTemperatureLow = *t;
+			break;
+
+			case TemperatureForecastGroup::Point::MAXIMUM:
+			result.airTemperatureHigh = *t;
+			break;
+
+			default:
+			break;
+		}
+	}
+}
+
+void CurrentWeatherExtractor::extractGroup(const Group & group,
+	CurrentWeather & result,
+	Speed & windSpeed)
+{
+	if (const auto gr = std::get_if<FixedGroup>(&group); gr) {
+		if (gr->type() == FixedGroup::Type::CAVOK) {
+			result.visibility = 
+				Distance::cavokVisibility().toUnit(Distance::Unit::METERS).value();
+			result.cloud = CurrentWeather::Cloud::MOSTLY_CLEAR;
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<WindGroup>(&group); gr) {
+		if (gr->type() != WindGroup::Type::SURFACE_WIND &&
+			gr->type() != WindGroup::Type::SURFACE_WIND_CALM &&
+			gr->type() != WindGroup::Type::SURFACE_WIND_WITH_VARIABLE_SECTOR) return;
+		if (const auto d = gr->direction().degrees(); d.has_value()) {
+			result.windDirection = *d;
+		}
+		if (gr->direction().status() == Direction::Status::VARIABLE) {
+			result.isWindVariable = true;
+		}
+		windSpeed = gr->windSpeed();
+		if (const auto s = gr->windSpeed().toUnit(Speed::Unit::KNOTS); s.has_value()) {
+			result.windSpeed = *s;
+		}
+		if (const auto s = gr->gustSpeed().toUnit(Speed::Unit::KNOTS); s.has_value()) {
+			result.gustSpeed = *s;
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<VisibilityGroup>(&group); gr) {
+		if (gr->type() != VisibilityGroup::Type::PREVAILING &&
+			gr->type() != VisibilityGroup::Type::PREVAILING_NDV) return;
+		const auto v = gr->visibility().toUnit(Distance::Unit::METERS);
+		if (v.has_value()) result.visibility = *v;
+		return;
+	}
+	if (const auto gr = std::get_if<CloudGroup>(&group); gr) {
+		result.cloud = cloud(result.cloud, gr->amount());
+		if (gr->type() == CloudGroup::Type::CUMULONIMBUS ||
+			gr->type() == CloudGroup::Type::TOWERING_CUMULUS)
+		{
+			result.isStormClouds = true;
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<WeatherGroup>(&group); gr) {
+		if (gr->type() != WeatherGroup::Type::CURRENT) return;
+		for (const auto & wp : gr->weatherPhenomena()) {
+			if (result.weatherSize >= CurrentWeather::maxWeather) return;
+			result.weather[result.weatherSize++] = ObservationColumns::weatherCode(wp);
+		}
+		return;
+	}
+}
+
+CurrentWeather::Cloud CurrentWeatherExtractor::cloud(CurrentWeather::Cloud previous,
+	CloudGroup::Amount amount)
+{
+	// Cloud layers are reported in ascending order, the result is the maximum
+	// sky cover of all layers
+	auto cover = CurrentWeather::Cloud::NOT_REPORTED;
+	switch (amount) {
+		case CloudGroup::Amount::NCD:
+		case CloudGroup::Amount::NONE_CLR:
+		case CloudGroup::Amount::NONE_SKC:
+		cover = CurrentWeather::Cloud::CLEAR;
+		break;
+
+		case CloudGroup::Amount::NSC:
+		case CloudGroup::Amount::FEW:
+		case CloudGroup::Amount::SCATTERED:
+		case CloudGroup::Amount::VARIABLE_FEW_SCATTERED:
+		case CloudGroup::Amount::VARIABLE_SCATTERED_BROKEN:
+		cover = CurrentWeather::Cloud::MOSTLY_CLEAR;
+		break;
+
+		case CloudGroup::Amount::BROKEN:
+		case CloudGroup::Amount::VARIABLE_BROKEN_OVERCAST:
+		cover = CurrentWeather::Cloud::MOSTLY_CLOUDY;
+		break;
+
+		case CloudGroup::Amount::OVERCAST:
+		case CloudGroup::Amount::OBSCURED:
+		cover = CurrentWeather::Cloud::OVERCAST;
+		break;
+
+		default:
+		break;
+	}
+	return std::max(previous, cover);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::size_t StationRegistry::load(std::string_view text) {
+	std::size_t count = 0;
+	while (!text.empty()) {
+		const auto lineEnd = text.find('\n');
+		auto line = text.substr(0, lineEnd);
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.length() : lineEnd + 1);
+		const auto begin = line.find_first_not_of(" \t");
+		if (begin == std::string_view::npos) continue;
+		line.remove_prefix(begin);
+		const auto key = LocationGroup::stringToKey(line.substr(0, line.find_first_of(" \t\r")));
+		if (!key.has_value()) continue;
+		const auto previousSize = size();
+		add(*key);
+		if (size() != previousSize) count++;
+	}
+	return count;
+}
+
+StationRegistry::Id StationRegistry::add(std::uint32_t key) {
+	const auto [it, inserted] = ids.try_emplace(key, static_cast<Id>(keys.size()));
+	if (inserted) keys.push_back(key);
+	return it->second;
+}
+
+StationRegistry::Id StationRegistry::find(std::uint32_t key) const {
+	const auto it = ids.find(key);
+	if (it == ids.end()) return notFound;
+	return it->second;
+}
+
+StationRegistry::Id StationRegistry::find(const ParseResult & parseResult) const {
+	for (const auto & gi : parseResult.groups) {
+		if (const auto lg = std::get_if<LocationGroup>(&gi.group); lg) return find(*lg);
+	}
+	return notFound;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::size_t StationIndex::load(std::string_view text, StationRegistry & registry) {
+	static const char whitespace[] = " \t\r";
+	std::size_t count = 0;
+	while (!text.empty()) {
+		const auto lineEnd = text.find('\n');
+		auto line = text.substr(0, lineEnd);
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.length() : lineEnd + 1);
+		auto nextField = [&line]() {
+			const auto begin = line.find_first_not_of(whitespace);
+			if (begin == std::string_view::npos) return std::string_view();
+			line.remove_prefix(begin);
+			const auto field = line.substr(0, line.find_first_of(whitespace));
+			line.remove_prefix(field.length());
+			return field;
+		};
+		const auto key = LocationGroup::stringToKey(nextField());
+		if (!key.has_value()) continue;
+		const auto latitude = coordinate(nextField(), 90);
+		const auto longitude = coordinate(nextField(), 180);
+		if (!latitude.has_value() || !longitude.has_value()) continue;
+		set(registry.add(*key), *latitude, *longitude);
+		count++;
+	}
+	return count;
+}
+
+std::optional<float> StationIndex::coordinate(std::string_view field, float maxValue) {
+	if (field.empty()) return std::optional<float>();
+	const std::string str(field);
+	char * end = nullptr;
+	const auto value = std::strtof(str.c_str(), &end);
+	if (end != str.c_str() + str.length()) return std::optional<float>();
+	if (!(value >= -maxValue && value <= maxValue)) return std::optional<float>();
+	return value;
+}
+
+bool StationIndex::set(Id id, float latitude, float longitude) {
+	if (!(latitude >= -90 && latitude <= 90)) return false;
+	if (!(longitude >= -180 && longitude <= 180)) return false;
+	if (cells.empty()) cells.resize(latCells * lonCells);
+	if (id >= locations.size()) locations.resize(id + 1);
+	auto & location = locations[id];
+	const auto cell = 
+		static_cast<std::uint32_t>(latCell(latitude) * lonCells + lonCell(longitude));
+	if (location.cell != cell) {
+		remove(id);
+		cells[cell].push_back(id);
+		location.cell = cell;
+		stationCount++;
+	}
+	location.latitude = latitude;
+	location.longitude = longitude;
+	return true;
+}
+
+void StationIndex::remove(Id id) {
+	if (!contains(id)) return;
+	auto & cell = cells[locations[id].cell];
+	const auto it = std::find(cell.begin(), cell.end(), id);
+	*it = cell.back();
+	cell.pop_back();
+	locations[id].cell = noCell;
+	stationCount--;
+}
+
+bool StationIndex::contains(Id id) const {
+	return (id < locations.size() && locations[id].cell != noCell);
+}
+
+void StationIndex::clear() {
+	locations.clear();
+	cells.clear();
+	stationCount = 0;
+}
+
+void StationIndex::radius(float latitude,
+	float longitude,
+	float distance,
+	std::vector<Result> & result) const
+{
+	radius(latitude, longitude, distance, result, [](Id){ return true; });
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename F>
+void StationIndex::radius(float latitude,
+	float longitude,
+	float distance,
+	std::vector<Result> & result,
+	F filter) const
+{
+	result.clear();
+	if (cells.empty() || !(distance >= 0)) return;
+	// Range of cells which may contain the stations within the distance
+	const auto angle = std::min(static_cast<double>(distance) / earthRadius, pi);
+	const auto latMin = latitude - toDegrees(angle);
+	const auto latMax = latitude + toDegrees(angle);
+	auto lonFirst = 0, lonLast = lonCells - 1;
+	const auto cosLat = std::cos(toRadians(latitude));
+	if (latMin > -90 && latMax < 90 && std::sin(angle) < cosLat) {
+		const auto lonRange = toDegrees(std::asin(std::sin(angle) / cosLat));
+		if (lonRange < 180) {
+			lonFirst = static_cast<int>(std::floor(longitude - lonRange)) + lonCells / 2;
+			lonLast = static_cast<int>(std::floor(longitude + lonRange)) + lonCells / 2;
+			if (lonLast - lonFirst >= lonCells) { lonFirst = 0; lonLast = lonCells - 1; }
+		}
+	}
+	for (auto lat = latCell(latMin); lat <= latCell(latMax); lat++) {
+		for (auto lon = lonFirst; lon <= lonLast; lon++) {
+			const auto cell = lat * lonCells + (lon + lonCells) % lonCells;
+			for (const auto id : cells[cell]) {
+				const auto & l = locations[id];
+				const auto d = 
+					StationIndex::distance(latitude, longitude, l.latitude, l.longitude);
+				if (d <= distance && filter(id)) result.push_back(Result{id, d});
+			}
+		}
+	}
+}
+
+#ifdef METAF_DEFINITIONS
+
+void StationIndex::nearest(float latitude,
+	float longitude,
+	std::size_t n,
+	std::vector<Result> & result) const
+{
+	nearest(latitude, longitude, n, result, [](Id){ return true; });
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename F>
+void StationIndex::nearest(float latitude,
+	float longitude,
+	std::size_t n,
+	std::vector<Result> & result,
+	F filter) const
+{
+	// Radius search with increasing distance; n nearest stations are within 
+	// the distance once there are at least n stations found
+	static const float initialDistance = 60;
+	const auto maxDistance = static_cast<float>(earthRadius * pi);
+	result.clear();
+	if (!n) return;
+	for (auto d = initialDistance; ; d *= 2) {
+		radius(latitude, longitude, std::min(d, maxDistance), result, filter);
+		if (result.size() >= n || d >= maxDistance) break;
+	}
+	const auto size = std::min(n, result.size());
+	std::partial_sort(result.begin(), result.begin() + size, result.end(),
+		[](const Result & r1, const Result & r2){
+			if (r1.distance != r2.distance) return r1.distance < r2.distance;
+			return r1.id < r2.id;
+		});
+	result.resize(size);
+}
+
+#ifdef METAF_DEFINITIONS
+
+float StationIndex::distance(float latitude1,
+	float longitude1,
+	float latitude2,
+	float longitude2)
+{
+	// Haversine formula
+	const auto lat1 = toRadians(latitude1), lat2 = toRadians(latitude2);
+	const auto sinLat = std::sin((lat2 - lat1) / 2);
+	const auto sinLon = std::sin(toRadians(longitude2 - longitude1) / 2);
+	const auto a = sinLat * sinLat + std::cos(lat1) * std::cos(lat2) * sinLon * sinLon;
+	return static_cast<float>(2 * earthRadius * std::asin(std::sqrt(std::min(a, 1.0))));
+}
+
+int StationIndex::latCell(double latitude) {
+	const auto cell = static_cast<int>(std::floor(latitude)) + latCells / 2;
+	return std::clamp(cell, 0, latCells - 1);
+}
+
+int StationIndex::lonCell(double longitude) {
+	const auto cell = static_cast<int>(std::floor(longitude)) + lonCells / 2;
+	return (cell % lonCells + lonCells) % lonCells;
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename F>
+std::size_t SignificantChangeDetector::update(Id station,
+	const ParseResult & metar,
+	F f)
+{
+	if (metar.reportMetadata.type != ReportType::METAR ||
+		metar.reportMetadata.error != ReportError::NONE ||
+		metar.sections.body.empty()) return 0;
+	// Missing report
+	const auto fg = std::get_if<FixedGroup>(&metar.groups[metar.sections.body.begin].group);
+	if (fg && fg->type() == FixedGroup::Type::NIL) return 0;
+	if (station >= states.size()) states.resize(station + 1);
+	auto & previous = states[station];
+	const auto current = fromParseResult(metar);
+	if (!previous.isReported) {
+		previous = current;
+		return 0;
+	}
+
+	std::size_t count = 0;
+	auto event = [&](Event::Type type, float p, float c) {
+		Event e;
+		e.station = station;
+		e.type = type;
+		e.previous = p;
+		e.current = c;
+		f(static_cast<const Event &>(e));
+		count++;
+	};
+	auto isReported = [](float p, float c) {
+		return (ObservationColumns::isReported(p) && ObservationColumns::isReported(c));
+	};
+	if (isReported(previous.ceiling, current.ceiling) &&
+		band(previous.ceiling, options.ceilingFeet) != 
+			band(current.ceiling, options.ceilingFeet))
+	{
+		event(Event::Type::CEILING, previous.ceiling, current.ceiling);
+	}
+	if (isReported(previous.visibility, current.visibility) &&
+		band(previous.visibility, options.visibilityMeters) != 
+			band(current.visibility, options.visibilityMeters))
+	{
+		event(Event::Type::VISIBILITY, previous.visibility, current.visibility);
+	}
+	if (isReported(previous.windDirection, current.windDirection) &&
+		isReported(previous.windSpeed, current.windSpeed) &&
+		previous.windSpeed >= options.windShiftSpeed &&
+		current.windSpeed >= options.windShiftSpeed)
+	{
+		auto delta = std::fabs(current.windDirection - previous.windDirection);
+		if (delta > 180) delta = 360 - delta;
+		if (delta >= options.windShiftDegrees) {
+			event(Event::Type::WIND_SHIFT, previous.windDirection, current.windDirection);
+		}
+	}
+	if (previous.isThunderstorm != current.isThunderstorm) {
+		event(current.isThunderstorm ?
+				Event::Type::THUNDERSTORM_BEGIN : Event::Type::THUNDERSTORM_END,
+			ObservationColumns::notReported,
+			ObservationColumns::notReported);
+	}
+	if (previous.isFreezingPrecipitation != current.isFreezingPrecipitation) {
+		event(current.isFreezingPrecipitation ?
+				Event::Type::FREEZING_PRECIPITATION_BEGIN :
+				Event::Type::FREEZING_PRECIPITATION_END,
+			ObservationColumns::notReported,
+			ObservationColumns::notReported);
+	}
+	previous = current;
+	return count;
+}
+
+#ifdef METAF_DEFINITIONS
+
+std::size_t SignificantChangeDetector::update(Id station,
+	const ParseResult & metar,
+	std::vector<Event> & events)
+{
+	return update(station, metar, [&events](const Event & e){ events.push_back(e); });
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
+template <typename F>
+std::size_t SignificantChangeDetector::update(StationRegistry & registry,
+	const ParseResult & metar,
+	F f)
+{
+	const auto location = metar.sections.firstOf<LocationGroup>();
+	if (location == ReportSections::notFound) return 0;
+	const auto station = 
+		registry.add(std::get<LocationGroup>(metar.groups[location].group));
+	return update(station, metar, std::move(f));
+}
+
+#ifdef METAF_DEFINITIONS
+
+const SignificantChangeDetector::State & SignificantChangeDetector::state(
+	Id station) const
+{
+	static const State notReported;
+	if (station >= states.size()) return notReported;
+	return states[station];
+}
+
+SignificantChangeDetector::State SignificantChangeDetector::fromParseResult(
+	const ParseResult & metar)
+{
+	State result;
+	result.isReported = true;
+	const auto & body = metar.sections.body;
+	for (auto i = body.begin; i < body.end; i++) {
+		checkGroup(metar.groups[i].group, result);
+	}
+	return result;
+}
+
+void SignificantChangeDetector::checkGroup(const Group & group, State & state) {
+	if (const auto gr = std::get_if<FixedGroup>(&group); gr) {
+		if (gr->type() != FixedGroup::Type::CAVOK) return;
+		state.visibility = 
+			Distance::cavokVisibility().toUnit(Distance::Unit::METERS).value();
+		state.ceiling = ObservationColumns::unlimited;
+		return;
+	}
+	if (const auto gr = std::get_if<WindGroup>(&group); gr) {
+		if (gr->type() != WindGroup::Type::SURFACE_WIND &&
+			gr->type() != WindGroup::Type::SURFACE_WIND_CALM &&
+			gr->type() != WindGroup::Type::SURFACE_WIND_WITH_VARIABLE_SECTOR) return;
+		if (const auto d = gr->direction().degrees(); d.has_value()) {
+			state.windDirection = *d;
+		}
+		if (const auto s = gr->windSpeed().toUnit(Speed::Unit::KNOTS); s.has_value()) {
+			state.windSpeed = *s;
+		}
+		return;
+	}
+	if (const auto gr = std::get_if<VisibilityGroup>(&group); gr) {
+		if (gr->type() != VisibilityGroup::Type::PREVAILING &&
+			gr->type() != VisibilityGroup::Type::PREVAILING_NDV) return;
+		const auto v = gr->visibility().toUnit(Distance::Unit::METERS);
+		if (v.has_value()) state.visibility = *v;
+		return;
+	}
+	if (const auto gr = std::get_if<CloudGroup>(&group); gr) {
+		ObservationExtractor::updateCeiling(*gr, state.ceiling);
+		return;
+	}
+	if (const auto gr = std::get_if<WeatherGroup>(&group); gr) {
+		if (gr->type() == WeatherGroup::Type::CURRENT) checkWeather(*gr, state);
+		return;
+	}
+}
+
+void SignificantChangeDetector::checkWeather(const WeatherGroup & group,
+	State & state)
+{
+	// Weather phenomena are copied to the buffer on stack rather than
+	// allocated on heap; monotonic resource only falls back to the default
+	// resource if the buffer is not large enough
+	std::array<std::byte, 1024> buffer;
+	std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+	const auto phenomena = group.weatherPhenomena(
+		std::pmr::polymorphic_allocator<WeatherPhenomena>(&resource));
+	for (const auto & wp : phenomena) {
+		if (wp.qualifier() == WeatherPhenomena::Qualifier::RECENT) continue;
+		switch (wp.descriptor()) {
+			case WeatherPhenomena::Descriptor::THUNDERSTORM:
+			state.isThunderstorm = true;
+			break;
+
+			case WeatherPhenomena::Descriptor::FREEZING:
+			// Freezing fog is not precipitation
+			for (const auto w : wp.weather(
+				std::pmr::polymorphic_allocator<WeatherPhenomena::Weather>(&resource)))
+			{
+				if (w == WeatherPhenomena::Weather::DRIZZLE ||
+					w == WeatherPhenomena::Weather::RAIN ||
+					w == WeatherPhenomena::Weather::UNDETERMINED)
+				{
+					state.isFreezingPrecipitation = true;
+				}
+			}
+			break;
+
+			default:
+			break;
+		}
+	}
+}
+
+std::size_t SignificantChangeDetector::band(float value,
+	const std::vector<float> & thresholds)
+{
+	// Number of thresholds less or equal to value
+	return (std::upper_bound(thresholds.begin(), thresholds.end(), value) -
+		thresholds.begin());
+}
+
+#endif //#ifdef METAF_DEFINITIONS
+
 } //namespace metaf
 
 #endif //#ifndef METAF_HPP
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Parses crafted reports which attempt to make the parser slow (very long
+// group strings, long sequences of delimiters, large number of group
+// strings which are appended to the previous group or which are not
+// recognised) and checks that the parse time grows linearly with the
+// report size when the parse limits are disabled, and that the default
+// parse limits stop the parser with error
+// Usage: adversarial [size in characters]
+
+#include "metaf.hpp"
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <string>
+#include <cstdlib>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct AdversarialInput {
+	string_view name;
+	// Generates the report of approximately specified size
+	function<string(size_t)> generate;
+};
+
+static string repeat(string_view prefix, string_view s, size_t size) {
+	string result(prefix);
+	while (result.length() < size) result += s;
+	return result;
+}
+
+static const AdversarialInput inputs[] = {
+	{ "Long group string", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z ", "A", size);
+	}},
+	{ "Long group string of digits", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT ", "1", size);
+	}},
+	{ "Long cloud types group", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT RMK ", "CB1", size);
+	}},
+	{ "Long sector group", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT RMK LTG DSNT N", "-NE-N", size);
+	}},
+	{ "Long sequence of delimiters", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z", " \t\r\n", size) + "24015KT";
+	}},
+	{ "Unrecognised group strings", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT", " /", size);
+	}},
+	{ "Incomplete visibility groups", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT", " 1", size);
+	}},
+	{ "Incomplete peak wind groups", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT RMK", " PK", size);
+	}},
+	{ "Incomplete trends", [](size_t size) {
+		return repeat("TAF KZZZ 041130Z 0412/0512 24015KT P6SM FEW030", " TEMPO", size);
+	}},
+	{ "Repeated groups", [](size_t size) {
+		return repeat("METAR KZZZ 041153Z 24015KT", " BKN030", size);
+	}}
+};
+
+static string_view errorName(metaf::ReportError error) {
+	switch (error) {
+		case metaf::ReportError::NONE: return "none";
+		case metaf::ReportError::REPORT_TOO_LARGE: return "too many groups";
+		case metaf::ReportError::GROUP_TOO_LONG: return "group too long";
+		case metaf::ReportError::REPORT_TOO_LONG: return "report too long";
+		case metaf::ReportError::WORK_LIMIT_EXCEEDED: return "work limit exceeded";
+		default: return "syntax error";
+	}
+}
+
+static chrono::steady_clock::duration parseTime(const string & report,
+	const metaf::ParseLimits & limits,
+	metaf::ReportError & error)
+{
+	static const auto attempts = 3;
+	auto best = chrono::steady_clock::duration::max();
+	for (auto i = 0; i < attempts; i++) {
+		const auto begin = chrono::steady_clock::now();
+		const auto result = metaf::Parser::parse(report, limits);
+		const auto time = chrono::steady_clock::now() - begin;
+		error = result.reportMetadata.error;
+		if (time < best) best = time;
+	}
+	return best;
+}
+
+static bool checkInput(const AdversarialInput & input, size_t size) {
+	// Time grows linearly if the report which is 8 times larger is parsed
+	// at most 16 times slower; quadratic time would be 64 times slower
+	static const auto sizeRatio = 8;
+	static const auto maxTimeRatio = 16.0;
+	static const auto unlimited = numeric_limits<size_t>::max();
+	metaf::ParseLimits noLimits(unlimited);
+	noLimits.groupLength = unlimited;
+	noLimits.reportLength = unlimited;
+	noLimits.work = unlimited;
+
+	cout << input.name << ": ";
+	metaf::ReportError error;
+	const auto smallTime = parseTime(input.generate(size), noLimits, error);
+	const auto largeTime = parseTime(input.generate(size * sizeRatio), noLimits, error);
+	const auto smallUs = chrono::duration_cast<chrono::microseconds>(smallTime).count();
+	const auto largeUs = chrono::duration_cast<chrono::microseconds>(largeTime).count();
+	// Very short times are not reliable
+	static const auto minUs = 100;
+	const auto ratio = static_cast<double>(largeUs) / max<chrono::microseconds::rep>(smallUs, minUs);
+	cout << smallUs << " / " << largeUs << " microseconds without limits (ratio ";
+	cout << ratio << "), ";
+
+	const auto limitedTime = parseTime(input.generate(size * sizeRatio),
+		metaf::ParseLimits(),
+		error);
+	cout << chrono::duration_cast<chrono::microseconds>(limitedTime).count();
+	cout << " microseconds with default limits (" << errorName(error) << ")\n";
+
+	bool isOk = true;
+	if (ratio > maxTimeRatio) {
+		cout << "ERROR: parse time is not linear\n";
+		isOk = false;
+	}
+	if (error == metaf::ReportError::NONE) {
+		cout << "ERROR: default limits are not reached\n";
+		isOk = false;
+	}
+	return isOk;
+}
+
+int main(int argc, char ** argv) {
+	size_t size = 50000;
+	if (argc > 1) size = strtoul(argv[1], nullptr, 10);
+	cout << "Checking adversarial reports, " << size << " characters\n";
+	size_t errors = 0;
+	for (const auto & input : inputs) {
+		if (!checkInput(input, size)) errors++;
+	}
+	return (errors ? 1 : 0);
+}
@@ -0,0 +1,125 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Checks the latency of publishing current weather to the shared memory
+// observation board and reading it back; the reader opens the board by
+// name and therefore uses its own mapping, same as another process would
+
+#include "observationboard.hpp"
+#include "testdata_real.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unistd.h>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const auto repetitions = 100;
+static const auto handoffs = 1000;
+
+static bool isSame(const metaf::CurrentWeather & a, const metaf::CurrentWeather & b) {
+	return !memcmp(&a, &b, sizeof(metaf::CurrentWeather));
+}
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+	const auto name = "/metaf_board_check_" + to_string(getpid());
+	struct Station {
+		uint32_t key;
+		metaf::CurrentWeather weather;
+	};
+	// Test data contains several reports from some stations, only the latest
+	// one remains on the board
+	vector<Station> stations;
+	unordered_map<uint32_t, size_t> stationIndex;
+	for (const auto & data : testdata::realDataSet) {
+		const auto metar = metaf::Parser::parse(data.metar);
+		const auto taf = metaf::Parser::parse(data.taf);
+		const auto location = metar.sections.firstOf<metaf::LocationGroup>();
+		if (location == metaf::ReportSections::notFound) continue;
+		const auto key = get<metaf::LocationGroup>(metar.groups[location].group).key();
+		const auto weather = metaf::CurrentWeatherExtractor::extract(metar, taf);
+		const auto [it, isNew] = stationIndex.emplace(key, stations.size());
+		if (isNew) stations.push_back(Station{key, weather});
+		stations[it->second].weather = weather;
+	}
+
+	ObservationBoard writer, reader;
+	if (!writer.create(name, stations.size()) || !reader.open(name)) {
+		cout << "ERROR: cannot open board " << name << ": ";
+		cout << strerror(writer.error() ? writer.error() : reader.error()) << "\n";
+		return 1;
+	}
+	ObservationBoard::remove(name);
+
+	cout << "Checking observation board latency, " << stations.size() << " stations\n";
+	size_t errors = 0;
+	auto beginTime = chrono::steady_clock::now();
+	for (auto i = 0; i < repetitions; i++) {
+		for (const auto & s : stations) {
+			if (!writer.publish(s.key, s.weather)) errors++;
+		}
+	}
+	auto endTime = chrono::steady_clock::now();
+	const auto publishNs = chrono::duration_cast<chrono::nanoseconds>(endTime - beginTime).count();
+	cout << "Publish: " << publishNs / (repetitions * stations.size()) << " ns per record\n";
+
+	metaf::CurrentWeather weather;
+	uint64_t version = 0;
+	beginTime = chrono::steady_clock::now();
+	for (auto i = 0; i < repetitions; i++) {
+		for (const auto & s : stations) {
+			if (!reader.read(s.key, weather, &version) ||
+				!isSame(weather, s.weather) ||
+				version < static_cast<uint64_t>(repetitions)) errors++;
+		}
+	}
+	endTime = chrono::steady_clock::now();
+	const auto readNs = chrono::duration_cast<chrono::nanoseconds>(endTime - beginTime).count();
+	cout << "Read: " << readNs / (repetitions * stations.size()) << " ns per record\n";
+	if (reader.size() != stations.size()) errors++;
+
+	// Writer publishes a station and waits until the reader thread has seen
+	// it; the latency is measured from the start of publishing until the new
+	// version is read
+	atomic<int64_t> publishTime {0};
+	atomic<uint64_t> seenVersion {0};
+	int64_t totalLatency = 0;
+	const auto initialVersion = reader.version(stations.front().key);
+	thread readerThread([&](){
+		uint64_t last = initialVersion;
+		for (auto i = 0; i < handoffs; i++) {
+			uint64_t v;
+			metaf::CurrentWeather w;
+			while (!reader.read(stations.front().key, w, &v) || v == last) {
+				this_thread::yield();
+			}
+			const auto now = chrono::steady_clock::now().time_since_epoch();
+			totalLatency +=
+				chrono::duration_cast<chrono::nanoseconds>(now).count() - publishTime.load();
+			if (!isSame(w, stations.front().weather)) errors++;
+			last = v;
+			seenVersion.store(v, memory_order_release);
+		}
+	});
+	for (auto i = 0; i < handoffs; i++) {
+		const auto v = reader.version(stations.front().key);
+		const auto now = chrono::steady_clock::now().time_since_epoch();
+		publishTime.store(chrono::duration_cast<chrono::nanoseconds>(now).count());
+		writer.publish(stations.front().key, stations.front().weather);
+		while (seenVersion.load(memory_order_acquire) <= v) this_thread::yield();
+	}
+	readerThread.join();
+	cout << "Publish to read latency: " << totalLatency / handoffs << " ns\n";
+	if (errors) cout << "ERROR: " << errors << " mismatched records\n";
+	return (errors ? 1 : 0);
+}
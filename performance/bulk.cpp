@@ -0,0 +1,121 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Compares cost per report of processing the reports one by one (as the web
+// examples do) and in bulk; when built with emcc, run with node
+
+#include "bulk.hpp"
+#include "testdata_real.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void pack(vector<uint8_t> & buffer, const string & report) {
+	const auto length = static_cast<uint32_t>(report.length());
+	const auto pos = buffer.size();
+	buffer.resize(pos + sizeof(length) + length);
+	memcpy(buffer.data() + pos, &length, sizeof(length));
+	memcpy(buffer.data() + pos + sizeof(length), report.data(), length);
+}
+
+static void printStats(string_view name,
+	chrono::steady_clock::duration time,
+	size_t reports)
+{
+	const auto us = chrono::duration_cast<chrono::microseconds>(time).count();
+	cout << name << ": " << us << " microseconds, " << reports << " reports, ";
+	cout << (reports ? us / static_cast<double>(reports) : 0) << " microseconds per report\n";
+}
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+	static const auto repetitions = 10;
+	vector<pair<string, string>> stations;
+	vector<uint8_t> stationsBuffer, reportsBuffer;
+	for (const auto & data : testdata::realDataSet) {
+		stations.emplace_back(data.metar, data.taf);
+		pack(stationsBuffer, data.metar);
+		pack(stationsBuffer, data.taf);
+		if (!data.metar.empty()) pack(reportsBuffer, data.metar);
+		if (!data.taf.empty()) pack(reportsBuffer, data.taf);
+	}
+	const auto reportCount = BulkProcessor::countEntries(reportsBuffer.data(), 
+		reportsBuffer.size());
+
+	cout << "Checking current weather performance\n";
+	{
+		// Same as summary example: parse reports, copy results per station
+		const auto begin = chrono::steady_clock::now();
+		for (auto i = 0; i < repetitions; i++) {
+			for (const auto & s : stations) {
+				const auto cw = metaf::CurrentWeatherExtractor::extract(
+					metaf::Parser::parse(s.first), metaf::Parser::parse(s.second));
+				(void)cw;
+			}
+		}
+		printStats("One station per call", 
+			chrono::steady_clock::now() - begin, stations.size() * repetitions);
+	}
+	{
+		vector<PackedCurrentWeather> output(stations.size());
+		const auto begin = chrono::steady_clock::now();
+		for (auto i = 0; i < repetitions; i++) {
+			BulkProcessor::currentWeather(stationsBuffer.data(), stationsBuffer.size(),
+				output.data(), output.size());
+		}
+		printStats("Bulk, 1 thread",
+			chrono::steady_clock::now() - begin, stations.size() * repetitions);
+	}
+#ifdef WORKERPOOL_THREADS
+	{
+		vector<PackedCurrentWeather> output(stations.size());
+		const auto begin = chrono::steady_clock::now();
+		for (auto i = 0; i < repetitions; i++) {
+			BulkProcessor::currentWeather(stationsBuffer.data(), stationsBuffer.size(),
+				output.data(), output.size(), 0);
+		}
+		printStats("Bulk, hardware threads",
+			chrono::steady_clock::now() - begin, stations.size() * repetitions);
+	}
+#endif
+	cout << "\n";
+
+	cout << "Checking explain performance\n";
+	{
+		// Same as explain example: new string for each report
+		const auto begin = chrono::steady_clock::now();
+		for (auto i = 0; i < repetitions; i++) {
+			for (const auto & s : stations) {
+				for (const auto & report : { s.first, s.second }) {
+					if (report.empty()) continue;
+					string result;
+					ExplainDecoder().decode(report, result);
+				}
+			}
+		}
+		printStats("One report per call",
+			chrono::steady_clock::now() - begin, reportCount * repetitions);
+	}
+	{
+		vector<char> output(16 * 1024 * 1024);
+		vector<uint32_t> offsets(reportCount);
+		const auto begin = chrono::steady_clock::now();
+		for (auto i = 0; i < repetitions; i++) {
+			BulkProcessor::explain(reportsBuffer.data(), reportsBuffer.size(),
+				output.data(), output.size(), 
+				offsets.data(), offsets.size(),
+				ExplainDecoder::Format::HTML);
+		}
+		printStats("Bulk",
+			chrono::steady_clock::now() - begin, reportCount * repetitions);
+	}
+}
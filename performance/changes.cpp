@@ -0,0 +1,79 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Checks the time needed to update significant change detector with a new
+// METAR report for each of a large number of stations (one update cycle);
+// the reports from testdata_real.cpp are assigned to the stations in turn,
+// and the reports are parsed before the time is measured
+// Also checks that the detector does not allocate memory once reserved
+
+#include "metaf.hpp"
+#include "testdata_real.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory_resource>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Memory resource which counts allocations of the detector and passes them 
+// to new/delete
+class CountingResource : public pmr::memory_resource {
+public:
+	size_t allocations = 0;
+private:
+	void * do_allocate(size_t bytes, size_t alignment) override {
+		allocations++;
+		return pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void * p, size_t bytes, size_t alignment) override {
+		pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const pmr::memory_resource & other) const noexcept override {
+		return (this == &other);
+	}
+};
+
+static const auto stations = 50000;
+static const auto cycles = 10;
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+	vector<metaf::ParseResult> reports;
+	for (const auto & data : testdata::realDataSet) {
+		auto result = metaf::Parser::parse(data.metar);
+		if (result.reportMetadata.type != metaf::ReportType::METAR ||
+			result.reportMetadata.error != metaf::ReportError::NONE) continue;
+		reports.push_back(move(result));
+	}
+
+	cout << "Checking significant change detector, " << stations << " stations, ";
+	cout << reports.size() << " different reports\n";
+	CountingResource resource;
+	metaf::SignificantChangeDetector detector(&resource);
+	detector.reserve(stations);
+	size_t events = 0;
+	auto count = [&events](const metaf::SignificantChangeDetector::Event &) { events++; };
+	const auto allocationsBefore = resource.allocations;
+	for (auto cycle = 0; cycle < cycles; cycle++) {
+		events = 0;
+		const auto beginTime = chrono::steady_clock::now();
+		for (auto station = 0; station < stations; station++) {
+			const auto & report = reports[(station + cycle) % reports.size()];
+			detector.update(station, report, count);
+		}
+		const auto endTime = chrono::steady_clock::now();
+		const auto us = chrono::duration_cast<chrono::microseconds>(endTime - beginTime).count();
+		cout << "Cycle " << cycle << ": " << us << " microseconds, ";
+		cout << events << " events\n";
+	}
+	const auto allocated = resource.allocations - allocationsBefore;
+	if (allocated) cout << "ERROR: " << allocated << " memory allocations during update\n";
+	return (allocated ? 1 : 0);
+}
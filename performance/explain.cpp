@@ -0,0 +1,128 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "explain.hpp"
+#include "testdata_real.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Decodes all METAR and TAF reports from testdata_real.cpp a number of times
+/// and displays throughput of the explain decoder.
+class ExplainThroughputChecker {
+public:
+	ExplainThroughputChecker();
+	/// Decodes reports in batches using specified number of threads.
+	void runBatch(ostream & output, ExplainDecoder::Format format, unsigned int threads);
+	/// Decodes reports one by one into fixed-size buffer.
+	void runBuffer(ostream & output, ExplainDecoder::Format format);
+private:
+	static const inline auto repetitions = 20;
+	static const inline size_t bufferSize = 64 * 1024;
+	vector<string> reports;
+	static void printStats(ostream & output,
+		chrono::microseconds totalTime,
+		size_t reportCount,
+		size_t outputSize);
+	static string_view formatName(ExplainDecoder::Format format);
+};
+
+ExplainThroughputChecker::ExplainThroughputChecker() {
+	for (const auto & data : testdata::realDataSet) {
+		if (!data.metar.empty()) reports.push_back(data.metar);
+		if (!data.taf.empty()) reports.push_back(data.taf);
+	}
+}
+
+void ExplainThroughputChecker::runBatch(ostream & output,
+	ExplainDecoder::Format format,
+	unsigned int threads)
+{
+	const ExplainDecoder decoder(format);
+	vector<string> outputs;
+	size_t outputSize = 0;
+	const auto beginTime = chrono::steady_clock::now();
+	for (auto i = 0; i < repetitions; i++) {
+		decoder.decode(reports, outputs, threads);
+		for (const auto & o : outputs) outputSize += o.length();
+	}
+	const auto endTime = chrono::steady_clock::now();
+	output << formatName(format) << ", batch, ";
+	if (threads) {
+		output << threads << " thread(s): ";
+	} else {
+		output << "hardware threads: ";
+	}
+	printStats(output,
+		chrono::duration_cast<chrono::microseconds>(endTime - beginTime),
+		reports.size() * repetitions,
+		outputSize);
+}
+
+void ExplainThroughputChecker::runBuffer(ostream & output,
+	ExplainDecoder::Format format)
+{
+	const ExplainDecoder decoder(format);
+	vector<char> buffer(bufferSize);
+	size_t outputSize = 0;
+	const auto beginTime = chrono::steady_clock::now();
+	for (auto i = 0; i < repetitions; i++) {
+		for (const auto & report : reports) {
+			outputSize += decoder.decode(report, buffer.data(), buffer.size());
+		}
+	}
+	const auto endTime = chrono::steady_clock::now();
+	output << formatName(format) << ", caller's buffer, 1 thread: ";
+	printStats(output,
+		chrono::duration_cast<chrono::microseconds>(endTime - beginTime),
+		reports.size() * repetitions,
+		outputSize);
+}
+
+void ExplainThroughputChecker::printStats(ostream & output,
+	chrono::microseconds totalTime,
+	size_t reportCount,
+	size_t outputSize)
+{
+	const auto seconds = static_cast<double>(totalTime.count()) / 1000000;
+	output << totalTime.count() << " microseconds, ";
+	output << reportCount << " reports, ";
+	if (seconds > 0) {
+		output << static_cast<unsigned long>(reportCount / seconds);
+		output << " reports per second, ";
+		output << static_cast<unsigned long>(outputSize / seconds / 1024);
+		output << " KB of output per second";
+	}
+	output << "\n";
+}
+
+string_view ExplainThroughputChecker::formatName(ExplainDecoder::Format format) {
+	switch (format) {
+		case ExplainDecoder::Format::HTML: return "HTML";
+		case ExplainDecoder::Format::TEXT: return "Plain text";
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+	cout << "Checking explain decoder throughput\n";
+	ExplainThroughputChecker checker;
+	for (auto format : { ExplainDecoder::Format::HTML, ExplainDecoder::Format::TEXT }) {
+		checker.runBuffer(cout, format);
+		for (auto threads : { 1u, 2u, 4u, 0u }) {
+			checker.runBatch(cout, format, threads);
+		}
+		cout << "\n";
+	}
+}
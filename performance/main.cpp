@@ -14,6 +14,8 @@
 #include <functional>
 #include <regex>
 #include <sstream>
+#include <iterator>
+#include <fstream>
 
 using namespace std;
 
@@ -150,7 +152,7 @@ void PerformanceCheckerBase::run(ostream & output) {
 		output << "Test failed.\n";
 		return;
 	}
-	auto totalTime = chrono::microseconds(endTime - beginTime);
+	auto totalTime = chrono::duration_cast<chrono::microseconds>(endTime - beginTime);
 	auto averageTimePerItem = chrono::microseconds(totalTime / itemCount);
 	if (totalTime.count()) {
 		output << totalTime.count() << " microseconds, ";
@@ -177,22 +179,33 @@ void PerformanceCheckerBase::run(ostream & output) {
 
 /// Parses all METAR and TAF reports from testdata_real.cpp and displays 
 /// performance stats of parsing entire report.
+/// If group parse order is specified, it is used to parse the reports.
 class ParserPerformanceChecker : public PerformanceCheckerBase {
 public:
-	ParserPerformanceChecker() { setItemName("report"); }
+	ParserPerformanceChecker(const metaf::GroupParseOrder * order = nullptr) :
+		groupParseOrder(order) { setItemName("report"); }
 protected:
 	virtual int process();
+private:
+	const metaf::GroupParseOrder * groupParseOrder = nullptr;
+	void parse(const string & report) {
+		if (groupParseOrder) {
+			metaf::Parser::parse(report, *groupParseOrder);
+			return;
+		}
+		metaf::Parser::parse(report);
+	}
 };
 
 int ParserPerformanceChecker::process() {
 	auto reportCount = 0;
 	for (const auto & data : testdata::realDataSet) {
  		if (!data.metar.empty()) {
-			metaf::Parser::parse(data.metar);
+			parse(data.metar);
 			reportCount++;
 		}
 		if (!data.taf.empty()) {
-			metaf::Parser::parse(data.taf);
+			parse(data.taf);
 			reportCount++;
 		}
 	}
@@ -233,6 +246,106 @@ int GroupPerformanceChecker::process() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// Air temperature, dew point and wind speed values used to compare 
+/// performance of scalar and batch derived values calculation.
+class DerivedValuesTestSet {
+public:
+	DerivedValuesTestSet();
+	size_t size() const { return airTemperature.size(); }
+	vector<metaf::Temperature> airTemperature;
+	vector<metaf::Temperature> dewPoint;
+	vector<metaf::Speed> windSpeed;
+	vector<float> airTemperatureC;
+	vector<float> dewPointC;
+	vector<float> windSpeedKmh;
+	vector<uint8_t> valid;
+private:
+	static string twoDigits(int value);
+};
+
+DerivedValuesTestSet::DerivedValuesTestSet() {
+	static const auto valueCount = 1000000;
+	for (auto i = 0; i < valueCount; i++) {
+		const auto t = i % 81 - 40;
+		const auto dp = t - i % 23;
+		const auto ws = i % 60;
+		airTemperature.push_back(*metaf::Temperature::fromString(twoDigits(t)));
+		dewPoint.push_back(*metaf::Temperature::fromString(twoDigits(dp)));
+		windSpeed.push_back(*metaf::Speed::fromString(twoDigits(ws), 
+			metaf::Speed::Unit::KILOMETERS_PER_HOUR));
+		airTemperatureC.push_back(t);
+		dewPointC.push_back(dp);
+		windSpeedKmh.push_back(ws);
+	}
+	valid.resize(size());
+	metaf::BatchConverter::validityMask(size(), airTemperatureC.data(), valid.data());
+}
+
+string DerivedValuesTestSet::twoDigits(int value) {
+	string result = (value < 0) ? "M" : "";
+	if (value < 0) value = -value;
+	if (value < 10) result += "0";
+	return result + to_string(value);
+}
+
+/// Calculates relative humidity and wind chill for each value of the test set 
+/// using Temperature methods.
+class ScalarDerivedValuesChecker : public PerformanceCheckerBase {
+public:
+	ScalarDerivedValuesChecker(const DerivedValuesTestSet & ts) : testSet(&ts) {
+		setItemName("value");
+	}
+protected:
+	virtual int process();
+private:
+	const DerivedValuesTestSet * testSet = nullptr;
+};
+
+int ScalarDerivedValuesChecker::process() {
+	auto checksum = 0.0;
+	for (auto i = 0u; i < testSet->size(); i++) {
+		const auto rh = metaf::Temperature::relativeHumidity(
+			testSet->airTemperature[i], testSet->dewPoint[i]);
+		const auto wc = metaf::Temperature::windChill(
+			testSet->airTemperature[i], testSet->windSpeed[i]);
+		checksum += rh.value_or(0) + wc.temperature().value_or(0);
+	}
+	if (checksum == 0) return 0;
+	return testSet->size();
+}
+
+/// Calculates relative humidity and wind chill for all values of the test set 
+/// using BatchConverter.
+class BatchDerivedValuesChecker : public PerformanceCheckerBase {
+public:
+	BatchDerivedValuesChecker(const DerivedValuesTestSet & ts) : testSet(&ts) {
+		setItemName("value");
+	}
+protected:
+	virtual int process();
+private:
+	const DerivedValuesTestSet * testSet = nullptr;
+};
+
+int BatchDerivedValuesChecker::process() {
+	vector<float> rh(testSet->size()), wc(testSet->size());
+	vector<uint8_t> wcValid(testSet->size());
+	metaf::BatchConverter::relativeHumidity(testSet->size(),
+		testSet->airTemperatureC.data(), testSet->dewPointC.data(),
+		testSet->valid.data(), rh.data());
+	metaf::BatchConverter::windChill(testSet->size(),
+		testSet->airTemperatureC.data(), testSet->windSpeedKmh.data(),
+		testSet->valid.data(), wc.data(), wcValid.data());
+	auto checksum = 0.0;
+	for (auto i = 0u; i < testSet->size(); i++) {
+		checksum += rh[i] + (wcValid[i] ? wc[i] : 0);
+	}
+	if (checksum == 0) return 0;
+	return testSet->size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 
 /// Splits METAR or TAF report into individual groups and saves group string 
 /// along with associated report parts. The strings associated with a certain
@@ -449,6 +562,43 @@ void printDataSize(){
 	cout << endl;
 }
 
+/// Display parse instrumentation counters collected while running other
+/// checks; only available if compiled with METAF_PARSE_STATS defined.
+void printParseStats() {
+	if (!metaf::ParseStats::enabled) return;
+	const auto stats = metaf::ParseStats::snapshot();
+	cout << "Parse statistics for " << stats.reports << " reports, ";
+	cout << stats.reparses << " re-parses\n";
+	for (auto i = 0u; i < stats.alternatives.size(); i++) {
+		const auto & a = stats.alternatives[i];
+		cout << groupName(i) << ": ";
+		cout << a.parseAttempts << " attempts, ";
+		cout << a.parsed << " parsed, ";
+		cout << a.rejected() << " rejected, ";
+		if (a.parseNanoseconds) cout << a.parseNanoseconds << " ns, ";
+		cout << a.appendAttempts << " append attempts (";
+		cout << a.appended << " appended, ";
+		cout << a.notAppended << " not appended, ";
+		cout << a.invalidated << " invalidated)\n";
+	}
+	cout << endl;
+}
+
+/// Write the trace of the slowest reports parsed by the last checks in
+/// Chrome trace event format; only available if compiled with
+/// METAF_PARSE_TRACE defined.
+void writeParseTrace() {
+	if (!metaf::ParseTrace::enabled) return;
+	static const auto fileName = "parse_trace.json";
+	static const auto minReportNanoseconds = 20000u;
+	const auto events = metaf::ParseTrace::events();
+	ofstream file(fileName);
+	file << metaf::ParseTrace::toChromeTrace(events, minReportNanoseconds);
+	cout << "Parse trace of the reports which took at least ";
+	cout << minReportNanoseconds / 1000 << " microseconds is written to ";
+	cout << fileName << "\n";
+}
+
 int main(int argc, char ** argv) {
 	(void) argc; (void) argv;
 	{
@@ -457,6 +607,19 @@ int main(int argc, char ** argv) {
 		checker.run(cout);
 		cout << "\n";
 	}
+	{
+		cout << "Checking parser performance with group parse order based on ";
+		cout << "group frequency\n";
+		metaf::GroupFrequency frequency;
+		for (const auto & data : testdata::realDataSet) {
+			if (!data.metar.empty()) frequency.add(metaf::Parser::parse(data.metar));
+			if (!data.taf.empty()) frequency.add(metaf::Parser::parse(data.taf));
+		}
+		const auto order = metaf::GroupParseOrder::fromFrequency(frequency);
+		ParserPerformanceChecker checker(&order);
+		checker.run(cout);
+		cout << "\n";
+	}
 	{
 		cout << "Checking group performance\n";
 		GroupsTestSet groupsTestSet;
@@ -465,6 +628,18 @@ int main(int argc, char ** argv) {
 		groupsTestSet.runPerformanceTests(cout);
 		cout << "\n";
 	}
+	{
+		DerivedValuesTestSet derivedValuesTestSet;
+		cout << "Checking scalar derived values performance\n";
+		ScalarDerivedValuesChecker scalarChecker(derivedValuesTestSet);
+		scalarChecker.run(cout);
+		cout << "Checking batch derived values performance\n";
+		BatchDerivedValuesChecker batchChecker(derivedValuesTestSet);
+		batchChecker.run(cout);
+		cout << "\n";
+	}
 	checkRecognisedGroups();
 	printDataSize();
+	printParseStats();
+	writeParseTrace();
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Checks throughput of the ingest pipeline with different number of parser
+// threads; the reports from testdata_real.cpp are read from memory, so that
+// the pipeline itself rather than input is the bottleneck
+
+#include "pipeline.hpp"
+#include "testdata_real.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const auto repetitions = 20;
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+	vector<string> reports;
+	string input;
+	for (auto i = 0; i < repetitions; i++) {
+		for (const auto & data : testdata::realDataSet) {
+			for (const auto & report : { data.metar, data.taf }) {
+				// Leading and trailing whitespace is not passed to the sink
+				const auto begin = report.find_first_not_of(" ");
+				if (begin == string::npos) continue;
+				reports.push_back(report.substr(begin, report.find_last_not_of(" ") - begin + 1));
+				input += report;
+				input += "\n\n";
+			}
+		}
+	}
+	vector<size_t> expectedGroups;
+	for (auto i = 0u; i < reports.size() / repetitions; i++) {
+		expectedGroups.push_back(metaf::Parser::parse(reports[i]).groups.size());
+	}
+
+	cout << "Checking ingest pipeline throughput\n";
+	for (auto parsers : { 1u, 2u, 4u, 0u }) {
+		IngestPipeline::Options options;
+		options.parsers = parsers;
+		IngestPipeline pipeline(options);
+		size_t position = 0, index = 0, errors = 0;
+		const auto beginTime = chrono::steady_clock::now();
+		pipeline.run(
+			[&](char * buffer, size_t size){
+				const auto count = min(size, input.length() - position);
+				memcpy(buffer, input.data() + position, count);
+				position += count;
+				return count;
+			},
+			[&](const string & report, const metaf::ParseResult & result){
+				const auto expected = index % expectedGroups.size();
+				if (report != reports[index] ||
+					result.groups.size() != expectedGroups[expected]) errors++;
+				index++;
+			});
+		const auto endTime = chrono::steady_clock::now();
+		const auto us = chrono::duration_cast<chrono::microseconds>(endTime - beginTime).count();
+		const auto stats = pipeline.stats();
+		cout << pipeline.parsers() << " parser thread(s): ";
+		cout << us << " microseconds, ";
+		cout << stats.reportsWritten << " reports, ";
+		if (us) cout << static_cast<unsigned long>(stats.reportsWritten * 1000000.0 / us) << " reports per second, ";
+		cout << stats.sourceStalls << " source stalls, ";
+		cout << stats.sinkStalls << " sink stalls";
+		if (errors || index != reports.size()) cout << ", ERROR: " << errors << " mismatched reports";
+		cout << "\n";
+	}
+}
@@ -0,0 +1,70 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Checks query and update time of the station index, using the number of 
+// stations similar to global METAR station set
+
+#include "metaf.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const auto stationCount = 10000u;
+static const auto queryCount = 100000u;
+
+template <typename F>
+static void check(string_view name, size_t count, F f) {
+	const auto begin = chrono::steady_clock::now();
+	size_t results = 0;
+	for (auto i = 0u; i < count; i++) results += f(i);
+	const auto time = chrono::steady_clock::now() - begin;
+	const auto us = chrono::duration_cast<chrono::microseconds>(time).count();
+	cout << name << ": " << us << " microseconds, " << count << " operations, ";
+	cout << static_cast<double>(us) / count << " microseconds per operation";
+	if (results) cout << ", " << static_cast<double>(results) / count << " stations per result";
+	cout << "\n";
+}
+
+int main(int argc, char ** argv) {
+	(void) argc; (void) argv;
+	mt19937 generator(1);
+	// Most stations are located on land between 60S and 70N
+	uniform_real_distribution<float> lat(-60, 70), lon(-180, 180);
+	vector<pair<float, float>> points;
+	for (auto i = 0u; i < queryCount; i++) {
+		points.emplace_back(lat(generator), lon(generator));
+	}
+
+	cout << "Checking station index performance\n";
+	metaf::StationIndex index;
+	check("Add station", stationCount, [&](size_t i){
+		index.set(i, lat(generator), lon(generator));
+		return 0;
+	});
+	check("Move station", stationCount, [&](size_t i){
+		index.set(i, lat(generator), lon(generator));
+		return 0;
+	});
+	vector<metaf::StationIndex::Result> result;
+	check("Radius 100 NM", queryCount, [&](size_t i){
+		index.radius(points[i].first, points[i].second, 100, result);
+		return result.size();
+	});
+	check("Radius 500 NM", queryCount, [&](size_t i){
+		index.radius(points[i].first, points[i].second, 500, result);
+		return result.size();
+	});
+	check("Nearest 5", queryCount, [&](size_t i){
+		index.nearest(points[i].first, points[i].second, 5, result);
+		return result.size();
+	});
+}
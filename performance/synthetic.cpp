@@ -0,0 +1,170 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Parses large number of synthetic METAR and TAF reports
+// Usage: synthetic [number of reports] [seed]
+
+#include "testdata_synthetic.h"
+#include "pipeline.hpp"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct CorpusStats {
+	size_t reports = 0;
+	size_t bytes = 0;
+	size_t groups = 0;
+	size_t unknownGroups = 0;
+	size_t errors = 0;
+
+	void add(const metaf::ParseResult & result) {
+		reports++;
+		groups += result.groups.size();
+		for (const auto & gi : result.groups) {
+			if (holds_alternative<metaf::UnknownGroup>(gi.group)) unknownGroups++;
+		}
+		if (result.reportMetadata.error != metaf::ReportError::NONE) errors++;
+	}
+	void print(ostream & output) const {
+		output << reports << " reports, " << bytes / 1024 << " KB, ";
+		output << groups << " groups, ";
+		output << (groups ? 100.0 * unknownGroups / groups : 0) << "% unknown groups, ";
+		output << (reports ? 100.0 * errors / reports : 0) << "% reports with errors\n";
+	}
+};
+
+static void printTime(ostream & output,
+	string_view name,
+	chrono::steady_clock::duration time,
+	size_t reports)
+{
+	const auto us = chrono::duration_cast<chrono::microseconds>(time).count();
+	output << name << ": " << us << " microseconds";
+	if (us) {
+		output << ", " << static_cast<unsigned long>(reports * 1000000.0 / us);
+		output << " reports per second";
+	}
+	output << "\n";
+}
+
+static void checkCorpus(string_view name,
+	const testdata::SyntheticDataGenerator::Options & options,
+	size_t count)
+{
+	cout << "Checking " << name << " synthetic reports\n";
+	CorpusStats stats;
+	vector<string> reports;
+	{
+		testdata::SyntheticDataGenerator generator(options);
+		const auto begin = chrono::steady_clock::now();
+		reports = generator.generate(count);
+		printTime(cout, "Generate", chrono::steady_clock::now() - begin, count);
+	}
+	for (const auto & r : reports) stats.bytes += r.length();
+	{
+		const auto begin = chrono::steady_clock::now();
+		for (const auto & r : reports) stats.add(metaf::Parser::parse(r));
+		printTime(cout, "Parse", chrono::steady_clock::now() - begin, count);
+	}
+	{
+		metaf::GroupCache cache;
+		metaf::ParseResult result;
+		const auto begin = chrono::steady_clock::now();
+		for (const auto & r : reports) metaf::Parser::parse(r, result, cache);
+		printTime(cout, "Parse with group cache", chrono::steady_clock::now() - begin, count);
+		cout << "Group cache hit rate: " << 100.0 * cache.stats().hitRate() << "%\n";
+	}
+	{
+		metaf::GroupCache cache;
+		metaf::CompactParseResult result;
+		const auto begin = chrono::steady_clock::now();
+		for (const auto & r : reports) metaf::Parser::parse(r, result, cache);
+		printTime(cout, "Parse into compact result with group cache",
+			chrono::steady_clock::now() - begin, count);
+	}
+	{
+		// Remarks are not accessed and remain undecoded
+		metaf::GroupCache cache;
+		metaf::LazyParseResult result;
+		size_t deferred = 0;
+		const auto begin = chrono::steady_clock::now();
+		for (const auto & r : reports) {
+			metaf::Parser::parse(r, result, cache);
+			if (!result.isDecoded()) deferred++;
+		}
+		printTime(cout, "Lazy parse with group cache", chrono::steady_clock::now() - begin, count);
+		cout << "Reports with deferred remarks: " << 100.0 * deferred / count << "%\n";
+	}
+	{
+		// Corrected reports are the original reports with COR group inserted,
+		// the results of parsing the original reports are kept in memory, so
+		// only part of the reports is used
+		static const size_t maxCorrections = 10000;
+		const auto corrections = min(count, maxCorrections);
+		vector<metaf::ParseResult> original(corrections);
+		vector<string> corrected(corrections);
+		metaf::GroupCache cache;
+		for (auto i = 0u; i < corrections; i++) {
+			metaf::Parser::parse(reports[i], original[i], cache);
+			corrected[i] = reports[i];
+			const auto pos = corrected[i].find(' ');
+			if (pos != string::npos) corrected[i].insert(pos, " COR");
+		}
+		metaf::ParseResult result;
+		cache.clear();
+		auto begin = chrono::steady_clock::now();
+		for (const auto & r : corrected) metaf::Parser::parse(r, result, cache);
+		printTime(cout, "Parse corrected reports with group cache",
+			chrono::steady_clock::now() - begin, corrections);
+		cache.clear();
+		begin = chrono::steady_clock::now();
+		for (auto i = 0u; i < corrections; i++) {
+			metaf::Parser::reparse(corrected[i], original[i], result, cache);
+		}
+		printTime(cout, "Re-parse corrected reports with group cache",
+			chrono::steady_clock::now() - begin, corrections);
+	}
+	{
+		string input;
+		input.reserve(stats.bytes + 2 * reports.size());
+		for (const auto & r : reports) { input += r; input += "\n\n"; }
+		IngestPipeline pipeline;
+		size_t position = 0, parsed = 0;
+		const auto begin = chrono::steady_clock::now();
+		pipeline.run(
+			[&](char * buffer, size_t size){
+				const auto count = min(size, input.length() - position);
+				memcpy(buffer, input.data() + position, count);
+				position += count;
+				return count;
+			},
+			[&](const string &, const metaf::ParseResult &){ parsed++; });
+		const auto name = 
+			"Ingest pipeline, " + to_string(pipeline.parsers()) + " parser thread(s)";
+		printTime(cout, name, chrono::steady_clock::now() - begin, parsed);
+	}
+	stats.print(cout);
+	cout << "\n";
+}
+
+int main(int argc, char ** argv) {
+	const size_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 100000;
+	testdata::SyntheticDataGenerator::Options options;
+	if (argc > 2) options.seed = strtoul(argv[2], nullptr, 10);
+	checkCorpus("valid", options, count);
+	options.longRemarks = 0.05;
+	options.unknownTokens = 0.05;
+	options.malformedReports = 0.05;
+	checkCorpus("noisy", options, count);
+}
@@ -0,0 +1,17 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// Compiles the metaf functions for separate compilation mode; the programs
+// linked with this translation unit define METAF_SEPARATE_COMPILATION
+// before including metaf.hpp
+
+#ifndef METAF_SEPARATE_COMPILATION
+	#define METAF_SEPARATE_COMPILATION
+#endif
+#define METAF_IMPLEMENTATION
+
+#include "metaf.hpp"
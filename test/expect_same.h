@@ -0,0 +1,62 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#ifndef EXPECT_SAME_H
+#define EXPECT_SAME_H
+
+#include <string>
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+#include "explain.hpp"
+
+namespace testdata {
+
+	inline std::string rawString(const metaf::ParseResult & result, std::size_t index) {
+		return result.groups[index].rawString;
+	}
+
+	inline std::string rawString(const metaf::CompactParseResult & result, std::size_t index) {
+		return std::string(result.rawString(index));
+	}
+
+	/// Checks that the parse result is the same as expected one
+	/// @details Groups are compared by their decoded content (i.e. the
+	/// explanation of the group, which covers all values decoded from the
+	/// group), report part and raw string; report sections are compared too
+	template <typename Result>
+	void expectSame(const Result & actual, const metaf::ParseResult & expected) {
+		EXPECT_EQ(actual.reportMetadata.type, expected.reportMetadata.type);
+		EXPECT_EQ(actual.reportMetadata.error, expected.reportMetadata.error);
+		ASSERT_EQ(actual.groups.size(), expected.groups.size());
+		VisitorExplain explain;
+		for (auto i = 0u; i < actual.groups.size(); i++) {
+			const auto & group = actual.groups[i];
+			const auto raw = rawString(actual, i);
+			EXPECT_EQ(group.group.index(), expected.groups[i].group.index());
+			EXPECT_EQ(group.reportPart, expected.groups[i].reportPart);
+			EXPECT_EQ(raw, expected.groups[i].rawString);
+			EXPECT_EQ(explain.visit(group.group, group.reportPart, raw),
+				explain.visit(expected.groups[i])) << "Group: " << raw;
+		}
+		EXPECT_EQ(actual.sections.header.end, expected.sections.header.end);
+		EXPECT_EQ(actual.sections.body.begin, expected.sections.body.begin);
+		EXPECT_EQ(actual.sections.body.end, expected.sections.body.end);
+		ASSERT_EQ(actual.sections.trends.size(), expected.sections.trends.size());
+		for (auto i = 0u; i < actual.sections.trends.size(); i++) {
+			EXPECT_EQ(actual.sections.trends[i].trendGroup,
+				expected.sections.trends[i].trendGroup);
+			EXPECT_EQ(actual.sections.trends[i].range.end,
+				expected.sections.trends[i].range.end);
+		}
+		EXPECT_EQ(actual.sections.remarks.begin, expected.sections.remarks.begin);
+		EXPECT_EQ(actual.sections.remarks.end, expected.sections.remarks.end);
+		EXPECT_EQ(actual.sections.first, expected.sections.first);
+	}
+
+} // namespace testdata
+
+#endif // #ifndef EXPECT_SAME_H
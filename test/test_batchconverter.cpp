@@ -0,0 +1,240 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+
+// Batch results are not rounded to tenths of degree unlike Temperature
+static const auto tempMargin = 0.1/2 + 0.01;
+static const auto rhMargin = 0.01;
+static const auto relativeMargin = 1e-5;
+
+static std::string twoDigits(int value) {
+	const auto absValue = value < 0 ? -value : value;
+	std::string result = (absValue < 10) ? "0" : "";
+	result += std::to_string(absValue);
+	if (value < 0) result = "M" + result;
+	return result;
+}
+
+TEST(BatchConverter, validityMask) {
+	const std::vector<float> values = {
+		1.0, metaf::ObservationColumns::notReported, 0.0,
+		metaf::ObservationColumns::unlimited};
+	std::vector<std::uint8_t> valid(values.size());
+	metaf::BatchConverter::validityMask(values.size(), values.data(), valid.data());
+	EXPECT_TRUE(valid[0]);
+	EXPECT_FALSE(valid[1]);
+	EXPECT_TRUE(valid[2]);
+	EXPECT_TRUE(valid[3]);
+}
+
+TEST(BatchConverter, speedToUnit) {
+	const std::vector<metaf::Speed::Unit> units = {
+		metaf::Speed::Unit::KNOTS,
+		metaf::Speed::Unit::METERS_PER_SECOND,
+		metaf::Speed::Unit::KILOMETERS_PER_HOUR,
+		metaf::Speed::Unit::MILES_PER_HOUR
+	};
+	std::vector<float> speed;
+	for (auto i = 0; i < 200; i++) speed.push_back(i);
+	const std::vector<std::uint8_t> valid(speed.size(), 1);
+	std::vector<float> result(speed.size());
+	for (const auto unit : units) {
+		for (const auto resultUnit : units) {
+			metaf::BatchConverter::speedToUnit(speed.size(),
+				speed.data(), valid.data(), unit, resultUnit, result.data());
+			for (auto i = 0u; i < speed.size(); i++) {
+				const auto s = metaf::Speed::fromString(twoDigits(i), unit);
+				ASSERT_TRUE(s.has_value());
+				const auto expected = s->toUnit(resultUnit);
+				ASSERT_TRUE(expected.has_value());
+				EXPECT_NEAR(result[i], *expected, *expected * relativeMargin);
+			}
+		}
+	}
+}
+
+TEST(BatchConverter, distanceToUnit) {
+	const std::vector<metaf::Distance::Unit> units = {
+		metaf::Distance::Unit::METERS,
+		metaf::Distance::Unit::STATUTE_MILES,
+		metaf::Distance::Unit::FEET
+	};
+	std::vector<float> distance;
+	for (auto i = 0; i < 10000; i += 50) distance.push_back(i);
+	const std::vector<std::uint8_t> valid(distance.size(), 1);
+	std::vector<float> result(distance.size());
+	for (const auto unit : units) {
+		for (const auto resultUnit : units) {
+			metaf::BatchConverter::distanceToUnit(distance.size(),
+				distance.data(), valid.data(), unit, resultUnit, result.data());
+			for (auto i = 0u; i < distance.size(); i++) {
+				const auto expected = metaf::Distance(distance[i], unit).toUnit(resultUnit);
+				ASSERT_TRUE(expected.has_value());
+				EXPECT_NEAR(result[i], *expected, *expected * relativeMargin);
+			}
+		}
+	}
+}
+
+TEST(BatchConverter, pressureToUnit) {
+	const std::vector<metaf::Pressure::Unit> units = {
+		metaf::Pressure::Unit::HECTOPASCAL,
+		metaf::Pressure::Unit::INCHES_HG,
+		metaf::Pressure::Unit::MM_HG
+	};
+	const std::vector<float> pressure = {1000, 1013, 1030};
+	const std::vector<std::uint8_t> valid(pressure.size(), 1);
+	std::vector<float> result(pressure.size());
+	for (const auto resultUnit : units) {
+		metaf::BatchConverter::pressureToUnit(pressure.size(), pressure.data(),
+			valid.data(), metaf::Pressure::Unit::HECTOPASCAL, resultUnit, result.data());
+		for (auto i = 0u; i < pressure.size(); i++) {
+			const auto p = metaf::Pressure::fromString(
+				"Q" + std::to_string(static_cast<int>(pressure[i])));
+			ASSERT_TRUE(p.has_value());
+			const auto expected = p->toUnit(resultUnit);
+			ASSERT_TRUE(expected.has_value());
+			EXPECT_NEAR(result[i], *expected, *expected * relativeMargin);
+		}
+	}
+	metaf::BatchConverter::pressureToUnit(pressure.size(), pressure.data(),
+		valid.data(), metaf::Pressure::Unit::MM_HG, metaf::Pressure::Unit::INCHES_HG,
+		result.data());
+	EXPECT_NEAR(result[0], 1000 / 25.4, 1000 / 25.4 * relativeMargin);
+}
+
+TEST(BatchConverter, temperatureToUnit) {
+	std::vector<float> temperature;
+	for (auto i = -60; i < 60; i++) temperature.push_back(i);
+	const std::vector<std::uint8_t> valid(temperature.size(), 1);
+	std::vector<float> resultF(temperature.size());
+	std::vector<float> resultC(temperature.size());
+	metaf::BatchConverter::temperatureToUnit(temperature.size(),
+		temperature.data(), valid.data(),
+		metaf::Temperature::Unit::C, metaf::Temperature::Unit::F, resultF.data());
+	metaf::BatchConverter::temperatureToUnit(temperature.size(),
+		temperature.data(), valid.data(),
+		metaf::Temperature::Unit::C, metaf::Temperature::Unit::C, resultC.data());
+	for (auto i = 0u; i < temperature.size(); i++) {
+		const auto t = metaf::Temperature::fromString(twoDigits(temperature[i]));
+		ASSERT_TRUE(t.has_value());
+		const auto expected = t->toUnit(metaf::Temperature::Unit::F);
+		ASSERT_TRUE(expected.has_value());
+		EXPECT_NEAR(resultF[i], *expected, tempMargin);
+		EXPECT_NEAR(resultC[i], temperature[i], tempMargin);
+	}
+}
+
+TEST(BatchConverter, temperatureToUnitNotSupported) {
+	// Conversion from F to C is not supported by Temperature::toUnit()
+	const std::vector<float> temperature = {-40, 32, 212};
+	const std::vector<std::uint8_t> valid(temperature.size(), 1);
+	std::vector<float> result(temperature.size());
+	metaf::BatchConverter::temperatureToUnit(temperature.size(),
+		temperature.data(), valid.data(),
+		metaf::Temperature::Unit::F, metaf::Temperature::Unit::C, result.data());
+	for (auto i = 0u; i < temperature.size(); i++) {
+		EXPECT_FALSE(metaf::ObservationColumns::isReported(result[i]));
+	}
+}
+
+TEST(BatchConverter, notValid) {
+	const std::vector<float> values = {10, 20, 30};
+	const std::vector<std::uint8_t> valid = {1, 0, 1};
+	std::vector<float> result(values.size());
+	metaf::BatchConverter::speedToUnit(values.size(), values.data(), valid.data(),
+		metaf::Speed::Unit::KNOTS, metaf::Speed::Unit::KNOTS, result.data());
+	EXPECT_NEAR(result[0], 10, relativeMargin);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(result[1]));
+	EXPECT_NEAR(result[2], 30, relativeMargin);
+
+	metaf::BatchConverter::relativeHumidity(values.size(),
+		values.data(), values.data(), valid.data(), result.data());
+	EXPECT_NEAR(result[0], 100, rhMargin);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(result[1]));
+	EXPECT_NEAR(result[2], 100, rhMargin);
+}
+
+TEST(BatchConverter, relativeHumidity) {
+	std::vector<float> airTemperature, dewPoint;
+	for (auto t = -50; t <= 50; t++) {
+		for (auto dp = -50; dp <= 50; dp++) {
+			airTemperature.push_back(t);
+			dewPoint.push_back(dp);
+		}
+	}
+	const std::vector<std::uint8_t> valid(airTemperature.size(), 1);
+	std::vector<float> result(airTemperature.size());
+	metaf::BatchConverter::relativeHumidity(airTemperature.size(),
+		airTemperature.data(), dewPoint.data(), valid.data(), result.data());
+	for (auto i = 0u; i < result.size(); i++) {
+		const auto t = metaf::Temperature::fromString(twoDigits(airTemperature[i]));
+		const auto dp = metaf::Temperature::fromString(twoDigits(dewPoint[i]));
+		ASSERT_TRUE(t.has_value() && dp.has_value());
+		const auto expected = metaf::Temperature::relativeHumidity(*t, *dp);
+		ASSERT_TRUE(expected.has_value());
+		EXPECT_NEAR(result[i], *expected, rhMargin);
+	}
+}
+
+TEST(BatchConverter, heatIndex) {
+	std::vector<float> airTemperature, relativeHumidity;
+	for (auto t = 20; t <= 50; t++) {
+		for (auto rh = 30; rh <= 100; rh++) {
+			airTemperature.push_back(t);
+			relativeHumidity.push_back(rh);
+		}
+	}
+	const std::vector<std::uint8_t> valid(airTemperature.size(), 1);
+	std::vector<float> result(airTemperature.size());
+	std::vector<std::uint8_t> resultValid(airTemperature.size());
+	metaf::BatchConverter::heatIndex(airTemperature.size(),
+		airTemperature.data(), relativeHumidity.data(), valid.data(),
+		result.data(), resultValid.data());
+	for (auto i = 0u; i < result.size(); i++) {
+		const auto t = metaf::Temperature::fromString(twoDigits(airTemperature[i]));
+		ASSERT_TRUE(t.has_value());
+		const auto expected = metaf::Temperature::heatIndex(*t, relativeHumidity[i]);
+		EXPECT_EQ(static_cast<bool>(resultValid[i]), expected.isReported());
+		if (expected.isReported()) {
+			EXPECT_NEAR(result[i], *expected.temperature(), tempMargin);
+		} else {
+			EXPECT_FALSE(metaf::ObservationColumns::isReported(result[i]));
+		}
+	}
+}
+
+TEST(BatchConverter, windChill) {
+	std::vector<float> airTemperature, windSpeed;
+	for (auto t = -50; t <= 20; t++) {
+		for (auto ws = 0; ws <= 150; ws++) {
+			airTemperature.push_back(t);
+			windSpeed.push_back(ws);
+		}
+	}
+	const std::vector<std::uint8_t> valid(airTemperature.size(), 1);
+	std::vector<float> result(airTemperature.size());
+	std::vector<std::uint8_t> resultValid(airTemperature.size());
+	metaf::BatchConverter::windChill(airTemperature.size(),
+		airTemperature.data(), windSpeed.data(), valid.data(),
+		result.data(), resultValid.data());
+	for (auto i = 0u; i < result.size(); i++) {
+		const auto t = metaf::Temperature::fromString(twoDigits(airTemperature[i]));
+		const auto ws = metaf::Speed::fromString(twoDigits(windSpeed[i]),
+			metaf::Speed::Unit::KILOMETERS_PER_HOUR);
+		ASSERT_TRUE(t.has_value() && ws.has_value());
+		const auto expected = metaf::Temperature::windChill(*t, *ws);
+		EXPECT_EQ(static_cast<bool>(resultValid[i]), expected.isReported());
+		if (expected.isReported()) {
+			EXPECT_NEAR(result[i], *expected.temperature(), tempMargin);
+		} else {
+			EXPECT_FALSE(metaf::ObservationColumns::isReported(result[i]));
+		}
+	}
+}
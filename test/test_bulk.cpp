@@ -0,0 +1,117 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "bulk.hpp"
+
+static void pack(std::vector<std::uint8_t> & buffer, const std::string & report) {
+	const auto length = static_cast<std::uint32_t>(report.length());
+	const auto pos = buffer.size();
+	buffer.resize(pos + sizeof(length) + length);
+	std::memcpy(buffer.data() + pos, &length, sizeof(length));
+	std::memcpy(buffer.data() + pos + sizeof(length), report.data(), length);
+}
+
+static std::vector<std::uint8_t> stationsBuffer() {
+	std::vector<std::uint8_t> buffer;
+	for (const auto & data : testdata::realDataSet) {
+		pack(buffer, data.metar);
+		pack(buffer, data.taf);
+	}
+	return buffer;
+}
+
+static bool sameRecord(const PackedCurrentWeather & r1, const PackedCurrentWeather & r2) {
+	// Records are compared bitwise, so that not reported (NaN) values match
+	return !std::memcmp(&r1, &r2, sizeof(PackedCurrentWeather));
+}
+
+TEST(BulkProcessor, currentWeatherOrder) {
+	const auto input = stationsBuffer();
+	const auto size = testdata::realDataSet.size();
+	for (auto threads : {1u, 0u, 4u}) {
+		// Batch is processed twice to use the worker threads kept from
+		// the previous batch
+		for (auto batch = 0; batch < 2; batch++) {
+			std::vector<PackedCurrentWeather> output(size);
+			const auto count = BulkProcessor::currentWeather(input.data(),
+				input.size(), output.data(), output.size(), threads);
+			ASSERT_EQ(count, static_cast<int>(size));
+			for (auto i = 0u; i < size; i++) {
+				const auto & data = testdata::realDataSet[i];
+				const auto expected = PackedCurrentWeather::fromCurrentWeather(
+					metaf::CurrentWeatherExtractor::extract(
+						metaf::Parser::parse(data.metar),
+						metaf::Parser::parse(data.taf)));
+				EXPECT_TRUE(sameRecord(output[i], expected)) << "Station " << i;
+			}
+		}
+	}
+}
+
+TEST(BulkProcessor, currentWeatherOutputSize) {
+	const auto input = stationsBuffer();
+	std::vector<PackedCurrentWeather> output(3);
+	const auto count = BulkProcessor::currentWeather(input.data(),
+		input.size(), output.data(), output.size(), 4);
+	EXPECT_EQ(count, 3);
+}
+
+TEST(BulkProcessor, malformedInput) {
+	auto input = stationsBuffer();
+	// Last entry is longer than the rest of the buffer
+	input.pop_back();
+	std::vector<PackedCurrentWeather> output(testdata::realDataSet.size());
+	EXPECT_EQ(BulkProcessor::countEntries(input.data(), input.size()), -1);
+	EXPECT_EQ(BulkProcessor::currentWeather(input.data(), input.size(),
+		output.data(), output.size(), 4), -1);
+	std::vector<char> text(1024);
+	std::vector<std::uint32_t> offsets(16);
+	EXPECT_EQ(BulkProcessor::explain(input.data(), input.size(),
+		text.data(), text.size(), offsets.data(), offsets.size(),
+		ExplainDecoder::Format::TEXT), -1);
+	// METAR without TAF at the end of the buffer
+	auto unpaired = stationsBuffer();
+	pack(unpaired, testdata::realDataSet.front().metar);
+	EXPECT_EQ(BulkProcessor::countEntries(unpaired.data(), unpaired.size()),
+		static_cast<int>(2 * testdata::realDataSet.size() + 1));
+	EXPECT_EQ(BulkProcessor::currentWeather(unpaired.data(), unpaired.size(),
+		output.data(), output.size(), 4), -1);
+	// Incomplete length prefix
+	const std::uint8_t truncated[] = { 1, 0 };
+	EXPECT_EQ(BulkProcessor::countEntries(truncated, sizeof(truncated)), -1);
+}
+
+TEST(BulkProcessor, explainOrder) {
+	std::vector<std::uint8_t> input;
+	std::vector<std::string> reports;
+	for (const auto & data : testdata::realDataSet) {
+		if (reports.size() >= 20) break;
+		if (data.metar.empty()) continue;
+		reports.push_back(data.metar);
+		pack(input, data.metar);
+	}
+	std::vector<char> text(1024 * 1024);
+	std::vector<std::uint32_t> offsets(reports.size());
+	const auto count = BulkProcessor::explain(input.data(), input.size(),
+		text.data(), text.size(), offsets.data(), offsets.size(),
+		ExplainDecoder::Format::TEXT);
+	ASSERT_EQ(count, static_cast<int>(reports.size()));
+	const ExplainDecoder decoder(ExplainDecoder::Format::TEXT);
+	for (auto i = 0u; i < reports.size(); i++) {
+		std::string expected;
+		decoder.decode(reports[i], expected);
+		EXPECT_EQ(std::string(text.data() + offsets[i]), expected);
+	}
+	// Stops before the explanation which does not fit
+	const auto first = std::string(text.data()).length();
+	const auto partial = BulkProcessor::explain(input.data(), input.size(),
+		text.data(), first + 1, offsets.data(), offsets.size(),
+		ExplainDecoder::Format::TEXT);
+	EXPECT_EQ(partial, 1);
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include "expect_same.h"
+
+using testdata::expectSame;
+
+TEST(CompactParseResult, rawStrings) {
+	const std::string report =
+		"METAR KZZZ 041153Z 24015KT 1 1/2SM FEW030 12/10 A2992 "
+		"RMK AO2 PK WND 25030/1120 SLP132=";
+	metaf::CompactParseResult result;
+	metaf::Parser::parse(report, result, metaf::GroupCache::threadCache());
+	EXPECT_EQ(result.text, report.substr(0, report.length() - 1));
+	expectSame(result, metaf::Parser::parse(report));
+	ASSERT_EQ(result.groups.size(), 12u);
+	EXPECT_EQ(result.rawString(4), "1 1/2SM");
+	EXPECT_EQ(result.rawString(10), "PK WND 25030/1120");
+	EXPECT_EQ(result.groups[10].begin, 62u);
+	EXPECT_EQ(result.groups[10].end, 79u);
+}
+
+TEST(CompactParseResult, normalizedText) {
+	const std::string report =
+		"  METAR KZZZ\n041153Z  24015KT\t1\n1/2SM FEW030 12/10 A2992   \n";
+	metaf::CompactParseResult result;
+	metaf::Parser::parse(report, result, metaf::GroupCache::threadCache());
+	EXPECT_EQ(result.text, "METAR KZZZ 041153Z 24015KT 1 1/2SM FEW030 12/10 A2992");
+	expectSame(result, metaf::Parser::parse(report));
+}
+
+TEST(CompactParseResult, invalidatedGroups) {
+	// PK expects WND to follow, and the invalidated groups are merged into
+	// a single fallback group
+	const std::string report =
+		"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 RMK AO2 PK PK PK";
+	metaf::CompactParseResult result;
+	metaf::Parser::parse(report, result, metaf::GroupCache::threadCache());
+	const auto expected = metaf::Parser::parse(report);
+	expectSame(result, expected);
+	EXPECT_EQ(result.rawString(result.groups.size() - 1),
+		expected.groups.back().rawString);
+	EXPECT_TRUE(std::holds_alternative<metaf::UnknownGroup>(result.groups.back().group));
+	EXPECT_EQ(result.groups.back().end, result.text.length());
+}
+
+TEST(CompactParseResult, toParseResult) {
+	const std::string report =
+		"TAF ZZZZ 041100Z 0412/0512 24010KT P6SM SCT020 TEMPO 0414/0418 2 1/2SM RA";
+	metaf::CompactParseResult result;
+	metaf::Parser::parse(report, result, metaf::GroupCache::threadCache());
+	const auto converted = result.toParseResult();
+	expectSame(result, converted);
+	EXPECT_EQ(converted.sections.trends.size(), 1u);
+	const auto gi = result.groupInfo(8);
+	EXPECT_EQ(gi.rawString, "2 1/2SM");
+	EXPECT_TRUE(std::holds_alternative<metaf::VisibilityGroup>(gi.group));
+}
+
+TEST(CompactParseResult, sameResultAsParser) {
+	metaf::GroupCache cache;
+	metaf::CompactParseResult result;
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { data.metar, data.taf }) {
+			metaf::Parser::parse(report, result, cache);
+			expectSame(result, metaf::Parser::parse(report));
+		}
+	}
+}
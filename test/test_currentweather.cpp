@@ -0,0 +1,161 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include <thread>
+
+static const auto margin = 0.1 / 2;
+
+TEST(CurrentWeatherExtractor, fromMetar) {
+	const auto metar = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 24015G25KT 3000 -SHRA BR FEW010 BKN020CB OVC050 "
+		"30/20 Q1012 BECMG 9999 NSW");
+	const auto taf = metaf::Parser::parse(
+		"TAF ZZZZ 040500Z 0406/0512 VRB05KT CAVOK TX32/0414Z TN18/0505Z");
+	const auto cw = metaf::CurrentWeatherExtractor::extract(metar, taf);
+	EXPECT_EQ(cw.source, metaf::CurrentWeather::Source::METAR);
+	EXPECT_NEAR(cw.windDirection, 240, margin);
+	EXPECT_FALSE(cw.isWindVariable);
+	EXPECT_NEAR(cw.windSpeed, 15, margin);
+	EXPECT_NEAR(cw.gustSpeed, 25, margin);
+	EXPECT_NEAR(cw.visibility, 3000, margin);
+	EXPECT_EQ(cw.cloud, metaf::CurrentWeather::Cloud::OVERCAST);
+	EXPECT_TRUE(cw.isStormClouds);
+	ASSERT_EQ(cw.weatherSize, 2u);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeQualifier(cw.weather[0]),
+		metaf::WeatherPhenomena::Qualifier::LIGHT);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeDescriptor(cw.weather[0]),
+		metaf::WeatherPhenomena::Descriptor::SHOWERS);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeWeather(cw.weather[0], 0),
+		metaf::WeatherPhenomena::Weather::RAIN);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeWeather(cw.weather[1], 0),
+		metaf::WeatherPhenomena::Weather::MIST);
+	EXPECT_NEAR(cw.airTemperature, 30, margin);
+	EXPECT_GT(cw.perceivedTemperature, 30);
+	EXPECT_NEAR(cw.relativeHumidity, 55, 1);
+	EXPECT_NEAR(cw.pressure, 1012, margin);
+	EXPECT_NEAR(cw.airTemperatureHigh, 32, margin);
+	EXPECT_NEAR(cw.airTemperatureLow, 18, margin);
+	ASSERT_TRUE(cw.reportTime.has_value());
+	EXPECT_EQ(cw.reportTime->day(), 4u);
+	EXPECT_EQ(cw.reportTime->hour(), 11u);
+	EXPECT_EQ(cw.reportTime->minute(), 15u);
+}
+
+TEST(CurrentWeatherExtractor, fromTafIfNoMetar) {
+	const auto metar = metaf::Parser::parse("");
+	const auto taf = metaf::Parser::parse(
+		"TAF ZZZZ 040500Z 0406/0512 VRB05KT 6000 RA SCT015 TX12/0414Z "
+		"FM041200 27020KT 9999 NSW BKN020");
+	const auto cw = metaf::CurrentWeatherExtractor::extract(metar, taf);
+	EXPECT_EQ(cw.source, metaf::CurrentWeather::Source::TAF);
+	EXPECT_FALSE(metaf::CurrentWeather::isReported(cw.windDirection));
+	EXPECT_TRUE(cw.isWindVariable);
+	EXPECT_NEAR(cw.windSpeed, 5, margin);
+	EXPECT_NEAR(cw.visibility, 6000, margin);
+	EXPECT_EQ(cw.cloud, metaf::CurrentWeather::Cloud::MOSTLY_CLEAR);
+	EXPECT_EQ(cw.weatherSize, 1u);
+	EXPECT_FALSE(metaf::CurrentWeather::isReported(cw.airTemperature));
+	EXPECT_NEAR(cw.airTemperatureHigh, 12, margin);
+	EXPECT_FALSE(metaf::CurrentWeather::isReported(cw.airTemperatureLow));
+	ASSERT_TRUE(cw.reportTime.has_value());
+	EXPECT_EQ(cw.reportTime->hour(), 5u);
+}
+
+TEST(CurrentWeatherExtractor, noReports) {
+	const auto cw = metaf::CurrentWeatherExtractor::extract(
+		metaf::Parser::parse("METAR"), metaf::Parser::parse("METAR ZZZZ 041115Z"));
+	EXPECT_EQ(cw.source, metaf::CurrentWeather::Source::NONE);
+	EXPECT_EQ(cw.cloud, metaf::CurrentWeather::Cloud::NOT_REPORTED);
+	EXPECT_FALSE(metaf::CurrentWeather::isReported(cw.windSpeed));
+	EXPECT_FALSE(metaf::CurrentWeather::isReported(cw.airTemperatureHigh));
+	EXPECT_FALSE(cw.reportTime.has_value());
+	EXPECT_EQ(cw.weatherSize, 0u);
+}
+
+TEST(CurrentWeatherExtractor, weatherLimit) {
+	const auto metar = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 24015KT 3000 RA SN BR FG HZ FU DU SA PY 10/10 Q1012");
+	const auto cw = metaf::CurrentWeatherExtractor::extract(metar, metaf::ParseResult());
+	EXPECT_EQ(cw.weatherSize, metaf::CurrentWeather::maxWeather);
+}
+
+static std::vector<metaf::CurrentWeatherExtractor::Reports> realReports() {
+	std::vector<metaf::CurrentWeatherExtractor::Reports> result;
+	for (const auto & data : testdata::realDataSet) {
+		result.emplace_back(data.metar, data.taf);
+	}
+	return result;
+}
+
+static bool sameValue(float v1, float v2) {
+	if (!metaf::CurrentWeather::isReported(v1)) return !metaf::CurrentWeather::isReported(v2);
+	return (v1 == v2);
+}
+
+static void expectSame(const metaf::CurrentWeather & cw1, const metaf::CurrentWeather & cw2) {
+	EXPECT_EQ(cw1.source, cw2.source);
+	EXPECT_EQ(cw1.cloud, cw2.cloud);
+	EXPECT_TRUE(sameValue(cw1.windSpeed, cw2.windSpeed));
+	EXPECT_TRUE(sameValue(cw1.visibility, cw2.visibility));
+	EXPECT_TRUE(sameValue(cw1.airTemperature, cw2.airTemperature));
+	EXPECT_TRUE(sameValue(cw1.airTemperatureHigh, cw2.airTemperatureHigh));
+	EXPECT_EQ(cw1.weatherSize, cw2.weatherSize);
+	EXPECT_EQ(cw1.weather, cw2.weather);
+}
+
+TEST(CurrentWeatherExtractor, batch) {
+	const auto reports = realReports();
+	std::vector<metaf::CurrentWeather> result;
+	metaf::CurrentWeatherExtractor::extract(reports, result);
+	ASSERT_EQ(result.size(), reports.size());
+	for (auto i = 0u; i < reports.size(); i++) {
+		const auto expected = metaf::CurrentWeatherExtractor::extract(
+			metaf::Parser::parse(reports[i].first),
+			metaf::Parser::parse(reports[i].second));
+		expectSame(result[i], expected);
+	}
+}
+
+TEST(CurrentWeatherExtractor, reuseParseResults) {
+	const auto reports = realReports();
+	metaf::ParseResult metar, taf;
+	for (const auto & r : reports) {
+		const auto cw = metaf::CurrentWeatherExtractor::extract(r, metar, taf);
+		const auto expected = metaf::CurrentWeatherExtractor::extract(
+			metaf::Parser::parse(r.first),
+			metaf::Parser::parse(r.second));
+		expectSame(cw, expected);
+		EXPECT_EQ(metar.groups.size(), metaf::Parser::parse(r.first).groups.size());
+		EXPECT_EQ(taf.groups.size(), metaf::Parser::parse(r.second).groups.size());
+	}
+}
+
+TEST(CurrentWeatherExtractor, parallelBatch) {
+	const auto reports = realReports();
+	std::vector<metaf::CurrentWeather> sequential;
+	metaf::CurrentWeatherExtractor::extract(reports, sequential);
+	std::vector<metaf::CurrentWeather> parallel(reports.size());
+	static const auto threads = 4u;
+	const auto rangeSize = (reports.size() + threads - 1) / threads;
+	std::vector<std::thread> workers;
+	for (auto t = 0u; t < threads; t++) {
+		const auto begin = std::min(t * rangeSize, reports.size());
+		const auto end = std::min(begin + rangeSize, reports.size());
+		workers.emplace_back([&, begin, end](){
+			metaf::GroupCache cache;
+			metaf::CurrentWeatherExtractor::extract(reports.data() + begin,
+				end - begin,
+				parallel.data() + begin,
+				cache);
+		});
+	}
+	for (auto & w : workers) w.join();
+	for (auto i = 0u; i < reports.size(); i++) expectSame(parallel[i], sequential[i]);
+}
@@ -0,0 +1,107 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "explain.hpp"
+
+static const std::string report = 
+	"METAR EGLL 051120Z 24015G25KT 9999 -RA BKN012 OVC025 12/10 Q1012 NOSIG";
+
+TEST(ExplainDecoder, html) {
+	const ExplainDecoder decoder(ExplainDecoder::Format::HTML);
+	std::string result;
+	decoder.decode(report, result);
+	EXPECT_EQ(result.rfind("<thead>", 0), 0u);
+	EXPECT_NE(result.find("<tr><td>24015G25KT</td><td>"), std::string::npos);
+	EXPECT_NE(result.find("</tbody>"), std::string::npos);
+}
+
+TEST(ExplainDecoder, text) {
+	const ExplainDecoder decoder(ExplainDecoder::Format::TEXT);
+	std::string result;
+	decoder.decode(report, result);
+	EXPECT_EQ(result.find('<'), std::string::npos);
+	EXPECT_EQ(result.find("&deg;"), std::string::npos);
+	EXPECT_NE(result.find("\n24015G25KT\n  "), std::string::npos);
+}
+
+TEST(ExplainDecoder, decodeAppends) {
+	const ExplainDecoder decoder;
+	std::string expected;
+	decoder.decode(report, expected);
+	std::string result = "prefix";
+	decoder.decode(report, result);
+	EXPECT_EQ(result, "prefix" + expected);
+}
+
+TEST(ExplainDecoder, bufferRequiredLength) {
+	const ExplainDecoder decoder;
+	std::string expected;
+	decoder.decode(report, expected);
+	// Null buffer only returns required length, similar to snprintf
+	EXPECT_EQ(decoder.decode(report, nullptr, 0), expected.length());
+	std::vector<char> buffer(expected.length() + 1, 'x');
+	EXPECT_EQ(decoder.decode(report, buffer.data(), buffer.size()), expected.length());
+	EXPECT_EQ(std::string(buffer.data()), expected);
+}
+
+TEST(ExplainDecoder, bufferTruncation) {
+	const ExplainDecoder decoder(ExplainDecoder::Format::TEXT);
+	std::string expected;
+	decoder.decode(report, expected);
+	static const auto bufferSize = 16u;
+	char buffer[bufferSize + 1];
+	buffer[bufferSize] = 'x';
+	EXPECT_EQ(decoder.decode(report, buffer, bufferSize), expected.length());
+	EXPECT_EQ(std::string(buffer), expected.substr(0, bufferSize - 1));
+	EXPECT_EQ(buffer[bufferSize], 'x');
+	// Buffer which is exactly one char short
+	std::vector<char> shortBuffer(expected.length());
+	EXPECT_EQ(decoder.decode(report, shortBuffer.data(), shortBuffer.size()),
+		expected.length());
+	EXPECT_EQ(std::string(shortBuffer.data()), 
+		expected.substr(0, expected.length() - 1));
+}
+
+TEST(ExplainDecoder, bufferSizeOne) {
+	const ExplainDecoder decoder;
+	char buffer[2] = {'x', 'x'};
+	EXPECT_GT(decoder.decode(report, buffer, 1), 0u);
+	EXPECT_EQ(buffer[0], '\0');
+	EXPECT_EQ(buffer[1], 'x');
+}
+
+TEST(ExplainDecoder, batch) {
+	std::vector<std::string> reports;
+	for (const auto & data : testdata::realDataSet) {
+		if (!data.metar.empty()) reports.push_back(data.metar);
+		if (!data.taf.empty()) reports.push_back(data.taf);
+		if (reports.size() >= 200) break;
+	}
+	const ExplainDecoder decoder;
+	std::vector<std::string> expected(reports.size());
+	for (auto i = 0u; i < reports.size(); i++) decoder.decode(reports[i], expected[i]);
+	#ifdef __EMSCRIPTEN__
+		// WebAssembly tests are built without threads support
+		const auto threadCounts = {0u, 1u};
+	#else
+		const auto threadCounts = {0u, 1u, 3u, 1000u};
+	#endif
+	for (const auto threads : threadCounts) {
+		std::vector<std::string> outputs = {"stale output"};
+		decoder.decode(reports, outputs, threads);
+		EXPECT_EQ(outputs, expected) << threads << " threads";
+	}
+}
+
+TEST(ExplainDecoder, batchEmpty) {
+	const ExplainDecoder decoder;
+	std::vector<std::string> outputs = {"stale output"};
+	decoder.decode(std::vector<std::string>(), outputs);
+	EXPECT_TRUE(outputs.empty());
+}
@@ -0,0 +1,137 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+
+using metaf::FlightCategory;
+using metaf::FlightCategoryClassifier;
+
+static const auto nr = metaf::ObservationColumns::notReported;
+static const auto unlimited = metaf::ObservationColumns::unlimited;
+
+static FlightCategory classify(const std::string & report,
+	FlightCategoryClassifier::Mode mode = FlightCategoryClassifier::Mode::FULL)
+{
+	return FlightCategoryClassifier::classify(metaf::Parser::parse(report), mode);
+}
+
+TEST(FlightCategoryClassifier, fromCeilingVisibility) {
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(nr, nr),
+		FlightCategory::UNKNOWN);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(unlimited, nr),
+		FlightCategory::VFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(3100, 6),
+		FlightCategory::VFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(3000, 6),
+		FlightCategory::MVFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(nr, 5),
+		FlightCategory::MVFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(1000, nr),
+		FlightCategory::MVFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(900, 6),
+		FlightCategory::IFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(unlimited, 2.5),
+		FlightCategory::IFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(500, 1),
+		FlightCategory::IFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(400, 6),
+		FlightCategory::LIFR);
+	EXPECT_EQ(FlightCategoryClassifier::fromCeilingVisibility(5000, 0.5),
+		FlightCategory::LIFR);
+}
+
+TEST(FlightCategoryClassifier, metar) {
+	EXPECT_EQ(classify("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012"),
+		FlightCategory::VFR);
+	EXPECT_EQ(classify("METAR ZZZZ 041115Z 24015KT CAVOK 12/10 Q1012"),
+		FlightCategory::VFR);
+	EXPECT_EQ(classify("METAR KZZZ 041115Z 24015KT 4SM BR BKN025 12/10 A2992"),
+		FlightCategory::MVFR);
+	EXPECT_EQ(classify("METAR KZZZ 041115Z 24015KT 2SM -RA OVC008 12/10 A2992"),
+		FlightCategory::IFR);
+	EXPECT_EQ(classify("METAR KZZZ 041115Z 00000KT 1/4SM FG VV002 12/12 A2992"),
+		FlightCategory::LIFR);
+	EXPECT_EQ(classify("METAR ZZZZ 041115Z 24015KT 12/10 Q1012"),
+		FlightCategory::UNKNOWN);
+}
+
+TEST(FlightCategoryClassifier, trendsAndRemarksIgnored) {
+	EXPECT_EQ(classify("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012 "
+		"TEMPO 0800 FG VV001"),
+		FlightCategory::VFR);
+	EXPECT_EQ(classify("METAR KZZZ 041115Z 24015KT 10SM FEW030 12/10 A2992 "
+		"RMK AO2 VIS 1/2"),
+		FlightCategory::VFR);
+}
+
+TEST(FlightCategoryClassifier, earlyExit) {
+	const auto early = FlightCategoryClassifier::Mode::EARLY_EXIT;
+	EXPECT_EQ(classify("METAR KZZZ 041115Z 24015KT 2SM -RA OVC008 12/10 A2992",
+		early),
+		FlightCategory::IFR);
+	EXPECT_EQ(classify("METAR ZZZZ 041115Z 24015KT 0400 FG BKN040 12/10 Q1012",
+		early),
+		FlightCategory::LIFR);
+	// Early exit relies on cloud layers being reported in ascending order
+	const auto unordered = "METAR ZZZZ 041115Z 24015KT 9999 BKN040 OVC008";
+	EXPECT_EQ(classify(unordered), FlightCategory::IFR);
+	EXPECT_EQ(classify(unordered, early), FlightCategory::VFR);
+}
+
+TEST(FlightCategoryClassifier, batch) {
+	std::vector<metaf::ParseResult> parseResults;
+	for (const auto & data : testdata::realDataSet) {
+		if (!data.metar.empty()) parseResults.push_back(metaf::Parser::parse(data.metar));
+		if (!data.taf.empty()) parseResults.push_back(metaf::Parser::parse(data.taf));
+	}
+	std::vector<FlightCategory> result(parseResults.size());
+	FlightCategoryClassifier::classify(parseResults, result.data());
+	for (auto i = 0u; i < parseResults.size(); i++) {
+		EXPECT_EQ(result[i], FlightCategoryClassifier::classify(parseResults[i]));
+	}
+}
+
+TEST(FlightCategoryClassifier, taf) {
+	const auto tl = metaf::TafTimeline::fromParseResult(metaf::Parser::parse(
+		"TAF KZZZ 041100Z 0412/0512 15006KT P6SM SCT040 "
+		"FM041800 20010KT 4SM -RA OVC020 "
+		"TEMPO 0420/0424 1SM RA BR OVC008 "
+		"FM050300 25015KT P6SM SKC"));
+	ASSERT_TRUE(tl.has_value());
+	ASSERT_EQ(tl->prevailing().size(), 3u);
+	ASSERT_EQ(tl->temporary().size(), 1u);
+
+	FlightCategory prevailing[3], temporary[1];
+	FlightCategoryClassifier::classify(*tl, prevailing, temporary);
+	EXPECT_EQ(prevailing[0], FlightCategory::VFR);
+	EXPECT_EQ(prevailing[1], FlightCategory::MVFR);
+	EXPECT_EQ(prevailing[2], FlightCategory::VFR);
+	EXPECT_EQ(temporary[0], FlightCategory::IFR);
+
+	const auto time = [](const std::string & s) {
+		return metaf::MetafTime::fromStringDDHHMM(s).value();
+	};
+	EXPECT_EQ(FlightCategoryClassifier::classifyAt(*tl, time("041300")),
+		FlightCategory::VFR);
+	EXPECT_EQ(FlightCategoryClassifier::classifyAt(*tl, time("041900")),
+		FlightCategory::MVFR);
+	EXPECT_EQ(FlightCategoryClassifier::classifyAt(*tl, time("042100")),
+		FlightCategory::IFR);
+	EXPECT_EQ(FlightCategoryClassifier::classifyAt(*tl, time("050400")),
+		FlightCategory::VFR);
+	EXPECT_EQ(FlightCategoryClassifier::classifyAt(*tl, time("060000")),
+		FlightCategory::UNKNOWN);
+}
+
+TEST(FlightCategoryClassifier, tafConditions) {
+	metaf::TafConditions conditions;
+	EXPECT_EQ(FlightCategoryClassifier::classify(conditions), FlightCategory::UNKNOWN);
+	conditions.cavok = true;
+	EXPECT_EQ(FlightCategoryClassifier::classify(conditions), FlightCategory::VFR);
+}
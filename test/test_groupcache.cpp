@@ -0,0 +1,159 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include "expect_same.h"
+
+using testdata::expectSame;
+
+TEST(GroupCache, hitsAndMisses) {
+	metaf::GroupCache cache;
+	const auto report = "METAR ZZZZ 041115Z 24015KT CAVOK 12/10 Q1012 NOSIG";
+	metaf::Parser::parse(report, cache);
+	const auto first = cache.stats();
+	EXPECT_EQ(first.hits, 0u);
+	EXPECT_EQ(first.misses, 8u);
+	EXPECT_EQ(first.size, 8u);
+
+	metaf::Parser::parse(report, cache);
+	const auto second = cache.stats();
+	EXPECT_EQ(second.hits, 8u);
+	EXPECT_EQ(second.misses, 8u);
+	EXPECT_EQ(second.size, 8u);
+	EXPECT_NEAR(second.hitRate(), 0.5, 0.001);
+
+	cache.clear();
+	EXPECT_EQ(cache.stats().hits, 0u);
+	EXPECT_EQ(cache.stats().size, 0u);
+}
+
+TEST(GroupCache, reportPart) {
+	metaf::GroupCache cache;
+	metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012", cache);
+	const auto taf = metaf::Parser::parse(
+		"TAF ZZZZ 041100Z 0412/0512 24015KT 9999 FEW030", cache);
+	ASSERT_EQ(taf.groups.size(), 7u);
+	EXPECT_EQ(taf.groups[4].reportPart, metaf::ReportPart::TAF);
+	EXPECT_TRUE(std::holds_alternative<metaf::WindGroup>(taf.groups[4].group));
+	// Only location ZZZZ belongs to the same report part
+	EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST(GroupCache, eviction) {
+	metaf::GroupCache cache(2);
+	EXPECT_EQ(cache.capacity(), 2u);
+	const auto md = metaf::ReportMetadata();
+	cache.parse("CAVOK", metaf::ReportPart::METAR, md);
+	cache.parse("NOSIG", metaf::ReportPart::METAR, md);
+	cache.parse("CAVOK", metaf::ReportPart::METAR, md);
+	cache.parse("NSC", metaf::ReportPart::METAR, md);
+	EXPECT_EQ(cache.stats().evictions, 1u);
+	EXPECT_EQ(cache.stats().size, 2u);
+	// NOSIG was least recently used
+	cache.parse("CAVOK", metaf::ReportPart::METAR, md);
+	EXPECT_EQ(cache.stats().hits, 2u);
+	cache.parse("NOSIG", metaf::ReportPart::METAR, md);
+	EXPECT_EQ(cache.stats().hits, 2u);
+	EXPECT_EQ(cache.stats().evictions, 2u);
+}
+
+TEST(GroupCache, reportTimeDependentGroups) {
+	metaf::GroupCache cache;
+	const auto r1 = metaf::Parser::parse(
+		"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 RMK RAB15", cache);
+	const auto r2 = metaf::Parser::parse(
+		"METAR KZZZ 041253Z 24015KT 10SM FEW030 12/10 A2992 RMK RAB15", cache);
+	ASSERT_EQ(r1.groups.size(), 10u);
+	ASSERT_EQ(r2.groups.size(), 10u);
+	const auto w1 = std::get_if<metaf::WeatherGroup>(&r1.groups.back().group);
+	const auto w2 = std::get_if<metaf::WeatherGroup>(&r2.groups.back().group);
+	ASSERT_TRUE(w1 && w2);
+	ASSERT_TRUE(w1->weatherPhenomena().at(0).time().has_value());
+	ASSERT_TRUE(w2->weatherPhenomena().at(0).time().has_value());
+	EXPECT_EQ(w1->weatherPhenomena()[0].time()->hour(), 11u);
+	EXPECT_EQ(w2->weatherPhenomena()[0].time()->hour(), 12u);
+	EXPECT_EQ(cache.stats().bypassed, 2u);
+}
+
+TEST(GroupCache, sameResultAsParser) {
+	metaf::GroupCache cache(64);
+	for (auto pass = 0; pass < 2; pass++) {
+		for (const auto & data : testdata::realDataSet) {
+			for (const auto & report : { data.metar, data.taf }) {
+				if (report.empty()) continue;
+				const auto expected = metaf::Parser::parse(report);
+				const auto actual = metaf::Parser::parse(report, cache);
+				EXPECT_EQ(actual.reportMetadata.type, expected.reportMetadata.type);
+				EXPECT_EQ(actual.reportMetadata.error, expected.reportMetadata.error);
+				ASSERT_EQ(actual.groups.size(), expected.groups.size());
+				for (auto i = 0u; i < actual.groups.size(); i++) {
+					EXPECT_EQ(actual.groups[i].group.index(),
+						expected.groups[i].group.index());
+					EXPECT_EQ(actual.groups[i].reportPart,
+						expected.groups[i].reportPart);
+					EXPECT_EQ(actual.groups[i].rawString,
+						expected.groups[i].rawString);
+				}
+			}
+		}
+	}
+	EXPECT_GT(cache.stats().hits, 0u);
+	EXPECT_GT(cache.stats().evictions, 0u);
+}
+
+TEST(GroupCache, reuseParseResult) {
+	metaf::GroupCache cache;
+	metaf::ParseResult actual;
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { data.metar, data.taf }) {
+			metaf::Parser::parse(report, actual, cache);
+			expectSame(actual, metaf::Parser::parse(report));
+		}
+	}
+	EXPECT_GT(cache.stats().hits, 0u);
+}
+
+TEST(GroupCache, reuseParseResultReplacesContent) {
+	const std::string longReport = 
+		"METAR KZZZ 041153Z 24015KT 10SM -SHRA FEW030 BKN080 12/10 A2992 "
+		"RMK AO2 SLP132 P0000 T01220100=";
+	const std::string shortReport = "TAF ZZZZ 041100Z 0412/0512 24010KT P6SM SCT020=";
+	metaf::GroupCache cache;
+	metaf::ParseResult result;
+	metaf::Parser::parse(longReport, result, cache);
+	expectSame(result, metaf::Parser::parse(longReport));
+	const auto capacity = result.groups.capacity();
+	const auto data = result.groups.data();
+
+	// Previous groups, metadata and sections are replaced, the memory
+	// allocated for the groups is re-used
+	metaf::Parser::parse(shortReport, result, cache);
+	expectSame(result, metaf::Parser::parse(shortReport));
+	EXPECT_EQ(result.groups.capacity(), capacity);
+	EXPECT_EQ(result.groups.data(), data);
+	EXPECT_TRUE(result.sections.remarks.empty());
+
+	// Empty report clears the result
+	metaf::Parser::parse("", result, cache);
+	expectSame(result, metaf::Parser::parse(""));
+	EXPECT_TRUE(result.groups.empty());
+
+	// Groups of the previous report are decoded using cache
+	const auto before = cache.stats();
+	metaf::Parser::parse(longReport, result, cache);
+	expectSame(result, metaf::Parser::parse(longReport));
+	EXPECT_GT(cache.stats().hits, before.hits);
+}
+
+TEST(GroupCache, threadCache) {
+	auto & cache = metaf::GroupCache::threadCache();
+	EXPECT_EQ(&cache, &metaf::GroupCache::threadCache());
+	EXPECT_GT(cache.capacity(), 0u);
+}
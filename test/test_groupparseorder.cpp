@@ -0,0 +1,155 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include <set>
+#include <sstream>
+
+using metaf::GroupParseOrder;
+
+static metaf::GroupFrequency realDataFrequency() {
+	metaf::GroupFrequency result;
+	for (const auto & data : testdata::realDataSet) {
+		if (!data.metar.empty()) result.add(metaf::Parser::parse(data.metar));
+		if (!data.taf.empty()) result.add(metaf::Parser::parse(data.taf));
+	}
+	return result;
+}
+
+TEST(GroupParseOrder, defaultOrder) {
+	const GroupParseOrder order;
+	const auto & o = order.order(metaf::ReportPart::METAR);
+	for (auto i = 0u; i < o.size(); i++) EXPECT_EQ(o[i], i);
+	EXPECT_EQ(GroupParseOrder::size, std::variant_size_v<metaf::Group> - 1);
+}
+
+TEST(GroupParseOrder, setOrder) {
+	GroupParseOrder order;
+	auto o = order.order(metaf::ReportPart::TAF);
+	std::reverse(o.begin(), o.end());
+	// Reversed order violates priorities
+	EXPECT_FALSE(order.setOrder(metaf::ReportPart::TAF, o));
+	EXPECT_EQ(order.order(metaf::ReportPart::TAF)[0], 0u);
+
+	o = order.order(metaf::ReportPart::TAF);
+	std::swap(o[0], o[4]);
+	EXPECT_TRUE(order.setOrder(metaf::ReportPart::TAF, o));
+	EXPECT_EQ(order.order(metaf::ReportPart::TAF)[0], 4u);
+	EXPECT_EQ(order.order(metaf::ReportPart::METAR)[0], 0u);
+
+	// Not a permutation
+	o[1] = o[2];
+	EXPECT_FALSE(order.setOrder(metaf::ReportPart::TAF, o));
+}
+
+TEST(GroupParseOrder, string) {
+	GroupParseOrder order;
+	auto o = order.order(metaf::ReportPart::RMK);
+	std::swap(o[0], o[5]);
+	ASSERT_TRUE(order.setOrder(metaf::ReportPart::RMK, o));
+	const auto s = order.toString();
+	const auto loaded = GroupParseOrder::fromString(s);
+	ASSERT_TRUE(loaded.has_value());
+	EXPECT_EQ(loaded->toString(), s);
+	EXPECT_EQ(loaded->order(metaf::ReportPart::RMK)[0], 5u);
+
+	EXPECT_FALSE(GroupParseOrder::fromString("").has_value());
+	EXPECT_FALSE(GroupParseOrder::fromString("0 1 2").has_value());
+	EXPECT_FALSE(GroupParseOrder::fromString(s + ";").has_value());
+	EXPECT_FALSE(GroupParseOrder::fromString(s.substr(2)).has_value());
+	EXPECT_FALSE(GroupParseOrder::fromString("A" + s).has_value());
+}
+
+TEST(GroupParseOrder, fromFrequency) {
+	const auto frequency = realDataFrequency();
+	const auto order = GroupParseOrder::fromFrequency(frequency);
+	for (auto rp : { metaf::ReportPart::UNKNOWN, metaf::ReportPart::HEADER,
+		metaf::ReportPart::METAR, metaf::ReportPart::TAF, metaf::ReportPart::RMK })
+	{
+		const auto & o = order.order(rp);
+		EXPECT_TRUE(GroupParseOrder::isValid(o));
+		// Most frequent alternative is attempted first
+		for (auto i = 0u; i < GroupParseOrder::size; i++) {
+			EXPECT_GE(frequency.count(rp, o[0]), frequency.count(rp, i));
+		}
+	}
+	const auto & metar = order.order(metaf::ReportPart::METAR);
+	const auto fixed = metaf::Group(metaf::FixedGroup()).index();
+	EXPECT_NE(metar[0], fixed);
+}
+
+TEST(GroupParseOrder, sameResultAsDefaultOrder) {
+	const auto order = GroupParseOrder::fromFrequency(realDataFrequency());
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { data.metar, data.taf }) {
+			if (report.empty()) continue;
+			const auto expected = metaf::Parser::parse(report);
+			const auto actual = metaf::Parser::parse(report, order);
+			EXPECT_EQ(actual.reportMetadata.type, expected.reportMetadata.type);
+			EXPECT_EQ(actual.reportMetadata.error, expected.reportMetadata.error);
+			ASSERT_EQ(actual.groups.size(), expected.groups.size());
+			for (auto i = 0u; i < actual.groups.size(); i++) {
+				EXPECT_EQ(actual.groups[i].group.index(),
+					expected.groups[i].group.index());
+				EXPECT_EQ(actual.groups[i].rawString,
+					expected.groups[i].rawString);
+			}
+		}
+	}
+}
+
+// Alternatives which successfully parse the group string
+template <size_t I = 0>
+static void parsedBy(const std::string & group,
+	metaf::ReportPart reportPart,
+	const metaf::ReportMetadata & reportMetadata,
+	std::vector<std::size_t> & result)
+{
+	if constexpr (I < GroupParseOrder::size) {
+		using Alternative = std::variant_alternative_t<I, metaf::Group>;
+		if (Alternative::parse(group, reportPart, reportMetadata).has_value()) {
+			result.push_back(I);
+		}
+		parsedBy<I + 1>(group, reportPart, reportMetadata, result);
+	}
+}
+
+TEST(GroupParseOrder, prioritiesComplete) {
+	// If the same group string may be parsed by two alternatives, their
+	// relative priority must be specified
+	std::set<std::string> groups;
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { data.metar, data.taf }) {
+			std::istringstream ss(report);
+			std::string group;
+			while (ss >> group) {
+				if (group.back() == '=') group.pop_back();
+				groups.insert(group);
+			}
+		}
+	}
+	const auto & priorities = GroupParseOrder::priorities();
+	metaf::ReportMetadata reportMetadata;
+	reportMetadata.reportTime = metaf::MetafTime::fromStringDDHHMM("041200");
+	for (const auto & group : groups) {
+		for (auto rp : { metaf::ReportPart::HEADER, metaf::ReportPart::METAR,
+			metaf::ReportPart::TAF, metaf::ReportPart::RMK })
+		{
+			std::vector<std::size_t> alternatives;
+			parsedBy(group, rp, reportMetadata, alternatives);
+			for (auto i = 0u; i < alternatives.size(); i++) {
+				for (auto j = i + 1; j < alternatives.size(); j++) {
+					const auto p = std::make_pair(alternatives[i], alternatives[j]);
+					EXPECT_NE(std::find(priorities.begin(), priorities.end(), p),
+						priorities.end()) << group;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,94 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include "expect_same.h"
+
+using testdata::expectSame;
+
+TEST(LazyParseResult, metarRemarksDeferred) {
+	const std::string report =
+		"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 RMK AO2 RAB15 "
+		"SLP132 T01220100=";
+	metaf::LazyParseResult lazy;
+	metaf::Parser::parse(report, lazy);
+	EXPECT_FALSE(lazy.isDecoded());
+	EXPECT_EQ(lazy.remarks(), "AO2 RAB15 SLP132 T01220100=");
+	EXPECT_EQ(lazy.reportMetadata().type, metaf::ReportType::METAR);
+	EXPECT_EQ(lazy.reportMetadata().error, metaf::ReportError::NONE);
+	ASSERT_TRUE(lazy.reportMetadata().reportTime.has_value());
+	EXPECT_EQ(lazy.reportMetadata().reportTime->hour(), 11u);
+
+	const auto & partial = lazy.partialResult();
+	ASSERT_EQ(partial.groups.size(), 9u);
+	EXPECT_EQ(partial.groups.back().rawString, "RMK");
+	EXPECT_EQ(partial.sections.body.begin, 3u);
+	EXPECT_EQ(partial.sections.body.end, 8u);
+	EXPECT_EQ(partial.sections.remarks.size(), 1u);
+
+	const auto & result = lazy.parseResult();
+	EXPECT_TRUE(lazy.isDecoded());
+	EXPECT_TRUE(lazy.remarks().empty());
+	expectSame(result, metaf::Parser::parse(report));
+	// Remark groups use report time from the header
+	const auto wx = std::get_if<metaf::WeatherGroup>(&result.groups[10].group);
+	ASSERT_TRUE(wx);
+	ASSERT_TRUE(wx->weatherPhenomena().at(0).time().has_value());
+	EXPECT_EQ(wx->weatherPhenomena()[0].time()->hour(), 11u);
+}
+
+TEST(LazyParseResult, notDeferred) {
+	for (const auto & report : {
+		"METAR ZZZZ 041100Z 24010KT 9999 SCT020 10/05 Q1010 NOSIG=",
+		"TAF ZZZZ 041100Z 0412/0512 24010KT 9999 SCT020 RMK NXT FCST BY 041800Z=",
+		"METAR ZZZZ 041100Z NIL=",
+		"METAR ZZZZ 041100Z 24010KT 9999 SCT020 10/05 Q1010 RMK=",
+		""})
+	{
+		metaf::LazyParseResult lazy;
+		metaf::Parser::parse(report, lazy);
+		EXPECT_TRUE(lazy.isDecoded());
+		EXPECT_TRUE(lazy.remarks().empty());
+		expectSame(lazy.partialResult(), metaf::Parser::parse(report));
+	}
+}
+
+TEST(LazyParseResult, remarksTooLarge) {
+	const std::string report =
+		"METAR ZZZZ 041100Z 24010KT 9999 SCT020 10/05 Q1010 RMK A B C D E F G";
+	const auto expected = metaf::Parser::parse(report, 12);
+	ASSERT_EQ(expected.reportMetadata.error, metaf::ReportError::REPORT_TOO_LARGE);
+	metaf::LazyParseResult lazy;
+	metaf::Parser::parse(report, lazy, 12);
+	EXPECT_TRUE(lazy.isDecoded());
+	EXPECT_EQ(lazy.reportMetadata().error, metaf::ReportError::REPORT_TOO_LARGE);
+	expectSame(lazy.partialResult(), expected);
+
+	metaf::Parser::parse(report, lazy, 20);
+	EXPECT_FALSE(lazy.isDecoded());
+	EXPECT_EQ(lazy.reportMetadata().error, metaf::ReportError::NONE);
+	expectSame(lazy.parseResult(), metaf::Parser::parse(report, 20));
+}
+
+TEST(LazyParseResult, sameResultAsParser) {
+	metaf::GroupCache cache;
+	metaf::LazyParseResult lazy;
+	auto deferred = 0u;
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { data.metar, data.taf }) {
+			const auto expected = metaf::Parser::parse(report);
+			metaf::Parser::parse(report, lazy, cache);
+			EXPECT_EQ(lazy.reportMetadata().type, expected.reportMetadata.type);
+			EXPECT_EQ(lazy.reportMetadata().error, expected.reportMetadata.error);
+			if (!lazy.isDecoded()) deferred++;
+			expectSame(lazy.parseResult(cache), expected);
+		}
+	}
+	EXPECT_GT(deferred, 0u);
+}
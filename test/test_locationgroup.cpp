@@ -46,3 +46,30 @@ TEST(LocationGroup, isValid) {
 	ASSERT_TRUE(lg2.has_value());
 	EXPECT_TRUE(lg2->isValid());
 }
+
+TEST(LocationGroup, key) {
+	const auto lg = metaf::LocationGroup::parse("K2J3", metaf::ReportPart::HEADER);
+	ASSERT_TRUE(lg.has_value());
+	EXPECT_EQ(lg->key(), 0x4B324A33u);
+	EXPECT_EQ(metaf::LocationGroup::keyToString(lg->key()), "K2J3");
+	EXPECT_EQ(metaf::LocationGroup::stringToKey("K2J3"), lg->key());
+}
+
+TEST(LocationGroup, keyOrder) {
+	static const char * const locations[] = { "A000", "A00Z", "A0A0", "K2J3", "KJFK", "UKLL", "ZZZZ" };
+	for (auto i = 1u; i < std::size(locations); i++) {
+		const auto k1 = metaf::LocationGroup::stringToKey(locations[i - 1]);
+		const auto k2 = metaf::LocationGroup::stringToKey(locations[i]);
+		ASSERT_TRUE(k1.has_value() && k2.has_value());
+		EXPECT_LT(*k1, *k2);
+	}
+}
+
+TEST(LocationGroup, keyWrongFormat) {
+	EXPECT_FALSE(metaf::LocationGroup::stringToKey("").has_value());
+	EXPECT_FALSE(metaf::LocationGroup::stringToKey("2AAA").has_value());
+	EXPECT_FALSE(metaf::LocationGroup::stringToKey("AAA").has_value());
+	EXPECT_FALSE(metaf::LocationGroup::stringToKey("AAAAA").has_value());
+	EXPECT_FALSE(metaf::LocationGroup::stringToKey("AAaA").has_value());
+	EXPECT_EQ(metaf::LocationGroup::keyToString(0), "");
+}
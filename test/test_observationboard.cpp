@@ -0,0 +1,386 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+// POSIX shared memory is not available in the tests built with emcc
+#ifndef __EMSCRIPTEN__
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "observationboard.hpp"
+#include <array>
+#include <map>
+#include <tuple>
+#include <vector>
+
+static std::string boardName(const std::string & test) {
+	return "/metaf_test_board_" + test + "_" + std::to_string(getpid());
+}
+
+// Record with every byte set to the specified value, so that a record mixed
+// from two different updates is detected
+static ObservationBoard::Record filledRecord(std::uint8_t value) {
+	// Record is trivially copyable (checked by ObservationBoard), so that
+	// its bytes may be copied from an array
+	std::array<unsigned char, sizeof(ObservationBoard::Record)> bytes;
+	bytes.fill(value);
+	ObservationBoard::Record record;
+	std::memcpy(&record, bytes.data(), bytes.size());
+	return record;
+}
+
+static bool isFilled(const ObservationBoard::Record & record, std::uint8_t value) {
+	const auto bytes = reinterpret_cast<const std::uint8_t *>(&record);
+	for (auto i = 0u; i < sizeof(record); i++) {
+		if (bytes[i] != value) return false;
+	}
+	return true;
+}
+
+static bool isSame(float v1, float v2) {
+	if (!metaf::CurrentWeather::isReported(v1)) {
+		return !metaf::CurrentWeather::isReported(v2);
+	}
+	return (v1 == v2);
+}
+
+// Records extracted separately are compared by value: padding bytes and
+// the storage of empty optionals are not copied by the extractor
+static bool isSame(const ObservationBoard::Record & r1, const ObservationBoard::Record & r2) {
+	const auto time = [](const ObservationBoard::Record & r) {
+		return r.reportTime.has_value() ?
+			std::tuple(true, r.reportTime->day(), r.reportTime->hour(), r.reportTime->minute()) :
+			std::tuple(false, std::optional<unsigned int>(), 0u, 0u);
+	};
+	return r1.source == r2.source &&
+		r1.cloud == r2.cloud &&
+		r1.isWindVariable == r2.isWindVariable &&
+		r1.isStormClouds == r2.isStormClouds &&
+		isSame(r1.windDirection, r2.windDirection) &&
+		isSame(r1.windSpeed, r2.windSpeed) &&
+		isSame(r1.gustSpeed, r2.gustSpeed) &&
+		isSame(r1.visibility, r2.visibility) &&
+		isSame(r1.airTemperature, r2.airTemperature) &&
+		isSame(r1.perceivedTemperature, r2.perceivedTemperature) &&
+		isSame(r1.airTemperatureHigh, r2.airTemperatureHigh) &&
+		isSame(r1.airTemperatureLow, r2.airTemperatureLow) &&
+		isSame(r1.relativeHumidity, r2.relativeHumidity) &&
+		isSame(r1.pressure, r2.pressure) &&
+		time(r1) == time(r2) &&
+		r1.weather == r2.weather &&
+		r1.weatherSize == r2.weatherSize;
+}
+
+// Maps the shared memory object for writing and calls f(data, size); used to
+// simulate a writer which terminated during update, or a board created by
+// an incompatible version
+template <typename F>
+static void modifyBoard(const std::string & name, F f) {
+	const auto fd = shm_open(name.c_str(), O_RDWR, 0);
+	ASSERT_GE(fd, 0);
+	struct stat st;
+	ASSERT_FALSE(fstat(fd, &st));
+	const auto size = static_cast<std::size_t>(st.st_size);
+	void * p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	ASSERT_NE(p, MAP_FAILED);
+	f(static_cast<char *>(p), size);
+	munmap(p, size);
+}
+
+TEST(ObservationBoard, createOpen) {
+	const auto name = boardName("createOpen");
+	ObservationBoard writer;
+	EXPECT_FALSE(writer.isOpen());
+	EXPECT_EQ(writer.capacity(), 0u);
+	EXPECT_FALSE(writer.create(name, 0));
+	EXPECT_EQ(writer.error(), EINVAL);
+	ASSERT_TRUE(writer.create(name, 10));
+	EXPECT_TRUE(writer.isOpen());
+	EXPECT_TRUE(writer.isWriter());
+	EXPECT_EQ(writer.capacity(), 10u);
+	EXPECT_EQ(writer.size(), 0u);
+	EXPECT_EQ(writer.updates(), 0u);
+
+	ObservationBoard reader;
+	ASSERT_TRUE(reader.open(name));
+	EXPECT_TRUE(reader.isOpen());
+	EXPECT_FALSE(reader.isWriter());
+	EXPECT_EQ(reader.capacity(), 10u);
+	// Reader cannot publish
+	EXPECT_FALSE(reader.publish(1, filledRecord(1)));
+
+	// Board remains valid after the shared memory object is removed
+	EXPECT_TRUE(ObservationBoard::remove(name));
+	EXPECT_FALSE(ObservationBoard::remove(name));
+	EXPECT_TRUE(writer.publish(1, filledRecord(1)));
+	EXPECT_EQ(reader.size(), 1u);
+	ObservationBoard other;
+	EXPECT_FALSE(other.open(name));
+	EXPECT_EQ(other.error(), ENOENT);
+
+	// Moved-from board is closed
+	ObservationBoard moved(std::move(reader));
+	EXPECT_FALSE(reader.isOpen());
+	EXPECT_TRUE(moved.isOpen());
+	EXPECT_EQ(moved.size(), 1u);
+	moved.close();
+	EXPECT_FALSE(moved.isOpen());
+	EXPECT_EQ(moved.size(), 0u);
+}
+
+TEST(ObservationBoard, publishRead) {
+	const auto name = boardName("publishRead");
+	ObservationBoard writer, reader;
+	ASSERT_TRUE(writer.create(name, 3));
+	ASSERT_TRUE(reader.open(name));
+	ObservationBoard::remove(name);
+
+	ObservationBoard::Record record;
+	std::uint64_t version = 0;
+	EXPECT_FALSE(reader.read(1, record));
+	EXPECT_FALSE(writer.publish(0, filledRecord(1)));
+
+	EXPECT_TRUE(writer.publish(1, filledRecord(1)));
+	EXPECT_TRUE(writer.publish(2, filledRecord(2)));
+	ASSERT_TRUE(reader.read(1, record, &version));
+	EXPECT_TRUE(isFilled(record, 1));
+	EXPECT_EQ(version, 1u);
+	ASSERT_TRUE(reader.read(2, record));
+	EXPECT_TRUE(isFilled(record, 2));
+	EXPECT_FALSE(reader.read(3, record));
+	EXPECT_EQ(reader.size(), 2u);
+	EXPECT_EQ(reader.updates(), 2u);
+
+	// Only the latest record of the station is kept
+	EXPECT_TRUE(writer.publish(1, filledRecord(3)));
+	ASSERT_TRUE(reader.read(1, record, &version));
+	EXPECT_TRUE(isFilled(record, 3));
+	EXPECT_EQ(version, 2u);
+	EXPECT_EQ(reader.size(), 2u);
+	EXPECT_EQ(reader.updates(), 3u);
+
+	std::map<std::uint32_t, std::pair<std::uint8_t, std::uint64_t>> stations;
+	reader.forEach([&](std::uint32_t key,
+		const ObservationBoard::Record & r,
+		std::uint64_t v)
+	{
+		stations[key] = std::pair(*reinterpret_cast<const std::uint8_t *>(&r), v);
+	});
+	ASSERT_EQ(stations.size(), 2u);
+	EXPECT_EQ(stations[1], std::pair(std::uint8_t(3), std::uint64_t(2)));
+	EXPECT_EQ(stations[2], std::pair(std::uint8_t(2), std::uint64_t(1)));
+}
+
+TEST(ObservationBoard, publishReports) {
+	const auto name = boardName("publishReports");
+	ObservationBoard writer, reader;
+	ASSERT_TRUE(writer.create(name, testdata::realDataSet.size()));
+	ASSERT_TRUE(reader.open(name));
+	ObservationBoard::remove(name);
+	// Test data contains several reports from some stations, only the latest
+	// one remains on the board
+	std::map<std::uint32_t, ObservationBoard::Record> expected;
+	for (const auto & data : testdata::realDataSet) {
+		const auto metar = metaf::Parser::parse(data.metar);
+		const auto taf = metaf::Parser::parse(data.taf);
+		std::uint32_t key = 0;
+		for (const auto result : { &metar, &taf }) {
+			const auto i = result->sections.firstOf<metaf::LocationGroup>();
+			if (i == metaf::ReportSections::notFound) continue;
+			key = std::get<metaf::LocationGroup>(result->groups[i].group).key();
+			break;
+		}
+		EXPECT_EQ(writer.publish(metar, taf), key != 0);
+		if (!key) continue;
+		expected[key] = metaf::CurrentWeatherExtractor::extract(metar, taf);
+	}
+	ASSERT_FALSE(expected.empty());
+	EXPECT_EQ(reader.size(), expected.size());
+	for (const auto & [key, weather] : expected) {
+		ObservationBoard::Record record;
+		ASSERT_TRUE(reader.read(key, record));
+		EXPECT_TRUE(isSame(record, weather)) << metaf::LocationGroup::keyToString(key);
+	}
+	// No location in either report
+	EXPECT_FALSE(writer.publish(metaf::ParseResult(), metaf::ParseResult()));
+}
+
+TEST(ObservationBoard, full) {
+	const auto name = boardName("full");
+	ObservationBoard writer;
+	ASSERT_TRUE(writer.create(name, 5));
+	ObservationBoard::remove(name);
+	for (auto key = 1u; key <= 5; key++) {
+		EXPECT_TRUE(writer.publish(key, filledRecord(key)));
+	}
+	EXPECT_FALSE(writer.publish(6, filledRecord(6)));
+	EXPECT_EQ(writer.size(), 5u);
+	// Stations already on the board can still be updated
+	EXPECT_TRUE(writer.publish(5, filledRecord(7)));
+	ObservationBoard::Record record;
+	ASSERT_TRUE(writer.read(5, record));
+	EXPECT_TRUE(isFilled(record, 7));
+	EXPECT_FALSE(writer.read(6, record));
+}
+
+TEST(ObservationBoard, version) {
+	const auto name = boardName("version");
+	ObservationBoard writer, reader;
+	ASSERT_TRUE(writer.create(name, 2));
+	ASSERT_TRUE(reader.open(name));
+	EXPECT_EQ(reader.version(1), 0u);
+	for (auto i = 1u; i <= 10; i++) {
+		writer.publish(1, filledRecord(i));
+		EXPECT_EQ(reader.version(1), i);
+	}
+	EXPECT_EQ(reader.version(2), 0u);
+	EXPECT_EQ(reader.version(0), 0u);
+
+	// Board created with different layout or record size is not opened
+	modifyBoard(name, [](char * data, std::size_t) {
+		std::uint32_t layoutVersion;
+		std::memcpy(&layoutVersion, data + sizeof(std::uint64_t), sizeof(layoutVersion));
+		layoutVersion++;
+		std::memcpy(data + sizeof(std::uint64_t), &layoutVersion, sizeof(layoutVersion));
+	});
+	ObservationBoard other;
+	EXPECT_FALSE(other.open(name));
+	EXPECT_EQ(other.error(), EPROTO);
+	EXPECT_FALSE(other.isOpen());
+
+	// Shared memory object which is not a board
+	ObservationBoard::remove(name);
+	const auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	ASSERT_GE(fd, 0);
+	close(fd);
+	EXPECT_FALSE(other.open(name));
+	EXPECT_EQ(other.error(), EPROTO);
+	ObservationBoard::remove(name);
+}
+
+TEST(ObservationBoard, staleReader) {
+	const auto name = boardName("staleReader");
+	ObservationBoard writer, reader;
+	ASSERT_TRUE(writer.create(name, 2));
+	ASSERT_TRUE(reader.open(name));
+	writer.publish(1, filledRecord(1));
+
+	// Board is replaced; reader opened before still sees the old board
+	ASSERT_TRUE(writer.create(name, 4));
+	writer.publish(2, filledRecord(2));
+	ObservationBoard::Record record;
+	EXPECT_EQ(reader.capacity(), 2u);
+	ASSERT_TRUE(reader.read(1, record));
+	EXPECT_TRUE(isFilled(record, 1));
+	EXPECT_FALSE(reader.read(2, record));
+
+	// Re-opened reader sees the new board
+	ASSERT_TRUE(reader.open(name));
+	EXPECT_EQ(reader.capacity(), 4u);
+	EXPECT_FALSE(reader.read(1, record));
+	ASSERT_TRUE(reader.read(2, record));
+	EXPECT_TRUE(isFilled(record, 2));
+	ObservationBoard::remove(name);
+}
+
+TEST(ObservationBoard, interruptedUpdate) {
+	const auto name = boardName("interruptedUpdate");
+	ObservationBoard writer, reader;
+	ASSERT_TRUE(writer.create(name, 2));
+	ASSERT_TRUE(reader.open(name));
+	static const std::uint32_t key = 0x5A5A1234;
+	writer.publish(key, filledRecord(1));
+	writer.publish(key, filledRecord(2));
+
+	// Writer terminated in the middle of update and left sequence odd;
+	// slots are cache line aligned and begin with the 32-bit key followed
+	// by the 64-bit sequence
+	bool found = false;
+	auto setSequence = [&](std::uint64_t value) {
+		modifyBoard(name, [&](char * data, std::size_t size) {
+			for (auto offset = 64u; offset + 64 <= size; offset += 64) {
+				std::uint32_t k;
+				std::memcpy(&k, data + offset, sizeof(k));
+				if (k != key) continue;
+				std::memcpy(data + offset + 8, &value, sizeof(value));
+				found = true;
+				return;
+			}
+		});
+	};
+	setSequence(5);
+	ASSERT_TRUE(found);
+
+	ObservationBoard::Record record = filledRecord(0);
+	std::uint64_t version = 0;
+	// Reader retries and gives up rather than returning a torn record
+	EXPECT_FALSE(reader.read(key, record, &version));
+	EXPECT_TRUE(isFilled(record, 0));
+	EXPECT_EQ(version, 0u);
+	std::size_t stations = 0;
+	reader.forEach([&](auto, const auto &, auto) { stations++; });
+	EXPECT_EQ(stations, 0u);
+
+	// Next complete update makes the record readable again
+	setSequence(4);
+	ASSERT_TRUE(reader.read(key, record, &version));
+	EXPECT_TRUE(isFilled(record, 2));
+	EXPECT_EQ(version, 2u);
+	ObservationBoard::remove(name);
+}
+
+TEST(ObservationBoard, concurrentPublishRead) {
+	const auto name = boardName("concurrentPublishRead");
+	ObservationBoard writer;
+	ASSERT_TRUE(writer.create(name, 4));
+	static const std::uint32_t keys = 4;
+	static const std::size_t updates = 20000;
+	for (auto key = 1u; key <= keys; key++) writer.publish(key, filledRecord(1));
+
+	std::atomic<bool> finished = false;
+	std::vector<std::thread> readers;
+	std::vector<std::size_t> reads(3), errors(3);
+	for (auto r = 0u; r < reads.size(); r++) {
+		readers.emplace_back([&, r](){
+			// Each reader uses its own mapping, same as another process would
+			ObservationBoard reader;
+			if (!reader.open(name)) { errors[r]++; return; }
+			std::uint64_t lastVersion[keys + 1] = {};
+			// At least one pass is made even if the writer has already finished
+			do {
+				for (auto key = 1u; key <= keys; key++) {
+					ObservationBoard::Record record;
+					std::uint64_t version = 0;
+					if (!reader.read(key, record, &version)) continue;
+					reads[r]++;
+					// Record is never mixed from two updates, and version is
+					// never decremented; record of version n is filled with n
+					if (!isFilled(record, static_cast<std::uint8_t>(version))) errors[r]++;
+					if (version < lastVersion[key]) errors[r]++;
+					lastVersion[key] = version;
+				}
+			} while (!finished.load());
+		});
+	}
+	for (auto i = 2u; i <= updates; i++) {
+		for (auto key = 1u; key <= keys; key++) {
+			writer.publish(key, filledRecord(static_cast<std::uint8_t>(i)));
+		}
+	}
+	finished = true;
+	for (auto & t : readers) t.join();
+	ObservationBoard::remove(name);
+
+	for (auto r = 0u; r < reads.size(); r++) {
+		EXPECT_EQ(errors[r], 0u) << "Reader " << r;
+		EXPECT_GT(reads[r], 0u) << "Reader " << r;
+	}
+	EXPECT_EQ(writer.updates(), keys * updates);
+	for (auto key = 1u; key <= keys; key++) EXPECT_EQ(writer.version(key), updates);
+}
+
+#endif
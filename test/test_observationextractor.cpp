@@ -0,0 +1,193 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+
+static const auto margin = 0.1/2;
+
+TEST(ObservationExtractor, metar) {
+	const auto parseResult = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 24015G25KT 1 1/2SM -SHRA BR BKN012 OVC025 "
+		"12/10 A2992 RMK AO2 SLP135");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+
+	ASSERT_EQ(columns.size(), 1u);
+	EXPECT_NEAR(columns.windDirection[0], 240, margin);
+	EXPECT_NEAR(columns.windSpeed[0], 15, margin);
+	EXPECT_NEAR(columns.gustSpeed[0], 25, margin);
+	EXPECT_NEAR(columns.visibility[0], 1.5 * 1609.347, 1);
+	EXPECT_NEAR(columns.ceiling[0], 1200, margin);
+	EXPECT_NEAR(columns.airTemperature[0], 12, margin);
+	EXPECT_NEAR(columns.dewPoint[0], 10, margin);
+	EXPECT_NEAR(columns.pressure[0], 1012.9, 0.5);
+
+	ASSERT_EQ(columns.weatherOffset.size(), 2u);
+	EXPECT_EQ(columns.weatherOffset[0], 0u);
+	EXPECT_EQ(columns.weatherOffset[1], 2u);
+	ASSERT_EQ(columns.weather.size(), 2u);
+	const auto rain = columns.weather[0];
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeQualifier(rain),
+		metaf::WeatherPhenomena::Qualifier::LIGHT);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeDescriptor(rain),
+		metaf::WeatherPhenomena::Descriptor::SHOWERS);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeWeather(rain, 0),
+		metaf::WeatherPhenomena::Weather::RAIN);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeWeather(rain, 1),
+		metaf::WeatherPhenomena::Weather::OMMITTED);
+	EXPECT_EQ(metaf::ObservationColumns::weatherCodeWeather(columns.weather[1], 0),
+		metaf::WeatherPhenomena::Weather::MIST);
+}
+
+TEST(ObservationExtractor, metarNotReported) {
+	const auto parseResult = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z VRB02KT //// ///////");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+
+	ASSERT_EQ(columns.size(), 1u);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.windDirection[0]));
+	EXPECT_NEAR(columns.windSpeed[0], 2, margin);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.gustSpeed[0]));
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.visibility[0]));
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.ceiling[0]));
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.airTemperature[0]));
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.dewPoint[0]));
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.pressure[0]));
+	EXPECT_TRUE(columns.weather.empty());
+}
+
+TEST(ObservationExtractor, cavok) {
+	const auto parseResult = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 00000KT CAVOK 22/M03 Q1020");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+
+	ASSERT_EQ(columns.size(), 1u);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.windDirection[0]));
+	EXPECT_NEAR(columns.windSpeed[0], 0, margin);
+	EXPECT_NEAR(columns.visibility[0], 10000, margin);
+	EXPECT_EQ(columns.ceiling[0], metaf::ObservationColumns::unlimited);
+	EXPECT_NEAR(columns.dewPoint[0], -3, margin);
+	EXPECT_NEAR(columns.pressure[0], 1020, margin);
+}
+
+TEST(ObservationExtractor, verticalVisibilityAndNoCeiling) {
+	const auto parseResult = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 0200 FG VV002 M01/M01 Q1011");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+	const auto parseResultNoCeiling = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 9999 FEW030 SCT100 M01/M01 Q1011");
+	metaf::ObservationExtractor::extract(parseResultNoCeiling, columns);
+
+	ASSERT_EQ(columns.size(), 2u);
+	EXPECT_NEAR(columns.visibility[0], 200, margin);
+	EXPECT_NEAR(columns.ceiling[0], 200, margin);
+	EXPECT_NEAR(columns.visibility[1], 10000, margin);
+	EXPECT_EQ(columns.ceiling[1], metaf::ObservationColumns::unlimited);
+}
+
+TEST(ObservationExtractor, updateCeiling) {
+	auto ceiling = metaf::ObservationColumns::notReported;
+	const auto few = metaf::CloudGroup::parse("FEW030", 
+		metaf::ReportPart::METAR, metaf::ReportMetadata());
+	ASSERT_TRUE(few.has_value());
+	metaf::ObservationExtractor::updateCeiling(*few, ceiling);
+	EXPECT_EQ(ceiling, metaf::ObservationColumns::unlimited);
+
+	const auto ovc = metaf::CloudGroup::parse("OVC025", 
+		metaf::ReportPart::METAR, metaf::ReportMetadata());
+	ASSERT_TRUE(ovc.has_value());
+	metaf::ObservationExtractor::updateCeiling(*ovc, ceiling);
+	EXPECT_NEAR(ceiling, 2500, margin);
+
+	const auto bkn = metaf::CloudGroup::parse("BKN040", 
+		metaf::ReportPart::METAR, metaf::ReportMetadata());
+	ASSERT_TRUE(bkn.has_value());
+	metaf::ObservationExtractor::updateCeiling(*bkn, ceiling);
+	EXPECT_NEAR(ceiling, 2500, margin);
+
+	const auto vv = metaf::CloudGroup::parse("VV002", 
+		metaf::ReportPart::METAR, metaf::ReportMetadata());
+	ASSERT_TRUE(vv.has_value());
+	metaf::ObservationExtractor::updateCeiling(*vv, ceiling);
+	EXPECT_NEAR(ceiling, 200, margin);
+
+	metaf::ObservationExtractor::updateCeiling(*few, ceiling);
+	EXPECT_NEAR(ceiling, 200, margin);
+}
+
+TEST(ObservationExtractor, trendsAndRemarksIgnored) {
+	const auto parseResult = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 18005KT 9999 SCT030 15/10 Q1015 "
+		"TEMPO 27020G35KT 2000 TSRA BKN010CB");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+
+	ASSERT_EQ(columns.size(), 1u);
+	EXPECT_NEAR(columns.windDirection[0], 180, margin);
+	EXPECT_NEAR(columns.windSpeed[0], 5, margin);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.gustSpeed[0]));
+	EXPECT_NEAR(columns.visibility[0], 10000, margin);
+	EXPECT_EQ(columns.ceiling[0], metaf::ObservationColumns::unlimited);
+	EXPECT_TRUE(columns.weather.empty());
+}
+
+TEST(ObservationExtractor, tafPrevailingConditions) {
+	const auto parseResult = metaf::Parser::parse(
+		"TAF ZZZZ 041100Z 0412/0512 15006MPS 6000 BKN015 "
+		"TEMPO 0412/0415 15009G15MPS 1000 TSRA OVC005");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+
+	ASSERT_EQ(columns.size(), 1u);
+	EXPECT_NEAR(columns.windDirection[0], 150, margin);
+	EXPECT_NEAR(columns.windSpeed[0], 6 * 1.943844, margin);
+	EXPECT_NEAR(columns.visibility[0], 6000, margin);
+	EXPECT_NEAR(columns.ceiling[0], 1500, margin);
+	EXPECT_FALSE(metaf::ObservationColumns::isReported(columns.pressure[0]));
+}
+
+TEST(ObservationExtractor, batchRealData) {
+	std::vector<metaf::ParseResult> parseResults;
+	for (const auto & data : testdata::realDataSet) {
+		if (!data.metar.empty()) parseResults.push_back(metaf::Parser::parse(data.metar));
+	}
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResults, columns);
+
+	const auto size = parseResults.size();
+	ASSERT_EQ(columns.size(), size);
+	EXPECT_EQ(columns.windSpeed.size(), size);
+	EXPECT_EQ(columns.gustSpeed.size(), size);
+	EXPECT_EQ(columns.visibility.size(), size);
+	EXPECT_EQ(columns.ceiling.size(), size);
+	EXPECT_EQ(columns.airTemperature.size(), size);
+	EXPECT_EQ(columns.dewPoint.size(), size);
+	EXPECT_EQ(columns.pressure.size(), size);
+	ASSERT_EQ(columns.weatherOffset.size(), size + 1);
+	EXPECT_EQ(columns.weatherOffset.back(), columns.weather.size());
+	for (auto i = 0u; i < size; i++) {
+		EXPECT_LE(columns.weatherOffset[i], columns.weatherOffset[i + 1]);
+	}
+}
+
+TEST(ObservationExtractor, clear) {
+	const auto parseResult = metaf::Parser::parse(
+		"METAR ZZZZ 041115Z 24015KT 9999 -RA BKN012 12/10 Q1012");
+	metaf::ObservationColumns columns;
+	metaf::ObservationExtractor::extract(parseResult, columns);
+	ASSERT_EQ(columns.size(), 1u);
+	columns.clear();
+	EXPECT_EQ(columns.size(), 0u);
+	EXPECT_TRUE(columns.weather.empty());
+	ASSERT_EQ(columns.weatherOffset.size(), 1u);
+	EXPECT_EQ(columns.weatherOffset[0], 0u);
+}
@@ -0,0 +1,123 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include "expect_same.h"
+
+using testdata::expectSame;
+
+static const std::string metar =
+	"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 RMK AO2 SLP132 T01220100";
+
+TEST(ParseLimits, defaults) {
+	const metaf::ParseLimits limits;
+	EXPECT_EQ(limits.groups, 100u);
+	// Group limit is converted to limits
+	const metaf::ParseLimits groupLimit(12);
+	EXPECT_EQ(groupLimit.groups, 12u);
+	EXPECT_EQ(groupLimit.groupLength, limits.groupLength);
+	EXPECT_EQ(groupLimit.reportLength, limits.reportLength);
+	EXPECT_EQ(groupLimit.work, limits.work);
+}
+
+TEST(ParseLimits, groupTooLong) {
+	metaf::ParseLimits limits;
+	limits.groupLength = 7;
+	const auto result = metaf::Parser::parse(metar, limits);
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::GROUP_TOO_LONG);
+	// Parsing stops before the group
+	ASSERT_EQ(result.groups.size(), 11u);
+	EXPECT_EQ(result.groups.back().rawString, "SLP132");
+	limits.groupLength = 9;
+	EXPECT_EQ(metaf::Parser::parse(metar, limits).reportMetadata.error,
+		metaf::ReportError::NONE);
+	// Report end character is not included in the group length
+	EXPECT_EQ(metaf::Parser::parse(metar + "=", limits).reportMetadata.error,
+		metaf::ReportError::NONE);
+}
+
+TEST(ParseLimits, reportTooLong) {
+	metaf::ParseLimits limits;
+	limits.reportLength = metar.length();
+	EXPECT_EQ(metaf::Parser::parse(metar, limits).reportMetadata.error,
+		metaf::ReportError::NONE);
+	// Report end character is counted but the text after it is not
+	EXPECT_EQ(metaf::Parser::parse(metar + "= \n" + metar, limits).reportMetadata.error,
+		metaf::ReportError::REPORT_TOO_LONG);
+	limits.reportLength = metar.length() + 1;
+	EXPECT_EQ(metaf::Parser::parse(metar + "= \n" + metar, limits).reportMetadata.error,
+		metaf::ReportError::NONE);
+	// Delimiters are counted; parsing stops before the group string at
+	// the limit
+	limits.reportLength = metar.length();
+	const auto result = metaf::Parser::parse(metar + " X", limits);
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::REPORT_TOO_LONG);
+	EXPECT_EQ(result.groups.size(), 11u);
+	EXPECT_EQ(metaf::Parser::parse(metar + "\n" + metar, limits).reportMetadata.error,
+		metaf::ReportError::REPORT_TOO_LONG);
+	// Report without report end character padded past the limit
+	for (const auto length : { metar.length(), metar.length() + 1 }) {
+		limits.reportLength = length;
+		const auto padded = metaf::Parser::parse(metar + "  \r\n" + std::string(100, ' '), limits);
+		EXPECT_EQ(padded.reportMetadata.error, metaf::ReportError::NONE);
+		EXPECT_EQ(padded.groups.size(), 12u);
+	}
+	limits.reportLength = metar.length() - 1;
+	EXPECT_EQ(metaf::Parser::parse(metar, limits).groups.size(), 11u);
+	// Long sequence of delimiters
+	const auto spaces = metaf::Parser::parse(
+		"METAR KZZZ 041153Z" + std::string(100000, ' ') + "24015KT");
+	EXPECT_EQ(spaces.reportMetadata.error, metaf::ReportError::REPORT_TOO_LONG);
+	EXPECT_EQ(spaces.groups.size(), 3u);
+}
+
+TEST(ParseLimits, workLimitExceeded) {
+	metaf::ParseLimits limits;
+	limits.work = 0;
+	auto result = metaf::Parser::parse(metar, limits);
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::WORK_LIMIT_EXCEEDED);
+	EXPECT_TRUE(result.groups.empty());
+	// Appending and decoding each group string is attempted once in
+	// this report
+	limits.work = 2 * (metar.length() + 1);
+	result = metaf::Parser::parse(metar, limits);
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::NONE);
+	limits.work = 40;
+	result = metaf::Parser::parse(metar, limits);
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::WORK_LIMIT_EXCEEDED);
+	EXPECT_FALSE(result.groups.empty());
+	EXPECT_LT(result.groups.size(), 12u);
+}
+
+TEST(ParseLimits, sameResultForAllParseModes) {
+	// Lazy, compact and incremental parsing stop at the same groups as the
+	// parser
+	for (const auto length : { 10u, 40u, 60u, 75u, 200u }) {
+		for (const auto work : { 50u, 150u, 1000u }) {
+			metaf::ParseLimits limits;
+			limits.reportLength = length;
+			limits.work = work;
+			limits.groupLength = 6;
+			for (const auto & data : testdata::realDataSet) {
+				const auto expected = metaf::Parser::parse(data.metar, limits);
+				metaf::GroupCache cache;
+				metaf::LazyParseResult lazy;
+				metaf::Parser::parse(data.metar, lazy, limits);
+				EXPECT_EQ(lazy.reportMetadata().error, expected.reportMetadata.error);
+				expectSame(lazy.parseResult(), expected);
+				metaf::CompactParseResult compact;
+				metaf::Parser::parse(data.metar, compact, cache, limits);
+				expectSame(compact.toParseResult(), expected);
+				metaf::ParseResult reparsed;
+				metaf::Parser::reparse(data.metar, expected, reparsed, cache, limits);
+				expectSame(reparsed, expected);
+			}
+		}
+	}
+}
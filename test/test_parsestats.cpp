@@ -0,0 +1,82 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+
+// The instrumentation is only compiled in if METAF_PARSE_STATS is defined
+// for the entire test executable (e.g. -DMETAF_PARSE_STATS in compiler flags)
+
+static std::uint64_t total(const metaf::ParseStats & stats,
+	std::uint64_t metaf::ParseStats::Alternative::* counter)
+{
+	std::uint64_t result = 0;
+	for (const auto & a : stats.alternatives) result += a.*counter;
+	return result;
+}
+
+#ifndef METAF_PARSE_STATS
+
+TEST(ParseStats, disabled) {
+	EXPECT_FALSE(metaf::ParseStats::enabled);
+	metaf::ParseStats::reset();
+	metaf::Parser::parse("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012");
+	const auto stats = metaf::ParseStats::snapshot();
+	EXPECT_EQ(stats.reports, 0u);
+	EXPECT_EQ(stats.reparses, 0u);
+	EXPECT_EQ(total(stats, &metaf::ParseStats::Alternative::parseAttempts), 0u);
+	EXPECT_EQ(total(stats, &metaf::ParseStats::Alternative::appendAttempts), 0u);
+}
+
+#else
+
+TEST(ParseStats, enabled) {
+	EXPECT_TRUE(metaf::ParseStats::enabled);
+	metaf::ParseStats::reset();
+	const auto result = 
+		metaf::Parser::parse("METAR ZZZZ 041115Z 24015KT 1 1/2SM FEW030 12/10 Q1012");
+	const auto stats = metaf::ParseStats::snapshot();
+	EXPECT_EQ(stats.reports, 1u);
+
+	// Each parsed group is a hit of exactly one alternative
+	const auto parsed = total(stats, &metaf::ParseStats::Alternative::parsed);
+	EXPECT_EQ(parsed, result.groups.size() + stats.reparses);
+	const auto attempts = total(stats, &metaf::ParseStats::Alternative::parseAttempts);
+	EXPECT_GT(attempts, parsed);
+	for (const auto & a : stats.alternatives) {
+		EXPECT_EQ(a.appendAttempts, a.appended + a.notAppended + a.invalidated);
+		EXPECT_EQ(a.rejected(), a.parseAttempts - a.parsed);
+	}
+
+	// Visibility group 1 is appended with 1/2SM
+	const auto visibilityIndex = metaf::Group(metaf::VisibilityGroup()).index();
+	EXPECT_EQ(stats.alternatives[visibilityIndex].appended, 1u);
+	EXPECT_EQ(stats.alternatives[visibilityIndex].parsed, 1u);
+
+	// Fixed group is attempted first for every group string
+	EXPECT_EQ(stats.alternatives[0].parseAttempts, result.groups.size() + 
+		stats.reparses);
+}
+
+TEST(ParseStats, reparse) {
+	metaf::ParseStats::reset();
+	metaf::Parser::parse("ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012");
+	const auto stats = metaf::ParseStats::snapshot();
+	EXPECT_EQ(stats.reports, 1u);
+	EXPECT_EQ(stats.reparses, 1u);
+}
+
+TEST(ParseStats, reset) {
+	metaf::Parser::parse("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012");
+	metaf::ParseStats::reset();
+	const auto stats = metaf::ParseStats::snapshot();
+	EXPECT_EQ(stats.reports, 0u);
+	EXPECT_EQ(total(stats, &metaf::ParseStats::Alternative::parseAttempts), 0u);
+	EXPECT_EQ(total(stats, &metaf::ParseStats::Alternative::parseNanoseconds), 0u);
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+
+// The tracing is only compiled in if METAF_PARSE_TRACE is defined for the
+// entire test executable (e.g. -DMETAF_PARSE_TRACE in compiler flags)
+
+using Stage = metaf::ParseTrace::Stage;
+
+static metaf::ParseTrace::Event event(Stage stage,
+	std::uint64_t begin,
+	std::uint64_t end,
+	std::uint32_t report,
+	std::uint32_t group = 0,
+	std::uint32_t thread = 0)
+{
+	metaf::ParseTrace::Event e;
+	e.stage = stage;
+	e.begin = begin;
+	e.end = end;
+	e.report = report;
+	e.group = group;
+	e.thread = thread;
+	return e;
+}
+
+TEST(ParseTrace, toChromeTrace) {
+	const std::vector<metaf::ParseTrace::Event> events = {
+		event(Stage::DECODE, 1000, 2500, 1, 0),
+		event(Stage::REPORT, 1000, 3001, 1),
+		event(Stage::TOKENIZE, 4000, 4100, 2, 0, 3),
+		event(Stage::REPORT, 4000, 4500, 2, 0, 3)
+	};
+	EXPECT_EQ(metaf::ParseTrace::toChromeTrace(events),
+		"{\"traceEvents\":[\n"
+		"{\"name\":\"decode\",\"cat\":\"metaf\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+		"\"ts\":1.000,\"dur\":1.500,\"args\":{\"report\":1,\"group\":0}},\n"
+		"{\"name\":\"report\",\"cat\":\"metaf\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+		"\"ts\":1.000,\"dur\":2.001,\"args\":{\"report\":1}},\n"
+		"{\"name\":\"tokenize\",\"cat\":\"metaf\",\"ph\":\"X\",\"pid\":0,\"tid\":3,"
+		"\"ts\":4.000,\"dur\":0.100,\"args\":{\"report\":2,\"group\":0}},\n"
+		"{\"name\":\"report\",\"cat\":\"metaf\",\"ph\":\"X\",\"pid\":0,\"tid\":3,"
+		"\"ts\":4.000,\"dur\":0.500,\"args\":{\"report\":2}}\n"
+		"]}\n");
+}
+
+TEST(ParseTrace, toChromeTraceSlowReports) {
+	const std::vector<metaf::ParseTrace::Event> events = {
+		event(Stage::DECODE, 1000, 2500, 1, 0),
+		event(Stage::REPORT, 1000, 3000, 1),
+		event(Stage::DECODE, 4000, 4100, 2, 0),
+		event(Stage::REPORT, 4000, 4500, 2),
+		// Same report number in other thread
+		event(Stage::REPORT, 4000, 4500, 1, 0, 1)
+	};
+	const auto trace = metaf::ParseTrace::toChromeTrace(events, 2000);
+	EXPECT_NE(trace.find("\"dur\":1.500"), std::string::npos);
+	EXPECT_NE(trace.find("\"dur\":2.000"), std::string::npos);
+	EXPECT_EQ(trace.find("\"ts\":4.000"), std::string::npos);
+	EXPECT_EQ(metaf::ParseTrace::toChromeTrace(events, 5000), "{\"traceEvents\":[\n]}\n");
+	// Events of the report without report event are not included
+	EXPECT_EQ(metaf::ParseTrace::toChromeTrace({ event(Stage::DECODE, 1, 2, 1) }),
+		"{\"traceEvents\":[\n]}\n");
+}
+
+#ifndef METAF_PARSE_TRACE
+
+TEST(ParseTrace, disabled) {
+	EXPECT_FALSE(metaf::ParseTrace::enabled);
+	metaf::ParseTrace::clear();
+	metaf::Parser::parse("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012");
+	EXPECT_TRUE(metaf::ParseTrace::events().empty());
+}
+
+#else
+
+TEST(ParseTrace, enabled) {
+	EXPECT_TRUE(metaf::ParseTrace::enabled);
+	metaf::ParseTrace::clear();
+	const auto result =
+		metaf::Parser::parse("METAR ZZZZ 041115Z 24015KT 1 1/2SM FEW030 12/10 Q1012");
+	const auto events = metaf::ParseTrace::events();
+	ASSERT_FALSE(events.empty());
+	// Report event is recorded last and includes all other events
+	const auto & report = events.back();
+	EXPECT_EQ(report.stage, Stage::REPORT);
+	std::size_t tokenized = 0, appended = 0, decoded = 0;
+	for (const auto & e : events) {
+		EXPECT_EQ(e.report, report.report);
+		EXPECT_EQ(e.thread, report.thread);
+		EXPECT_GE(e.begin, report.begin);
+		EXPECT_LE(e.end, report.end);
+		EXPECT_LE(e.begin, e.end);
+		if (e.stage == Stage::TOKENIZE) tokenized++;
+		if (e.stage == Stage::APPEND) appended++;
+		if (e.stage == Stage::DECODE) decoded++;
+	}
+	// Group strings 1 and 1/2SM form one group
+	EXPECT_EQ(tokenized, 9u);
+	EXPECT_EQ(appended, 9u);
+	EXPECT_EQ(decoded, result.groups.size());
+	EXPECT_EQ(events[events.size() - 2].stage, Stage::FINISH);
+}
+
+TEST(ParseTrace, reparse) {
+	metaf::ParseTrace::clear();
+	metaf::Parser::parse("ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012");
+	std::size_t reparsed = 0;
+	for (const auto & e : metaf::ParseTrace::events()) {
+		if (e.stage == Stage::REPARSE) reparsed++;
+	}
+	EXPECT_EQ(reparsed, 1u);
+}
+
+TEST(ParseTrace, lazyRemarks) {
+	metaf::ParseTrace::clear();
+	metaf::LazyParseResult result;
+	metaf::Parser::parse("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012 RMK AO2",
+		result);
+	result.parseResult();
+	// Remarks are decoded as a separate report
+	std::vector<std::uint32_t> reports;
+	for (const auto & e : metaf::ParseTrace::events()) {
+		if (e.stage == Stage::REPORT) reports.push_back(e.report);
+	}
+	ASSERT_EQ(reports.size(), 2u);
+	EXPECT_EQ(reports[1], reports[0] + 1);
+}
+
+TEST(ParseTrace, ringBuffer) {
+	metaf::ParseTrace::clear();
+	const std::string report = "METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012";
+	metaf::Parser::parse(report);
+	const auto eventsPerReport = metaf::ParseTrace::events().size();
+	for (auto i = 0u; i < metaf::ParseTrace::capacity / eventsPerReport; i++) {
+		metaf::Parser::parse(report);
+	}
+	const auto before = metaf::ParseTrace::events();
+	metaf::Parser::parse(report);
+	const auto after = metaf::ParseTrace::events();
+	ASSERT_EQ(after.size(), metaf::ParseTrace::capacity);
+	EXPECT_EQ(after.back().stage, Stage::REPORT);
+	EXPECT_GT(after.back().report, before.back().report);
+	metaf::ParseTrace::clear();
+	EXPECT_TRUE(metaf::ParseTrace::events().empty());
+}
+
+#endif
@@ -0,0 +1,251 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "pipeline.hpp"
+#include "expect_same.h"
+#include <set>
+#include <cstring>
+#include <algorithm>
+
+TEST(SpscQueue, capacity) {
+	EXPECT_EQ(SpscQueue<int>(0).capacity(), 1u);
+	EXPECT_EQ(SpscQueue<int>(1).capacity(), 1u);
+	EXPECT_EQ(SpscQueue<int>(5).capacity(), 8u);
+	EXPECT_EQ(SpscQueue<int>(256).capacity(), 256u);
+}
+
+TEST(SpscQueue, fifo) {
+	SpscQueue<int> queue(4);
+	int value = 0;
+	EXPECT_FALSE(queue.pop(value));
+	// Queue wraps around the buffer many times
+	for (auto i = 0; i < 100; i++) {
+		EXPECT_TRUE(queue.push(2 * i));
+		EXPECT_TRUE(queue.push(2 * i + 1));
+		EXPECT_EQ(queue.size(), 2u);
+		ASSERT_TRUE(queue.pop(value));
+		EXPECT_EQ(value, 2 * i);
+		ASSERT_TRUE(queue.pop(value));
+		EXPECT_EQ(value, 2 * i + 1);
+		EXPECT_EQ(queue.size(), 0u);
+	}
+	EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(SpscQueue, full) {
+	SpscQueue<int> queue(4);
+	for (auto i = 0; i < 4; i++) EXPECT_TRUE(queue.push(i));
+	EXPECT_EQ(queue.size(), 4u);
+	EXPECT_FALSE(queue.push(4));
+	int value = 0;
+	ASSERT_TRUE(queue.pop(value));
+	EXPECT_EQ(value, 0);
+	// Space is available after pop
+	EXPECT_TRUE(queue.push(4));
+	EXPECT_FALSE(queue.push(5));
+	for (auto i = 1; i <= 4; i++) {
+		ASSERT_TRUE(queue.pop(value));
+		EXPECT_EQ(value, i);
+	}
+}
+
+TEST(SpscQueue, moveOnly) {
+	SpscQueue<std::unique_ptr<int>> queue(2);
+	EXPECT_TRUE(queue.push(std::make_unique<int>(42)));
+	std::unique_ptr<int> value;
+	ASSERT_TRUE(queue.pop(value));
+	ASSERT_TRUE(value);
+	EXPECT_EQ(*value, 42);
+}
+
+// Tests below run multiple threads, which are not available in the tests
+// built with emcc
+#ifndef __EMSCRIPTEN__
+
+TEST(SpscQueue, producerConsumer) {
+	SpscQueue<std::size_t> queue(16);
+	static const std::size_t count = 200000;
+	std::thread producer([&](){
+		for (std::size_t i = 0; i < count; i++) {
+			while (!queue.push(i)) std::this_thread::yield();
+		}
+	});
+	std::size_t expected = 0;
+	while (expected < count) {
+		std::size_t value;
+		if (!queue.pop(value)) { std::this_thread::yield(); continue; }
+		ASSERT_EQ(value, expected);
+		expected++;
+	}
+	producer.join();
+	EXPECT_EQ(queue.size(), 0u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Source which returns the text in chunks of the specified size
+class TextSource {
+public:
+	TextSource(std::string t, std::size_t c) : text(std::move(t)), chunk(c) {}
+	std::size_t operator()(char * buffer, std::size_t size) {
+		const auto n = std::min({size, chunk, text.length() - pos});
+		std::memcpy(buffer, text.data() + pos, n);
+		pos += n;
+		return n;
+	}
+private:
+	std::string text;
+	std::size_t chunk;
+	std::size_t pos = 0;
+};
+
+static std::vector<std::string> realReports() {
+	std::vector<std::string> result;
+	for (const auto & data : testdata::realDataSet) {
+		if (!data.metar.empty()) result.push_back(data.metar);
+		if (!data.taf.empty()) result.push_back(data.taf);
+	}
+	return result;
+}
+
+static std::string joinReports(const std::vector<std::string> & reports,
+	const std::string & delimiter)
+{
+	std::string result;
+	for (const auto & r : reports) result += r + delimiter;
+	return result;
+}
+
+// Report text as passed to the sink, i.e. without leading and trailing 
+// whitespace
+static std::string trimmed(std::string s) {
+	while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.pop_back();
+	const auto begin = std::find_if(s.begin(), s.end(),
+		[](char c){ return !std::isspace(static_cast<unsigned char>(c)); });
+	return std::string(begin, s.end());
+}
+
+TEST(IngestPipeline, order) {
+	const auto reports = realReports();
+	for (auto parsers : {1u, 3u}) {
+		IngestPipeline::Options options;
+		options.parsers = parsers;
+		options.queueSize = 4;
+		options.readBufferSize = 100;
+		IngestPipeline pipeline(options);
+		EXPECT_EQ(pipeline.parsers(), parsers);
+		std::vector<std::string> received;
+		pipeline.run(TextSource(joinReports(reports, "\n\n"), 37),
+			[&](const std::string & report, const metaf::ParseResult & result) {
+				received.push_back(report);
+				testdata::expectSame(result, metaf::Parser::parse(report));
+			});
+		ASSERT_EQ(received.size(), reports.size());
+		for (auto i = 0u; i < reports.size(); i++) {
+			EXPECT_EQ(received[i], trimmed(reports[i]));
+		}
+		const auto stats = pipeline.stats();
+		EXPECT_EQ(stats.reportsRead, reports.size());
+		EXPECT_EQ(stats.reportsParsed, reports.size());
+		EXPECT_EQ(stats.reportsWritten, reports.size());
+		EXPECT_EQ(stats.parseQueueDepth, 0u);
+		EXPECT_EQ(stats.sinkQueueDepth, 0u);
+	}
+}
+
+TEST(IngestPipeline, delimiters) {
+	const std::string text =
+		"METAR ZZZZ 041115Z 24015KT\n"
+		"  9999 FEW030 12/10 Q1012\n"
+		"\n"
+		"METAR ZZZZ 041145Z 24015KT 9999 FEW030 12/10 Q1012= METAR ZZZZ 041215Z\n";
+	IngestPipeline::Options options;
+	options.parsers = 2;
+	std::vector<std::string> received;
+	auto sink = [&](const std::string & report, const metaf::ParseResult &) {
+		received.push_back(report);
+	};
+
+	options.delimiter = IngestPipeline::Delimiter::EMPTY_LINE;
+	IngestPipeline(options).run(TextSource(text, text.length()), sink);
+	ASSERT_EQ(received.size(), 3u);
+	EXPECT_EQ(received[0], "METAR ZZZZ 041115Z 24015KT\n  9999 FEW030 12/10 Q1012");
+	EXPECT_EQ(received[1], "METAR ZZZZ 041145Z 24015KT 9999 FEW030 12/10 Q1012=");
+	EXPECT_EQ(received[2], "METAR ZZZZ 041215Z");
+
+	received.clear();
+	options.delimiter = IngestPipeline::Delimiter::LINE;
+	IngestPipeline(options).run(TextSource(text, text.length()), sink);
+	ASSERT_EQ(received.size(), 4u);
+	EXPECT_EQ(received[0], "METAR ZZZZ 041115Z 24015KT");
+	EXPECT_EQ(received[1], "9999 FEW030 12/10 Q1012");
+}
+
+TEST(IngestPipeline, endOfData) {
+	IngestPipeline::Options options;
+	options.parsers = 3;
+	IngestPipeline pipeline(options);
+	std::size_t calls = 0;
+	auto sink = [&](const std::string &, const metaf::ParseResult &) { calls++; };
+	// No data: sink is not called and all threads finish
+	pipeline.run(TextSource("", 1), sink);
+	EXPECT_EQ(calls, 0u);
+	// Whitespace only
+	pipeline.run(TextSource(" \n\n \n", 2), sink);
+	EXPECT_EQ(calls, 0u);
+	// Fewer reports than parsers, last report is not terminated
+	pipeline.run(TextSource("METAR ZZZZ 041115Z 24015KT", 5), sink);
+	EXPECT_EQ(calls, 1u);
+	EXPECT_EQ(pipeline.stats().reportsWritten, 1u);
+}
+
+TEST(IngestPipeline, backpressure) {
+	const auto reports = realReports();
+	IngestPipeline::Options options;
+	options.parsers = 1;
+	options.queueSize = 1;
+	IngestPipeline pipeline(options);
+	std::size_t received = 0;
+	pipeline.run(TextSource(joinReports(reports, "\n\n"), 4096),
+		[&](const std::string & report, const metaf::ParseResult &) {
+			// Slow sink: source runs out of free items and waits
+			EXPECT_EQ(report, trimmed(reports[received]));
+			received++;
+			const auto depth = pipeline.stats();
+			EXPECT_LE(depth.parseQueueDepth, 1u);
+			EXPECT_LE(depth.sinkQueueDepth, 1u);
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		});
+	EXPECT_EQ(received, reports.size());
+	EXPECT_GT(pipeline.stats().sourceStalls, 0u);
+}
+
+TEST(IngestPipeline, freeListReuse) {
+	const auto reports = realReports();
+	IngestPipeline::Options options;
+	options.parsers = 2;
+	options.queueSize = 2;
+	IngestPipeline pipeline(options);
+	// Two queues per parser plus the item being filled by source
+	static const std::size_t items = 2 * 2 * 2 + 1;
+	std::set<const metaf::ParseResult *> used;
+	auto sink = [&](const std::string &, const metaf::ParseResult & result) {
+		used.insert(&result);
+	};
+	pipeline.run(TextSource(joinReports(reports, "\n\n"), 512), sink);
+	EXPECT_LE(used.size(), items);
+	ASSERT_GT(reports.size(), items);
+	// All items are returned to free list and re-used by the next run
+	const auto firstRun = used;
+	pipeline.run(TextSource(joinReports(reports, "\n\n"), 512), sink);
+	EXPECT_EQ(used.size(), firstRun.size());
+	EXPECT_EQ(pipeline.stats().reportsWritten, reports.size());
+}
+
+#endif
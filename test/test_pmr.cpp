@@ -0,0 +1,195 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include <memory_resource>
+
+// ParseResult may be forward-declared as in the previous versions
+namespace metaf { struct ParseResult; }
+static std::size_t groupCount(const metaf::ParseResult & result);
+
+// Memory resource which counts allocations and passes them to new/delete
+class CountingResource : public std::pmr::memory_resource {
+public:
+	std::size_t allocated = 0;
+	std::size_t deallocated = 0;
+private:
+	void * do_allocate(std::size_t bytes, std::size_t alignment) override {
+		allocated += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override {
+		deallocated += bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override {
+		return (this == &other);
+	}
+};
+
+static void expectAllocatedFrom(const metaf::pmr::ParseResult & result,
+	std::pmr::memory_resource * resource)
+{
+	EXPECT_EQ(result.groups.get_allocator().resource(), resource);
+	EXPECT_EQ(result.sections.trends.get_allocator().resource(), resource);
+	for (const auto & gi : result.groups) {
+		EXPECT_EQ(gi.rawString.get_allocator().resource(), resource);
+	}
+}
+
+TEST(Pmr, parseResult) {
+	const std::string report =
+		"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 TEMPO 5SM -RA "
+		"RMK AO2 PK WND 25030/1120 SLP132 T01220100=";
+	CountingResource resource;
+	metaf::pmr::ParseResult result(&resource);
+	metaf::Parser::parse(report, result, metaf::GroupCache::threadCache());
+	EXPECT_GT(resource.allocated, 0u);
+	expectAllocatedFrom(result, &resource);
+
+	const auto expected = metaf::Parser::parse(report);
+	EXPECT_EQ(result.reportMetadata.type, expected.reportMetadata.type);
+	EXPECT_EQ(result.reportMetadata.error, expected.reportMetadata.error);
+	ASSERT_EQ(result.groups.size(), expected.groups.size());
+	for (auto i = 0u; i < result.groups.size(); i++) {
+		EXPECT_EQ(result.groups[i].group.index(), expected.groups[i].group.index());
+		EXPECT_EQ(result.groups[i].reportPart, expected.groups[i].reportPart);
+		EXPECT_EQ(std::string_view(result.groups[i].rawString),
+			expected.groups[i].rawString);
+	}
+	EXPECT_EQ(result.sections.trends.size(), 1u);
+	EXPECT_EQ(result.sections.remarks.begin, expected.sections.remarks.begin);
+}
+
+TEST(Pmr, batchInArena) {
+	CountingResource upstream;
+	std::pmr::monotonic_buffer_resource arena(&upstream);
+	{
+		std::pmr::vector<metaf::pmr::ParseResult> batch(&arena);
+		auto & cache = metaf::GroupCache::threadCache();
+		for (const auto & data : testdata::realDataSet) {
+			for (const auto & report : { data.metar, data.taf }) {
+				batch.emplace_back();
+				metaf::Parser::parse(report, batch.back(), cache);
+			}
+		}
+		ASSERT_EQ(batch.size(), 2 * testdata::realDataSet.size());
+		// Results were moved within the arena when the vector grew
+		for (const auto & result : batch) expectAllocatedFrom(result, &arena);
+		const auto copy = batch.back();
+		EXPECT_EQ(copy.groups.size(), batch.back().groups.size());
+		EXPECT_NE(copy.groups.get_allocator().resource(), &arena);
+	}
+	EXPECT_GT(upstream.allocated, 0u);
+	// Memory of the whole batch is returned at once
+	EXPECT_EQ(upstream.deallocated, 0u);
+	arena.release();
+	EXPECT_EQ(upstream.deallocated, upstream.allocated);
+}
+
+TEST(Pmr, groupHelpers) {
+	CountingResource resource;
+	const auto result = metaf::Parser::parse(
+		"METAR KZZZ 041153Z 24015KT 10SM -SHRASN 12/10 A2992 "
+		"RMK FRQ LTGICCG NE-SE AND W CB DSNT N-E SC3AC2");
+	ASSERT_EQ(result.groups.size(), 12u);
+
+	const auto wg = std::get_if<metaf::WeatherGroup>(&result.groups[5].group);
+	ASSERT_TRUE(wg);
+	const auto wp = wg->weatherPhenomena(
+		std::pmr::polymorphic_allocator<metaf::WeatherPhenomena>(&resource));
+	ASSERT_EQ(wp.size(), 1u);
+	EXPECT_EQ(wp.get_allocator().resource(), &resource);
+	const auto w = wp[0].weather(
+		std::pmr::polymorphic_allocator<metaf::WeatherPhenomena::Weather>(&resource));
+	const auto expectedWeather = wp[0].weather();
+	EXPECT_TRUE(std::equal(w.begin(), w.end(),
+		expectedWeather.begin(), expectedWeather.end()));
+	EXPECT_EQ(w.get_allocator().resource(), &resource);
+
+	const auto lg = std::get_if<metaf::LightningGroup>(&result.groups[9].group);
+	ASSERT_TRUE(lg);
+	const auto dirs = lg->directions(
+		std::pmr::polymorphic_allocator<metaf::Direction::Cardinal>(&resource));
+	const auto expectedDirs = lg->directions();
+	EXPECT_EQ(std::vector<metaf::Direction::Cardinal>(dirs.begin(), dirs.end()),
+		expectedDirs);
+
+	const auto vg = std::get_if<metaf::VicinityGroup>(&result.groups[10].group);
+	ASSERT_TRUE(vg);
+	EXPECT_EQ(vg->directions(
+		std::pmr::polymorphic_allocator<metaf::Direction::Cardinal>(&resource)).size(),
+		vg->directions().size());
+
+	const auto ct = std::get_if<metaf::CloudTypesGroup>(&result.groups[11].group);
+	ASSERT_TRUE(ct);
+	using CloudType = std::pair<metaf::CloudTypesGroup::Type, unsigned int>;
+	EXPECT_EQ(ct->toVector(std::pmr::polymorphic_allocator<CloudType>(&resource)).size(),
+		ct->toVector().size());
+	EXPECT_GT(resource.allocated, 0u);
+}
+
+class RawStringVisitor : public metaf::Visitor<std::string> {
+protected:
+	std::string visitFixedGroup(const metaf::FixedGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitLocationGroup(const metaf::LocationGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitReportTimeGroup(const metaf::ReportTimeGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitTrendGroup(const metaf::TrendGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitWindGroup(const metaf::WindGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitVisibilityGroup(const metaf::VisibilityGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitCloudGroup(const metaf::CloudGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitWeatherGroup(const metaf::WeatherGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitTemperatureGroup(const metaf::TemperatureGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitTemperatureForecastGroup(const metaf::TemperatureForecastGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitPressureGroup(const metaf::PressureGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitRunwayVisualRangeGroup(const metaf::RunwayVisualRangeGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitRunwayStateGroup(const metaf::RunwayStateGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitSecondaryLocationGroup(const metaf::SecondaryLocationGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitRainfallGroup(const metaf::RainfallGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitSeaSurfaceGroup(const metaf::SeaSurfaceGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitColourCodeGroup(const metaf::ColourCodeGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitMinMaxTemperatureGroup(const metaf::MinMaxTemperatureGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitPrecipitationGroup(const metaf::PrecipitationGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitLayerForecastGroup(const metaf::LayerForecastGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitPressureTendencyGroup(const metaf::PressureTendencyGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitCloudTypesGroup(const metaf::CloudTypesGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitCloudLayersGroup(const metaf::CloudLayersGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitLightningGroup(const metaf::LightningGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitVicinityGroup(const metaf::VicinityGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitMiscGroup(const metaf::MiscGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+	std::string visitUnknownGroup(const metaf::UnknownGroup &, metaf::ReportPart, const std::string & s) override { return s; }
+};
+
+TEST(Pmr, visitor) {
+	CountingResource resource;
+	metaf::pmr::ParseResult result(&resource);
+	metaf::Parser::parse("METAR ZZZZ 041100Z 24010KT 1 1/2SM SCT020 10/05 Q1010=",
+		result, metaf::GroupCache::threadCache());
+	ASSERT_EQ(result.groups.size(), 8u);
+	RawStringVisitor visitor;
+	EXPECT_EQ(visitor.visit(result.groups[4]), "1 1/2SM");
+	EXPECT_EQ(visitor.visit(result.groups[7]), "Q1010");
+}
+
+static std::size_t groupCount(const metaf::ParseResult & result) {
+	return result.groups.size();
+}
+
+TEST(ParseResult, forwardDeclaration) {
+	const std::string report = "METAR EGYP 281650Z 21014KT 9999 FEW015 10/06 Q1011 RMK BLU BLU=";
+	const auto result = metaf::Parser::parse(report);
+	EXPECT_EQ(groupCount(result), 10u);
+	// BasicParseResult with default allocator converts to ParseResult
+	metaf::BasicParseResult<> basic;
+	metaf::GroupCache cache;
+	metaf::Parser::parse(report, basic, cache);
+	const metaf::ParseResult converted(basic);
+	EXPECT_EQ(groupCount(converted), 10u);
+	EXPECT_EQ(converted.sections.body.begin, result.sections.body.begin);
+}
@@ -0,0 +1,505 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+
+TEST(Regex, literal) {
+	static constexpr metaf::Regex rgx("CAVOK");
+	EXPECT_TRUE(rgx.match("CAVOK"));
+	EXPECT_FALSE(rgx.match("CAVO"));
+	EXPECT_FALSE(rgx.match("CAVOKK"));
+	EXPECT_FALSE(rgx.match(""));
+}
+
+TEST(Regex, charClasses) {
+	static constexpr metaf::Regex rgx("[A-C][^/]\\d\\D[\\d/]\\w\\s.");
+	EXPECT_TRUE(rgx.match("BX5Z/_ +"));
+	EXPECT_TRUE(rgx.match("AA0a/0\tX"));
+	EXPECT_FALSE(rgx.match("DX5Z/_ +"));
+	EXPECT_FALSE(rgx.match("B/5Z/_ +"));
+	EXPECT_FALSE(rgx.match("BXZZ/_ +"));
+	EXPECT_FALSE(rgx.match("BX55/_ +"));
+	EXPECT_FALSE(rgx.match("BX5ZZ_ +"));
+	EXPECT_FALSE(rgx.match("BX5Z/- +"));
+	EXPECT_FALSE(rgx.match("BX5Z/_X+"));
+}
+
+TEST(Regex, escapedSpecialChars) {
+	static constexpr metaf::Regex rgx("\\d\\.\\d\\(\\)[\\]\\-]");
+	EXPECT_TRUE(rgx.match("1.2()]"));
+	EXPECT_TRUE(rgx.match("1.2()-"));
+	EXPECT_FALSE(rgx.match("1x2()]"));
+}
+
+TEST(Regex, alternation) {
+	static constexpr metaf::Regex rgx("(\\d\\d\\d)|///|A(B|C|)D");
+	metaf::RegexMatch match;
+	const std::string s1 = "123", s2 = "///", s3 = "ACD", s4 = "AD";
+	ASSERT_TRUE(rgx.match(s1, match));
+	EXPECT_EQ(match.str(0), "123");
+	EXPECT_EQ(match.str(1), "123");
+	EXPECT_FALSE(match.matched(2));
+	ASSERT_TRUE(rgx.match(s2, match));
+	EXPECT_FALSE(match.matched(1));
+	ASSERT_TRUE(rgx.match(s3, match));
+	EXPECT_EQ(match.str(2), "C");
+	ASSERT_TRUE(rgx.match(s4, match));
+	EXPECT_TRUE(match.matched(2));
+	EXPECT_EQ(match.str(2), "");
+	EXPECT_FALSE(rgx.match("ABCD"));
+}
+
+TEST(Regex, quantifiers) {
+	static constexpr metaf::Regex rgx("A?B*C+D{2}E{1,}F{1,3}");
+	EXPECT_TRUE(rgx.match("CDDEF"));
+	EXPECT_TRUE(rgx.match("ABBBCCDDEEEFFF"));
+	EXPECT_FALSE(rgx.match("AACDDEF"));
+	EXPECT_FALSE(rgx.match("DDEF"));
+	EXPECT_FALSE(rgx.match("CDEF"));
+	EXPECT_FALSE(rgx.match("CDDDEF"));
+	EXPECT_FALSE(rgx.match("CDDF"));
+	EXPECT_FALSE(rgx.match("CDDE"));
+	EXPECT_FALSE(rgx.match("CDDEFFFF"));
+}
+
+TEST(Regex, optionalRepetitions) {
+	static constexpr metaf::Regex rgx("((?:[A-Z][A-Z]){0,4})(\\d{0,2})");
+	metaf::RegexMatch match;
+	const std::string empty;
+	ASSERT_TRUE(rgx.match(empty, match));
+	EXPECT_EQ(match.str(1), "");
+	const std::string s = "RAGSSN1";
+	ASSERT_TRUE(rgx.match(s, match));
+	EXPECT_EQ(match.str(1), "RAGSSN");
+	EXPECT_EQ(match.str(2), "1");
+	EXPECT_TRUE(rgx.match("RAGSSNDZ12"));
+	EXPECT_FALSE(rgx.match("RAGSSNDZBR"));
+	EXPECT_FALSE(rgx.match("RAG"));
+	EXPECT_FALSE(rgx.match("123"));
+}
+
+TEST(Regex, greedyAndLazy) {
+	static constexpr metaf::Regex greedy("(\\d*)(\\d*)");
+	static constexpr metaf::Regex lazy("(\\d*?)(\\d*)");
+	metaf::RegexMatch match;
+	const std::string s = "1234";
+	ASSERT_TRUE(greedy.match(s, match));
+	EXPECT_EQ(match.str(1), "1234");
+	EXPECT_EQ(match.str(2), "");
+	ASSERT_TRUE(lazy.match(s, match));
+	EXPECT_EQ(match.str(1), "");
+	EXPECT_EQ(match.str(2), "1234");
+}
+
+TEST(Regex, capturePositions) {
+	static constexpr metaf::Regex rgx("(?:WS(\\d\\d\\d)/)?(\\d\\d0)(\\d\\d)KT");
+	static_assert(rgx.groups() == 4);
+	metaf::RegexMatch match;
+	const std::string s = "24015KT";
+	ASSERT_TRUE(rgx.match(s, match));
+	EXPECT_EQ(match.size(), 4u);
+	EXPECT_FALSE(match.matched(1));
+	EXPECT_EQ(match.str(1), "");
+	EXPECT_EQ(match.position(2), 0u);
+	EXPECT_EQ(match.length(2), 3u);
+	EXPECT_EQ(match.str(3), "15");
+	EXPECT_FALSE(match.matched(4));
+}
+
+TEST(Regex, search) {
+	static constexpr metaf::Regex rgx("([A-Z]{2,4})([1-8])");
+	const std::string s = "SC3ACC2-CI1";
+	metaf::RegexMatch match;
+	std::vector<std::string> found;
+	for (auto from = 0u; rgx.search(s, from, match);) {
+		found.push_back(match.str(1) + "/" + match.str(2));
+		from = match.position(0) + match.length(0);
+	}
+	EXPECT_EQ(found, (std::vector<std::string>{"SC/3", "ACC/2", "CI/1"}));
+	EXPECT_FALSE(rgx.search(s, 11, match));
+}
+
+TEST(Regex, searchLeftmost) {
+	// Search finds the same leftmost match as std::regex_search from every
+	// start position, including empty matches and the matches which begin
+	// before the other candidates end
+	static constexpr metaf::Regex rgx1("(A+)(B)?|B(C*?)D");
+	static constexpr metaf::Regex rgx2("(\\d\\d)?(\\d)/");
+	static constexpr metaf::Regex rgx3("X*");
+	const std::vector<std::string> inputs = {
+		"", "A", "AAB", "CBD", "BCCD", "xxAABCBD", "BBBCCCA", "1/", "123/45/",
+		"12", "9/9/99/", "BCCCx", "XXAXX"
+	};
+	auto check = [&inputs](const auto & rgx) {
+		const std::regex stdRgx(rgx.pattern());
+		for (const auto & s : inputs) {
+			for (auto from = 0u; from <= s.length(); from++) {
+				metaf::RegexMatch match;
+				std::smatch stdMatch;
+				const auto result = rgx.search(s, from, match);
+				ASSERT_EQ(result, std::regex_search(s.cbegin() + from, s.cend(),
+					stdMatch, stdRgx)) << rgx.pattern() << " " << s << " " << from;
+				if (!result) continue;
+				EXPECT_EQ(match.position(0), from + static_cast<std::size_t>(stdMatch.position(0)))
+					<< rgx.pattern() << " " << s << " " << from;
+				for (auto i = 0u; i < stdMatch.size(); i++) {
+					EXPECT_EQ(match.matched(i), stdMatch[i].matched)
+						<< rgx.pattern() << " " << s << " " << from << " " << i;
+					EXPECT_EQ(match.str(i), stdMatch.str(i))
+						<< rgx.pattern() << " " << s << " " << from << " " << i;
+				}
+			}
+			metaf::RegexMatch match;
+			EXPECT_FALSE(rgx.search(s, s.length() + 1, match));
+		}
+	};
+	check(rgx1);
+	check(rgx2);
+	check(rgx3);
+}
+
+TEST(Regex, lengthLimit) {
+	// Positions are 16-bit, longer strings never match
+	static constexpr metaf::Regex rgx("A*B");
+	metaf::RegexMatch match;
+	const auto maxLength = metaf::RegexMatch::maxLength;
+	auto s = std::string(maxLength - 1, 'A') + "B";
+	EXPECT_TRUE(rgx.match(s));
+	ASSERT_TRUE(rgx.search(s, 0, match));
+	EXPECT_EQ(match.length(0), maxLength);
+	ASSERT_TRUE(rgx.search(s, maxLength - 1, match));
+	EXPECT_EQ(match.position(0), maxLength - 1);
+	s.insert(0, 1, 'A');
+	EXPECT_FALSE(rgx.match(s));
+	EXPECT_FALSE(rgx.search(s, 0, match));
+}
+
+TEST(Regex, validity) {
+	static_assert(metaf::Regex("R(?:WY)?(\\d\\d)([RLC])?").isValid());
+	EXPECT_FALSE(metaf::Regex("\\d?\\d)/(\\d?\\d").isValid());
+	EXPECT_FALSE(metaf::Regex("(\\d\\d").isValid());
+	EXPECT_FALSE(metaf::Regex("[A-Z").isValid());
+	EXPECT_FALSE(metaf::Regex("*A").isValid());
+	EXPECT_FALSE(metaf::Regex("A{2,1}").isValid());
+	EXPECT_FALSE(metaf::Regex("\\1").isValid());
+	EXPECT_FALSE(metaf::Regex("(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)").isValid());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Equivalence of the library patterns and std::regex compiled from the same
+// pattern strings, and of the hand-coded matchers and their patterns
+///////////////////////////////////////////////////////////////////////////////
+
+static const std::string alphabet = "0123456789ABCDEGKMNPRSTVWXZ/.-";
+
+static std::set<std::string> equivalenceInputs() {
+	std::set<std::string> inputs;
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { data.metar, data.taf }) {
+			std::istringstream ss(report);
+			std::string group;
+			while (ss >> group) {
+				if (group.back() == '=') group.pop_back();
+				inputs.insert(group);
+			}
+		}
+	}
+	std::mt19937 gen(20201018);
+	std::uniform_int_distribution<std::size_t> ch(0, alphabet.length() - 1);
+	std::vector<std::string> mutated;
+	for (const auto & group : inputs) {
+		for (auto n = 0; n < 2; n++) {
+			auto s = group;
+			const auto pos = gen() % (s.length() + 1);
+			switch (gen() % 3) {
+				case 0: if (pos < s.length()) s[pos] = alphabet[ch(gen)]; break;
+				case 1: s.insert(pos, 1, alphabet[ch(gen)]); break;
+				case 2: if (pos < s.length()) s.erase(pos, 1); break;
+			}
+			mutated.push_back(s);
+		}
+	}
+	inputs.insert(mutated.begin(), mutated.end());
+	for (auto n = 0; n < 5000; n++) {
+		std::string s;
+		const auto length = gen() % 12;
+		for (auto i = 0u; i < length; i++) s.push_back(alphabet[ch(gen)]);
+		inputs.insert(s);
+	}
+	for (const auto c1 : alphabet) {
+		for (const auto c2 : alphabet) inputs.insert(std::string{c1, c2});
+	}
+	return inputs;
+}
+
+// Hand-coded matchers parse the values within groups, so the inputs also 
+// include all substrings of the groups and all strings of up to 3 chars
+static std::set<std::string> handCodedInputs() {
+	auto inputs = equivalenceInputs();
+	std::vector<std::string> substrings;
+	for (const auto & s : inputs) {
+		for (auto pos = 0u; pos < s.length(); pos++) {
+			for (auto len = 1u; pos + len <= s.length(); len++) {
+				substrings.push_back(s.substr(pos, len));
+			}
+		}
+	}
+	inputs.insert(substrings.begin(), substrings.end());
+	for (const auto c1 : alphabet) {
+		for (const auto c2 : alphabet) {
+			for (const auto c3 : alphabet) inputs.insert(std::string{c1, c2, c3});
+		}
+	}
+	return inputs;
+}
+
+template <std::size_t N, std::size_t Size>
+static void checkEquivalence(const metaf::Regex<N, Size> & rgx) {
+	static const auto inputs = equivalenceInputs();
+	const auto pattern = rgx.pattern();
+	const std::regex stdRgx(pattern);
+	ASSERT_TRUE(rgx.isValid()) << pattern;
+	ASSERT_EQ(rgx.groups(), stdRgx.mark_count() + 1) << pattern;
+	for (const auto & s : inputs) {
+		metaf::RegexMatch match;
+		std::smatch stdMatch;
+		const auto result = rgx.match(s, match);
+		ASSERT_EQ(result, std::regex_match(s, stdMatch, stdRgx))
+			<< pattern << " " << s;
+		if (!result) continue;
+		for (auto i = 0u; i < stdMatch.size(); i++) {
+			EXPECT_EQ(match.matched(i), stdMatch[i].matched)
+				<< pattern << " " << s << " " << i;
+			EXPECT_EQ(match.str(i), stdMatch.str(i))
+				<< pattern << " " << s << " " << i;
+		}
+	}
+}
+
+// Hand-coded matcher must accept the strings which match the pattern, 
+// except the strings which are syntactically correct but reserved
+template <std::size_t N, std::size_t Size, typename Accepts>
+static void checkHandCoded(const metaf::Regex<N, Size> & rgx,
+	Accepts accepts,
+	const std::set<std::string> & reserved = {})
+{
+	static const auto inputs = handCodedInputs();
+	for (const auto & s : inputs) {
+		const auto expected = rgx.match(s) && !reserved.count(s);
+		ASSERT_EQ(accepts(s), expected) << rgx.pattern() << " " << s;
+	}
+	for (const auto & s : reserved) EXPECT_TRUE(rgx.match(s)) << s;
+}
+
+TEST(Regex, equivalenceHandCodedPatterns) {
+	using namespace metaf::patterns;
+	checkEquivalence(runway);
+	checkEquivalence(timeDayHourMinute);
+	checkEquivalence(timeDayHour);
+	checkEquivalence(temperature);
+	checkEquivalence(temperatureRemark);
+	checkEquivalence(speed);
+	checkEquivalence(distanceMeters);
+	checkEquivalence(distanceMiles);
+	checkEquivalence(distanceHeight);
+	checkEquivalence(distanceRvr);
+	checkEquivalence(distanceLayer);
+	checkEquivalence(distanceKm);
+	checkEquivalence(directionDegrees);
+	checkEquivalence(pressure);
+	checkEquivalence(pressureForecast);
+	checkEquivalence(pressureSlp);
+	checkEquivalence(pressureQfe);
+	checkEquivalence(pressureTendency);
+	checkEquivalence(precipitationRainfall);
+	checkEquivalence(precipitationRunwayDeposits);
+	checkEquivalence(precipitationRemark);
+	checkEquivalence(fraction);
+	checkEquivalence(surfaceFriction);
+	checkEquivalence(waveHeight);
+	checkEquivalence(cloudType);
+	checkEquivalence(cloudTypesType);
+}
+
+TEST(Regex, equivalenceGroupPatterns) {
+	using namespace metaf::patterns;
+	checkEquivalence(directionSector);
+	checkEquivalence(weatherBeginEnd);
+	checkEquivalence(location);
+	checkEquivalence(reportTime);
+	checkEquivalence(trendTimeSpan);
+	checkEquivalence(trendFrom);
+	checkEquivalence(trendTime);
+	checkEquivalence(wind);
+	checkEquivalence(windVariableSector);
+	checkEquivalence(peakWind);
+	checkEquivalence(visibilityMeters);
+	checkEquivalence(visibilityVariable);
+	checkEquivalence(visibilityVariableMeters);
+	checkEquivalence(cloudLayer);
+	checkEquivalence(cloudLayerVariable);
+	checkEquivalence(temperatureGroup);
+	checkEquivalence(temperatureGroupRemark);
+	checkEquivalence(temperatureForecast);
+	checkEquivalence(runwayVisualRange);
+	checkEquivalence(runwayState);
+	checkEquivalence(variableCeiling);
+	checkEquivalence(rainfall);
+	checkEquivalence(seaSurface);
+	checkEquivalence(minMaxTemperature6hourly);
+	checkEquivalence(minMaxTemperature24hourly);
+	checkEquivalence(precipitationGroup);
+	checkEquivalence(layerForecast);
+	checkEquivalence(pressureTendencyGroup);
+	checkEquivalence(cloudTypes);
+	checkEquivalence(cloudTypesSearch);
+	checkEquivalence(cloudTypesAltFormat);
+	checkEquivalence(cloudLayers);
+	checkEquivalence(sunshineDuration);
+	checkEquivalence(correctionObservation);
+}
+
+TEST(Regex, handCodedRunway) {
+	checkHandCoded(metaf::patterns::runway, [](const std::string & s) {
+		return metaf::Runway::fromString(s, true).has_value();
+	});
+	// RWY prefix is only accepted if enabled
+	checkHandCoded(metaf::patterns::runway, [](const std::string & s) {
+		return metaf::Runway::fromString(s).has_value() || 
+			(s.rfind("RWY", 0) == 0 && metaf::patterns::runway.match(s));
+	});
+}
+
+TEST(Regex, handCodedTime) {
+	checkHandCoded(metaf::patterns::timeDayHourMinute, [](const std::string & s) {
+		return metaf::MetafTime::fromStringDDHHMM(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::timeDayHour, [](const std::string & s) {
+		return metaf::MetafTime::fromStringDDHH(s).has_value();
+	});
+}
+
+TEST(Regex, handCodedTemperature) {
+	checkHandCoded(metaf::patterns::temperature, [](const std::string & s) {
+		return metaf::Temperature::fromString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::temperatureRemark, [](const std::string & s) {
+		return metaf::Temperature::fromRemarkString(s).has_value();
+	});
+}
+
+TEST(Regex, handCodedSpeed) {
+	checkHandCoded(metaf::patterns::speed, [](const std::string & s) {
+		return metaf::Speed::fromString(s, metaf::Speed::Unit::KNOTS).has_value();
+	});
+}
+
+TEST(Regex, handCodedDistance) {
+	checkHandCoded(metaf::patterns::distanceMeters, [](const std::string & s) {
+		return metaf::Distance::fromMeterString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::distanceMiles, [](const std::string & s) {
+		return metaf::Distance::fromMileString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::distanceHeight, [](const std::string & s) {
+		return metaf::Distance::fromHeightString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::distanceRvr, [](const std::string & s) {
+		return metaf::Distance::fromRvrString(s, false).has_value();
+	});
+	checkHandCoded(metaf::patterns::distanceLayer, [](const std::string & s) {
+		return metaf::Distance::fromLayerString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::distanceKm, [](const std::string & s) {
+		return metaf::Distance::fromKmString(s).has_value();
+	});
+}
+
+TEST(Regex, handCodedDirection) {
+	checkHandCoded(metaf::patterns::directionDegrees, [](const std::string & s) {
+		return metaf::Direction::fromDegreesString(s).has_value();
+	});
+}
+
+TEST(Regex, handCodedPressure) {
+	checkHandCoded(metaf::patterns::pressure, [](const std::string & s) {
+		return metaf::Pressure::fromString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::pressureForecast, [](const std::string & s) {
+		return metaf::Pressure::fromForecastString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::pressureSlp, [](const std::string & s) {
+		return metaf::Pressure::fromSlpString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::pressureQfe, [](const std::string & s) {
+		return metaf::Pressure::fromQfeString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::pressureTendency, [](const std::string & s) {
+		return metaf::Pressure::fromTendencyString(s).has_value();
+	});
+}
+
+TEST(Regex, handCodedPrecipitation) {
+	checkHandCoded(metaf::patterns::precipitationRainfall, [](const std::string & s) {
+		return metaf::Precipitation::fromRainfallString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::precipitationRunwayDeposits, 
+		[](const std::string & s) {
+			return metaf::Precipitation::fromRunwayDeposits(s).has_value();
+		},
+		{"91"});
+	checkHandCoded(metaf::patterns::precipitationRemark, [](const std::string & s) {
+		return metaf::Precipitation::fromRemarkString(s, 
+			1, metaf::Precipitation::Unit::INCHES, true).has_value();
+	});
+	// Not reported value is only accepted if allowed
+	checkHandCoded(metaf::patterns::precipitationRemark, 
+		[](const std::string & s) {
+			return metaf::Precipitation::fromRemarkString(s).has_value();
+		},
+		{"///", "////"});
+	checkHandCoded(metaf::patterns::fraction, [](const std::string & s) {
+		return metaf::Precipitation::fromSnincrString(s).has_value();
+	});
+	checkHandCoded(metaf::patterns::fraction, [](const std::string & s) {
+		return metaf::fractionStrToUint(s, 0, s.length()).has_value();
+	});
+}
+
+TEST(Regex, handCodedSurfaceFriction) {
+	checkHandCoded(metaf::patterns::surfaceFriction, 
+		[](const std::string & s) {
+			return metaf::SurfaceFriction::fromString(s).has_value();
+		},
+		{"96", "97", "98"});
+}
+
+TEST(Regex, handCodedWaveHeight) {
+	checkHandCoded(metaf::patterns::waveHeight, [](const std::string & s) {
+		return metaf::WaveHeight::fromString(s).has_value();
+	});
+}
+
+TEST(Regex, handCodedCloudTypes) {
+	// Cloud type in alternative format group, e.g. 1CB030
+	checkHandCoded(metaf::patterns::cloudType, [](const std::string & s) {
+		return metaf::CloudTypesGroup::parse("1" + s + "030", 
+			metaf::ReportPart::RMK).has_value();
+	});
+	// Cloud type or obscuration in cloud types group, e.g. CB1
+	checkHandCoded(metaf::patterns::cloudTypesType, [](const std::string & s) {
+		for (const auto c : s) if (c < 'A' || c > 'Z') return false;
+		return metaf::CloudTypesGroup::parse(s + "1", 
+			metaf::ReportPart::RMK).has_value();
+	});
+}
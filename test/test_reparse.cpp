@@ -0,0 +1,111 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include "expect_same.h"
+
+using testdata::expectSame;
+
+static std::uint64_t decodedGroups(const metaf::GroupCache & cache) {
+	const auto stats = cache.stats();
+	return (stats.hits + stats.misses + stats.bypassed);
+}
+
+TEST(Reparse, correction) {
+	const std::string original =
+		"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 RMK AO2 SLP132 T01220100=";
+	const std::string corrected =
+		"METAR COR KZZZ 041153Z 24015KT 10SM FEW030 13/10 A2992 RMK AO2 SLP132 T01330100=";
+	const auto previous = metaf::Parser::parse(original);
+	metaf::GroupCache cache;
+	metaf::ParseResult result;
+	metaf::Parser::reparse(corrected, previous, result, cache);
+	expectSame(result, metaf::Parser::parse(corrected));
+	// Only COR and the changed temperature groups are decoded
+	EXPECT_EQ(decodedGroups(cache), 3u);
+	const auto tg = std::get_if<metaf::TemperatureGroup>(&result.groups[7].group);
+	ASSERT_TRUE(tg);
+	ASSERT_TRUE(tg->airTemperature().temperature().has_value());
+	EXPECT_NEAR(*tg->airTemperature().temperature(), 13, 0.1);
+}
+
+TEST(Reparse, amendment) {
+	const std::string original =
+		"TAF ZZZZ 041100Z 0412/0512 24010KT P6SM SCT020 "
+		"TEMPO 0414/0418 2 1/2SM RA BECMG 0500/0502 BKN010=";
+	const std::string amended =
+		"TAF AMD ZZZZ 041130Z 0412/0512 24010KT P6SM SCT020 "
+		"TEMPO 0414/0418 1 1/2SM TSRA BECMG 0500/0502 BKN010=";
+	const auto previous = metaf::Parser::parse(original);
+	metaf::GroupCache cache;
+	metaf::ParseResult result;
+	metaf::Parser::reparse(amended, previous, result, cache);
+	expectSame(result, metaf::Parser::parse(amended));
+	EXPECT_LT(decodedGroups(cache), result.groups.size());
+}
+
+TEST(Reparse, reportTimeChanged) {
+	// Begin time of weather phenomena in remarks depends on report time
+	const auto previous = metaf::Parser::parse(
+		"METAR KZZZ 041153Z 24015KT 10SM FEW030 12/10 A2992 RMK AO2 RAB15=");
+	const auto result = metaf::Parser::reparse(
+		"METAR KZZZ 041253Z 24015KT 10SM FEW030 12/10 A2992 RMK AO2 RAB15=",
+		previous);
+	ASSERT_EQ(result.groups.size(), 11u);
+	const auto wg = std::get_if<metaf::WeatherGroup>(&result.groups[10].group);
+	ASSERT_TRUE(wg);
+	ASSERT_TRUE(wg->weatherPhenomena().at(0).time().has_value());
+	EXPECT_EQ(wg->weatherPhenomena()[0].time()->hour(), 12u);
+}
+
+TEST(Reparse, appendedGroups) {
+	// Group strings which were appended to the previous group in the
+	// previous report are not appended in the new report and vice versa
+	const std::string original =
+		"METAR KZZZ 041153Z 24015KT 1 1/2SM FEW030 12/10 A2992 RMK PK WND 25030/1120";
+	const std::string changed =
+		"METAR KZZZ 041153Z 24015KT 1/2SM FEW030 12/10 A2992 RMK PK 25030/1120 WND";
+	expectSame(metaf::Parser::reparse(changed, metaf::Parser::parse(original)),
+		metaf::Parser::parse(changed));
+	expectSame(metaf::Parser::reparse(original, metaf::Parser::parse(changed)),
+		metaf::Parser::parse(original));
+}
+
+TEST(Reparse, sameResultAsParser) {
+	// Each report is re-parsed with the previous result of the same report,
+	// of the same report corrected, and of the unrelated report
+	metaf::GroupCache cache;
+	metaf::ParseResult result;
+	metaf::ParseResult unrelated;
+	for (const auto & data : testdata::realDataSet) {
+		for (const auto & report : { std::string(data.metar), std::string(data.taf) }) {
+			const auto expected = metaf::Parser::parse(report);
+			metaf::Parser::reparse(report, expected, result, cache);
+			expectSame(result, expected);
+			metaf::Parser::reparse(report, unrelated, result, cache);
+			expectSame(result, expected);
+			auto changed = report;
+			const auto pos = changed.find(' ', changed.find_first_not_of(' '));
+			if (pos != std::string::npos) changed.insert(pos, " COR");
+			metaf::Parser::reparse(changed, expected, result, cache);
+			expectSame(result, metaf::Parser::parse(changed));
+			metaf::Parser::reparse(report, result, unrelated, cache);
+			expectSame(unrelated, expected);
+		}
+	}
+}
+
+TEST(Reparse, groupLimit) {
+	const std::string report =
+		"METAR ZZZZ 041100Z 24010KT 9999 SCT020 10/05 Q1010 RMK A B C D E F G";
+	const auto previous = metaf::Parser::parse(report);
+	const auto result = metaf::Parser::reparse(report, previous, 12);
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::REPORT_TOO_LARGE);
+	expectSame(result, metaf::Parser::parse(report, 12));
+}
@@ -0,0 +1,110 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+
+static void expectRange(const metaf::ReportSections::Range & range,
+	std::size_t begin,
+	std::size_t end)
+{
+	EXPECT_EQ(range.begin, begin);
+	EXPECT_EQ(range.end, end);
+}
+
+TEST(ReportSections, metar) {
+	const auto result = metaf::Parser::parse(
+		"METAR ZZZZ 041100Z 24010KT 9999 SCT020 10/05 Q1010 "
+		"TEMPO FM1200 TL1300 4000 RA NOSIG RMK AO2=");
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::NONE);
+	const auto & sections = result.sections;
+	expectRange(sections.header, 0, 3);
+	expectRange(sections.body, 3, 8);
+	ASSERT_EQ(sections.trends.size(), 2u);
+	EXPECT_EQ(sections.trends[0].trendGroup, 8u);
+	expectRange(sections.trends[0].range, 8, 11);
+	EXPECT_EQ(sections.trends[1].trendGroup, 11u);
+	expectRange(sections.trends[1].range, 11, 12);
+	expectRange(sections.remarks, 12, 14);
+	EXPECT_EQ(sections.remarks.end, result.groups.size());
+}
+
+TEST(ReportSections, taf) {
+	const auto result = metaf::Parser::parse(
+		"TAF AMD ZZZZ 041100Z 0412/0512 24010KT 9999 SCT020 TX10/0414Z "
+		"TEMPO 0414/0418 4000 RA BECMG 0500/0502 BKN010 RMK NXT FCST BY 041800Z=");
+	EXPECT_EQ(result.reportMetadata.error, metaf::ReportError::NONE);
+	const auto & sections = result.sections;
+	expectRange(sections.header, 0, 5);
+	expectRange(sections.body, 5, 9);
+	ASSERT_EQ(sections.trends.size(), 2u);
+	EXPECT_EQ(sections.trends[0].trendGroup, 9u);
+	expectRange(sections.trends[0].range, 9, 12);
+	EXPECT_EQ(sections.trends[1].trendGroup, 12u);
+	expectRange(sections.trends[1].range, 12, 14);
+	EXPECT_EQ(sections.remarks.begin, 14u);
+	EXPECT_EQ(sections.remarks.end, result.groups.size());
+	for (const auto & t : sections.trends) {
+		EXPECT_TRUE(std::holds_alternative<metaf::TrendGroup>(
+			result.groups[t.trendGroup].group));
+	}
+}
+
+TEST(ReportSections, firstOf) {
+	const auto result = metaf::Parser::parse(
+		"METAR ZZZZ 041100Z 24010KT 9999 SCT020 BKN040 10/05 Q1010 "
+		"BECMG 27015KT RMK AO2=");
+	const auto & sections = result.sections;
+	EXPECT_EQ(sections.firstOf<metaf::LocationGroup>(), 1u);
+	EXPECT_EQ(sections.firstOf<metaf::ReportTimeGroup>(), 2u);
+	EXPECT_EQ(sections.firstOf<metaf::WindGroup>(), 3u);
+	EXPECT_EQ(sections.firstOf<metaf::CloudGroup>(), 5u);
+	EXPECT_EQ(sections.firstOf<metaf::PressureGroup>(), 8u);
+	EXPECT_EQ(sections.firstOf<metaf::TrendGroup>(), 9u);
+	EXPECT_EQ(sections.firstOf<metaf::LightningGroup>(),
+		metaf::ReportSections::notFound);
+	EXPECT_EQ(sections.firstOf<metaf::TemperatureForecastGroup>(),
+		metaf::ReportSections::notFound);
+}
+
+TEST(ReportSections, noBody) {
+	const auto result = metaf::Parser::parse("METAR ZZZZ 041100Z NIL=");
+	const auto & sections = result.sections;
+	EXPECT_EQ(sections.header.begin, 0u);
+	EXPECT_EQ(sections.body.begin, sections.header.end);
+	EXPECT_TRUE(sections.trends.empty());
+	EXPECT_TRUE(sections.remarks.empty());
+	EXPECT_EQ(sections.remarks.end, result.groups.size());
+}
+
+TEST(ReportSections, emptyReport) {
+	const auto result = metaf::Parser::parse("");
+	const auto & sections = result.sections;
+	EXPECT_TRUE(sections.header.empty());
+	EXPECT_TRUE(sections.body.empty());
+	EXPECT_TRUE(sections.trends.empty());
+	EXPECT_TRUE(sections.remarks.empty());
+	EXPECT_EQ(sections.firstOf<metaf::FixedGroup>(), metaf::ReportSections::notFound);
+}
+
+TEST(ReportSections, reuseParseResult) {
+	metaf::GroupCache cache;
+	metaf::ParseResult result;
+	metaf::Parser::parse(
+		"TAF ZZZZ 041100Z 0412/0512 24010KT 9999 SCT020 TEMPO 0414/0418 4000 RA "
+		"RMK NXT FCST BY 041800Z=", result, cache);
+	EXPECT_EQ(result.sections.trends.size(), 1u);
+	EXPECT_FALSE(result.sections.remarks.empty());
+	metaf::Parser::parse("METAR ZZZZ 041100Z 24010KT 9999 SCT020 10/05 Q1010=",
+		result, cache);
+	expectRange(result.sections.header, 0, 3);
+	expectRange(result.sections.body, 3, result.groups.size());
+	EXPECT_TRUE(result.sections.trends.empty());
+	EXPECT_TRUE(result.sections.remarks.empty());
+	EXPECT_EQ(result.sections.firstOf<metaf::TrendGroup>(),
+		metaf::ReportSections::notFound);
+}
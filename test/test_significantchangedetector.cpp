@@ -0,0 +1,200 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include <memory_resource>
+
+using Event = metaf::SignificantChangeDetector::Event;
+
+static std::vector<Event> update(metaf::SignificantChangeDetector & detector,
+	const std::string & report,
+	metaf::SignificantChangeDetector::Id station = 0)
+{
+	std::vector<Event> events;
+	detector.update(station, metaf::Parser::parse(report), events);
+	return events;
+}
+
+TEST(SignificantChangeDetector, firstReport) {
+	metaf::SignificantChangeDetector detector;
+	EXPECT_FALSE(detector.state(0).isReported);
+	EXPECT_TRUE(update(detector,
+		"METAR KZZZ 041153Z 24015KT 1/2SM +TSRA OVC003 12/10 A2992").empty());
+	const auto & state = detector.state(0);
+	EXPECT_TRUE(state.isReported);
+	EXPECT_NEAR(state.ceiling, 300, 0.1);
+	EXPECT_NEAR(state.visibility, 805, 1);
+	EXPECT_NEAR(state.windDirection, 240, 0.1);
+	EXPECT_NEAR(state.windSpeed, 15, 0.1);
+	EXPECT_TRUE(state.isThunderstorm);
+	EXPECT_FALSE(state.isFreezingPrecipitation);
+}
+
+TEST(SignificantChangeDetector, ceiling) {
+	metaf::SignificantChangeDetector detector;
+	update(detector, "METAR KZZZ 041153Z 24005KT 10SM BKN040 12/10 A2992");
+	// 4000 to 3500 feet does not cross threshold
+	EXPECT_TRUE(update(detector,
+		"METAR KZZZ 041253Z 24005KT 10SM BKN035 12/10 A2992").empty());
+	auto events = update(detector, "METAR KZZZ 041353Z 24005KT 10SM SCT010 OVC025 12/10 A2992");
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, Event::Type::CEILING);
+	EXPECT_NEAR(events[0].previous, 3500, 0.1);
+	EXPECT_NEAR(events[0].current, 2500, 0.1);
+	// Ceiling dissipates
+	events = update(detector, "METAR KZZZ 041453Z 24005KT 10SM FEW025 12/10 A2992");
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, Event::Type::CEILING);
+	EXPECT_TRUE(std::isinf(events[0].current));
+	// Rising to threshold is a change
+	update(detector, "METAR KZZZ 041553Z 24005KT 10SM BKN009 12/10 A2992");
+	events = update(detector, "METAR KZZZ 041653Z 24005KT 10SM BKN010 12/10 A2992");
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, Event::Type::CEILING);
+}
+
+TEST(SignificantChangeDetector, visibility) {
+	metaf::SignificantChangeDetector detector;
+	update(detector, "METAR EZZZ 041150Z 24005KT 6000 SCT040 12/10 Q1012");
+	auto events = update(detector, "METAR EZZZ 041220Z 24005KT 4000 BR SCT040 12/10 Q1012");
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, Event::Type::VISIBILITY);
+	EXPECT_NEAR(events[0].previous, 6000, 0.1);
+	EXPECT_NEAR(events[0].current, 4000, 0.1);
+	EXPECT_TRUE(update(detector,
+		"METAR EZZZ 041250Z 24005KT 3500 BR SCT040 12/10 Q1012").empty());
+	// Visibility not reported is not compared
+	EXPECT_TRUE(update(detector,
+		"METAR EZZZ 041320Z 24005KT //// SCT040 12/10 Q1012").empty());
+	EXPECT_TRUE(update(detector,
+		"METAR EZZZ 041350Z 24005KT CAVOK 12/10 Q1012").empty());
+	events = update(detector, "METAR EZZZ 041420Z 24005KT 0600 FG VV001 12/12 Q1012");
+	ASSERT_EQ(events.size(), 2u);
+	EXPECT_EQ(events[0].type, Event::Type::CEILING);
+	EXPECT_TRUE(std::isinf(events[0].previous));
+	EXPECT_EQ(events[1].type, Event::Type::VISIBILITY);
+}
+
+TEST(SignificantChangeDetector, windShift) {
+	metaf::SignificantChangeDetector detector;
+	update(detector, "METAR KZZZ 041153Z 34015KT 10SM FEW040 12/10 A2992");
+	// Direction change through north
+	auto events = update(detector, "METAR KZZZ 041253Z 03012KT 10SM FEW040 12/10 A2992");
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, Event::Type::WIND_SHIFT);
+	EXPECT_NEAR(events[0].previous, 340, 0.1);
+	EXPECT_NEAR(events[0].current, 30, 0.1);
+	// Change less than 45 degrees
+	EXPECT_TRUE(update(detector,
+		"METAR KZZZ 041353Z 06012KT 10SM FEW040 12/10 A2992").empty());
+	// Wind speed is below 10 knots
+	EXPECT_TRUE(update(detector,
+		"METAR KZZZ 041453Z 15008KT 10SM FEW040 12/10 A2992").empty());
+	EXPECT_TRUE(update(detector,
+		"METAR KZZZ 041553Z VRB15KT 10SM FEW040 12/10 A2992").empty());
+}
+
+TEST(SignificantChangeDetector, weather) {
+	metaf::SignificantChangeDetector detector;
+	update(detector, "METAR KZZZ 041153Z 24005KT 10SM -RA FEW040 12/10 A2992");
+	auto events = update(detector, "METAR KZZZ 041253Z 24005KT 10SM VCTS -RA FEW040CB 12/10 A2992");
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, Event::Type::THUNDERSTORM_BEGIN);
+	events = update(detector, "METAR KZZZ 041353Z 24005KT 10SM -FZRA FEW040 00/M01 A2992 RMK TSE50");
+	ASSERT_EQ(events.size(), 2u);
+	EXPECT_EQ(events[0].type, Event::Type::THUNDERSTORM_END);
+	EXPECT_EQ(events[1].type, Event::Type::FREEZING_PRECIPITATION_BEGIN);
+	// Freezing fog is not freezing precipitation
+	events = update(detector, "METAR KZZZ 041453Z 24005KT 1/2SM FZFG VV002 00/M01 A2992");
+	EXPECT_EQ(events.size(), 3u);
+	EXPECT_EQ(events.back().type, Event::Type::FREEZING_PRECIPITATION_END);
+	EXPECT_FALSE(detector.state(0).isFreezingPrecipitation);
+}
+
+TEST(SignificantChangeDetector, stationsAndInvalidReports) {
+	metaf::SignificantChangeDetector detector;
+	metaf::StationRegistry registry;
+	detector.reserve(2);
+	std::vector<Event> events;
+	auto f = [&events](const Event & e) { events.push_back(e); };
+	detector.update(registry, metaf::Parser::parse(
+		"METAR KAAA 041153Z 24005KT 10SM OVC040 12/10 A2992"), f);
+	detector.update(registry, metaf::Parser::parse(
+		"METAR KBBB 041153Z 24005KT 10SM OVC004 12/10 A2992"), f);
+	EXPECT_TRUE(events.empty());
+	// TAF, NIL report and report with syntax error do not change the state
+	detector.update(registry, metaf::Parser::parse(
+		"TAF KAAA 041130Z 0412/0512 24005KT P6SM OVC002"), f);
+	detector.update(registry, metaf::Parser::parse("METAR KAAA 041253Z NIL"), f);
+	detector.update(registry, metaf::Parser::parse("METAR KAAA 24005KT 10SM OVC002"), f);
+	EXPECT_TRUE(events.empty());
+	EXPECT_EQ(detector.update(registry, metaf::Parser::parse(
+		"METAR KBBB 041253Z 24005KT 10SM OVC040 12/10 A2992"), f), 1u);
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].station, registry.find(*metaf::LocationGroup::stringToKey("KBBB")));
+	EXPECT_NEAR(detector.state(registry.find(*metaf::LocationGroup::stringToKey("KAAA"))).ceiling,
+		4000, 0.1);
+	detector.reset(0);
+	EXPECT_FALSE(detector.state(0).isReported);
+	EXPECT_FALSE(detector.state(100).isReported);
+}
+
+TEST(SignificantChangeDetector, options) {
+	metaf::SignificantChangeDetector::Options options;
+	options.ceilingFeet = { 2000 };
+	options.visibilityMeters.clear();
+	options.windShiftDegrees = 90;
+	metaf::SignificantChangeDetector detector(options);
+	update(detector, "METAR KZZZ 041153Z 24015KT 1/2SM BKN030 12/10 A2992");
+	EXPECT_TRUE(update(detector,
+		"METAR KZZZ 041253Z 30015KT 10SM BKN025 12/10 A2992").empty());
+	const auto events = update(detector, "METAR KZZZ 041353Z 04015KT 10SM BKN015 12/10 A2992");
+	ASSERT_EQ(events.size(), 2u);
+	EXPECT_EQ(events[0].type, Event::Type::CEILING);
+	EXPECT_EQ(events[1].type, Event::Type::WIND_SHIFT);
+}
+
+TEST(SignificantChangeDetector, memoryResource) {
+	std::array<std::byte, 4096> buffer;
+	std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(),
+		std::pmr::null_memory_resource());
+	metaf::SignificantChangeDetector::Options options;
+	options.windShiftDegrees = 90;
+	metaf::SignificantChangeDetector detector(options, &resource);
+	EXPECT_EQ(detector.settings().windShiftDegrees, 90);
+	// States are allocated from the buffer; resource throws if the buffer is
+	// exhausted
+	detector.reserve(10);
+	const auto metar = metaf::Parser::parse(
+		"METAR KZZZ 041153Z 24015KT 10SM BKN030 12/10 A2992");
+	std::size_t events = 0;
+	for (auto station = 0u; station < 10; station++) {
+		detector.update(station, metar, [&events](const Event &) { events++; });
+	}
+	EXPECT_EQ(events, 0u);
+	EXPECT_TRUE(detector.state(9).isReported);
+	EXPECT_THROW(detector.reserve(1000), std::bad_alloc);
+	EXPECT_TRUE(detector.state(9).isReported);
+}
+
+TEST(SignificantChangeDetector, realData) {
+	// Each report compared with itself has no changes
+	metaf::SignificantChangeDetector detector;
+	metaf::StationRegistry registry;
+	std::size_t events = 0;
+	for (const auto & data : testdata::realDataSet) {
+		const auto result = metaf::Parser::parse(data.metar);
+		const auto f = [&events](const Event &) { events++; };
+		detector.update(registry, result, f);
+		detector.update(registry, result, f);
+		detector.update(registry, result, f);
+		detector.clear();
+	}
+	EXPECT_EQ(events, 0u);
+}
@@ -0,0 +1,172 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+#include <random>
+
+static const auto margin = 0.5;
+
+static const char stations[] =
+	"# ICAO latitude longitude\n"
+	"EGLL 51.4775 -0.4614 London Heathrow\n"
+	"LFPG 49.0097 2.5479 Paris Charles de Gaulle\n"
+	"EHAM 52.3086 4.7639 Amsterdam Schiphol\n"
+	"KJFK 40.6398 -73.7789 New York JFK\n"
+	"NZCH -43.4894 172.5322 Christchurch\n"
+	"NZAA -37.0081 174.7917 Auckland\n"
+	"NFFN -17.7554 177.4431 Nadi\n"
+	"PAFA 64.8151 -147.8563\n"
+	"XXXX 91.0 0.0\n"
+	"YYYY 0.0 181.0\n"
+	"ZZZZ 12.0\n"
+	"WWWW 12.0 abc\n";
+
+static std::uint32_t key(std::string_view location) {
+	return metaf::LocationGroup::stringToKey(location).value();
+}
+
+TEST(StationIndex, distance) {
+	// London Heathrow to New York JFK
+	EXPECT_NEAR(metaf::StationIndex::distance(51.4775, -0.4614, 40.6398, -73.7789), 2991, 5);
+	EXPECT_NEAR(metaf::StationIndex::distance(0, 0, 1, 0), 60, margin);
+	EXPECT_NEAR(metaf::StationIndex::distance(0, 179.5, 0, -179.5), 60, margin);
+	EXPECT_NEAR(metaf::StationIndex::distance(90, 0, -90, 0), 10800, 10);
+}
+
+TEST(StationIndex, load) {
+	metaf::StationRegistry registry;
+	metaf::StationIndex index;
+	EXPECT_EQ(index.load(stations, registry), 8u);
+	EXPECT_EQ(index.size(), 8u);
+	EXPECT_EQ(registry.size(), 8u);
+	EXPECT_TRUE(index.contains(registry.find(key("PAFA"))));
+	EXPECT_EQ(registry.find(key("XXXX")), metaf::StationRegistry::notFound);
+	EXPECT_EQ(registry.find(key("ZZZZ")), metaf::StationRegistry::notFound);
+}
+
+TEST(StationIndex, radius) {
+	metaf::StationRegistry registry;
+	metaf::StationIndex index;
+	index.load(stations, registry);
+	std::vector<metaf::StationIndex::Result> result;
+	index.radius(51.4775, -0.4614, 195, result);
+	ASSERT_EQ(result.size(), 2u);
+	std::sort(result.begin(), result.end(),
+		[](const auto & r1, const auto & r2){ return r1.distance < r2.distance; });
+	EXPECT_EQ(result[0].id, registry.find(key("EGLL")));
+	EXPECT_NEAR(result[0].distance, 0, margin);
+	EXPECT_EQ(result[1].id, registry.find(key("LFPG")));
+	EXPECT_NEAR(result[1].distance, 188, 1);
+
+	index.radius(51.4775, -0.4614, 10, result);
+	EXPECT_EQ(result.size(), 1u);
+}
+
+TEST(StationIndex, radiusAcrossDateLine) {
+	metaf::StationRegistry registry;
+	metaf::StationIndex index;
+	index.load(stations, registry);
+	std::vector<metaf::StationIndex::Result> result;
+	index.radius(-18, -179.5, 200, result);
+	ASSERT_EQ(result.size(), 1u);
+	EXPECT_EQ(result[0].id, registry.find(key("NFFN")));
+}
+
+TEST(StationIndex, nearest) {
+	metaf::StationRegistry registry;
+	metaf::StationIndex index;
+	index.load(stations, registry);
+	std::vector<metaf::StationIndex::Result> result;
+	index.nearest(-40, 175, 3, result);
+	ASSERT_EQ(result.size(), 3u);
+	EXPECT_EQ(result[0].id, registry.find(key("NZAA")));
+	EXPECT_EQ(result[1].id, registry.find(key("NZCH")));
+	EXPECT_EQ(result[2].id, registry.find(key("NFFN")));
+
+	index.nearest(-40, 175, 100, result);
+	EXPECT_EQ(result.size(), 8u);
+
+	index.nearest(-40, 175, 0, result);
+	EXPECT_TRUE(result.empty());
+}
+
+TEST(StationIndex, update) {
+	metaf::StationRegistry registry;
+	metaf::StationIndex index;
+	index.load(stations, registry);
+	std::vector<metaf::StationIndex::Result> result;
+	// Station moved from London to New York
+	EXPECT_EQ(index.load("EGLL 40.7 -73.8", registry), 1u);
+	EXPECT_EQ(index.size(), 8u);
+	index.radius(40.6398, -73.7789, 50, result);
+	EXPECT_EQ(result.size(), 2u);
+	index.remove(registry.find(key("KJFK")));
+	EXPECT_EQ(index.size(), 7u);
+	index.radius(40.6398, -73.7789, 50, result);
+	ASSERT_EQ(result.size(), 1u);
+	EXPECT_EQ(result[0].id, registry.find(key("EGLL")));
+	EXPECT_FALSE(index.set(0, 95, 0));
+	index.clear();
+	EXPECT_EQ(index.size(), 0u);
+	index.radius(40.6398, -73.7789, 50, result);
+	EXPECT_TRUE(result.empty());
+}
+
+TEST(StationIndex, nearestReporting) {
+	metaf::StationRegistry registry;
+	metaf::StationIndex index;
+	index.load(stations, registry);
+	// Latest reports indexed by station ID
+	std::vector<metaf::ParseResult> latest(registry.size());
+	for (const auto report : {
+		"METAR EHAM 041125Z 24015KT 9999 FEW030 10/05 Q1012",
+		"METAR KJFK 041151Z 24015KT 9999 FEW030 10/05 Q1012" })
+	{
+		auto parseResult = metaf::Parser::parse(report);
+		latest.at(registry.find(parseResult)) = std::move(parseResult);
+	}
+	std::vector<metaf::StationIndex::Result> result;
+	index.nearest(51.4775, -0.4614, 2, result, 
+		[&](metaf::StationIndex::Id id){ return !latest[id].groups.empty(); });
+	ASSERT_EQ(result.size(), 2u);
+	EXPECT_EQ(result[0].id, registry.find(key("EHAM")));
+	EXPECT_EQ(result[1].id, registry.find(key("KJFK")));
+}
+
+TEST(StationIndex, randomStations) {
+	// Compare results with brute force search
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<float> lat(-90, 90), lon(-180, 180);
+	static const auto stationCount = 2000u;
+	std::vector<std::pair<float, float>> locations;
+	metaf::StationIndex index;
+	for (auto i = 0u; i < stationCount; i++) {
+		locations.emplace_back(lat(generator), lon(generator));
+		ASSERT_TRUE(index.set(i, locations.back().first, locations.back().second));
+	}
+	std::vector<metaf::StationIndex::Result> result;
+	for (auto q = 0; q < 200; q++) {
+		const auto qlat = lat(generator), qlon = lon(generator);
+		const auto distance = (q % 4 + 1) * 300.0f;
+		std::vector<float> distances;
+		auto expectedCount = 0u;
+		for (const auto & l : locations) {
+			const auto d = metaf::StationIndex::distance(qlat, qlon, l.first, l.second);
+			distances.push_back(d);
+			if (d <= distance) expectedCount++;
+		}
+		index.radius(qlat, qlon, distance, result);
+		EXPECT_EQ(result.size(), expectedCount);
+		std::sort(distances.begin(), distances.end());
+		index.nearest(qlat, qlon, 5, result);
+		ASSERT_EQ(result.size(), 5u);
+		for (auto i = 0u; i < result.size(); i++) {
+			EXPECT_EQ(result[i].distance, distances[i]);
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "metaf.hpp"
+
+static std::uint32_t key(std::string_view location) {
+	return metaf::LocationGroup::stringToKey(location).value();
+}
+
+TEST(StationRegistry, add) {
+	metaf::StationRegistry registry;
+	EXPECT_EQ(registry.add(key("UKLL")), 0u);
+	EXPECT_EQ(registry.add(key("KJFK")), 1u);
+	EXPECT_EQ(registry.add(key("UKLL")), 0u);
+	EXPECT_EQ(registry.size(), 2u);
+	EXPECT_EQ(registry.key(0), key("UKLL"));
+	EXPECT_EQ(registry.key(1), key("KJFK"));
+	EXPECT_THROW(registry.key(2), std::out_of_range);
+}
+
+TEST(StationRegistry, find) {
+	metaf::StationRegistry registry;
+	registry.add(key("UKLL"));
+	registry.add(key("KJFK"));
+	EXPECT_EQ(registry.find(key("KJFK")), 1u);
+	EXPECT_EQ(registry.find(key("EGLL")), metaf::StationRegistry::notFound);
+	EXPECT_EQ(registry.size(), 2u);
+	registry.clear();
+	EXPECT_EQ(registry.find(key("KJFK")), metaf::StationRegistry::notFound);
+	EXPECT_EQ(registry.size(), 0u);
+}
+
+TEST(StationRegistry, findReport) {
+	metaf::StationRegistry registry;
+	registry.add(key("UKLL"));
+	registry.add(key("KJFK"));
+	const auto r1 = metaf::Parser::parse("METAR KJFK 041115Z 24015KT 9999 FEW030 10/05 Q1012");
+	EXPECT_EQ(registry.find(r1), 1u);
+	const auto r2 = metaf::Parser::parse("METAR EGLL 041115Z 24015KT 9999 FEW030 10/05 Q1012");
+	EXPECT_EQ(registry.find(r2), metaf::StationRegistry::notFound);
+	const auto r3 = metaf::Parser::parse("METAR");
+	EXPECT_EQ(registry.find(r3), metaf::StationRegistry::notFound);
+}
+
+TEST(StationRegistry, load) {
+	static const char stations[] =
+		"# Station list\n"
+		"UKLL Lviv\n"
+		"\n"
+		"  KJFK\t40.64 -73.78\r\n"
+		"ukll lowercase\n"
+		"K2J3\n"
+		"UKLL duplicate\n"
+		"XXXXX wrong length";
+	metaf::StationRegistry registry;
+	EXPECT_EQ(registry.load(stations), 3u);
+	EXPECT_EQ(registry.size(), 3u);
+	EXPECT_EQ(registry.find(key("UKLL")), 0u);
+	EXPECT_EQ(registry.find(key("KJFK")), 1u);
+	EXPECT_EQ(registry.find(key("K2J3")), 2u);
+}
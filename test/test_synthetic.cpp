@@ -0,0 +1,83 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_synthetic.h"
+#include "metaf.hpp"
+
+static const auto reportCount = 1000u;
+
+static std::size_t countErrors(const std::vector<std::string> & reports) {
+	std::size_t result = 0;
+	for (const auto & r : reports) {
+		if (metaf::Parser::parse(r).reportMetadata.error != metaf::ReportError::NONE) {
+			result++;
+		}
+	}
+	return result;
+}
+
+TEST(SyntheticDataGenerator, sameSeed) {
+	testdata::SyntheticDataGenerator g1, g2;
+	for (auto i = 0u; i < reportCount; i++) EXPECT_EQ(g1.next(), g2.next());
+}
+
+TEST(SyntheticDataGenerator, differentSeed) {
+	testdata::SyntheticDataGenerator::Options options;
+	options.seed = 2;
+	testdata::SyntheticDataGenerator g1, g2(options);
+	EXPECT_NE(g1.generate(reportCount), g2.generate(reportCount));
+}
+
+TEST(SyntheticDataGenerator, validReports) {
+	const auto reports = testdata::SyntheticDataGenerator().generate(reportCount);
+	EXPECT_EQ(countErrors(reports), 0u);
+}
+
+TEST(SyntheticDataGenerator, malformedReports) {
+	testdata::SyntheticDataGenerator::Options options;
+	options.malformedReports = 1.0;
+	const auto reports = testdata::SyntheticDataGenerator(options).generate(reportCount);
+	EXPECT_EQ(countErrors(reports), reportCount);
+}
+
+TEST(SyntheticDataGenerator, unknownTokens) {
+	testdata::SyntheticDataGenerator::Options options;
+	options.unknownTokens = 1.0;
+	testdata::SyntheticDataGenerator generator(options);
+	auto reportsWithUnknownGroups = 0u;
+	for (auto i = 0u; i < reportCount; i++) {
+		const auto parseResult = metaf::Parser::parse(generator.next());
+		for (const auto & gi : parseResult.groups) {
+			if (std::holds_alternative<metaf::UnknownGroup>(gi.group)) {
+				reportsWithUnknownGroups++;
+				break;
+			}
+		}
+	}
+	// Random token is sometimes recognised as a valid group
+	EXPECT_GT(reportsWithUnknownGroups, reportCount * 9 / 10);
+}
+
+TEST(SyntheticDataGenerator, longRemarks) {
+	testdata::SyntheticDataGenerator::Options options;
+	options.longRemarks = 1.0;
+	options.longRemarksGroups = 30;
+	testdata::SyntheticDataGenerator generator(options);
+	auto reportsWithLongRemarks = 0u;
+	for (auto i = 0u; i < reportCount; i++) {
+		const auto parseResult = metaf::Parser::parse(generator.next(), 200);
+		EXPECT_EQ(parseResult.reportMetadata.error, metaf::ReportError::NONE);
+		auto remarks = 0u;
+		for (const auto & gi : parseResult.groups) {
+			if (gi.reportPart == metaf::ReportPart::RMK) remarks++;
+		}
+		if (remarks >= options.longRemarksGroups / 2) reportsWithLongRemarks++;
+	}
+	// NIL and cancelled reports do not have remarks
+	EXPECT_GT(reportsWithLongRemarks, reportCount * 9 / 10);
+}
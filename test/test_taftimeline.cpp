@@ -0,0 +1,205 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+
+static const auto margin = 0.1/2;
+
+static metaf::MetafTime time(const std::string & ddhhmm) {
+	const auto t = metaf::MetafTime::fromStringDDHHMM(ddhhmm);
+	EXPECT_TRUE(t.has_value());
+	return t.value_or(metaf::MetafTime());
+}
+
+static std::optional<metaf::TafTimeline> timeline(const std::string & report) {
+	return metaf::TafTimeline::fromParseResult(metaf::Parser::parse(report));
+}
+
+TEST(TafTimeline, notTaf) {
+	EXPECT_FALSE(timeline("METAR ZZZZ 041115Z 24015KT 9999 FEW030 12/10 Q1012").has_value());
+	EXPECT_FALSE(timeline("TAF ZZZZ 041100Z NIL").has_value());
+}
+
+TEST(TafTimeline, prevailingOnly) {
+	const auto tl = timeline("TAF ZZZZ 041100Z 0412/0512 15006KT 9999 BKN015");
+	ASSERT_TRUE(tl.has_value());
+	ASSERT_EQ(tl->prevailing().size(), 1u);
+	EXPECT_TRUE(tl->temporary().empty());
+	EXPECT_EQ(tl->validFrom().day(), 4u);
+	EXPECT_EQ(tl->validFrom().hour(), 12u);
+	EXPECT_EQ(tl->validTill().day(), 5u);
+	EXPECT_EQ(tl->validTill().hour(), 12u);
+
+	const auto & conditions = tl->prevailing()[0].conditions;
+	ASSERT_TRUE(conditions.wind.has_value());
+	EXPECT_NEAR(conditions.wind->windSpeed().speed().value(), 6, margin);
+	ASSERT_TRUE(conditions.visibility.has_value());
+	ASSERT_EQ(conditions.clouds.size(), 1u);
+	EXPECT_TRUE(conditions.weather.empty());
+
+	EXPECT_EQ(tl->prevailingAt(time("041200")), 0u);
+	EXPECT_EQ(tl->prevailingAt(time("051159")), 0u);
+	EXPECT_FALSE(tl->prevailingAt(time("041159")).has_value());
+	EXPECT_FALSE(tl->prevailingAt(time("051200")).has_value());
+}
+
+TEST(TafTimeline, from) {
+	const auto tl = timeline("TAF ZZZZ 041100Z 0412/0512 15006KT 9999 BKN015 "
+		"FM041800 20010KT 5000 RA OVC008 "
+		"FM050300 25015KT CAVOK");
+	ASSERT_TRUE(tl.has_value());
+	ASSERT_EQ(tl->prevailing().size(), 3u);
+	EXPECT_EQ(tl->prevailing()[0].till.hour(), 18u);
+	EXPECT_EQ(tl->prevailing()[1].from.hour(), 18u);
+	EXPECT_EQ(tl->prevailing()[1].till.hour(), 3u);
+	EXPECT_EQ(tl->prevailing()[2].from.hour(), 3u);
+	EXPECT_EQ(tl->prevailing()[2].till.hour(), 12u);
+	EXPECT_EQ(tl->prevailing()[1].trend.type(), metaf::TrendGroup::Type::FROM);
+
+	// FM trend replaces all conditions
+	const auto & conditions = tl->prevailing()[2].conditions;
+	EXPECT_TRUE(conditions.cavok);
+	EXPECT_FALSE(conditions.visibility.has_value());
+	EXPECT_TRUE(conditions.clouds.empty());
+	EXPECT_TRUE(conditions.weather.empty());
+
+	EXPECT_EQ(tl->prevailingAt(time("041759")), 0u);
+	EXPECT_EQ(tl->prevailingAt(time("041800")), 1u);
+	EXPECT_EQ(tl->prevailingAt(time("050259")), 1u);
+	EXPECT_EQ(tl->prevailingAt(time("050300")), 2u);
+
+	const auto range = tl->prevailingBetween(time("041700"), time("050300"));
+	EXPECT_EQ(range.first, 0u);
+	EXPECT_EQ(range.second, 2u);
+	const auto rangeAll = tl->prevailingBetween(time("040000"), time("060000"));
+	EXPECT_EQ(rangeAll.first, 0u);
+	EXPECT_EQ(rangeAll.second, 3u);
+	const auto rangeEmpty = tl->prevailingBetween(time("050300"), time("050300"));
+	EXPECT_EQ(rangeEmpty.first, rangeEmpty.second);
+}
+
+TEST(TafTimeline, becmg) {
+	const auto tl = timeline("TAF ZZZZ 041100Z 0412/0512 15006KT 9999 -RA BKN015 "
+		"BECMG 0414/0416 25012KT "
+		"BECMG 0420/0422 NSW SCT020");
+	ASSERT_TRUE(tl.has_value());
+	ASSERT_EQ(tl->prevailing().size(), 5u);
+
+	EXPECT_FALSE(tl->prevailing()[0].isTransition);
+	EXPECT_TRUE(tl->prevailing()[1].isTransition);
+	EXPECT_FALSE(tl->prevailing()[2].isTransition);
+	EXPECT_TRUE(tl->prevailing()[3].isTransition);
+	EXPECT_FALSE(tl->prevailing()[4].isTransition);
+	EXPECT_EQ(tl->prevailing()[1].from.hour(), 14u);
+	EXPECT_EQ(tl->prevailing()[1].till.hour(), 16u);
+	EXPECT_EQ(tl->prevailing()[2].from.hour(), 16u);
+	EXPECT_EQ(tl->prevailing()[2].till.hour(), 20u);
+
+	// BECMG trend only changes specified conditions
+	const auto & conditions2 = tl->prevailing()[2].conditions;
+	ASSERT_TRUE(conditions2.wind.has_value());
+	EXPECT_NEAR(conditions2.wind->windSpeed().speed().value(), 12, margin);
+	ASSERT_TRUE(conditions2.visibility.has_value());
+	EXPECT_EQ(conditions2.visibility->visibility().integer(), 10000u);
+	EXPECT_EQ(conditions2.clouds.size(), 1u);
+	EXPECT_EQ(conditions2.weather.size(), 1u);
+
+	const auto & conditions4 = tl->prevailing()[4].conditions;
+	ASSERT_TRUE(conditions4.wind.has_value());
+	EXPECT_NEAR(conditions4.wind->windSpeed().speed().value(), 12, margin);
+	ASSERT_EQ(conditions4.clouds.size(), 1u);
+	EXPECT_EQ(conditions4.clouds[0].amount(), metaf::CloudGroup::Amount::SCATTERED);
+	EXPECT_TRUE(conditions4.nsw);
+	EXPECT_TRUE(conditions4.weather.empty());
+
+	EXPECT_EQ(tl->prevailingAt(time("041500")), 1u);
+	EXPECT_EQ(tl->prevailingAt(time("041600")), 2u);
+	EXPECT_EQ(tl->prevailingAt(time("050000")), 4u);
+}
+
+TEST(TafTimeline, temporary) {
+	const auto tl = timeline("TAF ZZZZ 041100Z 0412/0512 15006KT 9999 BKN015 "
+		"TEMPO 0412/0418 4000 SHRA "
+		"PROB30 0416/0420 TSRA BKN010CB "
+		"PROB40 TEMPO 0500/0506 1500 BR");
+	ASSERT_TRUE(tl.has_value());
+	ASSERT_EQ(tl->prevailing().size(), 1u);
+	ASSERT_EQ(tl->temporary().size(), 3u);
+	EXPECT_EQ(tl->temporary()[0].trend.type(), metaf::TrendGroup::Type::TEMPO);
+	EXPECT_EQ(tl->temporary()[1].trend.probability(),
+		metaf::TrendGroup::Probability::PROB_30);
+	EXPECT_EQ(tl->temporary()[2].trend.probability(),
+		metaf::TrendGroup::Probability::PROB_40);
+
+	// Temporary conditions contain only changes
+	EXPECT_FALSE(tl->temporary()[0].conditions.wind.has_value());
+	EXPECT_TRUE(tl->temporary()[0].conditions.visibility.has_value());
+	EXPECT_TRUE(tl->temporary()[0].conditions.clouds.empty());
+
+	const auto at1300 = tl->temporaryAt(time("041300"));
+	ASSERT_EQ(at1300.second - at1300.first, 1u);
+	EXPECT_EQ(tl->activeTemporary()[at1300.first], 0u);
+
+	const auto at1700 = tl->temporaryAt(time("041700"));
+	ASSERT_EQ(at1700.second - at1700.first, 2u);
+	EXPECT_EQ(tl->activeTemporary()[at1700.first], 0u);
+	EXPECT_EQ(tl->activeTemporary()[at1700.first + 1], 1u);
+
+	const auto at2100 = tl->temporaryAt(time("042100"));
+	EXPECT_EQ(at2100.first, at2100.second);
+
+	const auto between = tl->temporaryBetween(time("041900"), time("050100"));
+	ASSERT_EQ(between.size(), 2u);
+	EXPECT_EQ(between[0], 1u);
+	EXPECT_EQ(between[1], 2u);
+
+	const auto outside = tl->temporaryAt(time("060000"));
+	EXPECT_EQ(outside.first, outside.second);
+}
+
+TEST(TafTimeline, monthBoundary) {
+	const auto tl = timeline("TAF ZZZZ 301100Z 3012/0112 15006KT 9999 BKN015 "
+		"FM010300 25015KT CAVOK "
+		"TEMPO 3022/0102 4000 SHRA");
+	ASSERT_TRUE(tl.has_value());
+	ASSERT_EQ(tl->prevailing().size(), 2u);
+	ASSERT_EQ(tl->temporary().size(), 1u);
+	EXPECT_EQ(tl->prevailingAt(time("302300")), 0u);
+	EXPECT_EQ(tl->prevailingAt(time("010200")), 0u);
+	EXPECT_EQ(tl->prevailingAt(time("010300")), 1u);
+	EXPECT_FALSE(tl->prevailingAt(time("011200")).has_value());
+	const auto at0100 = tl->temporaryAt(time("010100"));
+	EXPECT_EQ(at0100.second - at0100.first, 1u);
+}
+
+TEST(TafTimeline, realData) {
+	for (const auto & data : testdata::realDataSet) {
+		if (data.taf.empty()) continue;
+		const auto tl = timeline(data.taf);
+		if (!tl.has_value()) continue;
+		const auto & prevailing = tl->prevailing();
+		ASSERT_FALSE(prevailing.empty());
+		for (auto i = 0u; i < prevailing.size(); i++) {
+			// Each prevailing period is found at its beginning time
+			EXPECT_EQ(tl->prevailingAt(prevailing[i].from), i);
+			if (i) {
+				EXPECT_EQ(prevailing[i].from.day(), prevailing[i - 1].till.day());
+				EXPECT_EQ(prevailing[i].from.hour(), prevailing[i - 1].till.hour());
+			}
+		}
+		for (auto i = 0u; i < tl->temporary().size(); i++) {
+			const auto active = tl->temporaryAt(tl->temporary()[i].from);
+			auto found = false;
+			for (auto j = active.first; j < active.second; j++) {
+				if (tl->activeTemporary()[j] == i) found = true;
+			}
+			EXPECT_TRUE(found);
+		}
+	}
+}
@@ -0,0 +1,128 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "gtest/gtest.h"
+#include "workerpool.hpp"
+#include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+TEST(WorkerPool, ranges) {
+	WorkerPool pool;
+	for (auto threads : {0u, 1u, 3u, 4u, 100u}) {
+		for (auto size : {0u, 1u, 7u, 64u, 1001u}) {
+			std::vector<int> processed(size);
+			pool.run(size, threads, [&](std::size_t begin, std::size_t end) {
+				EXPECT_LE(begin, end);
+				EXPECT_LE(end, processed.size());
+				for (auto i = begin; i < end; i++) processed[i]++;
+			});
+			for (auto i = 0u; i < size; i++) {
+				EXPECT_EQ(processed[i], 1) << "threads " << threads << ", index " << i;
+			}
+		}
+	}
+}
+
+TEST(WorkerPool, order) {
+	// Each range writes results to its own positions, the result does not
+	// depend on the order in which the ranges are processed
+	WorkerPool pool;
+	static const auto size = 10000u;
+	std::vector<std::size_t> result(size);
+	pool.run(size, 4, [&](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; i++) result[i] = i * i;
+	});
+	for (auto i = 0u; i < size; i++) EXPECT_EQ(result[i], i * i);
+}
+
+TEST(WorkerPool, singleThread) {
+	WorkerPool pool;
+	std::size_t calls = 0;
+	pool.run(100, 1, [&](std::size_t begin, std::size_t end) {
+		EXPECT_EQ(begin, 0u);
+		EXPECT_EQ(end, 100u);
+		calls++;
+	});
+	EXPECT_EQ(calls, 1u);
+	EXPECT_EQ(pool.workers(), 0u);
+}
+
+#ifdef WORKERPOOL_THREADS
+
+TEST(WorkerPool, workersKeptBetweenBatches) {
+	WorkerPool pool;
+	std::mutex mutex;
+	std::vector<std::thread::id> first, second;
+	auto collect = [&](std::vector<std::thread::id> & ids) {
+		return [&](std::size_t, std::size_t) {
+			// Keep the range busy so that every worker gets a range
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			std::lock_guard<std::mutex> lock(mutex);
+			ids.push_back(std::this_thread::get_id());
+		};
+	};
+	pool.run(4, 4, collect(first));
+	EXPECT_EQ(pool.workers(), 3u);
+	pool.run(4, 4, collect(second));
+	EXPECT_EQ(pool.workers(), 3u);
+	// No new threads are started for the second batch
+	for (const auto & id : second) {
+		EXPECT_NE(std::find(first.begin(), first.end(), id), first.end());
+	}
+	// Fewer threads use some of the existing workers
+	pool.run(4, 2, [](std::size_t, std::size_t){});
+	EXPECT_EQ(pool.workers(), 3u);
+}
+
+TEST(WorkerPool, concurrentCallers) {
+	WorkerPool pool;
+	std::atomic<std::size_t> total = 0;
+	std::vector<std::thread> callers;
+	for (auto c = 0u; c < 4; c++) {
+		callers.emplace_back([&](){
+			for (auto b = 0u; b < 50; b++) {
+				pool.run(100, 3, [&](std::size_t begin, std::size_t end) {
+					total += end - begin;
+				});
+			}
+		});
+	}
+	for (auto & c : callers) c.join();
+	EXPECT_EQ(total, 4u * 50u * 100u);
+}
+
+#endif
+
+TEST(WorkerPool, errorPropagation) {
+	WorkerPool pool;
+	for (auto threads : {1u, 4u}) {
+		std::atomic<std::size_t> processed = 0;
+		auto f = [&](std::size_t begin, std::size_t end) {
+			if (begin <= 50 && 50 < end) throw std::runtime_error("range error");
+			processed += end - begin;
+		};
+		EXPECT_THROW(pool.run(100, threads, f), std::runtime_error);
+#ifdef WORKERPOOL_THREADS
+		// Other ranges are processed before the exception is re-thrown
+		if (threads > 1) {
+			EXPECT_EQ(processed, 75u);
+		}
+#endif
+		// Pool is usable after the error
+		processed = 0;
+		pool.run(100, threads, [&](std::size_t begin, std::size_t end) {
+			processed += end - begin;
+		});
+		EXPECT_EQ(processed, 100u);
+	}
+}
+
+TEST(WorkerPool, shared) {
+	EXPECT_EQ(&WorkerPool::shared(), &WorkerPool::shared());
+}
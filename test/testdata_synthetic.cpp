@@ -0,0 +1,161 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#include "testdata_synthetic.h"
+#include "testdata_real.h"
+#include "metaf.hpp"
+#include <variant>
+
+using namespace testdata;
+
+static const std::size_t reportParts = static_cast<std::size_t>(metaf::ReportPart::RMK) + 1;
+
+SyntheticDataGenerator::SyntheticDataGenerator() : SyntheticDataGenerator(Options()) {}
+
+SyntheticDataGenerator::SyntheticDataGenerator(const Options & o) :
+	options(o), generator(o.seed)
+{
+	pools.resize(std::variant_size_v<metaf::Group> * reportParts);
+	for (const auto & data : realDataSet) {
+		if (!data.metar.empty()) addTemplate(data.metar);
+		if (!data.taf.empty()) addTemplate(data.taf);
+	}
+	// Station locations are generated in the same way regardless of seed
+	std::mt19937 locationGenerator;
+	static const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	for (auto i = 0u; i < std::max(options.stations, std::size_t(1)); i++) {
+		std::string location;
+		for (auto j = 0; j < 4; j++) {
+			location.push_back(letters[locationGenerator() % (sizeof(letters) - 1)]);
+		}
+		locations.push_back(std::move(location));
+	}
+}
+
+void SyntheticDataGenerator::addTemplate(const std::string & report) {
+	const auto parseResult = metaf::Parser::parse(report);
+	Template result {{}, true};
+	for (const auto & gi : parseResult.groups) {
+		if (const auto fg = std::get_if<metaf::FixedGroup>(&gi.group); fg) {
+			if (fg->type() == metaf::FixedGroup::Type::NIL ||
+				fg->type() == metaf::FixedGroup::Type::CNL) result.hasBody = false;
+		}
+		const auto index = gi.group.index();
+		const auto part = static_cast<std::size_t>(gi.reportPart);
+		auto pool = index * reportParts + part;
+		// Groups which define report syntax are not replaced
+		const auto isLocation = std::holds_alternative<metaf::LocationGroup>(gi.group);
+		if (std::holds_alternative<metaf::FixedGroup>(gi.group) ||
+			std::holds_alternative<metaf::ReportTimeGroup>(gi.group) ||
+			std::holds_alternative<metaf::TrendGroup>(gi.group) ||
+			isLocation) pool = noPool;
+		if (pool != noPool) pools[pool].push_back(gi.rawString);
+		if (gi.reportPart == metaf::ReportPart::RMK && pool != noPool) {
+			remarks.push_back(gi.rawString);
+		}
+		result.groups.push_back(Group{pool, gi.rawString, isLocation});
+	}
+	if (!result.groups.empty()) templates.push_back(std::move(result));
+}
+
+std::string SyntheticDataGenerator::next() {
+	std::string result;
+	next(result);
+	return result;
+}
+
+void SyntheticDataGenerator::next(std::string & report) {
+	static const std::string remarksGroup("RMK");
+	const auto & reportTemplate = templates[random(templates.size())];
+	std::vector<const std::string *> groups;
+	bool hasRemarks = false;
+	std::size_t locationPosition = 0;
+	for (const auto & g : reportTemplate.groups) {
+		auto group = &g.rawString;
+		if (g.isLocation) {
+			locationPosition = groups.size();
+			group = &locations[random(locations.size())];
+		}
+		if (g.pool != noPool && chance(options.groupVariation)) {
+			const auto & pool = pools[g.pool];
+			group = &pool[random(pool.size())];
+		}
+		if (g.rawString == remarksGroup) hasRemarks = true;
+		groups.push_back(group);
+	}
+	if (reportTemplate.hasBody && !remarks.empty() && chance(options.longRemarks)) {
+		if (!hasRemarks) groups.push_back(&remarksGroup);
+		for (auto i = 0u; i < options.longRemarksGroups; i++) {
+			groups.push_back(&remarks[random(remarks.size())]);
+		}
+	}
+	if (chance(options.malformedReports)) malform(groups, locationPosition);
+
+	report.clear();
+	for (auto i = 0u; i < groups.size(); i++) {
+		if (i) report.push_back(' ');
+		report += *groups[i];
+		// Unknown tokens are not inserted into report header
+		if (i > 2 && chance(options.unknownTokens)) appendUnknownToken(report);
+	}
+	report.push_back('=');
+}
+
+std::vector<std::string> SyntheticDataGenerator::generate(std::size_t count) {
+	std::vector<std::string> result(count);
+	for (auto & report : result) next(report);
+	return result;
+}
+
+void SyntheticDataGenerator::appendUnknownToken(std::string & report) {
+	static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789/";
+	report.push_back(' ');
+	const auto length = 1 + random(10);
+	for (auto i = 0u; i < length; i++) {
+		report.push_back(chars[random(sizeof(chars) - 1)]);
+	}
+}
+
+void SyntheticDataGenerator::malform(std::vector<const std::string *> & groups,
+	std::size_t locationPosition)
+{
+	// Report header is damaged, so that the report syntax is always broken
+	if (groups.size() < 2) return;
+	enum { TRUNCATE, REMOVE_LOCATION, SWAP_GROUPS, INSERT_GROUP, DEFECTS };
+	switch (random(DEFECTS)) {
+		case TRUNCATE:
+		groups.resize(locationPosition + 1);
+		break;
+
+		case REMOVE_LOCATION:
+		groups.erase(groups.begin() + locationPosition);
+		break;
+
+		case SWAP_GROUPS:
+		if (locationPosition + 1 < groups.size()) {
+			std::swap(groups[locationPosition], groups[locationPosition + 1]);
+		} else {
+			groups.erase(groups.begin() + locationPosition);
+		}
+		break;
+
+		case INSERT_GROUP:
+		groups.insert(groups.begin() + locationPosition, groups[random(groups.size())]);
+		break;
+	}
+}
+
+std::size_t SyntheticDataGenerator::random(std::size_t size) {
+	// Not using std::uniform_int_distribution because its output is not 
+	// specified by the standard and may differ between standard libraries
+	return (generator() % size);
+}
+
+bool SyntheticDataGenerator::chance(double probability) {
+	if (probability <= 0) return false;
+	return (generator() < probability * (generator.max() + 1.0));
+}
@@ -0,0 +1,85 @@
+/*
+* Copyright (C) 2018-2020 Nick Naumenko (https://gitlab.com/nnaumenko)
+* All rights reserved.
+* This software may be modified and distributed under the terms
+* of the MIT license. See the LICENSE file for details.
+*/
+
+#ifndef TESTDATA_SYNTHETIC_H
+#define TESTDATA_SYNTHETIC_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+
+namespace testdata {
+
+	/// Generates any number of METAR and TAF reports for scale and load tests
+	/// @details Reports from realDataSet are used as templates; the groups
+	/// of each template are replaced with random groups of the same type and
+	/// report part found in realDataSet, so that the group type mix of the 
+	/// generated reports follows the one of realDataSet. Report type, report 
+	/// time and trend groups are kept to preserve report syntax.
+	/// The same seed and options always produce the same sequence of reports.
+	class SyntheticDataGenerator {
+	public:
+		struct Options {
+			std::uint32_t seed = 1;
+			/// Number of distinct station locations
+			std::size_t stations = 10000;
+			/// Probability of replacing each group of template report
+			double groupVariation = 0.5;
+			/// Probability of the report having long remarks section
+			double longRemarks = 0.0;
+			/// Number of groups appended to the long remarks section
+			std::size_t longRemarksGroups = 50;
+			/// Probability of inserting random unrecognised token after each
+			/// group
+			double unknownTokens = 0.0;
+			/// Probability of the report being malformed (truncated, location
+			/// missing, header groups in wrong order, etc.)
+			double malformedReports = 0.0;
+		};
+
+		SyntheticDataGenerator();
+		explicit SyntheticDataGenerator(const Options & options);
+
+		/// Generates next report
+		std::string next();
+		/// Generates next report, re-using memory allocated by the string
+		void next(std::string & report);
+		/// Generates specified number of reports
+		std::vector<std::string> generate(std::size_t count);
+
+	private:
+		struct Group {
+			std::size_t pool;	// Pool of replacement groups, or noPool
+			std::string rawString;
+			bool isLocation;
+		};
+		struct Template {
+			std::vector<Group> groups;
+			// Remarks can not be appended to NIL or cancelled reports
+			bool hasBody;
+		};
+		static const std::size_t noPool = static_cast<std::size_t>(-1);
+		Options options;
+		std::mt19937 generator;
+		std::vector<Template> templates;
+		// Group strings found in realDataSet for each group type / report part
+		std::vector<std::vector<std::string>> pools;
+		std::vector<std::string> remarks;
+		std::vector<std::string> locations;
+
+		void addTemplate(const std::string & report);
+		void appendUnknownToken(std::string & report);
+		void malform(std::vector<const std::string *> & groups,
+			std::size_t locationPosition);
+		std::size_t random(std::size_t size);
+		bool chance(double probability);
+	};
+
+} // namespace testdata
+
+#endif // #ifndef TESTDATA_SYNTHETIC_H